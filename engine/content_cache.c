@@ -0,0 +1,195 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 Soft Sprint Studios
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "content_cache.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <sys/stat.h>
+#include "gl_console.h"
+
+// Open-addressed table of parsed definition blobs. Invalidated entries keep
+// their path so the probe chain stays intact and a later store reuses the slot.
+
+typedef struct {
+    char path[CONTENT_CACHE_PATH_LENGTH];
+    ContentStamp stamp;
+    void* data;
+    size_t size;
+} ContentCacheEntry;
+
+static ContentCacheEntry g_content_entries[CONTENT_CACHE_SLOTS];
+
+static unsigned int hash_path(const char* s) {
+    unsigned int h = 2166136261u;
+    while (*s) {
+        unsigned char c = (unsigned char)tolower((unsigned char)*s++);
+        if (c == '\\') c = '/';
+        h ^= c;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static bool paths_equal(const char* a, const char* b) {
+    for (; *a && *b; ++a, ++b) {
+        char ca = (char)tolower((unsigned char)*a), cb = (char)tolower((unsigned char)*b);
+        if (ca == '\\') ca = '/';
+        if (cb == '\\') cb = '/';
+        if (ca != cb) return false;
+    }
+    return *a == *b;
+}
+
+static ContentCacheEntry* find_slot(const char* path, bool create) {
+    if (!path || !path[0] || strlen(path) >= CONTENT_CACHE_PATH_LENGTH) return NULL;
+    unsigned int slot = hash_path(path) & (CONTENT_CACHE_SLOTS - 1);
+    for (int probe = 0; probe < CONTENT_CACHE_SLOTS; ++probe) {
+        ContentCacheEntry* entry = &g_content_entries[slot];
+        if (entry->path[0] == '\0') {
+            if (!create) return NULL;
+            strcpy(entry->path, path);
+            return entry;
+        }
+        if (paths_equal(entry->path, path)) return entry;
+        slot = (slot + 1) & (CONTENT_CACHE_SLOTS - 1);
+    }
+    return NULL;
+}
+
+bool ContentCache_GetStamp(const char* path, ContentStamp* stamp) {
+    struct stat st;
+    if (!path || stat(path, &st) != 0) return false;
+    stamp->mtime = (long long)st.st_mtime;
+    stamp->size = (long long)st.st_size;
+    return true;
+}
+
+const void* ContentCache_Find(const char* path, size_t* size) {
+    ContentCacheEntry* entry = find_slot(path, false);
+    if (!entry || !entry->data) return NULL;
+    if (size) *size = entry->size;
+    return entry->data;
+}
+
+const void* ContentCache_Store(const char* path, const ContentStamp* stamp, const void* data, size_t size) {
+    ContentCacheEntry* entry = find_slot(path, true);
+    if (!entry) {
+        Console_Printf_Warning("[ContentCache] Table full, not caching '%s'.", path);
+        return NULL;
+    }
+    void* copy = malloc(size);
+    if (!copy) return NULL;
+    memcpy(copy, data, size);
+    free(entry->data);
+    entry->data = copy;
+    entry->size = size;
+    if (stamp) entry->stamp = *stamp;
+    else memset(&entry->stamp, 0, sizeof(entry->stamp));
+    return entry->data;
+}
+
+void ContentCache_Invalidate(const char* path) {
+    ContentCacheEntry* entry = find_slot(path, false);
+    if (!entry) return;
+    free(entry->data);
+    entry->data = NULL;
+    entry->size = 0;
+}
+
+int ContentCache_InvalidateStale(void) {
+    int dropped = 0;
+    for (int i = 0; i < CONTENT_CACHE_SLOTS; ++i) {
+        ContentCacheEntry* entry = &g_content_entries[i];
+        if (!entry->data) continue;
+        ContentStamp current;
+        if (!ContentCache_GetStamp(entry->path, &current) ||
+            current.mtime != entry->stamp.mtime || current.size != entry->stamp.size) {
+            free(entry->data);
+            entry->data = NULL;
+            entry->size = 0;
+            dropped++;
+        }
+    }
+    return dropped;
+}
+
+void ContentCache_Shutdown(void) {
+    for (int i = 0; i < CONTENT_CACHE_SLOTS; ++i) free(g_content_entries[i].data);
+    memset(g_content_entries, 0, sizeof(g_content_entries));
+}
+
+static bool compiled_path(const char* source_path, char* out, size_t out_size) {
+    int written = snprintf(out, out_size, "%s%s", source_path, CONTENT_CACHE_COMPILED_EXTENSION);
+    return written > 0 && (size_t)written < out_size;
+}
+
+void* ContentCache_LoadCompiled(const char* source_path, const char magic[4], int version, size_t* size) {
+    char path[CONTENT_CACHE_PATH_LENGTH + 8];
+    ContentStamp source;
+    if (!compiled_path(source_path, path, sizeof(path)) || !ContentCache_GetStamp(source_path, &source)) return NULL;
+
+    FILE* file = fopen(path, "rb");
+    if (!file) return NULL;
+
+    ContentCompiledHeader header;
+    void* data = NULL;
+    bool valid = fread(&header, sizeof(header), 1, file) == 1 &&
+        memcmp(header.magic, magic, 4) == 0 &&
+        header.version == version &&
+        header.source.mtime == source.mtime && header.source.size == source.size &&
+        header.dataSize > 0;
+    if (valid) {
+        data = malloc((size_t)header.dataSize);
+        valid = data && fread(data, 1, (size_t)header.dataSize, file) == (size_t)header.dataSize;
+    }
+    fclose(file);
+
+    if (!valid) {
+        free(data);
+        return NULL;
+    }
+    *size = (size_t)header.dataSize;
+    return data;
+}
+
+bool ContentCache_SaveCompiled(const char* source_path, const char magic[4], int version, const void* data, size_t size) {
+    char path[CONTENT_CACHE_PATH_LENGTH + 8];
+    ContentCompiledHeader header;
+    memset(&header, 0, sizeof(header));
+    if (!compiled_path(source_path, path, sizeof(path)) || !ContentCache_GetStamp(source_path, &header.source)) return false;
+    memcpy(header.magic, magic, 4);
+    header.version = version;
+    header.dataSize = (long long)size;
+
+    FILE* file = fopen(path, "wb");
+    if (!file) return false;
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 && fwrite(data, 1, size, file) == size;
+    fclose(file);
+    if (!ok) {
+        remove(path);
+        Console_Printf_Warning("[ContentCache] Failed to write '%s'.", path);
+    }
+    return ok;
+}
\ No newline at end of file
@@ -0,0 +1,76 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 Soft Sprint Studios
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+#ifndef CONTENT_CACHE_H
+#define CONTENT_CACHE_H
+
+//----------------------------------------//
+// Brief: Pre-parsed definition files keyed by path and modification stamp
+//----------------------------------------//
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CONTENT_CACHE_SLOTS 1024
+#define CONTENT_CACHE_PATH_LENGTH 256
+#define CONTENT_CACHE_COMPILED_EXTENSION ".cache"
+
+    typedef struct {
+        long long mtime;
+        long long size;
+    } ContentStamp;
+
+    typedef struct {
+        char magic[4];
+        int version;
+        ContentStamp source;
+        long long dataSize;
+    } ContentCompiledHeader;
+
+    bool ContentCache_GetStamp(const char* path, ContentStamp* stamp);
+    // Returns the parsed blob stored for path without touching the filesystem,
+    // or NULL if nothing is cached.
+    const void* ContentCache_Find(const char* path, size_t* size);
+    // Copies data into the cache, replacing any previous entry for path.
+    const void* ContentCache_Store(const char* path, const ContentStamp* stamp, const void* data, size_t size);
+    void ContentCache_Invalidate(const char* path);
+    // Stats every cached source and drops the entries whose stamp changed.
+    // Meant for level loads and editor reloads, not per-spawn paths.
+    int ContentCache_InvalidateStale(void);
+    void ContentCache_Shutdown(void);
+
+    // Compiled files live next to their source as <source>.cache. Load returns
+    // a malloc'd blob only if magic, version and the source stamp all match.
+    void* ContentCache_LoadCompiled(const char* source_path, const char magic[4], int version, size_t* size);
+    bool ContentCache_SaveCompiled(const char* source_path, const char magic[4], int version, const void* data, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CONTENT_CACHE_H
\ No newline at end of file
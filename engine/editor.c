@@ -1006,9 +1006,11 @@ void Editor_DuplicateParticleEmitter(Scene* scene, int index) {
     ParticleEmitter* src_emitter = &scene->particleEmitters[index];
     ParticleEmitter* new_emitter = &scene->particleEmitters[scene->numParticleEmitters];
     memcpy(new_emitter, src_emitter, sizeof(ParticleEmitter));
+    new_emitter->particles = NULL;
+    new_emitter->particleCapacity = 0;
     sprintf(new_emitter->targetname, "Emitter_%d", scene->numParticleEmitters);
     new_emitter->pos.x += 1.0f;
-    ParticleSystem* ps = ParticleSystem_Load(new_emitter->parFile);
+    ParticleSystem* ps = src_emitter->system ? ParticleSystem_Acquire(src_emitter->system) : ParticleSystem_Load(new_emitter->parFile);
     if (ps) {
         int new_emitter_index = scene->numParticleEmitters;
         ParticleEmitter_Init(new_emitter, ps, new_emitter->pos);
@@ -4492,9 +4494,9 @@ static void Editor_RenderSceneInternal(ViewportType type, Engine* engine, Render
         glUniform1i(glGetUniformLocation(renderer->postProcessShader, "u_bloomEnabled"), Cvar_GetInt("r_bloom"));
         glUniform1i(glGetUniformLocation(renderer->postProcessShader, "u_volumetricsEnabled"), Cvar_GetInt("r_volumetrics"));
         glActiveTexture(GL_TEXTURE0); glBindTexture(GL_TEXTURE_2D, renderer->gLitColor);
-        glActiveTexture(GL_TEXTURE1); glBindTexture(GL_TEXTURE_2D, renderer->pingpongColorbuffers[0]);
+        glActiveTexture(GL_TEXTURE1); glBindTexture(GL_TEXTURE_2D, renderer->bloomTexture);
         glActiveTexture(GL_TEXTURE2); glBindTexture(GL_TEXTURE_2D, renderer->gPosition);
-        glActiveTexture(GL_TEXTURE3); glBindTexture(GL_TEXTURE_2D, renderer->volPingpongTextures[0]);
+        glActiveTexture(GL_TEXTURE3); glBindTexture(GL_TEXTURE_2D, renderer->volumetricTexture);
         glUniform1i(glGetUniformLocation(renderer->postProcessShader, "sceneTexture"), 0);
         glUniform1i(glGetUniformLocation(renderer->postProcessShader, "bloomBlur"), 1);
         glUniform1i(glGetUniformLocation(renderer->postProcessShader, "gPosition"), 2);
@@ -5267,8 +5269,6 @@ void Editor_RenderAllViewports(Engine* engine, Renderer* renderer, Scene* scene)
     glBindFramebuffer(GL_FRAMEBUFFER, renderer->volumetricFBO);
     glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
     glClear(GL_COLOR_BUFFER_BIT);
-    glBindFramebuffer(GL_FRAMEBUFFER, renderer->volPingpongFBO[0]);
-    glClear(GL_COLOR_BUFFER_BIT);
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
     Shadows_RenderPointAndSpot(renderer, scene, engine);
 
@@ -5935,20 +5935,6 @@ static void Editor_RenderBuildCubemapsWindow(Renderer* renderer, Scene* scene, E
 
         MiscRender_BuildCubemaps(renderer, scene, engine, resolution);
 
-        for (int i = 0; i < scene->numBrushes; ++i) {
-            Brush* b = &scene->brushes[i];
-            if (strcmp(b->classname, "env_reflectionprobe") == 0) {
-                const char* suffixes[] = { "_px.png", "_nx.png", "_py.png", "_ny.png", "_pz.png", "_nz.png" };
-                char face_paths[6][256];
-                const char* face_pointers[6];
-                for (int k = 0; k < 6; ++k) {
-                    sprintf(face_paths[k], "cubemaps/%s_%s.png", b->name, suffixes[k]);
-                    face_pointers[k] = face_paths[k];
-                }
-                b->cubemapTexture = TextureManager_ReloadCubemap(face_pointers, b->cubemapTexture);
-            }
-        }
-
         g_EditorState.show_build_cubemaps_popup = false;
     }
     UI_SameLine();
@@ -5976,7 +5962,7 @@ static void Editor_RenderBakeLightingWindow(Scene* scene, Engine* engine) {
             int resolution_values[] = { 16, 32, 64, 128, 256, 512 };
             int resolution = resolution_values[g_EditorState.bake_resolution];
 
-            Lightmapper_Generate(scene, engine, resolution, g_EditorState.bake_bounces);
+            Lightmapper_Generate(scene, engine, resolution, g_EditorState.bake_bounces, 0);
 
             char map_name_sanitized[128];
             const char* last_slash = strrchr(scene->mapPath, '/');
@@ -7848,7 +7834,7 @@ void Editor_RenderUI(Engine* engine, Scene* scene, Renderer* renderer) {
         }
     }
     if (logic_entity_to_delete != -1) { Undo_PushDeleteEntity(scene, ENTITY_LOGIC, logic_entity_to_delete, "Delete Logic Entity"); _raw_delete_logic_entity(scene, logic_entity_to_delete); Editor_RemoveFromSelection(ENTITY_LOGIC, logic_entity_to_delete); }
-    if (show_add_particle_popup) { UI_Begin("Add Particle Emitter", &show_add_particle_popup); UI_InputText("Path (.par)", add_particle_path, sizeof(add_particle_path)); if (UI_Button("Create")) { if (scene->numParticleEmitters < MAX_PARTICLE_EMITTERS) { ParticleEmitter* emitter = &scene->particleEmitters[scene->numParticleEmitters]; strcpy(emitter->parFile, add_particle_path); sprintf(emitter->targetname, "Emitter_%d", scene->numParticleEmitters); ParticleSystem* ps = ParticleSystem_Load(emitter->parFile); if (ps) { ParticleEmitter_Init(emitter, ps, g_EditorState.editor_camera.position); scene->numParticleEmitters++; Undo_PushCreateEntity(scene, ENTITY_PARTICLE_EMITTER, scene->numParticleEmitters - 1, "Create Particle Emitter"); } else { Console_Printf_Error("[error] Failed to load particle system: %s", emitter->parFile); } } show_add_particle_popup = false; } UI_End(); }
+    if (show_add_particle_popup) { UI_Begin("Add Particle Emitter", &show_add_particle_popup); UI_InputText("Path (.par)", add_particle_path, sizeof(add_particle_path)); if (UI_Button("Create")) { if (scene->numParticleEmitters < MAX_PARTICLE_EMITTERS) { ParticleEmitter* emitter = &scene->particleEmitters[scene->numParticleEmitters]; memset(emitter, 0, sizeof(ParticleEmitter)); strcpy(emitter->parFile, add_particle_path); sprintf(emitter->targetname, "Emitter_%d", scene->numParticleEmitters); ParticleSystem* ps = ParticleSystem_Load(emitter->parFile); if (ps) { ParticleEmitter_Init(emitter, ps, g_EditorState.editor_camera.position); scene->numParticleEmitters++; Undo_PushCreateEntity(scene, ENTITY_PARTICLE_EMITTER, scene->numParticleEmitters - 1, "Create Particle Emitter"); } else { Console_Printf_Error("[error] Failed to load particle system: %s", emitter->parFile); } } show_add_particle_popup = false; } UI_End(); }
     UI_End();
     UI_SetNextWindowPos(screen_w - right_panel_width, 22 + screen_h * 0.5f); UI_SetNextWindowSize(right_panel_width, screen_h * 0.5f);
     UI_Begin("Inspector & Settings", NULL);
@@ -8380,7 +8366,7 @@ void Editor_RenderUI(Engine* engine, Scene* scene, Renderer* renderer) {
     }
     else if (primary && primary->type == ENTITY_PARTICLE_EMITTER) {
         ParticleEmitter* emitter = &scene->particleEmitters[primary->index]; UI_Text("Particle Emitter: %s", emitter->parFile); UI_Separator(); UI_DragFloat3("Position", &emitter->pos.x, 0.1f, 0, 0); if (UI_IsItemActivated()) { Undo_BeginEntityModification(scene, ENTITY_PARTICLE_EMITTER, primary->index); } if (UI_IsItemDeactivatedAfterEdit()) { Undo_EndEntityModification(scene, ENTITY_PARTICLE_EMITTER, primary->index, "Move Emitter"); }
-        UI_InputText("Name", emitter->targetname, sizeof(emitter->targetname)); if (UI_IsItemActivated()) { Undo_BeginEntityModification(scene, ENTITY_PARTICLE_EMITTER, primary->index); } if (UI_IsItemDeactivatedAfterEdit()) { Undo_EndEntityModification(scene, ENTITY_PARTICLE_EMITTER, primary->index, "Edit Emitter Name"); } if (UI_Checkbox("On by default", &emitter->on_by_default)) { Undo_BeginEntityModification(scene, ENTITY_PARTICLE_EMITTER, primary->index); emitter->is_on = emitter->on_by_default; Undo_EndEntityModification(scene, ENTITY_PARTICLE_EMITTER, primary->index, "Toggle Emitter On"); } if (UI_Button("Reload .par File")) { ParticleSystem_Free(emitter->system); ParticleSystem* ps = ParticleSystem_Load(emitter->parFile); if (ps) { ParticleEmitter_Init(emitter, ps, emitter->pos); } else { Console_Printf_Error("[error] Failed to reload particle system: %s", emitter->parFile); emitter->system = NULL; } }
+        UI_InputText("Name", emitter->targetname, sizeof(emitter->targetname)); if (UI_IsItemActivated()) { Undo_BeginEntityModification(scene, ENTITY_PARTICLE_EMITTER, primary->index); } if (UI_IsItemDeactivatedAfterEdit()) { Undo_EndEntityModification(scene, ENTITY_PARTICLE_EMITTER, primary->index, "Edit Emitter Name"); } if (UI_Checkbox("On by default", &emitter->on_by_default)) { Undo_BeginEntityModification(scene, ENTITY_PARTICLE_EMITTER, primary->index); emitter->is_on = emitter->on_by_default; Undo_EndEntityModification(scene, ENTITY_PARTICLE_EMITTER, primary->index, "Toggle Emitter On"); } if (UI_Button("Reload .par File")) { ParticleEmitter_Free(emitter); ParticleSystem_Free(emitter->system); ParticleSystem_InvalidateCache(emitter->parFile); ParticleSystem* ps = ParticleSystem_Load(emitter->parFile); if (ps) { ParticleEmitter_Init(emitter, ps, emitter->pos); } else { Console_Printf_Error("[error] Failed to reload particle system: %s", emitter->parFile); emitter->system = NULL; } }
     }
     else if (primary && primary->type == ENTITY_VIDEO_PLAYER) {
         VideoPlayer* vp = &scene->videoPlayers[primary->index];
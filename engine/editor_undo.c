@@ -139,6 +139,7 @@ void _raw_delete_particle_emitter(Scene* scene, int index) {
     if (scene->particleEmitters[index].system) ParticleSystem_Free(scene->particleEmitters[index].system);
     for (int i = index; i < scene->numParticleEmitters - 1; ++i) scene->particleEmitters[i] = scene->particleEmitters[i + 1];
     scene->numParticleEmitters--;
+    memset(&scene->particleEmitters[scene->numParticleEmitters], 0, sizeof(ParticleEmitter));
 }
 
 void _raw_delete_sprite(Scene* scene, int index) {
@@ -190,7 +191,7 @@ void capture_state(EntityState* state, Scene* scene, EntityType type, int index)
     case ENTITY_LIGHT: state->data.light = scene->lights[index]; break;
     case ENTITY_DECAL: state->data.decal = scene->decals[index]; break;
     case ENTITY_SOUND: state->data.soundEntity = scene->soundEntities[index]; strcpy(state->soundPath, scene->soundEntities[index].soundPath); break;
-    case ENTITY_PARTICLE_EMITTER: memcpy(&state->data.particleEmitter, &scene->particleEmitters[index], offsetof(ParticleEmitter, particles)); strcpy(state->parFile, scene->particleEmitters[index].parFile); break;
+    case ENTITY_PARTICLE_EMITTER: state->data.particleEmitter = scene->particleEmitters[index]; state->data.particleEmitter.system = NULL; state->data.particleEmitter.particles = NULL; state->data.particleEmitter.particleCapacity = 0; state->data.particleEmitter.activeParticles = 0; strcpy(state->parFile, scene->particleEmitters[index].parFile); break;
     case ENTITY_SPRITE: state->data.sprite = scene->sprites[index]; break;
     case ENTITY_VIDEO_PLAYER: state->data.videoPlayer = scene->videoPlayers[index]; break;
     case ENTITY_PARALLAX_ROOM: state->data.parallaxRoom = scene->parallaxRooms[index]; break;
@@ -361,7 +362,7 @@ void Undo_Shutdown() {
     }
 }
 
-static void Undo_PushAction(Action* action) {
+static void Undo_PushAction(Scene* scene, Action* action) {
     clear_stack(g_redo_stack, &g_redo_top);
     if (g_undo_top >= MAX_UNDO_ACTIONS - 1) {
         free_action_data(g_undo_stack[0]); free(g_undo_stack[0]);
@@ -370,6 +371,7 @@ static void Undo_PushAction(Action* action) {
     }
     g_undo_top++; g_undo_stack[g_undo_top] = action;
     Editor_SetMapDirty(true);
+    Scene_MarkEntityClassesDirty(scene);
 }
 
 static void deep_copy_entity_state(EntityState* dest, const EntityState* src) {
@@ -407,6 +409,7 @@ static Action* deep_copy_action(const Action* src) {
 void Undo_PerformUndo(Scene* scene, Engine* engine) {
     if (g_undo_top < 0) return;
     Action* action = g_undo_stack[g_undo_top--];
+    Scene_MarkEntityClassesDirty(scene);
     if (g_redo_top >= MAX_UNDO_ACTIONS - 1) { free_action_data(g_redo_stack[0]); free(g_redo_stack[0]); memmove(&g_redo_stack[0], &g_redo_stack[1], (MAX_UNDO_ACTIONS - 1) * sizeof(Action*)); g_redo_top--; }
     g_redo_stack[++g_redo_top] = deep_copy_action(action);
     switch (action->type) {
@@ -443,6 +446,7 @@ void Undo_PerformUndo(Scene* scene, Engine* engine) {
 void Undo_PerformRedo(Scene* scene, Engine* engine) {
     if (g_redo_top < 0) return;
     Action* action = g_redo_stack[g_redo_top--];
+    Scene_MarkEntityClassesDirty(scene);
     g_undo_stack[++g_undo_top] = action;
     switch (action->type) {
     case ACTION_MODIFY_ENTITY:   if (action->num_after_states == 1 && action->num_before_states > 1) {
@@ -501,7 +505,7 @@ void Undo_EndMultiEntityModification(Scene* scene, EditorSelection* selections,
     action->before_states = g_multi_before_states; action->num_before_states = g_num_multi_before_states;
     capture_unique_states(scene, selections, num_selections, &action->after_states, &action->num_after_states);
     g_multi_before_states = NULL; g_num_multi_before_states = 0;
-    Undo_PushAction(action);
+    Undo_PushAction(scene, action);
 }
 
 void Undo_PushCreateMultipleEntities(Scene* scene, EditorSelection* selections, int num_selections, const char* description) {
@@ -509,7 +513,7 @@ void Undo_PushCreateMultipleEntities(Scene* scene, EditorSelection* selections,
     action->type = ACTION_CREATE_ENTITY; strncpy(action->description, description, sizeof(action->description) - 1);
     capture_unique_states(scene, selections, num_selections, &action->after_states, &action->num_after_states);
     action->before_states = NULL; action->num_before_states = 0;
-    Undo_PushAction(action);
+    Undo_PushAction(scene, action);
 }
 
 void Undo_PushDeleteMultipleEntities(Scene* scene, EntityState* deleted_states, int num_states, const char* description) {
@@ -517,7 +521,7 @@ void Undo_PushDeleteMultipleEntities(Scene* scene, EntityState* deleted_states,
     action->type = ACTION_DELETE_ENTITY; strncpy(action->description, description, sizeof(action->description) - 1);
     action->before_states = deleted_states; action->num_before_states = num_states;
     action->after_states = NULL; action->num_after_states = 0;
-    Undo_PushAction(action);
+    Undo_PushAction(scene, action);
 }
 
 void Undo_PushMergeAction(Scene* scene, EntityState* before_states, int num_before, EntityState* after_states, int num_after, const char* description) {
@@ -529,7 +533,7 @@ void Undo_PushMergeAction(Scene* scene, EntityState* before_states, int num_befo
     action->num_before_states = num_before;
     action->after_states = after_states;
     action->num_after_states = num_after;
-    Undo_PushAction(action);
+    Undo_PushAction(scene, action);
 }
 
 void Undo_BeginEntityModification(Scene* scene, EntityType type, int index) {
@@ -39,6 +39,7 @@
 #include <float.h>
 #include "sound_system.h"
 #include "io_system.h"
+#include "trigger_volumes.h"
 #include "binds.h"
 #include "gameconfig.h"
 #include "discord_wrapper.h"
@@ -54,7 +55,13 @@
 #include "lightmapper.h"
 #include "ipc_system.h"
 #include "game_data.h"
+#include "content_cache.h"
 #include "gl_shadows.h"
+#include "gl_profiler.h"
+#include "gl_readback.h"
+#include "gl_stream_buffer.h"
+#include "gl_gpu_particles.h"
+#include "savegame.h"
 #include "engine_commands.h"
 #include "engine_api.h"
 #include "cgltf/cgltf.h"
@@ -83,6 +90,9 @@ const int NUM_LIGHT_STYLES = sizeof(g_light_styles) / sizeof(g_light_styles[0]);
 
 bool g_screenshot_requested = false;
 char g_screenshot_path[256] = { 0 };
+int g_screenshot_burst_remaining = 0;
+int g_screenshot_burst_index = 0;
+char g_screenshot_burst_base[256] = { 0 };
 static int g_last_deactivation_cvar_state = -1;
 
 bool g_player_input_disabled = false;
@@ -99,6 +109,8 @@ static int g_lockFileFd = -1;
 static void init_scene(void);
 
 static void Scene_UpdateAnimations(Scene* scene, float deltaTime);
+static void simulate_tick(void);
+static void Simulation_Run(float frameDelta);
 
 Engine g_engine_instance;
 Engine* g_engine = &g_engine_instance;
@@ -115,6 +127,17 @@ static float g_fps_display = 0.0f;
 
 static unsigned int g_frame_counter = 0;
 
+#define FRAME_SMOOTH_SAMPLES 8
+#define FRAME_STATS_SAMPLES 240
+#define FRAME_SPIN_THRESHOLD_US 2000
+static Uint64 g_perf_frequency = 1;
+static Uint64 g_perf_start = 0;
+static Uint64 g_last_frame_counter = 0;
+static Uint64 g_next_frame_deadline = 0;
+static float g_frame_times[FRAME_STATS_SAMPLES];
+static int g_frame_time_index = 0;
+static int g_frame_time_count = 0;
+
 unsigned int g_flashlight_sound_buffer = 0;
 unsigned int g_footstep_sound_buffer = 0;
 unsigned int g_jump_sound_buffer = 0;
@@ -141,6 +164,9 @@ void init_engine(SDL_Window* window, SDL_GLContext context) {
     g_engine->height = g_startup_height;
     g_engine->window = window; g_engine->context = context; g_engine->running = true; g_engine->deltaTime = 0.0f; g_engine->lastFrame = 0.0f;
     g_engine->unscaledDeltaTime = 0.0f; g_engine->scaledTime = 0.0f;
+    g_perf_frequency = SDL_GetPerformanceFrequency();
+    g_perf_start = SDL_GetPerformanceCounter();
+    g_last_frame_counter = g_perf_start;
     IPC_Init();
     g_engine->camera = (Camera){ {0,1,5}, 0,0, false, PLAYER_HEIGHT_NORMAL, NULL, 100.0f };  g_engine->flashlight_on = false;
     g_engine->active_camera_brush_index = -1;
@@ -160,7 +186,9 @@ void init_engine(SDL_Window* window, SDL_GLContext context) {
     Commands_Init();
     RegisterEngineCommandsAndCvars();
     Cvar_Load("cvars.txt");
+    SoundSystem_SetStreamingThreshold((unsigned int)Cvar_GetInt("snd_stream_threshold") * 1024u);
     IO_Init();
+    SaveGame_Init();
     Binds_Init();
     GameData_Init("tectonic.tgd");
     Sentry_Init();
@@ -181,7 +209,6 @@ void init_engine(SDL_Window* window, SDL_GLContext context) {
     TextureManager_Init();
     TextureManager_ParseMaterialsFromFile("materials.def");
     Renderer_Init(&g_renderer, g_engine);
-    DSP_Reverb_Thread_Init();
     init_scene();
     Discord_Init();
     Weapons_Init();
@@ -594,28 +621,22 @@ void update_state() {
     }
     g_engine->running = Cvar_GetInt("engine_running");
     SoundSystem_SetMasterVolume(Cvar_GetFloat("volume"));
+    SoundSystem_SetStreamingThreshold((unsigned int)Cvar_GetInt("snd_stream_threshold") * 1024u);
+    SoundSystem_Update(g_engine->deltaTime);
     g_engine->canUse = false;
     if (g_current_mode == MODE_GAME && !g_player_input_disabled && !Console_IsVisible()) {
         Vec3 forward = { cosf(g_engine->camera.pitch) * sinf(g_engine->camera.yaw), sinf(g_engine->camera.pitch), -cosf(g_engine->camera.pitch) * cosf(g_engine->camera.yaw) };
         vec3_normalize(&forward);
         Vec3 ray_end = vec3_add(g_engine->camera.position, vec3_muls(forward, 3.0f));
 
-        for (int i = 0; i < g_scene.numBrushes; ++i) {
-            Brush* brush = &g_scene.brushes[i];
-            bool is_usable = false;
-            if (strcmp(brush->classname, "func_button") == 0) {
-                is_usable = true;
-            }
-            else if (strcmp(brush->classname, "func_door") == 0) {
-                if (atoi(Brush_GetProperty(brush, "OpenOnUse", "1")) == 1) {
-                    is_usable = true;
-                }
-            }
-            else if (strcmp(brush->classname, "func_healthcharger") == 0) {
-                is_usable = true;
-            }
+        static const EntityClassId usable_classes[] = { ENTITY_CLASS_FUNC_BUTTON, ENTITY_CLASS_FUNC_DOOR, ENTITY_CLASS_FUNC_HEALTHCHARGER };
+        for (int c = 0; c < 3 && !g_engine->canUse; ++c) {
+            const int* usable;
+            int num_usable = Scene_GetBrushesOfClass(&g_scene, usable_classes[c], &usable);
+            for (int k = 0; k < num_usable; ++k) {
+                Brush* brush = &g_scene.brushes[usable[k]];
+                if (brush->classId == ENTITY_CLASS_FUNC_DOOR && !brush->comp.door.openOnUse) continue;
 
-            if (is_usable) {
                 Vec3 brush_local_min = { FLT_MAX, FLT_MAX, FLT_MAX };
                 Vec3 brush_local_max = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
                 if (brush->numVertices > 0) {
@@ -640,17 +661,14 @@ void update_state() {
             }
         }
     }
-    IO_ProcessPendingEvents(g_engine->lastFrame, &g_scene, g_engine);
-    LogicSystem_Update(&g_scene, g_engine->deltaTime);
     Scene_UpdateAnimations(&g_scene, g_engine->deltaTime);
     if (g_engine->active_camera_brush_index != -1) {
         Brush* cam_brush = &g_scene.brushes[g_engine->active_camera_brush_index];
-        const char* target_name = Brush_GetProperty(cam_brush, "target", "");
         Vec3 target_pos;
         Vec3 target_angles;
 
-        if (IO_FindNamedEntity(&g_scene, target_name, &target_pos, &target_angles)) {
-            float moveto_time = atof(Brush_GetProperty(cam_brush, "moveto", "2.0"));
+        if (IO_FindNamedEntity(&g_scene, cam_brush->comp.camera.target, &target_pos, &target_angles)) {
+            float moveto_time = cam_brush->comp.camera.moveTo;
             g_engine->camera_transition_timer += g_engine->unscaledDeltaTime;
 
             float t = 1.0f;
@@ -663,7 +681,7 @@ void update_state() {
             g_engine->camera.pitch = g_engine->camera_original_pitch + (target_angles.x * (M_PI / 180.0f) - g_engine->camera_original_pitch) * t;
 
             if (t >= 1.0f) {
-                float hold_time = atof(Brush_GetProperty(cam_brush, "holdtime", "5.0"));
+                float hold_time = cam_brush->comp.camera.holdTime;
                 if (g_engine->camera_transition_timer >= moveto_time + hold_time) {
                     ExecuteInput(cam_brush->targetname, "Disable", "", &g_scene, g_engine);
                     IO_FireOutput(ENTITY_BRUSH, g_engine->active_camera_brush_index, "OnEnd", g_engine->lastFrame, NULL);
@@ -718,119 +736,99 @@ void update_state() {
         MainMenu_Update(g_engine->deltaTime);
         return;
     }
-    if (g_current_mode == MODE_EDITOR) { Editor_Update(g_engine, &g_scene); return; }
+    if (g_current_mode == MODE_EDITOR) { if (g_scene.entityClassesDirty) Scene_RefreshEntityClasses(&g_scene); Editor_Update(g_engine, &g_scene); return; }
     if (Cvar_GetInt("r_particles")) {
         float particle_cull_dist = Cvar_GetFloat("r_particles_cull_dist");
         float particle_cull_dist_sq = particle_cull_dist * particle_cull_dist;
-        for (int i = 0; i < g_scene.numParticleEmitters; ++i) {
-            if (vec3_length_sq(vec3_sub(g_scene.particleEmitters[i].pos, g_engine->camera.position)) < particle_cull_dist_sq) {
-                ParticleEmitter_Update(&g_scene.particleEmitters[i], g_engine->deltaTime);
+        if (Cvar_GetInt("r_gpu_particles")) {
+            GPUParticles_Update(&g_scene, g_engine->camera.position, particle_cull_dist, g_engine->deltaTime);
+        }
+        else {
+            for (int i = 0; i < g_scene.numParticleEmitters; ++i) {
+                if (vec3_length_sq(vec3_sub(g_scene.particleEmitters[i].pos, g_engine->camera.position)) < particle_cull_dist_sq) {
+                    ParticleEmitter_Update(&g_scene.particleEmitters[i], g_engine->deltaTime);
+                }
             }
         }
     }
     VideoPlayer_UpdateAll(&g_scene, g_engine->deltaTime);
+    Simulation_Run(g_engine->deltaTime);
     Vec3 playerPos;
     Physics_GetPosition(g_engine->camera.physicsBody, &playerPos);
 
     int new_reverb_zone_index = -1;
-    for (int i = 0; i < g_scene.numBrushes; ++i) {
-        Brush* b = &g_scene.brushes[i];
-        if (strcmp(b->classname, "trigger_dspzone") != 0) continue;
-        if (b->numVertices == 0) continue;
-
-        Vec3 min_aabb = { FLT_MAX, FLT_MAX, FLT_MAX };
-        Vec3 max_aabb = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
-        for (int v = 0; v < b->numVertices; ++v) {
-            Vec3 world_v = mat4_mul_vec3(&b->modelMatrix, b->vertices[v].pos);
-            min_aabb.x = fminf(min_aabb.x, world_v.x);
-            min_aabb.y = fminf(min_aabb.y, world_v.y);
-            min_aabb.z = fminf(min_aabb.z, world_v.z);
-            max_aabb.x = fmaxf(max_aabb.x, world_v.x);
-            max_aabb.y = fmaxf(max_aabb.y, world_v.y);
-            max_aabb.z = fmaxf(max_aabb.z, world_v.z);
-        }
-
-        if (playerPos.x >= min_aabb.x && playerPos.x <= max_aabb.x &&
-            playerPos.y >= min_aabb.y && playerPos.y <= max_aabb.y &&
-            playerPos.z >= min_aabb.z && playerPos.z <= max_aabb.z)
-        {
-            new_reverb_zone_index = i;
-            break;
-        }
+    int dsp_zone;
+    if (TriggerVolumes_QueryPoint(playerPos, ENTITY_CLASS_TRIGGER_DSPZONE, &dsp_zone, 1) > 0) {
+        new_reverb_zone_index = dsp_zone;
     }
 
     if (new_reverb_zone_index != g_current_reverb_zone_index) {
         g_current_reverb_zone_index = new_reverb_zone_index;
         if (new_reverb_zone_index != -1) {
             Brush* b = &g_scene.brushes[new_reverb_zone_index];
-            const char* preset_str = Brush_GetProperty(b, "reverb_preset", "0");
-            SoundSystem_SetCurrentReverb((ReverbPreset)atoi(preset_str));
+            SoundSystem_SetCurrentReverb((ReverbPreset)b->comp.dspZone.reverbPreset);
         }
         else {
             SoundSystem_SetCurrentReverb(REVERB_PRESET_NONE);
         }
     }
+    Vec3 forward = { cosf(g_engine->camera.pitch) * sinf(g_engine->camera.yaw), sinf(g_engine->camera.pitch), -cosf(g_engine->camera.pitch) * cosf(g_engine->camera.yaw) };
+    vec3_normalize(&forward); SoundSystem_UpdateListener(g_engine->camera.position, forward, (Vec3) { 0, 1, 0 });
+}
 
-    for (int i = 0; i < g_scene.numBrushes; ++i) {
+static void simulate_tick(void) {
+    IO_ProcessPendingEvents(g_engine->lastFrame, &g_scene, g_engine);
+    LogicSystem_Update(&g_scene, g_engine->deltaTime);
+
+    Vec3 playerPos;
+    Physics_GetPosition(g_engine->camera.physicsBody, &playerPos);
+
+    TriggerVolumes_Update(&g_scene);
+    TriggerOverlaps overlaps;
+    TriggerVolumes_UpdateOverlaps(&g_scene, playerPos, &overlaps);
+    for (int k = 0; k < overlaps.numExited; ++k) {
+        int i = overlaps.exited[k];
         Brush* b = &g_scene.brushes[i];
-        if (strlen(b->classname) == 0 || !b->runtime_active) continue;
-
-        if (b->numVertices == 0) continue;
-
-        Vec3 min_aabb = { FLT_MAX, FLT_MAX, FLT_MAX };
-        Vec3 max_aabb = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
-        for (int v = 0; v < b->numVertices; ++v) {
-            Vec3 world_v = mat4_mul_vec3(&b->modelMatrix, b->vertices[v].pos);
-            min_aabb.x = fminf(min_aabb.x, world_v.x);
-            min_aabb.y = fminf(min_aabb.y, world_v.y);
-            min_aabb.z = fminf(min_aabb.z, world_v.z);
-            max_aabb.x = fmaxf(max_aabb.x, world_v.x);
-            max_aabb.y = fmaxf(max_aabb.y, world_v.y);
-            max_aabb.z = fmaxf(max_aabb.z, world_v.z);
-        }
-
-        bool is_inside = (playerPos.x >= min_aabb.x && playerPos.x <= max_aabb.x &&
-            playerPos.y >= min_aabb.y && playerPos.y <= max_aabb.y &&
-            playerPos.z >= min_aabb.z && playerPos.z <= max_aabb.z);
-
-        if(is_inside && !b->runtime_playerIsTouching) {
-            b->runtime_playerIsTouching = true;
-            if (strcmp(b->classname, "trigger_once") == 0) {
-                if (!b->runtime_hasFired) {
-                    const char* delay_str = Brush_GetProperty(b, "delay", "0");
-                    float fire_time = g_engine->lastFrame + atof(delay_str);
-                    IO_FireOutput(ENTITY_BRUSH, i, "OnStartTouch", fire_time, NULL);
-                    b->runtime_hasFired = true;
-                }
-            }
-            else if (strcmp(b->classname, "trigger_multiple") == 0) {
-                const char* delay_str = Brush_GetProperty(b, "delay", "0");
-                float fire_time = g_engine->lastFrame + atof(delay_str);
+        if (b->classId == ENTITY_CLASS_TRIGGER_MULTIPLE || b->classId == ENTITY_CLASS_TRIGGER_ONCE) {
+            IO_FireOutput(ENTITY_BRUSH, i, "OnEndTouch", g_engine->lastFrame, NULL);
+        }
+    }
+    for (int k = 0; k < overlaps.numEntered; ++k) {
+        int i = overlaps.entered[k];
+        Brush* b = &g_scene.brushes[i];
+        if (b->classId == ENTITY_CLASS_TRIGGER_ONCE) {
+            if (!b->runtime_hasFired) {
+                float fire_time = g_engine->lastFrame + b->comp.touch.delay;
                 IO_FireOutput(ENTITY_BRUSH, i, "OnStartTouch", fire_time, NULL);
+                b->runtime_hasFired = true;
             }
-            else if (strcmp(b->classname, "trigger_teleport") == 0) {
-                const char* target_name = Brush_GetProperty(b, "target", "");
-                Vec3 target_pos;
-                Vec3 target_angles;
-                if (strlen(target_name) > 0 && IO_FindNamedEntity(&g_scene, target_name, &target_pos, &target_angles)) {
-                    if (g_engine->camera.physicsBody) {
-                        Physics_Teleport(g_engine->camera.physicsBody, target_pos);
-                    }
-                    g_engine->camera.position = target_pos;
-                    g_engine->camera.yaw = target_angles.y * (M_PI / 180.0f);
-                    g_engine->camera.pitch = target_angles.x * (M_PI / 180.0f);
-                }
-            }
-            else if (strcmp(b->classname, "trigger_camera") == 0) {
-                if (g_engine->active_camera_brush_index != i) {
-                    ExecuteInput(b->targetname, "Enable", "", &g_scene, g_engine);
+        }
+        else if (b->classId == ENTITY_CLASS_TRIGGER_MULTIPLE) {
+            float fire_time = g_engine->lastFrame + b->comp.touch.delay;
+            IO_FireOutput(ENTITY_BRUSH, i, "OnStartTouch", fire_time, NULL);
+        }
+        else if (b->classId == ENTITY_CLASS_TRIGGER_TELEPORT) {
+            const char* target_name = b->comp.teleport.target;
+            Vec3 target_pos;
+            Vec3 target_angles;
+            if (strlen(target_name) > 0 && IO_FindNamedEntity(&g_scene, target_name, &target_pos, &target_angles)) {
+                if (g_engine->camera.physicsBody) {
+                    Physics_Teleport(g_engine->camera.physicsBody, target_pos);
                 }
+                g_engine->camera.position = target_pos;
+                g_engine->camera.yaw = target_angles.y * (M_PI / 180.0f);
+                g_engine->camera.pitch = target_angles.x * (M_PI / 180.0f);
             }
-            else if (strcmp(b->classname, "trigger_paralyzeplayer") == 0) {
-                g_player_input_disabled = true;
+        }
+        else if (b->classId == ENTITY_CLASS_TRIGGER_CAMERA) {
+            if (g_engine->active_camera_brush_index != i) {
+                ExecuteInput(b->targetname, "Enable", "", &g_scene, g_engine);
             }
         }
-        else if (strcmp(b->classname, "trigger_autosave") == 0) {
+        else if (b->classId == ENTITY_CLASS_TRIGGER_PARALYZEPLAYER) {
+            g_player_input_disabled = true;
+        }
+        else if (b->classId == ENTITY_CLASS_TRIGGER_AUTOSAVE) {
             if (!b->runtime_hasFired) {
                 char save_name[128];
                 time_t now = time(NULL);
@@ -842,27 +840,21 @@ void update_state() {
                 b->runtime_hasFired = true;
             }
         }
-        else if (!is_inside && b->runtime_playerIsTouching) {
-            b->runtime_playerIsTouching = false;
-            if (strcmp(b->classname, "trigger_multiple") == 0 || strcmp(b->classname, "trigger_once") == 0) {
-                IO_FireOutput(ENTITY_BRUSH, i, "OnEndTouch", g_engine->lastFrame, NULL);
-            }
-        }
-        if (is_inside && strcmp(b->classname, "trigger_hurt") == 0) {
-            const char* damage_str = Brush_GetProperty(b, "damage", "10");
-            float damage_per_second = atof(damage_str);
+    }
+    for (int k = 0; k < overlaps.numInside; ++k) {
+        Brush* b = &g_scene.brushes[overlaps.inside[k]];
+        if (b->classId == ENTITY_CLASS_TRIGGER_HURT) {
+            float damage_per_second = b->comp.hurt.damage;
             if (Cvar_GetInt("god") == 0) {
                 g_engine->camera.health -= damage_per_second * g_engine->deltaTime;
             }
         }
-        else if (is_inside && strcmp(b->classname, "trigger_killplayer") == 0) {
+        else if (b->classId == ENTITY_CLASS_TRIGGER_KILLPLAYER) {
             if (Cvar_GetInt("god") == 0) {
                 g_engine->camera.health = 0.0f;
             }
         }
     }
-    Vec3 forward = { cosf(g_engine->camera.pitch) * sinf(g_engine->camera.yaw), sinf(g_engine->camera.pitch), -cosf(g_engine->camera.pitch) * cosf(g_engine->camera.yaw) };
-    vec3_normalize(&forward); SoundSystem_UpdateListener(g_engine->camera.position, forward, (Vec3) { 0, 1, 0 });
     bool noclip = Cvar_GetInt("noclip");
     if (!noclip) {
         Vec3 vel = Physics_GetLinearVelocity(g_engine->camera.physicsBody);
@@ -885,49 +877,32 @@ void update_state() {
         g_last_player_pos = g_engine->camera.position;
     }
     if (g_engine->physicsWorld) {
-        for (int i = 0; i < g_scene.numBrushes; ++i) {
-            Brush* b = &g_scene.brushes[i];
-            if (strcmp(b->classname, "func_water") == 0 && b->numVertices > 0) {
-                Physics_ApplyBuoyancyInVolume(g_engine->physicsWorld, (const float*)b->vertices, b->numVertices, &b->modelMatrix);
+        const int* water;
+        int num_water = Scene_GetBrushesOfClass(&g_scene, ENTITY_CLASS_FUNC_WATER, &water);
+        for (int k = 0; k < num_water; ++k) {
+            Vec3 water_min, water_max;
+            if (TriggerVolumes_GetBounds(water[k], &water_min, &water_max)) {
+                Physics_ApplyBuoyancyInAABB(g_engine->physicsWorld, water_min, water_max);
             }
         }
     }
     g_current_friction_modifier = 1.0f;
-    for (int i = 0; i < g_scene.numBrushes; ++i) {
-        Brush* b = &g_scene.brushes[i];
-        if (strcmp(b->classname, "func_friction") == 0 && b->runtime_playerIsTouching) {
-            const char* modifier_str = Brush_GetProperty(b, "modifier", "100");
-            float modifier = atof(modifier_str);
-            g_current_friction_modifier = modifier / 100.0f;
+    const int* friction;
+    int num_friction = Scene_GetBrushesOfClass(&g_scene, ENTITY_CLASS_FUNC_FRICTION, &friction);
+    for (int k = 0; k < num_friction; ++k) {
+        Brush* b = &g_scene.brushes[friction[k]];
+        if (b->runtime_playerIsTouching) {
+            g_current_friction_modifier = b->comp.friction.modifier / 100.0f;
             break;
         }
     }
-    for (int i = 0; i < g_scene.numBrushes; ++i) {
-        Brush* b = &g_scene.brushes[i];
-        if (strcmp(b->classname, "func_conveyor") != 0) continue;
-
-        const char* speed_str = Brush_GetProperty(b, "speed", "0");
-        float speed = atof(speed_str);
-        if (speed == 0.0f) continue;
-
-        const char* dir_str = Brush_GetProperty(b, "direction", "0 0 0");
-        float pitch, yaw, roll;
-        sscanf(dir_str, "%f %f %f", &pitch, &yaw, &roll);
-
-        float pitch_rad = pitch * (M_PI / 180.0f);
-        float yaw_rad = yaw * (M_PI / 180.0f);
-        float roll_rad = roll * (M_PI / 180.0f);
-
-        Mat4 rot_x_mat = mat4_rotate_x(pitch_rad);
-        Mat4 rot_y_mat = mat4_rotate_y(yaw_rad);
-        Mat4 rot_z_mat = mat4_rotate_z(roll_rad);
-        Mat4 rot_mat;
-        mat4_multiply(&rot_mat, &rot_y_mat, &rot_x_mat);
-        mat4_multiply(&rot_mat, &rot_z_mat, &rot_mat);
+    const int* conveyors;
+    int num_conveyors = Scene_GetBrushesOfClass(&g_scene, ENTITY_CLASS_FUNC_CONVEYOR, &conveyors);
+    for (int k = 0; k < num_conveyors; ++k) {
+        Brush* b = &g_scene.brushes[conveyors[k]];
+        if (b->comp.conveyor.speed == 0.0f) continue;
 
-        Vec3 base_dir = { 1, 0, 0 };
-        Vec3 move_dir = mat4_mul_vec3_dir(&rot_mat, base_dir);
-        Vec3 conveyor_vel = vec3_muls(move_dir, speed);
+        Vec3 conveyor_vel = b->comp.conveyor.velocity;
 
         if (b->runtime_playerIsTouching) {
             Vec3 player_vel = Physics_GetLinearVelocity(g_engine->camera.physicsBody);
@@ -936,15 +911,7 @@ void update_state() {
         }
 
         Vec3 conveyor_min, conveyor_max;
-        if (b->numVertices > 0) {
-            conveyor_min = (Vec3){ FLT_MAX, FLT_MAX, FLT_MAX };
-            conveyor_max = (Vec3){ -FLT_MAX, -FLT_MAX, -FLT_MAX };
-            for (int v_idx = 0; v_idx < b->numVertices; ++v_idx) {
-                Vec3 world_v = mat4_mul_vec3(&b->modelMatrix, b->vertices[v_idx].pos);
-                conveyor_min.x = fminf(conveyor_min.x, world_v.x); conveyor_min.y = fminf(conveyor_min.y, world_v.y); conveyor_min.z = fminf(conveyor_min.z, world_v.z);
-                conveyor_max.x = fmaxf(conveyor_max.x, world_v.x); conveyor_max.y = fmaxf(conveyor_max.y, world_v.y); conveyor_max.z = fmaxf(conveyor_max.z, world_v.z);
-            }
-
+        if (TriggerVolumes_GetBounds(conveyors[k], &conveyor_min, &conveyor_max)) {
             for (int obj_idx = 0; obj_idx < g_scene.numObjects; ++obj_idx) {
                 SceneObject* obj = &g_scene.objects[obj_idx];
                 if (obj->mass > 0.0f) {
@@ -962,9 +929,11 @@ void update_state() {
         }
     }
     g_player_on_ladder = false;
-    for (int i = 0; i < g_scene.numBrushes; ++i) {
-        Brush* b = &g_scene.brushes[i];
-        if (strcmp(b->classname, "func_ladder") == 0 && b->runtime_playerIsTouching) {
+    const int* ladders;
+    int num_ladders = Scene_GetBrushesOfClass(&g_scene, ENTITY_CLASS_FUNC_LADDER, &ladders);
+    for (int k = 0; k < num_ladders; ++k) {
+        Brush* b = &g_scene.brushes[ladders[k]];
+        if (b->runtime_playerIsTouching) {
             Vec3 forward = { cosf(g_engine->camera.pitch) * sinf(g_engine->camera.yaw), sinf(g_engine->camera.pitch), -cosf(g_engine->camera.pitch) * cosf(g_engine->camera.yaw) };
             vec3_normalize(&forward);
             Vec3 ray_end = vec3_add(g_engine->camera.position, vec3_muls(forward, 2.0f));
@@ -977,10 +946,12 @@ void update_state() {
         }
     }
     bool in_gravity_zone = false;
-    for (int i = 0; i < g_scene.numBrushes; ++i) {
-        Brush* b = &g_scene.brushes[i];
-        if (strcmp(b->classname, "trigger_gravity") == 0 && b->runtime_playerIsTouching) {
-            float gravity_val = atof(Brush_GetProperty(b, "gravity", "9.81"));
+    const int* gravity_zones;
+    int num_gravity_zones = Scene_GetBrushesOfClass(&g_scene, ENTITY_CLASS_TRIGGER_GRAVITY, &gravity_zones);
+    for (int k = 0; k < num_gravity_zones; ++k) {
+        Brush* b = &g_scene.brushes[gravity_zones[k]];
+        if (b->runtime_playerIsTouching) {
+            float gravity_val = b->comp.gravity.gravity;
             Physics_SetGravity(g_engine->physicsWorld, (Vec3) { 0, -gravity_val, 0 });
             in_gravity_zone = true;
             break;
@@ -1026,252 +997,238 @@ void update_state() {
         }
         g_engine->prev_player_y_velocity = current_vel.y;
     }
-    for (int i = 0; i < g_scene.numBrushes; ++i) {
+    const int* doors;
+    int num_doors = Scene_GetBrushesOfClass(&g_scene, ENTITY_CLASS_FUNC_DOOR, &doors);
+    for (int k = 0; k < num_doors; ++k) {
+        int i = doors[k];
         Brush* b = &g_scene.brushes[i];
-        if (strcmp(b->classname, "func_door") == 0) {
-            if (vec3_length_sq(b->door_move_dir) < 0.001f) {
-                b->door_start_pos = b->pos;
-                Vec3 move_angles;
-                sscanf(Brush_GetProperty(b, "direction", "0 90 0"), "%f %f %f", &move_angles.x, &move_angles.y, &move_angles.z);
-
-                Mat4 rot_mat = create_trs_matrix((Vec3) { 0, 0, 0 }, move_angles, (Vec3) { 1, 1, 1 });
-                b->door_move_dir = mat4_mul_vec3_dir(&rot_mat, (Vec3) { 1, 0, 0 });
-                vec3_normalize(&b->door_move_dir);
-
-                float move_dist = atof(Brush_GetProperty(b, "distance", "0"));
-
-                if (move_dist <= 0) {
-                    Vec3 min_aabb_local = { FLT_MAX, FLT_MAX, FLT_MAX };
-                    Vec3 max_aabb_local = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
-                    for (int v = 0; v < b->numVertices; ++v) {
-                        min_aabb_local.x = fminf(min_aabb_local.x, b->vertices[v].pos.x);
-                        min_aabb_local.y = fminf(min_aabb_local.y, b->vertices[v].pos.y);
-                        min_aabb_local.z = fminf(min_aabb_local.z, b->vertices[v].pos.z);
-                        max_aabb_local.x = fmaxf(max_aabb_local.x, b->vertices[v].pos.x);
-                        max_aabb_local.y = fmaxf(max_aabb_local.y, b->vertices[v].pos.y);
-                        max_aabb_local.z = fmaxf(max_aabb_local.z, b->vertices[v].pos.z);
-                    }
-                    Vec3 size = vec3_sub(max_aabb_local, min_aabb_local);
-                    Vec3 extent_x = vec3_muls((Vec3) { 1, 0, 0 }, size.x);
-                    Vec3 extent_y = vec3_muls((Vec3) { 0, 1, 0 }, size.y);
-                    Vec3 extent_z = vec3_muls((Vec3) { 0, 0, 1 }, size.z);
-                    move_dist = fabsf(vec3_dot(extent_x, b->door_move_dir)) + fabsf(vec3_dot(extent_y, b->door_move_dir)) + fabsf(vec3_dot(extent_z, b->door_move_dir));
+        if (vec3_length_sq(b->door_move_dir) < 0.001f) {
+            b->door_start_pos = b->pos;
+            Mat4 rot_mat = create_trs_matrix((Vec3) { 0, 0, 0 }, b->comp.door.moveAngles, (Vec3) { 1, 1, 1 });
+            b->door_move_dir = mat4_mul_vec3_dir(&rot_mat, (Vec3) { 1, 0, 0 });
+            vec3_normalize(&b->door_move_dir);
+
+            float move_dist = b->comp.door.distance;
+
+            if (move_dist <= 0) {
+                Vec3 min_aabb_local = { FLT_MAX, FLT_MAX, FLT_MAX };
+                Vec3 max_aabb_local = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+                for (int v = 0; v < b->numVertices; ++v) {
+                    min_aabb_local.x = fminf(min_aabb_local.x, b->vertices[v].pos.x);
+                    min_aabb_local.y = fminf(min_aabb_local.y, b->vertices[v].pos.y);
+                    min_aabb_local.z = fminf(min_aabb_local.z, b->vertices[v].pos.z);
+                    max_aabb_local.x = fmaxf(max_aabb_local.x, b->vertices[v].pos.x);
+                    max_aabb_local.y = fmaxf(max_aabb_local.y, b->vertices[v].pos.y);
+                    max_aabb_local.z = fmaxf(max_aabb_local.z, b->vertices[v].pos.z);
                 }
+                Vec3 size = vec3_sub(max_aabb_local, min_aabb_local);
+                Vec3 extent_x = vec3_muls((Vec3) { 1, 0, 0 }, size.x);
+                Vec3 extent_y = vec3_muls((Vec3) { 0, 1, 0 }, size.y);
+                Vec3 extent_z = vec3_muls((Vec3) { 0, 0, 1 }, size.z);
+                move_dist = fabsf(vec3_dot(extent_x, b->door_move_dir)) + fabsf(vec3_dot(extent_y, b->door_move_dir)) + fabsf(vec3_dot(extent_z, b->door_move_dir));
+            }
 
-                b->door_end_pos = vec3_add(b->door_start_pos, vec3_muls(b->door_move_dir, move_dist));
+            b->door_end_pos = vec3_add(b->door_start_pos, vec3_muls(b->door_move_dir, move_dist));
 
-                if (atoi(Brush_GetProperty(b, "StartOpen", "0")) == 1) {
-                    b->pos = b->door_end_pos;
-                    b->door_state = DOOR_STATE_OPEN;
-                }
-                else {
-                    b->door_state = DOOR_STATE_CLOSED;
-                }
-                Brush_UpdateMatrix(b);
-                if (b->physicsBody) Physics_SetWorldTransform(b->physicsBody, b->modelMatrix);
+            if (b->comp.door.startOpen) {
+                b->pos = b->door_end_pos;
+                b->door_state = DOOR_STATE_OPEN;
+            }
+            else {
+                b->door_state = DOOR_STATE_CLOSED;
             }
+            Brush_UpdateMatrix(b);
+            if (b->physicsBody) Physics_SetWorldTransform(b->physicsBody, b->modelMatrix);
+        }
 
-            float speed = atof(Brush_GetProperty(b, "speed", "100"));
-            if (b->door_state == DOOR_STATE_OPENING) {
-                Vec3 to_end = vec3_sub(b->door_end_pos, b->pos);
-                float dist_to_end = vec3_length(to_end);
-                float move_dist = speed * g_engine->deltaTime;
+        float speed = b->comp.door.speed;
+        if (b->door_state == DOOR_STATE_OPENING) {
+            Vec3 to_end = vec3_sub(b->door_end_pos, b->pos);
+            float dist_to_end = vec3_length(to_end);
+            float move_dist = speed * g_engine->deltaTime;
 
-                if (move_dist >= dist_to_end) {
-                    b->pos = b->door_end_pos;
-                    b->door_state = DOOR_STATE_OPEN;
-                    IO_FireOutput(ENTITY_BRUSH, i, "OnOpened", g_engine->lastFrame, NULL);
-                }
-                else {
-                    b->pos = vec3_add(b->pos, vec3_muls(b->door_move_dir, move_dist));
-                }
-                Brush_UpdateMatrix(b);
-                if (b->physicsBody) Physics_SetWorldTransform(b->physicsBody, b->modelMatrix);
-            }
-            else if (b->door_state == DOOR_STATE_CLOSING) {
-                Vec3 to_start = vec3_sub(b->door_start_pos, b->pos);
-                float dist_to_start = vec3_length(to_start);
-                float move_dist = speed * g_engine->deltaTime;
-
-                if (move_dist >= dist_to_start) {
-                    b->pos = b->door_start_pos;
-                    b->door_state = DOOR_STATE_CLOSED;
-                    IO_FireOutput(ENTITY_BRUSH, i, "OnClosed", g_engine->lastFrame, NULL);
-                }
-                else {
-                    b->pos = vec3_add(b->pos, vec3_muls(vec3_muls(b->door_move_dir, -1.0f), move_dist));
-                }
-                Brush_UpdateMatrix(b);
-                if (b->physicsBody) Physics_SetWorldTransform(b->physicsBody, b->modelMatrix);
+            if (move_dist >= dist_to_end) {
+                b->pos = b->door_end_pos;
+                b->door_state = DOOR_STATE_OPEN;
+                IO_FireOutput(ENTITY_BRUSH, i, "OnOpened", g_engine->lastFrame, NULL);
             }
-        }
-        if (strcmp(b->classname, "func_wall_toggle") == 0) {
-            if (!b->runtime_hasFired) {
-                b->runtime_is_visible = (atoi(Brush_GetProperty(b, "StartON", "1")) != 0);
-                if (b->physicsBody) {
-                    Physics_ToggleCollision(g_engine->physicsWorld, b->physicsBody, b->runtime_is_visible);
-                }
-                b->runtime_hasFired = true;
+            else {
+                b->pos = vec3_add(b->pos, vec3_muls(b->door_move_dir, move_dist));
             }
+            Brush_UpdateMatrix(b);
+            if (b->physicsBody) Physics_SetWorldTransform(b->physicsBody, b->modelMatrix);
         }
-        if (strcmp(b->classname, "func_rotating") == 0 && b->runtime_active) {
-            bool use_accel = atoi(Brush_GetProperty(b, "AccDcc", "0")) != 0;
+        else if (b->door_state == DOOR_STATE_CLOSING) {
+            Vec3 to_start = vec3_sub(b->door_start_pos, b->pos);
+            float dist_to_start = vec3_length(to_start);
+            float move_dist = speed * g_engine->deltaTime;
 
-            if (use_accel) {
-                float friction = atof(Brush_GetProperty(b, "fanfriction", "0"));
-                float accel_factor = 1.0f - (friction / 100.0f);
-                float lerp_speed = 2.0f + (accel_factor * 8.0f);
-                b->current_angular_velocity = vec3_lerp((Vec3) { b->current_angular_velocity, 0, 0 }, (Vec3) { b->target_angular_velocity, 0, 0 }, g_engine->deltaTime* lerp_speed).x;
+            if (move_dist >= dist_to_start) {
+                b->pos = b->door_start_pos;
+                b->door_state = DOOR_STATE_CLOSED;
+                IO_FireOutput(ENTITY_BRUSH, i, "OnClosed", g_engine->lastFrame, NULL);
             }
             else {
-                b->current_angular_velocity = b->target_angular_velocity;
+                b->pos = vec3_add(b->pos, vec3_muls(vec3_muls(b->door_move_dir, -1.0f), move_dist));
             }
+            Brush_UpdateMatrix(b);
+            if (b->physicsBody) Physics_SetWorldTransform(b->physicsBody, b->modelMatrix);
+        }
+    }
+    const int* wall_toggles;
+    int num_wall_toggles = Scene_GetBrushesOfClass(&g_scene, ENTITY_CLASS_FUNC_WALL_TOGGLE, &wall_toggles);
+    for (int k = 0; k < num_wall_toggles; ++k) {
+        Brush* b = &g_scene.brushes[wall_toggles[k]];
+        if (!b->runtime_hasFired) {
+            b->runtime_is_visible = b->comp.wallToggle.startOn;
+            if (b->physicsBody) {
+                Physics_ToggleCollision(g_engine->physicsWorld, b->physicsBody, b->runtime_is_visible);
+            }
+            b->runtime_hasFired = true;
+        }
+    }
+    const int* rotators;
+    int num_rotators = Scene_GetBrushesOfClass(&g_scene, ENTITY_CLASS_FUNC_ROTATING, &rotators);
+    for (int k = 0; k < num_rotators; ++k) {
+        Brush* b = &g_scene.brushes[rotators[k]];
+        if (!b->runtime_active) continue;
 
-            if (fabsf(b->current_angular_velocity) > 0.001f) {
-                Vec3 rotation_axis = { 0, 0, 1 };
-                if (atoi(Brush_GetProperty(b, "XAxis", "0")) != 0) rotation_axis = (Vec3){ 1, 0, 0 };
-                if (atoi(Brush_GetProperty(b, "YAxis", "0")) != 0) rotation_axis = (Vec3){ 0, 1, 0 };
+        if (b->comp.rotating.useAccel) {
+            float accel_factor = 1.0f - (b->comp.rotating.friction / 100.0f);
+            float lerp_speed = 2.0f + (accel_factor * 8.0f);
+            b->current_angular_velocity = vec3_lerp((Vec3) { b->current_angular_velocity, 0, 0 }, (Vec3) { b->target_angular_velocity, 0, 0 }, g_engine->deltaTime* lerp_speed).x;
+        }
+        else {
+            b->current_angular_velocity = b->target_angular_velocity;
+        }
 
-                float deg_per_sec = b->current_angular_velocity;
-                Vec3 delta_rot = vec3_muls(rotation_axis, deg_per_sec * g_engine->deltaTime);
-                b->rot = vec3_add(b->rot, delta_rot);
+        if (fabsf(b->current_angular_velocity) > 0.001f) {
+            Vec3 rotation_axis = b->comp.rotating.axis;
+            float deg_per_sec = b->current_angular_velocity;
+            Vec3 delta_rot = vec3_muls(rotation_axis, deg_per_sec * g_engine->deltaTime);
+            b->rot = vec3_add(b->rot, delta_rot);
 
-                b->rot.x = fmodf(b->rot.x, 360.0f);
-                b->rot.y = fmodf(b->rot.y, 360.0f);
-                b->rot.z = fmodf(b->rot.z, 360.0f);
+            b->rot.x = fmodf(b->rot.x, 360.0f);
+            b->rot.y = fmodf(b->rot.y, 360.0f);
+            b->rot.z = fmodf(b->rot.z, 360.0f);
 
-                Brush_UpdateMatrix(b);
-                if (b->physicsBody) {
-                    Physics_SetWorldTransform(b->physicsBody, b->modelMatrix);
-                }
+            Brush_UpdateMatrix(b);
+            if (b->physicsBody) {
+                Physics_SetWorldTransform(b->physicsBody, b->modelMatrix);
             }
         }
     }
-    for (int i = 0; i < g_scene.numBrushes; ++i) {
-        Brush* b = &g_scene.brushes[i];
-        if (strcmp(b->classname, "func_plat") == 0 && b->runtime_active) {
-            float speed = atof(Brush_GetProperty(b, "speed", "150"));
-            float wait = atof(Brush_GetProperty(b, "wait", "3"));
-            bool is_trigger = atoi(Brush_GetProperty(b, "is_trigger", "0")) != 0;
+    const int* plats;
+    int num_plats = Scene_GetBrushesOfClass(&g_scene, ENTITY_CLASS_FUNC_PLAT, &plats);
+    for (int k = 0; k < num_plats; ++k) {
+        Brush* b = &g_scene.brushes[plats[k]];
+        if (!b->runtime_active) continue;
 
-            if (!is_trigger && b->runtime_playerIsTouching && b->plat_state == PLAT_STATE_BOTTOM) {
-                b->plat_state = PLAT_STATE_UP;
-            }
+        float speed = b->comp.plat.speed;
+        float wait = b->comp.plat.wait;
+        bool is_trigger = b->comp.plat.isTrigger;
 
-            if (b->plat_state == PLAT_STATE_UP) {
-                Vec3 to_end = vec3_sub(b->end_pos, b->pos);
-                float dist_to_end = vec3_length(to_end);
-                float move_dist = speed * g_engine->deltaTime;
+        if (!is_trigger && b->runtime_playerIsTouching && b->plat_state == PLAT_STATE_BOTTOM) {
+            b->plat_state = PLAT_STATE_UP;
+        }
 
-                if (move_dist >= dist_to_end) {
-                    b->pos = b->end_pos;
-                    b->plat_state = PLAT_STATE_TOP;
-                    b->wait_timer = wait;
-                }
-                else {
-                    b->pos = vec3_add(b->pos, vec3_muls(b->move_dir, move_dist));
-                }
-            }
-            else if (b->plat_state == PLAT_STATE_DOWN) {
-                Vec3 to_start = vec3_sub(b->start_pos, b->pos);
-                float dist_to_start = vec3_length(to_start);
-                float move_dist = speed * g_engine->deltaTime;
+        if (b->plat_state == PLAT_STATE_UP) {
+            Vec3 to_end = vec3_sub(b->end_pos, b->pos);
+            float dist_to_end = vec3_length(to_end);
+            float move_dist = speed * g_engine->deltaTime;
 
-                if (move_dist >= dist_to_start) {
-                    b->pos = b->start_pos;
-                    b->plat_state = PLAT_STATE_BOTTOM;
-                }
-                else {
-                    b->pos = vec3_add(b->pos, vec3_muls(vec3_muls(b->move_dir, -1.0f), move_dist));
-                }
+            if (move_dist >= dist_to_end) {
+                b->pos = b->end_pos;
+                b->plat_state = PLAT_STATE_TOP;
+                b->wait_timer = wait;
             }
-            else if (b->plat_state == PLAT_STATE_TOP) {
-                if (wait > 0) {
-                    b->wait_timer -= g_engine->deltaTime;
-                    if (b->wait_timer <= 0) {
-                        b->plat_state = PLAT_STATE_DOWN;
-                    }
-                }
+            else {
+                b->pos = vec3_add(b->pos, vec3_muls(b->move_dir, move_dist));
             }
+        }
+        else if (b->plat_state == PLAT_STATE_DOWN) {
+            Vec3 to_start = vec3_sub(b->start_pos, b->pos);
+            float dist_to_start = vec3_length(to_start);
+            float move_dist = speed * g_engine->deltaTime;
 
-            Brush_UpdateMatrix(b);
-            if (b->physicsBody) {
-                Physics_SetWorldTransform(b->physicsBody, b->modelMatrix);
+            if (move_dist >= dist_to_start) {
+                b->pos = b->start_pos;
+                b->plat_state = PLAT_STATE_BOTTOM;
+            }
+            else {
+                b->pos = vec3_add(b->pos, vec3_muls(vec3_muls(b->move_dir, -1.0f), move_dist));
+            }
+        }
+        else if (b->plat_state == PLAT_STATE_TOP) {
+            if (wait > 0) {
+                b->wait_timer -= g_engine->deltaTime;
+                if (b->wait_timer <= 0) {
+                    b->plat_state = PLAT_STATE_DOWN;
+                }
             }
         }
-        if (strcmp(b->classname, "func_pendulum") == 0) {
-            if (vec3_length_sq(b->pendulum_swing_dir) < 0.001f) {
-                b->pendulum_start_pos = b->pos;
-                Vec3 swing_angles;
-                sscanf(Brush_GetProperty(b, "direction", "0 90 0"), "%f %f %f", &swing_angles.x, &swing_angles.y, &swing_angles.z);
 
-                Mat4 rot_mat = create_trs_matrix((Vec3) { 0, 0, 0 }, swing_angles, (Vec3) { 1, 1, 1 });
-                b->pendulum_swing_dir = mat4_mul_vec3_dir(&rot_mat, (Vec3) { 1, 0, 0 });
-                vec3_normalize(&b->pendulum_swing_dir);
+        Brush_UpdateMatrix(b);
+        if (b->physicsBody) {
+            Physics_SetWorldTransform(b->physicsBody, b->modelMatrix);
+        }
+    }
+    const int* pendulums;
+    int num_pendulums = Scene_GetBrushesOfClass(&g_scene, ENTITY_CLASS_FUNC_PENDULUM, &pendulums);
+    for (int k = 0; k < num_pendulums; ++k) {
+        Brush* b = &g_scene.brushes[pendulums[k]];
+        if (vec3_length_sq(b->pendulum_swing_dir) < 0.001f) {
+            b->pendulum_start_pos = b->pos;
+            Mat4 rot_mat = create_trs_matrix((Vec3) { 0, 0, 0 }, b->comp.pendulum.swingAngles, (Vec3) { 1, 1, 1 });
+            b->pendulum_swing_dir = mat4_mul_vec3_dir(&rot_mat, (Vec3) { 1, 0, 0 });
+            vec3_normalize(&b->pendulum_swing_dir);
 
-                if (atoi(Brush_GetProperty(b, "StartON", "1")) == 1) {
-                    b->runtime_active = true;
-                }
+            if (b->comp.pendulum.startOn) {
+                b->runtime_active = true;
             }
+        }
 
-            if (b->runtime_active) {
-                float speed = atof(Brush_GetProperty(b, "speed", "1.0"));
-                float distance = atof(Brush_GetProperty(b, "distance", "10.0"));
+        if (b->runtime_active) {
+            float speed = b->comp.pendulum.speed;
+            float distance = b->comp.pendulum.distance;
 
-                float sine_wave_pos = sinf(g_engine->scaledTime * speed * 2.0f * M_PI);
-                Vec3 offset = vec3_muls(b->pendulum_swing_dir, sine_wave_pos * distance);
+            float sine_wave_pos = sinf(g_engine->scaledTime * speed * 2.0f * M_PI);
+            Vec3 offset = vec3_muls(b->pendulum_swing_dir, sine_wave_pos * distance);
 
-                b->pos = vec3_add(b->pendulum_start_pos, offset);
+            b->pos = vec3_add(b->pendulum_start_pos, offset);
 
-                Brush_UpdateMatrix(b);
-                if (b->physicsBody) {
-                    Physics_SetWorldTransform(b->physicsBody, b->modelMatrix);
-                }
+            Brush_UpdateMatrix(b);
+            if (b->physicsBody) {
+                Physics_SetWorldTransform(b->physicsBody, b->modelMatrix);
             }
         }
-        if (strcmp(b->classname, "func_weight_button") == 0) {
-            if (b->physicsBody) {
-                float required_weight = atof(Brush_GetProperty(b, "weight", "50"));
-                float current_weight = Physics_GetTotalMassOnObject(g_engine->physicsWorld, b->physicsBody);
-
-                bool is_pressed = current_weight >= required_weight;
+    }
+    const int* weight_buttons;
+    int num_weight_buttons = Scene_GetBrushesOfClass(&g_scene, ENTITY_CLASS_FUNC_WEIGHT_BUTTON, &weight_buttons);
+    for (int k = 0; k < num_weight_buttons; ++k) {
+        int i = weight_buttons[k];
+        Brush* b = &g_scene.brushes[i];
+        if (b->physicsBody) {
+            float required_weight = b->comp.weightButton.weight;
+            float current_weight = Physics_GetTotalMassOnObject(g_engine->physicsWorld, b->physicsBody);
 
-                if (is_pressed && !b->runtime_was_pressed) {
-                    IO_FireOutput(ENTITY_BRUSH, i, "OnPressed", g_engine->lastFrame, NULL);
-                }
-                else if (!is_pressed && b->runtime_was_pressed) {
-                    IO_FireOutput(ENTITY_BRUSH, i, "OnReleased", g_engine->lastFrame, NULL);
-                }
+            bool is_pressed = current_weight >= required_weight;
 
-                b->runtime_was_pressed = is_pressed;
+            if (is_pressed && !b->runtime_was_pressed) {
+                IO_FireOutput(ENTITY_BRUSH, i, "OnPressed", g_engine->lastFrame, NULL);
+            }
+            else if (!is_pressed && b->runtime_was_pressed) {
+                IO_FireOutput(ENTITY_BRUSH, i, "OnReleased", g_engine->lastFrame, NULL);
             }
+
+            b->runtime_was_pressed = is_pressed;
         }
     }
     g_scene.post.isUnderwater = false;
-    for (int i = 0; i < g_scene.numBrushes; ++i) {
-        Brush* b = &g_scene.brushes[i];
-        if (strcmp(b->classname, "func_water") != 0) continue;
-
-        Vec3 min_aabb = { FLT_MAX, FLT_MAX, FLT_MAX };
-        Vec3 max_aabb = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
-        for (int v = 0; v < b->numVertices; ++v) {
-            Vec3 world_v = mat4_mul_vec3(&b->modelMatrix, b->vertices[v].pos);
-            min_aabb.x = fminf(min_aabb.x, world_v.x);
-            min_aabb.y = fminf(min_aabb.y, world_v.y);
-            min_aabb.z = fminf(min_aabb.z, world_v.z);
-            max_aabb.x = fmaxf(max_aabb.x, world_v.x);
-            max_aabb.y = fmaxf(max_aabb.y, world_v.y);
-            max_aabb.z = fmaxf(max_aabb.z, world_v.z);
-        }
-
-        if (g_engine->camera.position.x >= min_aabb.x && g_engine->camera.position.x <= max_aabb.x &&
-            g_engine->camera.position.y >= min_aabb.y && g_engine->camera.position.y <= max_aabb.y &&
-            g_engine->camera.position.z >= min_aabb.z && g_engine->camera.position.z <= max_aabb.z)
-        {
-            g_scene.post.isUnderwater = true;
-            g_scene.post.underwaterColor = (Vec3){ 0.1f, 0.3f, 0.4f };
-            break;
-        }
+    int water_volume;
+    if (TriggerVolumes_QueryPoint(g_engine->camera.position, ENTITY_CLASS_FUNC_WATER, &water_volume, 1) > 0) {
+        g_scene.post.isUnderwater = true;
+        g_scene.post.underwaterColor = (Vec3){ 0.1f, 0.3f, 0.4f };
     }
     if (g_current_mode == MODE_GAME) {
         for (int i = 0; i < g_scene.numObjects; ++i) {
@@ -1297,6 +1254,115 @@ void update_state() {
     }
 }
 
+
+// Gameplay and physics advance in fixed ticks of 1/p_tickrate seconds so
+// their cost and results do not depend on frame rate. Rendering sees transforms
+// interpolated between the last two ticks.
+
+typedef struct {
+    Mat4 prev;
+    Mat4 curr;
+    Mat4 written;
+} InterpTransform;
+
+static InterpTransform* g_interp_objects = NULL;
+static InterpTransform* g_interp_brushes = NULL;
+static int g_interp_object_count = -1;
+static int g_interp_brush_count = -1;
+static Vec3 g_interp_cam_prev, g_interp_cam_curr, g_interp_cam_written;
+static float g_sim_accumulator = 0.0f;
+
+static void interp_reset_entry(InterpTransform* t, const Mat4* m) {
+    t->prev = *m;
+    t->curr = *m;
+    t->written = *m;
+}
+
+static void interp_reset(void) {
+    g_interp_objects = realloc(g_interp_objects, (g_scene.numObjects > 0 ? g_scene.numObjects : 1) * sizeof(InterpTransform));
+    g_interp_brushes = realloc(g_interp_brushes, (g_scene.numBrushes > 0 ? g_scene.numBrushes : 1) * sizeof(InterpTransform));
+    g_interp_object_count = g_scene.numObjects;
+    g_interp_brush_count = g_scene.numBrushes;
+    for (int i = 0; i < g_scene.numObjects; ++i) interp_reset_entry(&g_interp_objects[i], &g_scene.objects[i].modelMatrix);
+    for (int i = 0; i < g_scene.numBrushes; ++i) interp_reset_entry(&g_interp_brushes[i], &g_scene.brushes[i].modelMatrix);
+    g_interp_cam_prev = g_interp_cam_curr = g_interp_cam_written = g_engine->camera.position;
+    g_sim_accumulator = 0.0f;
+}
+
+static void interp_restore_entry(InterpTransform* t, Mat4* m) {
+    // Anything that moved the entity since we wrote the interpolated matrix
+    // (editor, IO inputs, animation) is authoritative and ends the blend.
+    if (memcmp(m, &t->written, sizeof(Mat4)) == 0) *m = t->curr;
+    else interp_reset_entry(t, m);
+}
+
+static void interp_restore(void) {
+    for (int i = 0; i < g_scene.numObjects; ++i) interp_restore_entry(&g_interp_objects[i], &g_scene.objects[i].modelMatrix);
+    for (int i = 0; i < g_scene.numBrushes; ++i) interp_restore_entry(&g_interp_brushes[i], &g_scene.brushes[i].modelMatrix);
+    Vec3* cam = &g_engine->camera.position;
+    if (cam->x == g_interp_cam_written.x && cam->y == g_interp_cam_written.y && cam->z == g_interp_cam_written.z) *cam = g_interp_cam_curr;
+    else g_interp_cam_prev = g_interp_cam_curr = *cam;
+}
+
+static void interp_capture(bool before_tick) {
+    for (int i = 0; i < g_scene.numObjects; ++i) {
+        if (before_tick) g_interp_objects[i].prev = g_interp_objects[i].curr;
+        else g_interp_objects[i].curr = g_scene.objects[i].modelMatrix;
+    }
+    for (int i = 0; i < g_scene.numBrushes; ++i) {
+        if (before_tick) g_interp_brushes[i].prev = g_interp_brushes[i].curr;
+        else g_interp_brushes[i].curr = g_scene.brushes[i].modelMatrix;
+    }
+    if (before_tick) g_interp_cam_prev = g_interp_cam_curr;
+    else g_interp_cam_curr = g_engine->camera.position;
+}
+
+static void interp_apply_entry(InterpTransform* t, Mat4* m, float alpha) {
+    if (memcmp(&t->prev, &t->curr, sizeof(Mat4)) == 0) t->written = t->curr;
+    else t->written = mat4_interpolate_transform(&t->prev, &t->curr, alpha);
+    *m = t->written;
+}
+
+static void interp_apply(float alpha) {
+    for (int i = 0; i < g_scene.numObjects; ++i) interp_apply_entry(&g_interp_objects[i], &g_scene.objects[i].modelMatrix, alpha);
+    for (int i = 0; i < g_scene.numBrushes; ++i) interp_apply_entry(&g_interp_brushes[i], &g_scene.brushes[i].modelMatrix, alpha);
+    g_interp_cam_written = vec3_lerp(g_interp_cam_prev, g_interp_cam_curr, alpha);
+    g_engine->camera.position = g_interp_cam_written;
+}
+
+static void Simulation_Run(float frameDelta) {
+    float tick_rate = Cvar_GetFloat("p_tickrate");
+    if (tick_rate < 10.0f) tick_rate = 10.0f;
+    if (tick_rate > 1000.0f) tick_rate = 1000.0f;
+    int max_steps = Cvar_GetInt("p_maxsteps");
+    if (max_steps < 1) max_steps = 1;
+    float tick = 1.0f / tick_rate;
+
+    if (g_interp_object_count != g_scene.numObjects || g_interp_brush_count != g_scene.numBrushes) interp_reset();
+    else interp_restore();
+
+    g_sim_accumulator += frameDelta;
+    // Each tick sees its own point on the IO clock, so output delays resolve
+    // at tick granularity rather than whenever the next frame happens to land.
+    float frame_time = g_engine->lastFrame;
+    int steps = 0;
+    while (g_sim_accumulator >= tick && steps < max_steps) {
+        g_engine->deltaTime = tick;
+        g_engine->lastFrame = frame_time - (g_sim_accumulator - tick);
+        interp_capture(true);
+        simulate_tick();
+        interp_capture(false);
+        g_sim_accumulator -= tick;
+        steps++;
+    }
+    g_engine->deltaTime = frameDelta;
+    g_engine->lastFrame = frame_time;
+    // Past the catch-up cap the simulation slows down instead of spiralling.
+    if (g_sim_accumulator >= tick) g_sim_accumulator = fmodf(g_sim_accumulator, tick);
+
+    interp_apply(g_sim_accumulator / tick);
+}
+
 void cleanup() {
     Physics_DestroyWorld(g_engine->physicsWorld);
     for (int i = 0; i < g_scene.numParticleEmitters; i++) {
@@ -1326,15 +1392,20 @@ void cleanup() {
     SoundSystem_DeleteBuffer(g_footstep_sound_buffer);
     SoundSystem_DeleteBuffer(g_jump_sound_buffer);
     ModelLoader_Shutdown();
+    free(g_interp_objects);
+    free(g_interp_brushes);
+    g_interp_objects = NULL;
+    g_interp_brushes = NULL;
     TextureManager_Shutdown();
     SoundSystem_Shutdown();
+    SaveGame_Shutdown();
     IO_Shutdown();
     Binds_Shutdown();
     Commands_Shutdown();
     Cvar_Save("cvars.txt");
-    DSP_Reverb_Thread_Shutdown();
     Editor_Shutdown();
     GameData_Shutdown();
+    ContentCache_Shutdown();
     Weapons_Shutdown();
     Network_Shutdown();
     UI_Shutdown();
@@ -1448,6 +1519,68 @@ void evaluate_animation(SceneObject* obj, float time) {
     free(global_transforms);
 }
 
+static float Frame_RecordDelta(float rawDelta) {
+    g_frame_times[g_frame_time_index] = rawDelta;
+    g_frame_time_index = (g_frame_time_index + 1) % FRAME_STATS_SAMPLES;
+    if (g_frame_time_count < FRAME_STATS_SAMPLES) g_frame_time_count++;
+
+    if (!Cvar_GetInt("fps_smooth")) return rawDelta;
+    // Averaging keeps the total simulated time equal to wall time while
+    // hiding single-frame jitter from physics and animation.
+    int samples = g_frame_time_count < FRAME_SMOOTH_SAMPLES ? g_frame_time_count : FRAME_SMOOTH_SAMPLES;
+    float sum = 0.0f;
+    for (int i = 1; i <= samples; ++i) {
+        sum += g_frame_times[(g_frame_time_index - i + FRAME_STATS_SAMPLES) % FRAME_STATS_SAMPLES];
+    }
+    return sum / (float)samples;
+}
+
+static void Frame_Limit(int fps_max) {
+    Uint64 interval = g_perf_frequency / (Uint64)fps_max;
+    Uint64 now = SDL_GetPerformanceCounter();
+    if (g_next_frame_deadline == 0 || now > g_next_frame_deadline + interval) {
+        // First limited frame or a long hitch, restart the schedule instead of
+        // rushing frames to catch up.
+        g_next_frame_deadline = now + interval;
+        return;
+    }
+    while (now < g_next_frame_deadline) {
+        Uint64 remaining_us = (g_next_frame_deadline - now) * 1000000 / g_perf_frequency;
+        if (remaining_us > FRAME_SPIN_THRESHOLD_US) {
+            SDL_Delay((Uint32)((remaining_us - FRAME_SPIN_THRESHOLD_US) / 1000) + 1);
+        }
+        now = SDL_GetPerformanceCounter();
+    }
+    g_next_frame_deadline += interval;
+}
+
+void Engine_PrintFrameTimeStats(void) {
+    if (g_frame_time_count == 0) {
+        Console_Printf("No frame times recorded yet.");
+        return;
+    }
+    double sum = 0.0, min_ms = 1e9, max_ms = 0.0;
+    for (int i = 0; i < g_frame_time_count; ++i) {
+        double ms = g_frame_times[i] * 1000.0;
+        sum += ms;
+        if (ms < min_ms) min_ms = ms;
+        if (ms > max_ms) max_ms = ms;
+    }
+    double mean = sum / g_frame_time_count;
+    double variance = 0.0;
+    for (int i = 0; i < g_frame_time_count; ++i) {
+        double d = g_frame_times[i] * 1000.0 - mean;
+        variance += d * d;
+    }
+    variance /= g_frame_time_count;
+    Console_Printf("Frame time over %d frames: mean %.3f ms, std dev %.3f ms (variance %.4f ms^2), min %.3f ms, max %.3f ms",
+        g_frame_time_count, mean, sqrt(variance), variance, min_ms, max_ms);
+    int fps_max = Cvar_GetInt("fps_max");
+    if (!Cvar_GetInt("r_vsync") && fps_max > 0) {
+        Console_Printf("Limiter target: %.3f ms (%d FPS)", 1000.0 / fps_max, fps_max);
+    }
+}
+
 static void Scene_UpdateAnimations(Scene* scene, float deltaTime) {
     for (int i = 0; i < scene->numObjects; ++i) {
         SceneObject* obj = &scene->objects[i];
@@ -1637,12 +1770,15 @@ ENGINE_API int Engine_Main(int argc, char* argv[]) {
             }
             else if (g_pending_mode_transition == TRANSITION_TO_GAME) {
                 Editor_Shutdown();
+                // Catches edits made outside the undo system, gizmo moves of
+                // trigger brushes for example, before gameplay reads the lists.
+                Scene_RefreshEntityClasses(&g_scene);
                 g_current_mode = MODE_GAME;
                 SDL_SetRelativeMouseMode(SDL_TRUE);
             }
             g_pending_mode_transition = TRANSITION_NONE;
         }
-        Uint32 frameStartTicks = SDL_GetTicks();
+        Profiler_BeginFrame(Cvar_GetInt("r_profiler") != 0);
         g_scene.post.fade_active = false;
         g_scene.post.fade_alpha = 0.0f;
         int current_vsync_cvar = Cvar_GetInt("r_vsync");
@@ -1655,9 +1791,11 @@ ENGINE_API int Engine_Main(int argc, char* argv[]) {
             }
             g_last_vsync_cvar_state = current_vsync_cvar;
         }
-        float currentFrame = (float)SDL_GetTicks() / 1000.0f;
-        g_engine->unscaledDeltaTime = currentFrame - g_engine->lastFrame;
-        g_engine->lastFrame = currentFrame;
+        Uint64 frameStartCounter = SDL_GetPerformanceCounter();
+        g_engine->unscaledDeltaTime = (float)((double)(frameStartCounter - g_last_frame_counter) / (double)g_perf_frequency);
+        g_engine->lastFrame = (float)((double)(frameStartCounter - g_perf_start) / (double)g_perf_frequency);
+        g_last_frame_counter = frameStartCounter;
+        float smoothedDeltaTime = Frame_RecordDelta(g_engine->unscaledDeltaTime);
 
         if (g_engine->unscaledDeltaTime > 0.0f) {
             g_fps_history[g_fps_history_index] = 1.0f / g_engine->unscaledDeltaTime;
@@ -1668,7 +1806,7 @@ ENGINE_API int Engine_Main(int argc, char* argv[]) {
         if (time_scale_val < 0.0f) {
             time_scale_val = 0.0f;
         }
-        g_engine->deltaTime = g_engine->unscaledDeltaTime * time_scale_val;
+        g_engine->deltaTime = smoothedDeltaTime * time_scale_val;
         g_engine->scaledTime += g_engine->deltaTime;
         g_fps_frame_count++;
         Uint32 currentTicks = SDL_GetTicks();
@@ -1679,7 +1817,12 @@ ENGINE_API int Engine_Main(int argc, char* argv[]) {
         }
         UI_BeginFrame();
         IPC_ReceiveCommands(Commands_Execute);
-        process_input(); update_state();
+        Profiler_BeginCPUZone("Input");
+        process_input();
+        Profiler_EndZone();
+        Profiler_BeginCPUZone("Update");
+        update_state();
+        Profiler_EndZone();
         if (g_current_mode == MODE_MAINMENU || g_current_mode == MODE_INGAMEMENU) {
             const GameConfig* config = GameConfig_Get();
             if (g_current_mode == MODE_MAINMENU) {
@@ -1688,8 +1831,10 @@ ENGINE_API int Engine_Main(int argc, char* argv[]) {
             else {
                 Discord_Update(config->gamename, "Paused");
             }
+            Profiler_BeginZone("Main Menu");
             MainMenu_Update(g_engine->unscaledDeltaTime);
             MainMenu_Render();
+            Profiler_EndZone();
         }
         else if (g_current_mode == MODE_GAME) {
             char details_str[128];
@@ -1725,6 +1870,7 @@ ENGINE_API int Engine_Main(int argc, char* argv[]) {
             mat4_identity(&sunLightSpaceMatrix);
 
             if (Cvar_GetInt("r_shadows")) {
+                Profiler_BeginZone("Shadows");
                 if ((g_frame_counter % 2) == 0) {
                     Shadows_RenderPointAndSpot(&g_renderer, &g_scene, g_engine);
                 }
@@ -1735,22 +1881,36 @@ ENGINE_API int Engine_Main(int argc, char* argv[]) {
                         Shadows_RenderSun(&g_renderer, &g_scene, &sunLightSpaceMatrix);
                     }
                 }
+                Profiler_EndZone();
             }
             if (Cvar_GetInt("r_planar")) {
+                Profiler_BeginZone("Planar Reflections");
                 Planar_RenderReflections(&g_renderer, &g_scene, g_engine, &view, &projection, &sunLightSpaceMatrix, &g_engine->camera);
+                Profiler_EndZone();
             }
+            Profiler_BeginZone("Geometry");
             Geometry_RenderPass(&g_renderer, &g_scene, g_engine, &view, &projection, &sunLightSpaceMatrix, g_engine->camera.position, false);
+            Profiler_EndZone();
             if (Cvar_GetInt("r_ssao")) {
+                Profiler_BeginZone("SSAO");
                 SSAO_RenderPass(&g_renderer, g_engine, &projection);
+                Profiler_EndZone();
             }
             if (Cvar_GetInt("r_volumetrics")) {
+                Profiler_BeginZone("Volumetrics");
                 Volumetrics_RenderPass(&g_renderer, &g_scene, g_engine, &view, &projection, &sunLightSpaceMatrix);
+                Profiler_EndZone();
             }
             if (Cvar_GetInt("r_bloom")) {
+                Profiler_BeginZone("Bloom");
                 Bloom_RenderPass(&g_renderer, g_engine);
+                Profiler_EndZone();
             }
+            Profiler_BeginZone("Post Process");
             MiscRender_AutoexposurePass(&g_renderer, g_engine);
             PostProcess_RenderPass(&g_renderer, &g_scene, g_engine, &view, &projection);
+            Profiler_EndZone();
+            Profiler_BeginZone("Forward");
             glBindFramebuffer(GL_READ_FRAMEBUFFER, g_renderer.gBufferFBO);
             glBindFramebuffer(GL_DRAW_FRAMEBUFFER, g_renderer.finalRenderFBO);
             const int LOW_RES_WIDTH = g_engine->width / GEOMETRY_PASS_DOWNSAMPLE_FACTOR;
@@ -1772,8 +1932,13 @@ ENGINE_API int Engine_Main(int argc, char* argv[]) {
                 Planar_RenderWater(&g_renderer, &g_scene, g_engine, &view, &projection, &sunLightSpaceMatrix);
             }
             if (Cvar_GetInt("r_particles")) {
-                for (int i = 0; i < g_scene.numParticleEmitters; ++i) {
-                    ParticleEmitter_Render(&g_scene.particleEmitters[i], view, projection);
+                if (Cvar_GetInt("r_gpu_particles")) {
+                    GPUParticles_Render(&view, &projection);
+                }
+                else {
+                    for (int i = 0; i < g_scene.numParticleEmitters; ++i) {
+                        ParticleEmitter_Render(&g_scene.particleEmitters[i], view, projection);
+                    }
                 }
             }
             if (Cvar_GetInt("r_sprites")) {
@@ -1781,13 +1946,17 @@ ENGINE_API int Engine_Main(int argc, char* argv[]) {
             }
             glDepthMask(GL_TRUE);
             glDisable(GL_BLEND);
+            Profiler_EndZone();
             GLuint source_fbo = g_renderer.finalRenderFBO;
             GLuint source_tex = g_renderer.finalRenderTexture;
             if (Cvar_GetInt("r_ssr")) {
-                SSR_RenderPass(&g_renderer, g_engine, source_tex, g_renderer.postProcessFBO, &view, &projection);
+                Profiler_BeginZone("SSR");
+                SSR_RenderPass(&g_renderer, &g_scene, g_engine, source_tex, g_renderer.postProcessFBO, &view, &projection);
+                Profiler_EndZone();
                 source_fbo = g_renderer.postProcessFBO;
                 source_tex = g_renderer.postProcessTexture;
             }
+            Profiler_BeginZone("Screen Effects");
             if (g_scene.post.dofEnabled && Cvar_GetInt("r_dof")) {
                 MiscRender_DoFPass(&g_renderer, &g_scene, source_tex, g_renderer.finalDepthTexture, g_renderer.postProcessFBO);
                 source_fbo = g_renderer.postProcessFBO;
@@ -1807,15 +1976,16 @@ ENGINE_API int Engine_Main(int argc, char* argv[]) {
             else if (Cvar_GetInt("r_debug_position")) { Renderer_RenderDebugBuffer(&g_renderer, g_engine, g_renderer.gPosition, 5); debug_view_active = true; }
             else if (Cvar_GetInt("r_debug_metallic")) { Renderer_RenderDebugBuffer(&g_renderer, g_engine, g_renderer.gPBRParams, 1); debug_view_active = true; }
             else if (Cvar_GetInt("r_debug_roughness")) { Renderer_RenderDebugBuffer(&g_renderer, g_engine, g_renderer.gPBRParams, 2); debug_view_active = true; }
-            else if (Cvar_GetInt("r_debug_ao")) { Renderer_RenderDebugBuffer(&g_renderer, g_engine, g_renderer.ssaoBlurColorBuffer, 1); debug_view_active = true; }
+            else if (Cvar_GetInt("r_debug_ao")) { Renderer_RenderDebugBuffer(&g_renderer, g_engine, g_renderer.ssaoTexture, 1); debug_view_active = true; }
             else if (Cvar_GetInt("r_debug_velocity")) { Renderer_RenderDebugBuffer(&g_renderer, g_engine, g_renderer.gVelocity, 0); debug_view_active = true; }
-            else if (Cvar_GetInt("r_debug_volumetric")) { Renderer_RenderDebugBuffer(&g_renderer, g_engine, g_renderer.volPingpongTextures[0], 0); debug_view_active = true; }
-            else if (Cvar_GetInt("r_debug_bloom")) { Renderer_RenderDebugBuffer(&g_renderer, g_engine, g_renderer.bloomBrightnessTexture, 0); debug_view_active = true; }
+            else if (Cvar_GetInt("r_debug_volumetric")) { Renderer_RenderDebugBuffer(&g_renderer, g_engine, g_renderer.volumetricTexture, 0); debug_view_active = true; }
+            else if (Cvar_GetInt("r_debug_bloom")) { Renderer_RenderDebugBuffer(&g_renderer, g_engine, g_renderer.bloomTexture, 0); debug_view_active = true; }
 
             if (!debug_view_active) {
                 Renderer_Present(source_fbo, g_engine);
             }
             Overlay_Render(&g_scene, g_engine);
+            Profiler_EndZone();
             Mat4 currentViewProjection;
             mat4_multiply(&currentViewProjection, &projection, &view);
             g_renderer.prevViewProjection = currentViewProjection;
@@ -1824,36 +1994,54 @@ ENGINE_API int Engine_Main(int argc, char* argv[]) {
             char details_str[128];
             sprintf(details_str, "Map: %s", g_scene.mapPath);
             Discord_Update("In the Editor", details_str);
+            Profiler_BeginZone("Editor Viewports");
             Editor_RenderAllViewports(g_engine, &g_renderer, &g_scene);
             glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            Profiler_EndZone();
         }
+        Profiler_BeginZone("UI");
         if (g_current_mode == MODE_MAINMENU || g_current_mode == MODE_INGAMEMENU) {
         }
         else if (g_current_mode == MODE_EDITOR) { Editor_RenderUI(g_engine, &g_scene, &g_renderer); }
         else {
             UI_RenderGameHUD(g_fps_display, g_engine->camera.position.x, g_engine->camera.position.y, g_engine->camera.position.z, g_engine->camera.health, g_fps_history, FPS_GRAPH_SAMPLES, g_engine->canUse);
+            Profiler_RenderOverlay((float)g_engine->width);
             UI_RenderDeveloperOverlay();
             if (g_current_mode == MODE_GAME) {
                 Keypad_RenderUI(&g_scene, g_engine);
             }
         }
         Console_Draw(); 
+        Profiler_EndZone();
         if (g_screenshot_requested) {
             MiscRender_SaveScreenshot(g_engine, g_screenshot_path);
             g_screenshot_requested = false;
         }
+        if (g_screenshot_burst_remaining > 0) {
+            char burst_path[300];
+            snprintf(burst_path, sizeof(burst_path), "%s_%04d.png", g_screenshot_burst_base, g_screenshot_burst_index++);
+            MiscRender_SaveScreenshot(g_engine, burst_path);
+            g_screenshot_burst_remaining--;
+        }
+        Readback_Update();
+        StreamBuffer_EndFrame();
+        SaveGame_Update();
         int vsync_enabled = Cvar_GetInt("r_vsync");
         int fps_max = Cvar_GetInt("fps_max");
 
         if (vsync_enabled == 0 && fps_max > 0) {
-            float targetFrameTimeMs = 1000.0f / (float)fps_max;
-            Uint32 frameTicks = SDL_GetTicks() - frameStartTicks;
-            if (frameTicks < targetFrameTimeMs) {
-                SDL_Delay((Uint32)(targetFrameTimeMs - frameTicks));
-            }
+            Profiler_BeginCPUZone("Frame Limiter");
+            Frame_Limit(fps_max);
+            Profiler_EndZone();
+        }
+        else {
+            g_next_frame_deadline = 0;
         }
         g_frame_counter++;
+        Profiler_BeginCPUZone("Swap");
         UI_EndFrame(window);
+        Profiler_EndZone();
+        Profiler_EndFrame();
     }
     cleanup(); return 0;
 }
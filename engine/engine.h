@@ -54,8 +54,13 @@ extern EngineModeTransition g_pending_mode_transition;
 extern bool g_player_input_disabled;
 extern bool g_screenshot_requested;
 extern char g_screenshot_path[256];
+extern int g_screenshot_burst_remaining;
+extern int g_screenshot_burst_index;
+extern char g_screenshot_burst_base[256];
 extern bool g_is_editor_mode;
 
+void Engine_PrintFrameTimeStats(void);
+
 #ifdef __cplusplus
 }
 #endif
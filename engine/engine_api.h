@@ -40,6 +40,7 @@ extern "C" {
 #endif
 
 ENGINE_API int Engine_Main(int argc, char* argv[]);
+ENGINE_API int Engine_BakeMain(int argc, char* argv[]);
 
 #ifdef __cplusplus
 }
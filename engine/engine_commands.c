@@ -33,6 +33,8 @@
 #include "network.h"
 #include "lightmapper.h"
 #include "gl_render_misc.h"
+#include "gl_profiler.h"
+#include "savegame.h"
 #include <time.h>
 #include <errno.h>
 
@@ -245,6 +247,20 @@ void Cmd_BuildCubemaps(int argc, char** argv) {
     MiscRender_BuildCubemaps(&g_renderer, &g_scene, g_engine, resolution);
 }
 
+void Cmd_FpsStats(int argc, char** argv) {
+    Engine_PrintFrameTimeStats();
+}
+
+void Cmd_ProfileDump(int argc, char** argv) {
+    int frames = argc > 1 ? atoi(argv[1]) : 120;
+    const char* path = argc > 2 ? argv[2] : "profile_trace.json";
+    if (frames <= 0) {
+        Console_Printf("Usage: profile_dump [frames] [file]");
+        return;
+    }
+    Profiler_StartCapture(frames, path);
+}
+
 void Cmd_Screenshot(int argc, char** argv) {
     if (g_screenshot_requested) {
         Console_Printf("Screenshot already queued.");
@@ -261,6 +277,25 @@ void Cmd_Screenshot(int argc, char** argv) {
     g_screenshot_requested = true;
 }
 
+void Cmd_ScreenshotBurst(int argc, char** argv) {
+    int frames = argc > 1 ? atoi(argv[1]) : 0;
+    if (frames <= 0) {
+        Console_Printf("Usage: screenshot_burst <frames>");
+        return;
+    }
+    if (g_screenshot_burst_remaining > 0) {
+        Console_Printf("Screenshot burst already running.");
+        return;
+    }
+    _mkdir("screenshots");
+
+    time_t rawtime;
+    time(&rawtime);
+    strftime(g_screenshot_burst_base, sizeof(g_screenshot_burst_base), "screenshots/burst_%Y-%m-%d_%H-%M-%S", localtime(&rawtime));
+    g_screenshot_burst_index = 0;
+    g_screenshot_burst_remaining = frames;
+}
+
 void Cmd_Echo(int argc, char** argv) {
     if (argc < 2) {
         Console_Printf("Usage: echo <message>");
@@ -368,10 +403,19 @@ void Cmd_SaveGame(int argc, char** argv) {
         return;
     }
 
-    if (Scene_SaveMap(&g_scene, g_engine, savePath)) {
-        Console_Printf("Game saved to %s", savePath);
+    // The editor can add and remove entities, so a delta against the loaded
+    // map would not describe the scene. Editor saves stay full text maps.
+    if (g_current_mode == MODE_EDITOR) {
+        if (Scene_SaveMap(&g_scene, g_engine, savePath)) {
+            Console_Printf("Game saved to %s", savePath);
+        }
+        else {
+            Console_Printf_Error("Failed to save game to %s", savePath);
+        }
+        return;
     }
-    else {
+
+    if (!SaveGame_Write(savePath, &g_scene, g_engine)) {
         Console_Printf_Error("Failed to save game to %s", savePath);
     }
 }
@@ -387,13 +431,25 @@ void Cmd_LoadGame(int argc, char** argv) {
 
     Console_Printf("Loading game from %s...", savePath);
 
+    bool was_editing = g_is_editor_mode;
     if (g_is_editor_mode) {
         Editor_Shutdown();
     }
     g_current_mode = MODE_GAME;
     SDL_SetRelativeMouseMode(SDL_TRUE);
 
-    if (Scene_LoadMap(&g_scene, &g_renderer, savePath, g_engine)) {
+    // A save of the same slot may still be on the writer thread, and the file
+    // is briefly missing while it is moved into place.
+    SaveGame_Flush();
+    bool loaded;
+    if (SaveGame_IsBinary(savePath)) {
+        loaded = SaveGame_Load(savePath, &g_scene, &g_renderer, g_engine, !was_editing);
+    }
+    else {
+        loaded = Scene_LoadMap(&g_scene, &g_renderer, savePath, g_engine);
+    }
+
+    if (loaded) {
         Console_Printf("Game loaded successfully.");
     }
     else {
@@ -428,7 +484,7 @@ void Cmd_BuildLighting(int argc, char** argv) {
         }
     }
 
-    Lightmapper_Generate(&g_scene, g_engine, resolution, bounces);
+    Lightmapper_Generate(&g_scene, g_engine, resolution, bounces, 0);
 }
 
 void Cmd_ScreenShake(int argc, char** argv) {
@@ -445,9 +501,13 @@ void Cmd_ScreenShake(int argc, char** argv) {
 void init_cvars() {
     Cvar_Register("developer", "0", "Show developer console log on screen (0=off, 1=on)", CVAR_CHEAT);
     Cvar_Register("volume", "2.5", "Master volume for the game (0.0 to 4.0)", CVAR_NONE);
+    Cvar_Register("snd_stream_threshold", "1024", "Sound files at least this many KB are streamed instead of fully decoded (0=never stream).", CVAR_NONE);
     Cvar_Register("noclip", "0", "Enable noclip mode (0=off, 1=on)", CVAR_NONE);
     Cvar_Register("god", "0", "Enable god mode (player is invulnerable).", CVAR_CHEAT);
     Cvar_Register("gravity", "9.81", "World gravity value", CVAR_NONE);
+    Cvar_Register("lightmap_denoise_page_size", "2048", "Width of the atlas pages lightmaps are packed into for denoising.", CVAR_NONE);
+    Cvar_Register("lightmap_denoise_max_memory", "0", "Memory limit in MB for the lightmap denoiser, enables tiled denoising (0=unlimited).", CVAR_NONE);
+    Cvar_Register("lightmap_batch_memory", "1024", "Traced lightmap data in MB held before it is denoised and written (0=unlimited).", CVAR_NONE);
     Cvar_Register("engine_running", "1", "Engine state (0=off, 1=on)", CVAR_HIDDEN);
     Cvar_Register("r_width", "1920", "Screen width in pixels", CVAR_NONE);
     Cvar_Register("r_height", "1080", "Screen height in pixels", CVAR_NONE);
@@ -468,6 +528,7 @@ void init_cvars() {
     Cvar_Register("r_shadow_distance_max", "100.0", "Max shadow casting distance", CVAR_NONE);
     Cvar_Register("r_shadow_map_size", "1024", "Shadow map resolution", CVAR_NONE);
     Cvar_Register("r_relief_mapping", "1", "Enable relief mapping (0=off, 1=on)", CVAR_NONE);
+    Cvar_Register("r_tess_triangle_size", "8", "Target on-screen edge length in pixels for displacement tessellation", CVAR_NONE);
     Cvar_Register("r_cubemaps", "1", "Enable environment mapping reflections (0=off, 1=on)", CVAR_NONE);
     Cvar_Register("r_colorcorrection", "1", "Enable color correction (0=off, 1=on)", CVAR_NONE);
     Cvar_Register("r_vignette", "1", "Enable vignette (0=off, 1=on)", CVAR_NONE);
@@ -486,14 +547,19 @@ void init_cvars() {
     Cvar_Register("r_skybox", "1", "Enable skybox (0=off, 1=on)", CVAR_NONE);
     Cvar_Register("r_particles", "1", "Enable particles (0=off, 1=on)", CVAR_NONE);
     Cvar_Register("r_particles_cull_dist", "75.0", "Particle culling distance", CVAR_NONE);
+    Cvar_Register("r_gpu_particles", "1", "Simulate and sort particles in compute shaders (0=off, 1=on)", CVAR_NONE);
     Cvar_Register("r_sprites", "1", "Enable sprites (0=off, 1=on)", CVAR_NONE);
     Cvar_Register("r_water", "1", "Enable water rendering (0=off, 1=on)", CVAR_NONE);
     Cvar_Register("r_planar", "1", "Enable planar reflections for water and reflective glass (0=off, 1=on)", CVAR_NONE);
     Cvar_Register("r_planar_downsample", "2", "Downsample factor for planar reflections/refractions (e.g., 2 = 1/4 resolution)", CVAR_NONE);
     Cvar_Register("r_lightmaps_bicubic", "0", "Enable Bicubic lightmap filtering (0=off, 1=on)", CVAR_NONE);
     Cvar_Register("fps_max", "300", "Max FPS (0=unlimited)", CVAR_NONE);
+    Cvar_Register("p_tickrate", "60", "Fixed simulation ticks per second for physics and gameplay (10-1000)", CVAR_NONE);
+    Cvar_Register("p_maxsteps", "5", "Max simulation ticks run in one frame before the game slows down to catch up", CVAR_NONE);
+    Cvar_Register("fps_smooth", "1", "Average frame delta over recent frames for physics and animation (0=off, 1=on)", CVAR_NONE);
     Cvar_Register("show_fps", "0", "Show FPS counter (0=off, 1=on)", CVAR_NONE);
     Cvar_Register("r_showgraph", "0", "Show framerate graph (0=off, 1=on)", CVAR_NONE);
+    Cvar_Register("r_profiler", "0", "Show the CPU/GPU frame profiler overlay (0=off, 1=on)", CVAR_NONE);
     Cvar_Register("show_pos", "0", "Show player position (0=off, 1=on)", CVAR_NONE);
     Cvar_Register("r_debug_albedo", "0", "Show albedo buffer (0=off, 1=on)", CVAR_NONE);
     Cvar_Register("r_debug_normals", "0", "Show normals buffer (0=off, 1=on)", CVAR_NONE);
@@ -552,6 +618,9 @@ void init_commands() {
     Commands_Register("ping", Cmd_Ping, "Pings a network host to check connectivity.", CMD_NONE);
     Commands_Register("build_cubemaps", Cmd_BuildCubemaps, "Builds cubemaps for all reflection probes. Usage: build_cubemaps [resolution]", CMD_NONE);
     Commands_Register("screenshot", Cmd_Screenshot, "Saves a screenshot to disk.", CMD_NONE);
+    Commands_Register("screenshot_burst", Cmd_ScreenshotBurst, "Saves a screenshot every frame for the given number of frames.", CMD_NONE);
+    Commands_Register("fps_stats", Cmd_FpsStats, "Prints frame time mean, variance and range over recent frames.", CMD_NONE);
+    Commands_Register("profile_dump", Cmd_ProfileDump, "Records frames with the profiler and writes a Chrome trace JSON.", CMD_NONE);
     Commands_Register("exec", Cmd_Exec, "Executes a script file from the root directory.", CMD_NONE);
     Commands_Register("version", Cmd_Version, "Displays engine and map version information.", CMD_NONE);
     Commands_Register("echo", Cmd_Echo, "Prints a message to the console.", CMD_NONE);
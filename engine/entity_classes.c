@@ -0,0 +1,341 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 Soft Sprint Studios
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "entity_classes.h"
+#include "map.h"
+#include "io_system.h"
+#include "trigger_volumes.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Classnames are interned once when a map loads. Per-frame systems then walk
+// the per-class index lists on the scene and read the parsed components, so
+// nothing on the hot path compares strings or calls atof.
+
+#define CLASS_HASH_SIZE 128
+
+static const char* g_class_names[ENTITY_CLASS_COUNT] = {
+    [ENTITY_CLASS_NONE] = "",
+    [ENTITY_CLASS_UNKNOWN] = "",
+    [ENTITY_CLASS_FUNC_BUTTON] = "func_button",
+    [ENTITY_CLASS_FUNC_DOOR] = "func_door",
+    [ENTITY_CLASS_FUNC_HEALTHCHARGER] = "func_healthcharger",
+    [ENTITY_CLASS_FUNC_WATER] = "func_water",
+    [ENTITY_CLASS_FUNC_FRICTION] = "func_friction",
+    [ENTITY_CLASS_FUNC_CONVEYOR] = "func_conveyor",
+    [ENTITY_CLASS_FUNC_LADDER] = "func_ladder",
+    [ENTITY_CLASS_FUNC_WALL_TOGGLE] = "func_wall_toggle",
+    [ENTITY_CLASS_FUNC_ROTATING] = "func_rotating",
+    [ENTITY_CLASS_FUNC_PLAT] = "func_plat",
+    [ENTITY_CLASS_FUNC_PENDULUM] = "func_pendulum",
+    [ENTITY_CLASS_FUNC_WEIGHT_BUTTON] = "func_weight_button",
+    [ENTITY_CLASS_FUNC_CLIP] = "func_clip",
+    [ENTITY_CLASS_FUNC_LOD] = "func_lod",
+    [ENTITY_CLASS_FUNC_ILLUSIONARY] = "func_illusionary",
+    [ENTITY_CLASS_FUNC_REFLECTIVE_GLASS] = "func_reflective_glass",
+    [ENTITY_CLASS_ENV_GLASS] = "env_glass",
+    [ENTITY_CLASS_ENV_REFLECTIONPROBE] = "env_reflectionprobe",
+    [ENTITY_CLASS_TRIGGER] = "trigger",
+    [ENTITY_CLASS_TRIGGER_ONCE] = "trigger_once",
+    [ENTITY_CLASS_TRIGGER_MULTIPLE] = "trigger_multiple",
+    [ENTITY_CLASS_TRIGGER_TELEPORT] = "trigger_teleport",
+    [ENTITY_CLASS_TRIGGER_CAMERA] = "trigger_camera",
+    [ENTITY_CLASS_TRIGGER_PARALYZEPLAYER] = "trigger_paralyzeplayer",
+    [ENTITY_CLASS_TRIGGER_AUTOSAVE] = "trigger_autosave",
+    [ENTITY_CLASS_TRIGGER_HURT] = "trigger_hurt",
+    [ENTITY_CLASS_TRIGGER_KILLPLAYER] = "trigger_killplayer",
+    [ENTITY_CLASS_TRIGGER_GRAVITY] = "trigger_gravity",
+    [ENTITY_CLASS_TRIGGER_DSPZONE] = "trigger_dspzone",
+    [ENTITY_CLASS_TRIGGER_KEYPAD] = "trigger_keypad",
+    [ENTITY_CLASS_LOGIC_TIMER] = "logic_timer",
+    [ENTITY_CLASS_LOGIC_RANDOM] = "logic_random",
+    [ENTITY_CLASS_LOGIC_REPEAT] = "logic_repeat",
+    [ENTITY_CLASS_LOGIC_RELAY] = "logic_relay",
+    [ENTITY_CLASS_LOGIC_COMPARE] = "logic_compare",
+    [ENTITY_CLASS_LOGIC_BRANCH] = "logic_branch",
+    [ENTITY_CLASS_LOGIC_AUTO] = "logic_auto",
+    [ENTITY_CLASS_MATH_COUNTER] = "math_counter",
+    [ENTITY_CLASS_ENV_BLACKHOLE] = "env_blackhole",
+    [ENTITY_CLASS_ENV_FADE] = "env_fade",
+    [ENTITY_CLASS_ENV_FOG] = "env_fog",
+    [ENTITY_CLASS_ENV_CABLE] = "env_cable",
+    [ENTITY_CLASS_ENV_SHAKE] = "env_shake",
+    [ENTITY_CLASS_ENV_BEAM] = "env_beam",
+    [ENTITY_CLASS_ENV_GLOW] = "env_glow",
+    [ENTITY_CLASS_ENV_OVERLAY] = "env_overlay",
+    [ENTITY_CLASS_INFO_TARGET] = "info_target",
+    [ENTITY_CLASS_POINT_SERVERCOMMAND] = "point_servercommand",
+    [ENTITY_CLASS_GAME_END] = "game_end",
+};
+
+static unsigned char g_class_hash[CLASS_HASH_SIZE];
+static bool g_class_hash_built = false;
+
+static unsigned int hash_classname(const char* s) {
+    unsigned int h = 2166136261u;
+    while (*s) {
+        h ^= (unsigned char)*s++;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static void build_class_hash(void) {
+    memset(g_class_hash, 0, sizeof(g_class_hash));
+    for (int id = ENTITY_CLASS_UNKNOWN + 1; id < ENTITY_CLASS_COUNT; ++id) {
+        unsigned int slot = hash_classname(g_class_names[id]) & (CLASS_HASH_SIZE - 1);
+        while (g_class_hash[slot] != 0) {
+            slot = (slot + 1) & (CLASS_HASH_SIZE - 1);
+        }
+        g_class_hash[slot] = (unsigned char)id;
+    }
+    g_class_hash_built = true;
+}
+
+EntityClassId EntityClass_FromName(const char* classname) {
+    if (!classname || classname[0] == '\0') return ENTITY_CLASS_NONE;
+    if (!g_class_hash_built) build_class_hash();
+
+    unsigned int slot = hash_classname(classname) & (CLASS_HASH_SIZE - 1);
+    while (g_class_hash[slot] != 0) {
+        int id = g_class_hash[slot];
+        if (strcmp(g_class_names[id], classname) == 0) return (EntityClassId)id;
+        slot = (slot + 1) & (CLASS_HASH_SIZE - 1);
+    }
+    return ENTITY_CLASS_UNKNOWN;
+}
+
+const char* EntityClass_GetName(EntityClassId id) {
+    if (id < 0 || id >= ENTITY_CLASS_COUNT) return "";
+    return g_class_names[id];
+}
+
+static Vec3 parse_vec3(const char* str) {
+    Vec3 v = { 0, 0, 0 };
+    sscanf(str, "%f %f %f", &v.x, &v.y, &v.z);
+    return v;
+}
+
+void Brush_ParseComponent(Brush* b) {
+    memset(&b->comp, 0, sizeof(b->comp));
+    switch (b->classId) {
+    case ENTITY_CLASS_FUNC_BUTTON:
+        b->comp.button.locked = atoi(Brush_GetProperty(b, "locked", "0")) == 1;
+        b->comp.button.delay = atof(Brush_GetProperty(b, "delay", "0"));
+        break;
+    case ENTITY_CLASS_FUNC_DOOR:
+        b->comp.door.openOnUse = atoi(Brush_GetProperty(b, "OpenOnUse", "1")) == 1;
+        b->comp.door.startOpen = atoi(Brush_GetProperty(b, "StartOpen", "0")) == 1;
+        b->comp.door.speed = atof(Brush_GetProperty(b, "speed", "100"));
+        b->comp.door.distance = atof(Brush_GetProperty(b, "distance", "0"));
+        b->comp.door.moveAngles = parse_vec3(Brush_GetProperty(b, "direction", "0 90 0"));
+        break;
+    case ENTITY_CLASS_FUNC_HEALTHCHARGER:
+        b->comp.healthCharger.healAmount = atof(Brush_GetProperty(b, "heal_amount", "25"));
+        break;
+    case ENTITY_CLASS_TRIGGER_ONCE:
+    case ENTITY_CLASS_TRIGGER_MULTIPLE:
+        b->comp.touch.delay = atof(Brush_GetProperty(b, "delay", "0"));
+        break;
+    case ENTITY_CLASS_TRIGGER_TELEPORT:
+        strncpy(b->comp.teleport.target, Brush_GetProperty(b, "target", ""), ENTITY_TARGET_LENGTH - 1);
+        break;
+    case ENTITY_CLASS_TRIGGER_CAMERA:
+        strncpy(b->comp.camera.target, Brush_GetProperty(b, "target", ""), ENTITY_TARGET_LENGTH - 1);
+        b->comp.camera.moveTo = atof(Brush_GetProperty(b, "moveto", "2.0"));
+        b->comp.camera.holdTime = atof(Brush_GetProperty(b, "holdtime", "5.0"));
+        break;
+    case ENTITY_CLASS_TRIGGER_HURT:
+        b->comp.hurt.damage = atof(Brush_GetProperty(b, "damage", "10"));
+        break;
+    case ENTITY_CLASS_TRIGGER_GRAVITY:
+        b->comp.gravity.gravity = atof(Brush_GetProperty(b, "gravity", "9.81"));
+        break;
+    case ENTITY_CLASS_TRIGGER_DSPZONE:
+        b->comp.dspZone.reverbPreset = atoi(Brush_GetProperty(b, "reverb_preset", "0"));
+        break;
+    case ENTITY_CLASS_FUNC_FRICTION:
+        b->comp.friction.modifier = atof(Brush_GetProperty(b, "modifier", "100"));
+        break;
+    case ENTITY_CLASS_FUNC_CONVEYOR: {
+        float speed = atof(Brush_GetProperty(b, "speed", "0"));
+        Vec3 angles = parse_vec3(Brush_GetProperty(b, "direction", "0 0 0"));
+        Mat4 rot_x_mat = mat4_rotate_x(angles.x * (M_PI / 180.0f));
+        Mat4 rot_y_mat = mat4_rotate_y(angles.y * (M_PI / 180.0f));
+        Mat4 rot_z_mat = mat4_rotate_z(angles.z * (M_PI / 180.0f));
+        Mat4 rot_mat;
+        mat4_multiply(&rot_mat, &rot_y_mat, &rot_x_mat);
+        mat4_multiply(&rot_mat, &rot_z_mat, &rot_mat);
+        Vec3 move_dir = mat4_mul_vec3_dir(&rot_mat, (Vec3) { 1, 0, 0 });
+        b->comp.conveyor.speed = speed;
+        b->comp.conveyor.velocity = vec3_muls(move_dir, speed);
+        break;
+    }
+    case ENTITY_CLASS_FUNC_WALL_TOGGLE:
+        b->comp.wallToggle.startOn = atoi(Brush_GetProperty(b, "StartON", "1")) != 0;
+        break;
+    case ENTITY_CLASS_FUNC_ROTATING:
+        b->comp.rotating.useAccel = atoi(Brush_GetProperty(b, "AccDcc", "0")) != 0;
+        b->comp.rotating.friction = atof(Brush_GetProperty(b, "fanfriction", "0"));
+        b->comp.rotating.speed = atof(Brush_GetProperty(b, "speed", "10"));
+        b->comp.rotating.axis = (Vec3){ 0, 0, 1 };
+        if (atoi(Brush_GetProperty(b, "XAxis", "0")) != 0) b->comp.rotating.axis = (Vec3){ 1, 0, 0 };
+        if (atoi(Brush_GetProperty(b, "YAxis", "0")) != 0) b->comp.rotating.axis = (Vec3){ 0, 1, 0 };
+        break;
+    case ENTITY_CLASS_FUNC_PLAT:
+        b->comp.plat.speed = atof(Brush_GetProperty(b, "speed", "150"));
+        b->comp.plat.wait = atof(Brush_GetProperty(b, "wait", "3"));
+        b->comp.plat.isTrigger = atoi(Brush_GetProperty(b, "is_trigger", "0")) != 0;
+        break;
+    case ENTITY_CLASS_FUNC_PENDULUM:
+        b->comp.pendulum.startOn = atoi(Brush_GetProperty(b, "StartON", "1")) == 1;
+        b->comp.pendulum.speed = atof(Brush_GetProperty(b, "speed", "1.0"));
+        b->comp.pendulum.distance = atof(Brush_GetProperty(b, "distance", "10.0"));
+        b->comp.pendulum.swingAngles = parse_vec3(Brush_GetProperty(b, "direction", "0 90 0"));
+        break;
+    case ENTITY_CLASS_FUNC_WEIGHT_BUTTON:
+        b->comp.weightButton.weight = atof(Brush_GetProperty(b, "weight", "50"));
+        break;
+    default:
+        break;
+    }
+}
+
+void LogicEntity_ParseComponent(LogicEntity* ent) {
+    memset(&ent->comp, 0, sizeof(ent->comp));
+    switch (ent->classId) {
+    case ENTITY_CLASS_LOGIC_TIMER:
+        ent->comp.timer.repeat = atoi(LogicEntity_GetProperty(ent, "repeat", "1"));
+        ent->comp.timer.delay = atof(LogicEntity_GetProperty(ent, "delay", "1.0"));
+        break;
+    case ENTITY_CLASS_LOGIC_RANDOM:
+        ent->comp.random.minTime = atof(LogicEntity_GetProperty(ent, "min_time", "0.0"));
+        ent->comp.random.maxTime = atof(LogicEntity_GetProperty(ent, "max_time", "0.0"));
+        break;
+    case ENTITY_CLASS_LOGIC_REPEAT:
+        ent->comp.repeat.delay = atof(LogicEntity_GetProperty(ent, "delay", "1.0"));
+        break;
+    case ENTITY_CLASS_ENV_BLACKHOLE:
+        ent->comp.blackhole.rotationSpeed = atof(LogicEntity_GetProperty(ent, "rotationspeed", "10.0"));
+        break;
+    case ENTITY_CLASS_ENV_FADE: {
+        float duration = atof(LogicEntity_GetProperty(ent, "duration", "2.0"));
+        ent->comp.fade.duration = duration > 0.0f ? duration : 0.01f;
+        ent->comp.fade.holdTime = atof(LogicEntity_GetProperty(ent, "holdtime", "1.0"));
+        ent->comp.fade.targetAlpha = (float)atoi(LogicEntity_GetProperty(ent, "renderamt", "255")) / 255.0f;
+        break;
+    }
+    case ENTITY_CLASS_ENV_FOG:
+        ent->comp.fog.color = parse_vec3(LogicEntity_GetProperty(ent, "color", "0.5 0.6 0.7"));
+        ent->comp.fog.start = atof(LogicEntity_GetProperty(ent, "start", "50.0"));
+        ent->comp.fog.end = atof(LogicEntity_GetProperty(ent, "end", "200.0"));
+        break;
+    case ENTITY_CLASS_ENV_CABLE: {
+        strncpy(ent->comp.cable.target, LogicEntity_GetProperty(ent, "Target", ""), ENTITY_TARGET_LENGTH - 1);
+        ent->comp.cable.depth = atof(LogicEntity_GetProperty(ent, "Depth", "20.0"));
+        ent->comp.cable.width = atof(LogicEntity_GetProperty(ent, "Width", "0.1"));
+        ent->comp.cable.segments = atoi(LogicEntity_GetProperty(ent, "Segments", "16"));
+        if (ent->comp.cable.segments < 2) ent->comp.cable.segments = 2;
+        ent->comp.cable.windAmount = atof(LogicEntity_GetProperty(ent, "WindAmount", "5.0"));
+        ent->comp.cable.windSpeed = atof(LogicEntity_GetProperty(ent, "WindSpeed", "1.0"));
+        Vec3 wind_angles = parse_vec3(LogicEntity_GetProperty(ent, "WindDirection", "0 0 0"));
+        Mat4 rot_mat = create_trs_matrix((Vec3) { 0, 0, 0 }, wind_angles, (Vec3) { 1, 1, 1 });
+        ent->comp.cable.windDir = mat4_mul_vec3_dir(&rot_mat, (Vec3) { 1, 0, 0 });
+        vec3_normalize(&ent->comp.cable.windDir);
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+void Scene_RefreshEntityClasses(Scene* scene) {
+    static unsigned int generation = 0;
+    int brush_counts[ENTITY_CLASS_COUNT] = { 0 };
+    for (int i = 0; i < scene->numBrushes; ++i) {
+        Brush* b = &scene->brushes[i];
+        b->classId = EntityClass_FromName(b->classname);
+        Brush_ParseComponent(b);
+        brush_counts[b->classId]++;
+    }
+    scene->brushClassStart[0] = 0;
+    for (int c = 0; c < ENTITY_CLASS_COUNT; ++c) {
+        scene->brushClassStart[c + 1] = scene->brushClassStart[c] + brush_counts[c];
+        brush_counts[c] = scene->brushClassStart[c];
+    }
+    for (int i = 0; i < scene->numBrushes; ++i) {
+        scene->brushClassOrder[brush_counts[scene->brushes[i].classId]++] = i;
+    }
+
+    int logic_counts[ENTITY_CLASS_COUNT] = { 0 };
+    for (int i = 0; i < scene->numLogicEntities; ++i) {
+        LogicEntity* ent = &scene->logicEntities[i];
+        ent->classId = EntityClass_FromName(ent->classname);
+        LogicEntity_ParseComponent(ent);
+        logic_counts[ent->classId]++;
+    }
+    scene->logicClassStart[0] = 0;
+    for (int c = 0; c < ENTITY_CLASS_COUNT; ++c) {
+        scene->logicClassStart[c + 1] = scene->logicClassStart[c] + logic_counts[c];
+        logic_counts[c] = scene->logicClassStart[c];
+    }
+    for (int i = 0; i < scene->numLogicEntities; ++i) {
+        scene->logicClassOrder[logic_counts[scene->logicEntities[i].classId]++] = i;
+    }
+
+    IO_RebuildIndex(scene);
+    TriggerVolumes_MarkDirty();
+    scene->entityClassesDirty = false;
+    scene->entityClassesGeneration = ++generation;
+}
+
+void Scene_MarkEntityClassesDirty(Scene* scene) {
+    scene->entityClassesDirty = true;
+}
+
+int Scene_GetBrushesOfClass(const Scene* scene, EntityClassId id, const int** indices_out) {
+    int start = scene->brushClassStart[id];
+    *indices_out = &scene->brushClassOrder[start];
+    return scene->brushClassStart[id + 1] - start;
+}
+
+int Scene_GetEntityBrushes(const Scene* scene, const int** indices_out) {
+    int start = scene->brushClassStart[ENTITY_CLASS_NONE + 1];
+    *indices_out = &scene->brushClassOrder[start];
+    return scene->brushClassStart[ENTITY_CLASS_COUNT] - start;
+}
+
+int Scene_GetLogicEntitiesOfClass(const Scene* scene, EntityClassId id, const int** indices_out) {
+    int start = scene->logicClassStart[id];
+    *indices_out = &scene->logicClassOrder[start];
+    return scene->logicClassStart[id + 1] - start;
+}
+
+LogicEntity* Scene_FindActiveLogicEntity(Scene* scene, EntityClassId id) {
+    for (int k = scene->logicClassStart[id]; k < scene->logicClassStart[id + 1]; ++k) {
+        LogicEntity* ent = &scene->logicEntities[scene->logicClassOrder[k]];
+        if (ent->runtime_active) return ent;
+    }
+    return NULL;
+}
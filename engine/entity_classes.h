@@ -0,0 +1,261 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 Soft Sprint Studios
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+#ifndef ENTITY_CLASSES_H
+#define ENTITY_CLASSES_H
+
+//----------------------------------------//
+// Brief: Interned entity classnames and their typed components
+//----------------------------------------//
+
+#include <stdbool.h>
+#include "math_lib.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ENTITY_TARGET_LENGTH 64
+
+    // Every classname the engine gives behaviour to. Brushes and logic
+    // entities share the one id space. Classnames the engine does not know
+    // about map to ENTITY_CLASS_UNKNOWN, an empty classname to ENTITY_CLASS_NONE.
+    typedef enum {
+        ENTITY_CLASS_NONE,
+        ENTITY_CLASS_UNKNOWN,
+
+        ENTITY_CLASS_FUNC_BUTTON,
+        ENTITY_CLASS_FUNC_DOOR,
+        ENTITY_CLASS_FUNC_HEALTHCHARGER,
+        ENTITY_CLASS_FUNC_WATER,
+        ENTITY_CLASS_FUNC_FRICTION,
+        ENTITY_CLASS_FUNC_CONVEYOR,
+        ENTITY_CLASS_FUNC_LADDER,
+        ENTITY_CLASS_FUNC_WALL_TOGGLE,
+        ENTITY_CLASS_FUNC_ROTATING,
+        ENTITY_CLASS_FUNC_PLAT,
+        ENTITY_CLASS_FUNC_PENDULUM,
+        ENTITY_CLASS_FUNC_WEIGHT_BUTTON,
+        ENTITY_CLASS_FUNC_CLIP,
+        ENTITY_CLASS_FUNC_LOD,
+        ENTITY_CLASS_FUNC_ILLUSIONARY,
+        ENTITY_CLASS_FUNC_REFLECTIVE_GLASS,
+        ENTITY_CLASS_ENV_GLASS,
+        ENTITY_CLASS_ENV_REFLECTIONPROBE,
+        ENTITY_CLASS_TRIGGER,
+        ENTITY_CLASS_TRIGGER_ONCE,
+        ENTITY_CLASS_TRIGGER_MULTIPLE,
+        ENTITY_CLASS_TRIGGER_TELEPORT,
+        ENTITY_CLASS_TRIGGER_CAMERA,
+        ENTITY_CLASS_TRIGGER_PARALYZEPLAYER,
+        ENTITY_CLASS_TRIGGER_AUTOSAVE,
+        ENTITY_CLASS_TRIGGER_HURT,
+        ENTITY_CLASS_TRIGGER_KILLPLAYER,
+        ENTITY_CLASS_TRIGGER_GRAVITY,
+        ENTITY_CLASS_TRIGGER_DSPZONE,
+        ENTITY_CLASS_TRIGGER_KEYPAD,
+
+        ENTITY_CLASS_LOGIC_TIMER,
+        ENTITY_CLASS_LOGIC_RANDOM,
+        ENTITY_CLASS_LOGIC_REPEAT,
+        ENTITY_CLASS_LOGIC_RELAY,
+        ENTITY_CLASS_LOGIC_COMPARE,
+        ENTITY_CLASS_LOGIC_BRANCH,
+        ENTITY_CLASS_LOGIC_AUTO,
+        ENTITY_CLASS_MATH_COUNTER,
+        ENTITY_CLASS_ENV_BLACKHOLE,
+        ENTITY_CLASS_ENV_FADE,
+        ENTITY_CLASS_ENV_FOG,
+        ENTITY_CLASS_ENV_CABLE,
+        ENTITY_CLASS_ENV_SHAKE,
+        ENTITY_CLASS_ENV_BEAM,
+        ENTITY_CLASS_ENV_GLOW,
+        ENTITY_CLASS_ENV_OVERLAY,
+        ENTITY_CLASS_INFO_TARGET,
+        ENTITY_CLASS_POINT_SERVERCOMMAND,
+        ENTITY_CLASS_GAME_END,
+
+        ENTITY_CLASS_COUNT
+    } EntityClassId;
+
+    // Brush components hold the parsed form of the properties the per-frame
+    // systems read. They are rebuilt from the KeyValue properties whenever
+    // those change, so the properties stay the source of truth.
+    typedef struct {
+        bool locked;
+        float delay;
+    } ButtonComponent;
+
+    typedef struct {
+        bool openOnUse;
+        bool startOpen;
+        float speed;
+        float distance;
+        Vec3 moveAngles;
+    } DoorComponent;
+
+    typedef struct {
+        float healAmount;
+    } HealthChargerComponent;
+
+    typedef struct {
+        float delay;
+    } TouchTriggerComponent;
+
+    typedef struct {
+        char target[ENTITY_TARGET_LENGTH];
+    } TeleportComponent;
+
+    typedef struct {
+        char target[ENTITY_TARGET_LENGTH];
+        float moveTo;
+        float holdTime;
+    } CameraComponent;
+
+    typedef struct {
+        float damage;
+    } HurtComponent;
+
+    typedef struct {
+        float gravity;
+    } GravityComponent;
+
+    typedef struct {
+        int reverbPreset;
+    } DspZoneComponent;
+
+    typedef struct {
+        float modifier;
+    } FrictionComponent;
+
+    typedef struct {
+        float speed;
+        Vec3 velocity;
+    } ConveyorComponent;
+
+    typedef struct {
+        bool startOn;
+    } WallToggleComponent;
+
+    typedef struct {
+        bool useAccel;
+        float friction;
+        float speed;
+        Vec3 axis;
+    } RotatingComponent;
+
+    typedef struct {
+        float speed;
+        float wait;
+        bool isTrigger;
+    } PlatComponent;
+
+    typedef struct {
+        bool startOn;
+        float speed;
+        float distance;
+        Vec3 swingAngles;
+    } PendulumComponent;
+
+    typedef struct {
+        float weight;
+    } WeightButtonComponent;
+
+    typedef union {
+        ButtonComponent button;
+        DoorComponent door;
+        HealthChargerComponent healthCharger;
+        TouchTriggerComponent touch;
+        TeleportComponent teleport;
+        CameraComponent camera;
+        HurtComponent hurt;
+        GravityComponent gravity;
+        DspZoneComponent dspZone;
+        FrictionComponent friction;
+        ConveyorComponent conveyor;
+        WallToggleComponent wallToggle;
+        RotatingComponent rotating;
+        PlatComponent plat;
+        PendulumComponent pendulum;
+        WeightButtonComponent weightButton;
+    } BrushComponent;
+
+    typedef struct {
+        int repeat;
+        float delay;
+    } TimerComponent;
+
+    typedef struct {
+        float minTime;
+        float maxTime;
+    } RandomComponent;
+
+    typedef struct {
+        float delay;
+    } RepeatComponent;
+
+    typedef struct {
+        float rotationSpeed;
+    } BlackholeComponent;
+
+    typedef struct {
+        float duration;
+        float holdTime;
+        float targetAlpha;
+    } FadeComponent;
+
+    typedef struct {
+        Vec3 color;
+        float start;
+        float end;
+    } FogComponent;
+
+    typedef struct {
+        char target[ENTITY_TARGET_LENGTH];
+        float depth;
+        float width;
+        int segments;
+        float windAmount;
+        float windSpeed;
+        Vec3 windDir;
+    } CableComponent;
+
+    typedef union {
+        TimerComponent timer;
+        RandomComponent random;
+        RepeatComponent repeat;
+        BlackholeComponent blackhole;
+        FadeComponent fade;
+        FogComponent fog;
+        CableComponent cable;
+    } LogicComponent;
+
+    EntityClassId EntityClass_FromName(const char* classname);
+    const char* EntityClass_GetName(EntityClassId id);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ENTITY_CLASSES_H
\ No newline at end of file
@@ -25,11 +25,30 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <ctype.h>
 #include "gl_console.h"
+#include "content_cache.h"
+
+#define TGD_COMPILED_MAGIC "TGDC"
+#define TGD_COMPILED_VERSION 1
+#define TGD_HASH_SIZE 512
+
+typedef struct {
+    int num_entity_defs;
+    int num_choices;
+} TGD_CompiledCounts;
 
 static TGD_EntityDef g_entity_defs[MAX_TGD_ENTITIES];
 static int g_num_entity_defs = 0;
 
+// All choice lists share one pool, laid out in entity/property order so the
+// per-property pointers can be rebuilt from num_choices alone.
+static TGD_Choice* g_choice_pool = NULL;
+static int g_num_choices = 0;
+static int g_choice_capacity = 0;
+
+static short g_entity_hash[TGD_HASH_SIZE];
+
 static const char** g_brush_classnames = NULL;
 static int g_num_brush_classnames = 0;
 
@@ -52,11 +71,115 @@ static TGD_PropertyType string_to_prop_type(const char* type_str) {
     return TGD_PROP_STRING;
 }
 
-void GameData_Init(const char* filepath) {
+static unsigned int hash_classname_nocase(const char* s) {
+    unsigned int h = 2166136261u;
+    while (*s) {
+        h ^= (unsigned char)tolower((unsigned char)*s++);
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static void build_entity_hash(void) {
+    memset(g_entity_hash, 0, sizeof(g_entity_hash));
+    for (int i = 0; i < g_num_entity_defs; ++i) {
+        unsigned int slot = hash_classname_nocase(g_entity_defs[i].classname) & (TGD_HASH_SIZE - 1);
+        while (g_entity_hash[slot] != 0) {
+            if (_stricmp(g_entity_defs[g_entity_hash[slot] - 1].classname, g_entity_defs[i].classname) == 0) break;
+            slot = (slot + 1) & (TGD_HASH_SIZE - 1);
+        }
+        // First definition wins on duplicates, matching the old linear search.
+        if (g_entity_hash[slot] == 0) g_entity_hash[slot] = (short)(i + 1);
+    }
+}
+
+static void push_choice(const TGD_Choice* choice) {
+    if (g_num_choices >= g_choice_capacity) {
+        int new_capacity = g_choice_capacity ? g_choice_capacity * 2 : 64;
+        TGD_Choice* pool = (TGD_Choice*)realloc(g_choice_pool, new_capacity * sizeof(TGD_Choice));
+        if (!pool) return;
+        g_choice_pool = pool;
+        g_choice_capacity = new_capacity;
+    }
+    g_choice_pool[g_num_choices++] = *choice;
+}
+
+static void link_choice_pool(void) {
+    int offset = 0;
+    for (int i = 0; i < g_num_entity_defs; ++i) {
+        for (int j = 0; j < g_entity_defs[i].num_properties; ++j) {
+            TGD_Property* prop = &g_entity_defs[i].properties[j];
+            prop->choices = prop->num_choices > 0 ? &g_choice_pool[offset] : NULL;
+            offset += prop->num_choices;
+        }
+    }
+}
+
+static bool load_compiled(const char* filepath) {
+    size_t size = 0;
+    unsigned char* data = (unsigned char*)ContentCache_LoadCompiled(filepath, TGD_COMPILED_MAGIC, TGD_COMPILED_VERSION, &size);
+    if (!data) return false;
+
+    TGD_CompiledCounts counts;
+    bool valid = size >= sizeof(counts);
+    if (valid) {
+        memcpy(&counts, data, sizeof(counts));
+        valid = counts.num_entity_defs >= 0 && counts.num_entity_defs <= MAX_TGD_ENTITIES && counts.num_choices >= 0 &&
+            size == sizeof(counts) + (size_t)counts.num_entity_defs * sizeof(TGD_EntityDef) + (size_t)counts.num_choices * sizeof(TGD_Choice);
+    }
+    if (valid && counts.num_choices > 0) {
+        g_choice_pool = (TGD_Choice*)malloc(counts.num_choices * sizeof(TGD_Choice));
+        valid = g_choice_pool != NULL;
+    }
+    if (valid) {
+        const unsigned char* cursor = data + sizeof(counts);
+        memcpy(g_entity_defs, cursor, counts.num_entity_defs * sizeof(TGD_EntityDef));
+        cursor += counts.num_entity_defs * sizeof(TGD_EntityDef);
+        if (counts.num_choices > 0) memcpy(g_choice_pool, cursor, counts.num_choices * sizeof(TGD_Choice));
+        g_num_entity_defs = counts.num_entity_defs;
+        g_num_choices = g_choice_capacity = counts.num_choices;
+
+        int expected = 0;
+        for (int i = 0; i < g_num_entity_defs; ++i) {
+            TGD_EntityDef* def = &g_entity_defs[i];
+            if (def->num_properties < 0 || def->num_properties > MAX_TGD_PROPERTIES) { valid = false; break; }
+            for (int j = 0; j < def->num_properties; ++j) expected += def->properties[j].num_choices;
+        }
+        valid = valid && expected == g_num_choices;
+    }
+    free(data);
+
+    if (!valid) {
+        free(g_choice_pool);
+        g_choice_pool = NULL;
+        g_num_choices = g_choice_capacity = 0;
+        g_num_entity_defs = 0;
+        return false;
+    }
+    link_choice_pool();
+    return true;
+}
+
+static void save_compiled(const char* filepath) {
+    TGD_CompiledCounts counts = { g_num_entity_defs, g_num_choices };
+    size_t size = sizeof(counts) + (size_t)g_num_entity_defs * sizeof(TGD_EntityDef) + (size_t)g_num_choices * sizeof(TGD_Choice);
+    unsigned char* data = (unsigned char*)malloc(size);
+    if (!data) return;
+    unsigned char* cursor = data;
+    memcpy(cursor, &counts, sizeof(counts));
+    cursor += sizeof(counts);
+    memcpy(cursor, g_entity_defs, g_num_entity_defs * sizeof(TGD_EntityDef));
+    cursor += g_num_entity_defs * sizeof(TGD_EntityDef);
+    if (g_num_choices > 0) memcpy(cursor, g_choice_pool, g_num_choices * sizeof(TGD_Choice));
+    ContentCache_SaveCompiled(filepath, TGD_COMPILED_MAGIC, TGD_COMPILED_VERSION, data, size);
+    free(data);
+}
+
+static bool parse_tgd(const char* filepath) {
     FILE* file = fopen(filepath, "r");
     if (!file) {
         Console_Printf_Error("Could not open TGD file: %s", filepath);
-        return;
+        return false;
     }
 
     char line[1024];
@@ -109,9 +232,9 @@ void GameData_Init(const char* filepath) {
                             while (fgets(next_line, sizeof(next_line), file) && trim(next_line)[0] != ']') {
                                 TGD_Choice choice;
                                 if (sscanf(trim(next_line), "%63s : \"%127[^\"]\"", choice.value, choice.display_name) == 2) {
-                                    prop->num_choices++;
-                                    prop->choices = (TGD_Choice*)realloc(prop->choices, prop->num_choices * sizeof(TGD_Choice));
-                                    prop->choices[prop->num_choices - 1] = choice;
+                                    int before = g_num_choices;
+                                    push_choice(&choice);
+                                    if (g_num_choices > before) prop->num_choices++;
                                 }
                             }
                         }
@@ -124,6 +247,17 @@ void GameData_Init(const char* filepath) {
         }
     }
     fclose(file);
+    link_choice_pool();
+    return true;
+}
+
+void GameData_Init(const char* filepath) {
+    bool from_cache = load_compiled(filepath);
+    if (!from_cache) {
+        if (!parse_tgd(filepath)) return;
+        save_compiled(filepath);
+    }
+    build_entity_hash();
 
     g_num_brush_classnames = 1;
     g_num_logic_classnames = 0;
@@ -149,19 +283,19 @@ void GameData_Init(const char* filepath) {
         }
     }
 
-    Console_Printf("Loaded %d entity definitions from TGD.", g_num_entity_defs);
+    Console_Printf("Loaded %d entity definitions from %s.", g_num_entity_defs, from_cache ? "compiled TGD cache" : "TGD");
 }
 
 void GameData_Shutdown(void) {
-    for (int i = 0; i < g_num_entity_defs; ++i) {
-        for (int j = 0; j < g_entity_defs[i].num_properties; ++j) {
-            if (g_entity_defs[i].properties[j].choices) {
-                free(g_entity_defs[i].properties[j].choices);
-            }
-        }
-    }
+    free(g_choice_pool);
+    g_choice_pool = NULL;
+    g_num_choices = 0;
+    g_choice_capacity = 0;
+    memset(g_entity_hash, 0, sizeof(g_entity_hash));
     if (g_brush_classnames) free(g_brush_classnames);
     if (g_logic_classnames) free(g_logic_classnames);
+    g_brush_classnames = NULL;
+    g_logic_classnames = NULL;
     g_num_entity_defs = 0;
     g_num_brush_classnames = 0;
     g_num_logic_classnames = 0;
@@ -169,10 +303,11 @@ void GameData_Shutdown(void) {
 
 const TGD_EntityDef* GameData_FindEntityDef(const char* classname) {
     if (!classname || classname[0] == '\0') return NULL;
-    for (int i = 0; i < g_num_entity_defs; ++i) {
-        if (_stricmp(g_entity_defs[i].classname, classname) == 0) {
-            return &g_entity_defs[i];
-        }
+    unsigned int slot = hash_classname_nocase(classname) & (TGD_HASH_SIZE - 1);
+    while (g_entity_hash[slot] != 0) {
+        const TGD_EntityDef* def = &g_entity_defs[g_entity_hash[slot] - 1];
+        if (_stricmp(def->classname, classname) == 0) return def;
+        slot = (slot + 1) & (TGD_HASH_SIZE - 1);
     }
     return NULL;
 }
@@ -23,46 +23,58 @@
  */
 #include "gl_beams.h"
 #include "gl_misc.h"
+#include "gl_stream_buffer.h"
 #include "io_system.h"
 #include "cvar.h"
 
 static GLuint g_beam_shader = 0;
 static GLuint g_beam_vao = 0;
-static GLuint g_beam_vbo = 0;
+
+typedef struct {
+    Vec3 pos;
+    float u, v;
+    Vec3 color;
+} BeamVertex;
 
 void Beams_Init(void) {
     g_beam_shader = createShaderProgram("shaders/beam.vert", "shaders/beam.frag");
     glGenVertexArrays(1, &g_beam_vao);
-    glGenBuffers(1, &g_beam_vbo);
     glBindVertexArray(g_beam_vao);
-    glBindBuffer(GL_ARRAY_BUFFER, g_beam_vbo);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 6 * 5, NULL, GL_DYNAMIC_DRAW);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
+    glBindBuffer(GL_ARRAY_BUFFER, StreamBuffer_GetVertexBuffer());
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(BeamVertex), (void*)offsetof(BeamVertex, pos));
     glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(BeamVertex), (void*)offsetof(BeamVertex, u));
     glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(BeamVertex), (void*)offsetof(BeamVertex, color));
+    glEnableVertexAttribArray(2);
     glBindVertexArray(0);
 }
 
 void Beams_Shutdown(void) {
     if (g_beam_shader) glDeleteProgram(g_beam_shader);
     if (g_beam_vao) glDeleteVertexArrays(1, &g_beam_vao);
-    if (g_beam_vbo) glDeleteBuffers(1, &g_beam_vbo);
 }
 
-void Beams_Render(Scene* scene, Mat4 view, Mat4 projection, Vec3 cameraPos, float time) {
-    glUseProgram(g_beam_shader);
-    glUniformMatrix4fv(glGetUniformLocation(g_beam_shader, "view"), 1, GL_FALSE, view.m);
-    glUniformMatrix4fv(glGetUniformLocation(g_beam_shader, "projection"), 1, GL_FALSE, projection.m);
-    glUniform1f(glGetUniformLocation(g_beam_shader, "u_time"), time);
+static void beam_vertex(BeamVertex* out, Vec3 pos, float u, float v, Vec3 color) {
+    out->pos = pos;
+    out->u = u;
+    out->v = v;
+    out->color = color;
+}
 
-    glDepthMask(GL_FALSE);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+void Beams_Render(Scene* scene, Mat4 view, Mat4 projection, Vec3 cameraPos, float time) {
+    int num_beams = 0;
+    for (int i = 0; i < scene->numLogicEntities; ++i) {
+        LogicEntity* ent = &scene->logicEntities[i];
+        if (strcmp(ent->classname, "env_beam") == 0 && ent->runtime_active) num_beams++;
+    }
+    if (num_beams == 0) return;
 
-    glBindVertexArray(g_beam_vao);
-    glBindBuffer(GL_ARRAY_BUFFER, g_beam_vbo);
+    GLint first_vertex = 0;
+    BeamVertex* vertices = (BeamVertex*)StreamBuffer_AllocVertices(num_beams * 6, sizeof(BeamVertex), &first_vertex);
+    if (!vertices) return;
 
+    int vertex_count = 0;
     for (int i = 0; i < scene->numLogicEntities; ++i) {
         LogicEntity* ent = &scene->logicEntities[i];
         if (strcmp(ent->classname, "env_beam") == 0 && ent->runtime_active) {
@@ -76,29 +88,36 @@ void Beams_Render(Scene* scene, Mat4 view, Mat4 projection, Vec3 cameraPos, floa
                 Vec3 color;
                 sscanf(LogicEntity_GetProperty(ent, "color", "1.0 1.0 1.0"), "%f %f %f", &color.x, &color.y, &color.z);
 
-                glUniform3fv(glGetUniformLocation(g_beam_shader, "u_color"), 1, &color.x);
-
                 Vec3 view_vec = vec3_sub(start_pos, cameraPos);
                 Vec3 beam_dir = vec3_sub(end_pos, start_pos);
                 Vec3 right = vec3_cross(beam_dir, view_vec);
                 vec3_normalize(&right);
                 right = vec3_muls(right, width * 0.5f);
 
-                float vertices[] = {
-                    start_pos.x - right.x, start_pos.y - right.y, start_pos.z - right.z, 0.0f, 0.0f,
-                    start_pos.x + right.x, start_pos.y + right.y, start_pos.z + right.z, 1.0f, 0.0f,
-                    end_pos.x + right.x,   end_pos.y + right.y,   end_pos.z + right.z,   1.0f, 1.0f,
-
-                    end_pos.x + right.x,   end_pos.y + right.y,   end_pos.z + right.z,   1.0f, 1.0f,
-                    end_pos.x - right.x,   end_pos.y - right.y,   end_pos.z - right.z,   0.0f, 1.0f,
-                    start_pos.x - right.x, start_pos.y - right.y, start_pos.z - right.z, 0.0f, 0.0f
-                };
-
-                glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
-                glDrawArrays(GL_TRIANGLES, 0, 6);
+                BeamVertex* v = &vertices[vertex_count];
+                beam_vertex(&v[0], vec3_sub(start_pos, right), 0.0f, 0.0f, color);
+                beam_vertex(&v[1], vec3_add(start_pos, right), 1.0f, 0.0f, color);
+                beam_vertex(&v[2], vec3_add(end_pos, right), 1.0f, 1.0f, color);
+                beam_vertex(&v[3], vec3_add(end_pos, right), 1.0f, 1.0f, color);
+                beam_vertex(&v[4], vec3_sub(end_pos, right), 0.0f, 1.0f, color);
+                beam_vertex(&v[5], vec3_sub(start_pos, right), 0.0f, 0.0f, color);
+                vertex_count += 6;
             }
         }
     }
+    if (vertex_count == 0) return;
+
+    glUseProgram(g_beam_shader);
+    glUniformMatrix4fv(glGetUniformLocation(g_beam_shader, "view"), 1, GL_FALSE, view.m);
+    glUniformMatrix4fv(glGetUniformLocation(g_beam_shader, "projection"), 1, GL_FALSE, projection.m);
+    glUniform1f(glGetUniformLocation(g_beam_shader, "u_time"), time);
+
+    glDepthMask(GL_FALSE);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+
+    glBindVertexArray(g_beam_vao);
+    glDrawArrays(GL_TRIANGLES, first_vertex, vertex_count);
 
     glBindVertexArray(0);
     glDisable(GL_BLEND);
@@ -23,30 +23,45 @@
  */
 #include "gl_bloom.h"
 #include "gl_renderer.h"
+#include "gl_misc.h"
+
+// Bloom is built in a half-resolution mip chain. The lit scene is thresholded
+// and filtered down one level at a time with a 13-tap kernel, then every level
+// is tent-upsampled and added into the one above it. Level 0 ends up holding
+// the glow of the whole chain, which post-processing samples directly.
+
+#define BLOOM_THRESHOLD 0.5f
+#define BLOOM_UPSAMPLE_RADIUS 1.0f
+
+static void bloom_dispatch(Engine* engine, int mip) {
+    GL_DispatchCompute2D((engine->width / 2) >> mip, (engine->height / 2) >> mip);
+}
 
 void Bloom_RenderPass(Renderer* renderer, Engine* engine) {
-    glUseProgram(renderer->bloomShader); 
-    glBindFramebuffer(GL_FRAMEBUFFER, renderer->bloomFBO);
-    glViewport(0, 0, engine->width / BLOOM_DOWNSAMPLE, engine->height / BLOOM_DOWNSAMPLE);
-    glActiveTexture(GL_TEXTURE0); 
-    glBindTexture(GL_TEXTURE_2D, renderer->gLitColor);
-    glBindVertexArray(renderer->quadVAO); 
-    glDrawArrays(GL_TRIANGLES, 0, 6);
-    
-    bool horizontal = true, first_iteration = true; 
-    unsigned int amount = 10; 
-    glUseProgram(renderer->bloomBlurShader);
-    
-    for (unsigned int i = 0; i < amount; i++) {
-        glBindFramebuffer(GL_FRAMEBUFFER, renderer->pingpongFBO[horizontal]); 
-        glUniform1i(glGetUniformLocation(renderer->bloomBlurShader, "horizontal"), horizontal);
-        glActiveTexture(GL_TEXTURE0); 
-        glBindTexture(GL_TEXTURE_2D, first_iteration ? renderer->bloomBrightnessTexture : renderer->pingpongColorbuffers[!horizontal]);
-        glBindVertexArray(renderer->quadVAO); 
-        glDrawArrays(GL_TRIANGLES, 0, 6);
-        horizontal = !horizontal; 
-        if (first_iteration) first_iteration = false;
+    glUseProgram(renderer->bloomDownsampleShader);
+    glUniform1f(glGetUniformLocation(renderer->bloomDownsampleShader, "u_threshold"), BLOOM_THRESHOLD);
+    glActiveTexture(GL_TEXTURE0);
+    for (int mip = 0; mip < renderer->bloomMipCount; ++mip) {
+        bool prefilter = (mip == 0);
+        glBindTexture(GL_TEXTURE_2D, prefilter ? renderer->gLitColor : renderer->bloomTexture);
+        glBindSampler(0, prefilter ? renderer->bloomLinearSampler : 0);
+        glUniform1i(glGetUniformLocation(renderer->bloomDownsampleShader, "u_prefilter"), prefilter);
+        glUniform1f(glGetUniformLocation(renderer->bloomDownsampleShader, "u_sourceLod"), prefilter ? 0.0f : (float)(mip - 1));
+        glBindImageTexture(0, renderer->bloomTexture, mip, GL_FALSE, 0, GL_WRITE_ONLY, GL_R11F_G11F_B10F);
+        bloom_dispatch(engine, mip);
     }
-    glViewport(0, 0, engine->width, engine->height);
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glBindSampler(0, 0);
+
+    glUseProgram(renderer->bloomUpsampleShader);
+    glUniform1f(glGetUniformLocation(renderer->bloomUpsampleShader, "u_radius"), BLOOM_UPSAMPLE_RADIUS);
+    glBindTexture(GL_TEXTURE_2D, renderer->bloomTexture);
+    for (int mip = renderer->bloomMipCount - 2; mip >= 0; --mip) {
+        glUniform1f(glGetUniformLocation(renderer->bloomUpsampleShader, "u_sourceLod"), (float)(mip + 1));
+        glUniform1f(glGetUniformLocation(renderer->bloomUpsampleShader, "u_scale"), mip == 0 ? 1.0f / (float)renderer->bloomMipCount : 1.0f);
+        glBindImageTexture(0, renderer->bloomTexture, mip, GL_FALSE, 0, GL_READ_WRITE, GL_R11F_G11F_B10F);
+        bloom_dispatch(engine, mip);
+    }
+
+    glBindImageTexture(0, 0, 0, GL_FALSE, 0, GL_READ_WRITE, GL_R11F_G11F_B10F);
+    glBindTexture(GL_TEXTURE_2D, 0);
 }
\ No newline at end of file
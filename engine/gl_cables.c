@@ -23,19 +23,19 @@
  */
 #include "map.h"
 #include "gl_misc.h"
+#include "gl_stream_buffer.h"
 #include "io_system.h"
 #include <stdlib.h>
 
 static GLuint g_cable_shader = 0;
 static GLuint g_cable_vao = 0;
-static GLuint g_cable_vbo = 0;
 
 void Cable_Init(void) {
     g_cable_shader = createShaderProgram("shaders/cable.vert", "shaders/cable.frag");
     glGenVertexArrays(1, &g_cable_vao);
-    glGenBuffers(1, &g_cable_vbo);
     glBindVertexArray(g_cable_vao);
-    glBindBuffer(GL_ARRAY_BUFFER, g_cable_vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, StreamBuffer_GetVertexBuffer());
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, StreamBuffer_GetIndexBuffer());
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
     glEnableVertexAttribArray(0);
     glBindVertexArray(0);
@@ -44,7 +44,6 @@ void Cable_Init(void) {
 void Cable_Shutdown(void) {
     if (g_cable_shader) glDeleteProgram(g_cable_shader);
     if (g_cable_vao) glDeleteVertexArrays(1, &g_cable_vao);
-    if (g_cable_vbo) glDeleteBuffers(1, &g_cable_vbo);
 }
 
 static Vec3 get_bezier_point(float t, Vec3 p0, Vec3 p1, Vec3 p2) {
@@ -58,6 +57,94 @@ static Vec3 get_bezier_point(float t, Vec3 p0, Vec3 p1, Vec3 p2) {
 }
 
 void Cable_Render(Scene* scene, Mat4 view, Mat4 projection, Vec3 cameraPos, float time) {
+    const int* cables;
+    int num_cables = Scene_GetLogicEntitiesOfClass(scene, ENTITY_CLASS_ENV_CABLE, &cables);
+    if (num_cables == 0) return;
+
+    // All cables go into one indexed triangle list, the strips are unrolled so
+    // separate cables don't need restart indices or degenerate triangles.
+    int max_vertices = 0;
+    int max_indices = 0;
+    for (int k = 0; k < num_cables; ++k) {
+        int segments = scene->logicEntities[cables[k]].comp.cable.segments;
+        if (segments <= 0) continue;
+        max_vertices += (segments + 1) * 2;
+        max_indices += segments * 6;
+    }
+    if (max_vertices == 0) return;
+
+    GLint first_vertex = 0;
+    size_t index_offset = 0;
+    Vec3* vertices = (Vec3*)StreamBuffer_AllocVertices(max_vertices, sizeof(Vec3), &first_vertex);
+    GLuint* indices = StreamBuffer_AllocIndices(max_indices, &index_offset);
+    if (!vertices || !indices) return;
+
+    int vertex_count = 0;
+    int index_count = 0;
+    for (int k = 0; k < num_cables; ++k) {
+        LogicEntity* ent = &scene->logicEntities[cables[k]];
+        const CableComponent* cable = &ent->comp.cable;
+        Vec3 end_pos;
+        Vec3 end_angles_dummy;
+
+        if (cable->segments > 0 && IO_FindNamedEntity(scene, cable->target, &end_pos, &end_angles_dummy)) {
+            Vec3 start_pos = ent->pos;
+            float depth = cable->depth;
+            float width = cable->width;
+            int segments = cable->segments;
+            float wind_amount = cable->windAmount;
+            float wind_speed = cable->windSpeed;
+
+            Vec3 control_pos = vec3_muls(vec3_add(start_pos, end_pos), 0.5f);
+            control_pos.y -= depth;
+
+            if (wind_amount > 0.0f) {
+                float sway1 = sin(time * wind_speed * 1.0f) * wind_amount * 0.6f;
+                float sway2 = sin(time * wind_speed * 0.45f + 1.23f) * wind_amount * 0.4f;
+                Vec3 wind_offset = vec3_muls(cable->windDir, sway1 + sway2);
+                control_pos = vec3_add(control_pos, wind_offset);
+            }
+
+            int base = vertex_count;
+            for (int j = 0; j <= segments; ++j) {
+                float t = (float)j / (float)segments;
+                Vec3 p = get_bezier_point(t, start_pos, control_pos, end_pos);
+
+                Vec3 next_p;
+                if (j == segments) {
+                    float t_prev = (float)(j - 1) / (float)segments;
+                    Vec3 prev_p = get_bezier_point(t_prev, start_pos, control_pos, end_pos);
+                    next_p = vec3_add(p, vec3_sub(p, prev_p));
+                }
+                else {
+                    float t_next = (float)(j + 1) / (float)segments;
+                    next_p = get_bezier_point(t_next, start_pos, control_pos, end_pos);
+                }
+
+                Vec3 tangent = vec3_sub(next_p, p);
+                vec3_normalize(&tangent);
+                Vec3 view_vec = vec3_sub(p, cameraPos);
+                Vec3 right = vec3_cross(tangent, view_vec);
+                vec3_normalize(&right);
+                right = vec3_muls(right, width * 0.5f);
+
+                vertices[base + j * 2] = vec3_sub(p, right);
+                vertices[base + j * 2 + 1] = vec3_add(p, right);
+            }
+            for (int j = 0; j < segments; ++j) {
+                GLuint a = (GLuint)(base + j * 2);
+                indices[index_count++] = a;
+                indices[index_count++] = a + 1;
+                indices[index_count++] = a + 2;
+                indices[index_count++] = a + 2;
+                indices[index_count++] = a + 1;
+                indices[index_count++] = a + 3;
+            }
+            vertex_count += (segments + 1) * 2;
+        }
+    }
+    if (index_count == 0) return;
+
     glUseProgram(g_cable_shader);
     glUniformMatrix4fv(glGetUniformLocation(g_cable_shader, "view"), 1, GL_FALSE, view.m);
     glUniformMatrix4fv(glGetUniformLocation(g_cable_shader, "projection"), 1, GL_FALSE, projection.m);
@@ -67,76 +154,6 @@ void Cable_Render(Scene* scene, Mat4 view, Mat4 projection, Vec3 cameraPos, floa
     glDisable(GL_BLEND);
 
     glBindVertexArray(g_cable_vao);
-    glBindBuffer(GL_ARRAY_BUFFER, g_cable_vbo);
-
-    for (int i = 0; i < scene->numLogicEntities; ++i) {
-        LogicEntity* ent = &scene->logicEntities[i];
-        if (strcmp(ent->classname, "env_cable") == 0) {
-            const char* target_name = LogicEntity_GetProperty(ent, "Target", "");
-            Vec3 end_pos;
-            Vec3 end_angles_dummy;
-
-            if (IO_FindNamedEntity(scene, target_name, &end_pos, &end_angles_dummy)) {
-                Vec3 start_pos = ent->pos;
-                float depth = atof(LogicEntity_GetProperty(ent, "Depth", "20.0"));
-                float width = atof(LogicEntity_GetProperty(ent, "Width", "0.1"));
-                int segments = atoi(LogicEntity_GetProperty(ent, "Segments", "16"));
-                if (segments < 2) segments = 2;
-
-                float wind_amount = atof(LogicEntity_GetProperty(ent, "WindAmount", "5.0"));
-                float wind_speed = atof(LogicEntity_GetProperty(ent, "WindSpeed", "1.0"));
-                Vec3 wind_angles;
-                sscanf(LogicEntity_GetProperty(ent, "WindDirection", "0 0 0"), "%f %f %f", &wind_angles.x, &wind_angles.y, &wind_angles.z);
-
-                Vec3 control_pos = vec3_muls(vec3_add(start_pos, end_pos), 0.5f);
-                control_pos.y -= depth;
-
-                if (wind_amount > 0.0f) {
-                    Mat4 rot_mat = create_trs_matrix((Vec3) { 0, 0, 0 }, wind_angles, (Vec3) { 1, 1, 1 });
-                    Vec3 wind_dir = mat4_mul_vec3_dir(&rot_mat, (Vec3) { 1, 0, 0 });
-                    vec3_normalize(&wind_dir);
-
-                    float sway1 = sin(time * wind_speed * 1.0f) * wind_amount * 0.6f;
-                    float sway2 = sin(time * wind_speed * 0.45f + 1.23f) * wind_amount * 0.4f;
-                    Vec3 wind_offset = vec3_muls(wind_dir, sway1 + sway2);
-                    control_pos = vec3_add(control_pos, wind_offset);
-                }
-
-                int num_vertices = (segments + 1) * 2;
-                Vec3* vertices = (Vec3*)malloc(num_vertices * sizeof(Vec3));
-                if (!vertices) continue;
-
-                for (int j = 0; j <= segments; ++j) {
-                    float t = (float)j / (float)segments;
-                    Vec3 p = get_bezier_point(t, start_pos, control_pos, end_pos);
-
-                    Vec3 next_p;
-                    if (j == segments) {
-                        float t_prev = (float)(j - 1) / (float)segments;
-                        Vec3 prev_p = get_bezier_point(t_prev, start_pos, control_pos, end_pos);
-                        next_p = vec3_add(p, vec3_sub(p, prev_p));
-                    }
-                    else {
-                        float t_next = (float)(j + 1) / (float)segments;
-                        next_p = get_bezier_point(t_next, start_pos, control_pos, end_pos);
-                    }
-
-                    Vec3 tangent = vec3_sub(next_p, p);
-                    vec3_normalize(&tangent);
-                    Vec3 view_vec = vec3_sub(p, cameraPos);
-                    Vec3 right = vec3_cross(tangent, view_vec);
-                    vec3_normalize(&right);
-                    right = vec3_muls(right, width * 0.5f);
-
-                    vertices[j * 2] = vec3_sub(p, right);
-                    vertices[j * 2 + 1] = vec3_add(p, right);
-                }
-
-                glBufferData(GL_ARRAY_BUFFER, num_vertices * sizeof(Vec3), vertices, GL_STREAM_DRAW);
-                glDrawArrays(GL_TRIANGLE_STRIP, 0, num_vertices);
-                free(vertices);
-            }
-        }
-    }
+    glDrawElementsBaseVertex(GL_TRIANGLES, index_count, GL_UNSIGNED_INT, (void*)index_offset, first_vertex);
     glBindVertexArray(0);
 }
\ No newline at end of file
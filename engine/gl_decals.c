@@ -24,6 +24,20 @@
 #include "gl_decals.h"
 #include "texturemanager.h"
 
+#define DECAL_INSTANCE_LIGHTMAP             (1u << 0)
+#define DECAL_INSTANCE_DIRECTIONAL_LIGHTMAP (1u << 1)
+
+// Mirrors DecalInstance in main.vert/tes/frag (std430, 112 bytes).
+typedef struct {
+    Mat4 model;
+    unsigned int diffuseMap[2];
+    unsigned int normalMap[2];
+    unsigned int rmaMap[2];
+    unsigned int lightmap[2];
+    unsigned int directionalLightmap[2];
+    unsigned int flags[2];
+} DecalInstance;
+
 static float decalQuadVertices[] = {
     -0.5f, -0.5f, -0.5f,  -1.0f,  0.0f,  0.0f,   0.0f, 1.0f,      0.0f, -1.0f,  0.0f, 1.0f,    0.0f, 0.0f, 0.0f, 1.0f,   0.0f, 0.0f,    0.0f, 0.0f,    0.0f, 0.0f,
      0.5f, -0.5f, -0.5f,  -1.0f,  0.0f,  0.0f,   1.0f, 1.0f,      0.0f, -1.0f,  0.0f, 1.0f,    0.0f, 0.0f, 0.0f, 1.0f,   0.0f, 0.0f,    0.0f, 0.0f,    0.0f, 0.0f,
@@ -59,55 +73,73 @@ void Decals_Init(Renderer* renderer) {
     glVertexAttribPointer(8, 2, GL_FLOAT, GL_FALSE, stride, (void*)(6 * sizeof(float)));
     glEnableVertexAttribArray(8);
     glBindVertexArray(0);
+
+    glGenBuffers(1, &renderer->decalInstanceSSBO);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, renderer->decalInstanceSSBO);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, MAX_DECALS * sizeof(DecalInstance), NULL, GL_STREAM_DRAW);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
 }
 
 void Decals_Shutdown(Renderer* renderer) {
     if (renderer->decalVAO) glDeleteVertexArrays(1, &renderer->decalVAO);
     if (renderer->decalVBO) glDeleteBuffers(1, &renderer->decalVBO);
+    if (renderer->decalInstanceSSBO) glDeleteBuffers(1, &renderer->decalInstanceSSBO);
+}
+
+static void Decals_PackHandle(unsigned int out[2], GLuint64 handle) {
+    out[0] = (unsigned int)(handle & 0xFFFFFFFF);
+    out[1] = (unsigned int)(handle >> 32);
 }
 
 void Decals_Render(Scene* scene, Renderer* renderer, GLuint shader_program) {
+    if (scene->numDecals <= 0) return;
+
+    // Every decal becomes one instance: its matrix and bindless material and
+    // lightmap handles go into the decal SSBO, and main.vert picks them up by
+    // gl_InstanceID. Instances draw in scene order, so blending between
+    // overlapping decals matches the old per-decal loop.
+    static DecalInstance instances[MAX_DECALS];
+    int count = scene->numDecals < MAX_DECALS ? scene->numDecals : MAX_DECALS;
+    for (int i = 0; i < count; ++i) {
+        Decal* d = &scene->decals[i];
+        DecalInstance* inst = &instances[i];
+        memset(inst, 0, sizeof(*inst));
+        inst->model = d->modelMatrix;
+        Decals_PackHandle(inst->diffuseMap, GL_GetResidentTextureHandle(d->material->diffuseMap));
+        Decals_PackHandle(inst->normalMap, GL_GetResidentTextureHandle(d->material->normalMap));
+        Decals_PackHandle(inst->rmaMap, GL_GetResidentTextureHandle(d->material->rmaMap));
+        if (d->lightmapAtlas != 0 && d->lightmapAtlas != missingTextureID) {
+            Decals_PackHandle(inst->lightmap, GL_GetResidentTextureHandle(d->lightmapAtlas));
+            inst->flags[0] |= DECAL_INSTANCE_LIGHTMAP;
+        }
+        if (d->directionalLightmapAtlas != 0 && d->directionalLightmapAtlas != missingTextureID) {
+            Decals_PackHandle(inst->directionalLightmap, GL_GetResidentTextureHandle(d->directionalLightmapAtlas));
+            inst->flags[0] |= DECAL_INSTANCE_DIRECTIONAL_LIGHTMAP;
+        }
+    }
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, renderer->decalInstanceSSBO);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, MAX_DECALS * sizeof(DecalInstance), NULL, GL_STREAM_DRAW);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, count * sizeof(DecalInstance), instances);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, renderer->decalInstanceSSBO);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     glDepthMask(GL_FALSE);
 
     glUseProgram(shader_program);
-    
     glUniform1i(glGetUniformLocation(shader_program, "isBrush"), 1);
+    glUniform1i(glGetUniformLocation(shader_program, "u_decalInstanced"), 1);
+    glUniform1f(glGetUniformLocation(shader_program, "heightScale"), 0.0f);
+    glActiveTexture(GL_TEXTURE3); glBindTexture(GL_TEXTURE_2D, 0);
+    glActiveTexture(GL_TEXTURE7); glBindTexture(GL_TEXTURE_2D, 0);
     glPatchParameteri(GL_PATCH_VERTICES, 3);
 
-    for (int i = 0; i < scene->numDecals; ++i) {
-        Decal* d = &scene->decals[i];
-
-        glUniformMatrix4fv(glGetUniformLocation(shader_program, "model"), 1, GL_FALSE, d->modelMatrix.m);
-        glUniform1f(glGetUniformLocation(shader_program, "heightScale"), 0.0f);
-
-        glActiveTexture(GL_TEXTURE0); glBindTexture(GL_TEXTURE_2D, d->material->diffuseMap);
-        glActiveTexture(GL_TEXTURE1); glBindTexture(GL_TEXTURE_2D, d->material->normalMap);
-        glActiveTexture(GL_TEXTURE2); glBindTexture(GL_TEXTURE_2D, d->material->rmaMap);
-        glActiveTexture(GL_TEXTURE3); glBindTexture(GL_TEXTURE_2D, 0);
-        glActiveTexture(GL_TEXTURE7); glBindTexture(GL_TEXTURE_2D, 0);
-
-        bool has_lightmap = d->lightmapAtlas != 0 && d->lightmapAtlas != missingTextureID;
-        glUniform1i(glGetUniformLocation(shader_program, "useLightmap"), has_lightmap);
-        if (has_lightmap) {
-            glActiveTexture(GL_TEXTURE5);
-            glBindTexture(GL_TEXTURE_2D, d->lightmapAtlas);
-            glUniform1i(glGetUniformLocation(shader_program, "lightmap"), 5);
-        }
-
-        bool has_dir_lightmap = d->directionalLightmapAtlas != 0 && d->directionalLightmapAtlas != missingTextureID;
-        glUniform1i(glGetUniformLocation(shader_program, "useDirectionalLightmap"), has_dir_lightmap);
-        if (has_dir_lightmap) {
-            glActiveTexture(GL_TEXTURE6);
-            glBindTexture(GL_TEXTURE_2D, d->directionalLightmapAtlas);
-            glUniform1i(glGetUniformLocation(shader_program, "directionalLightmap"), 6);
-        }
-
-        glBindVertexArray(renderer->decalVAO);
-        glDrawArrays(GL_PATCHES, 0, 6);
-    }
+    glBindVertexArray(renderer->decalVAO);
+    glDrawArraysInstanced(GL_PATCHES, 0, 6, count);
 
+    glUniform1i(glGetUniformLocation(shader_program, "u_decalInstanced"), 0);
     glUniform1i(glGetUniformLocation(shader_program, "isBrush"), 0);
     glUniform1i(glGetUniformLocation(shader_program, "useLightmap"), 0);
     glUniform1i(glGetUniformLocation(shader_program, "useDirectionalLightmap"), 0);
@@ -344,6 +344,17 @@ void render_brush(Renderer* renderer, Scene* scene, GLuint shader, Brush* b, boo
     }
 }
 
+// Inputs for the screen-space tessellation levels and patch culling in
+// main.tcs and zprepass_tess.tcs. Both passes must agree or the prepass depth
+// will not match the shaded surface.
+void Geometry_SetTessellationUniforms(GLuint shader, Engine* engine) {
+    float triangle_size = Cvar_GetFloat("r_tess_triangle_size");
+    if (triangle_size < 1.0f) triangle_size = 1.0f;
+    glUniform2f(glGetUniformLocation(shader, "viewportSize"), (float)(engine->width / GEOMETRY_PASS_DOWNSAMPLE_FACTOR), (float)(engine->height / GEOMETRY_PASS_DOWNSAMPLE_FACTOR));
+    glUniform1f(glGetUniformLocation(shader, "u_tessTriangleSize"), triangle_size);
+    glUniform1i(glGetUniformLocation(shader, "u_tessCullBackfaces"), Cvar_GetInt("r_faceculling"));
+}
+
 void Geometry_RenderPass(Renderer* renderer, Scene* scene, Engine* engine, Mat4* view, Mat4* projection, const Mat4* sunLightSpaceMatrix, Vec3 cameraPos, bool unlit) {
     Frustum frustum;
     Mat4 view_proj;
@@ -384,7 +395,7 @@ void Geometry_RenderPass(Renderer* renderer, Scene* scene, Engine* engine, Mat4*
     glPatchParameteri(GL_PATCH_VERTICES, 3);
     glUniformMatrix4fv(glGetUniformLocation(renderer->mainShader, "view"), 1, GL_FALSE, view->m);
     glUniformMatrix4fv(glGetUniformLocation(renderer->mainShader, "projection"), 1, GL_FALSE, projection->m);
-    glUniform2f(glGetUniformLocation(renderer->mainShader, "viewportSize"), (float)(engine->width / GEOMETRY_PASS_DOWNSAMPLE_FACTOR), (float)(engine->height / GEOMETRY_PASS_DOWNSAMPLE_FACTOR));
+    Geometry_SetTessellationUniforms(renderer->mainShader, engine);
     glUniformMatrix4fv(glGetUniformLocation(renderer->mainShader, "prevViewProjection"), 1, GL_FALSE, renderer->prevViewProjection.m);
     glUniform3fv(glGetUniformLocation(renderer->mainShader, "viewPos"), 1, &cameraPos.x);
     glUniform1f(glGetUniformLocation(renderer->mainShader, "u_time"), engine->lastFrame);
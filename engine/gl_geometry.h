@@ -34,6 +34,7 @@ extern "C" {
 void Geometry_RenderPass(Renderer* renderer, Scene* scene, Engine* engine, Mat4* view, Mat4* projection, const Mat4* sunLightSpaceMatrix, Vec3 cameraPos, bool unlit);
 void render_object(Renderer* renderer, Scene* scene, GLuint shader, SceneObject* obj, bool is_baking_pass, const Frustum* frustum);
 void render_brush(Renderer* renderer, Scene* scene, GLuint shader, Brush* b, bool is_baking_pass, const Frustum* frustum);
+void Geometry_SetTessellationUniforms(GLuint shader, Engine* engine);
 
 #ifdef __cplusplus
 }
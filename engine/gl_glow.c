@@ -23,11 +23,11 @@
  */
 #include "gl_glow.h"
 #include "gl_misc.h"
+#include "gl_stream_buffer.h"
 #include "io_system.h"
 
 static GLuint g_glow_shader = 0;
 static GLuint g_glow_vao = 0;
-static GLuint g_glow_vbo = 0;
 
 typedef struct {
     Vec3 pos;
@@ -38,11 +38,9 @@ typedef struct {
 void Glow_Init(void) {
     g_glow_shader = createShaderProgramGeom("shaders/glow.vert", "shaders/glow.geom", "shaders/glow.frag");
     glGenVertexArrays(1, &g_glow_vao);
-    glGenBuffers(1, &g_glow_vbo);
     glBindVertexArray(g_glow_vao);
-    glBindBuffer(GL_ARRAY_BUFFER, g_glow_vbo);
-    glBufferData(GL_ARRAY_BUFFER, MAX_LOGIC_ENTITIES * sizeof(GlowVertex), NULL, GL_STREAM_DRAW);
-    
+    glBindBuffer(GL_ARRAY_BUFFER, StreamBuffer_GetVertexBuffer());
+
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(GlowVertex), (void*)offsetof(GlowVertex, pos));
     glEnableVertexAttribArray(1);
@@ -56,10 +54,31 @@ void Glow_Init(void) {
 void Glow_Shutdown(void) {
     if (g_glow_shader) glDeleteProgram(g_glow_shader);
     if (g_glow_vao) glDeleteVertexArrays(1, &g_glow_vao);
-    if (g_glow_vbo) glDeleteBuffers(1, &g_glow_vbo);
 }
 
 void Glow_Render(Scene* scene, Mat4 view, Mat4 projection) {
+    int glow_count = 0;
+    for (int i = 0; i < scene->numLogicEntities; ++i) {
+        LogicEntity* ent = &scene->logicEntities[i];
+        if (strcmp(ent->classname, "env_glow") == 0 && ent->runtime_active) glow_count++;
+    }
+    if (glow_count == 0) return;
+
+    GLint first_vertex = 0;
+    GlowVertex* vbo_data = (GlowVertex*)StreamBuffer_AllocVertices(glow_count, sizeof(GlowVertex), &first_vertex);
+    if (!vbo_data) return;
+
+    int written = 0;
+    for (int i = 0; i < scene->numLogicEntities && written < glow_count; ++i) {
+        LogicEntity* ent = &scene->logicEntities[i];
+        if (strcmp(ent->classname, "env_glow") == 0 && ent->runtime_active) {
+            GlowVertex* v = &vbo_data[written++];
+            v->pos = ent->pos;
+            v->size = atof(LogicEntity_GetProperty(ent, "glow_size", "10.0"));
+            sscanf(LogicEntity_GetProperty(ent, "color", "1.0 0.8 0.2"), "%f %f %f", &v->color.x, &v->color.y, &v->color.z);
+        }
+    }
+
     glUseProgram(g_glow_shader);
     glUniformMatrix4fv(glGetUniformLocation(g_glow_shader, "view"), 1, GL_FALSE, view.m);
     glUniformMatrix4fv(glGetUniformLocation(g_glow_shader, "projection"), 1, GL_FALSE, projection.m);
@@ -68,31 +87,10 @@ void Glow_Render(Scene* scene, Mat4 view, Mat4 projection) {
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE);
 
-    GlowVertex vbo_data[MAX_LOGIC_ENTITIES];
-    int glow_count = 0;
-
-    for (int i = 0; i < scene->numLogicEntities; ++i) {
-        LogicEntity* ent = &scene->logicEntities[i];
-        if (strcmp(ent->classname, "env_glow") == 0 && ent->runtime_active) {
-            if (glow_count >= MAX_LOGIC_ENTITIES) break;
-
-            vbo_data[glow_count].pos = ent->pos;
-            vbo_data[glow_count].size = atof(LogicEntity_GetProperty(ent, "glow_size", "10.0"));
-            sscanf(LogicEntity_GetProperty(ent, "color", "1.0 0.8 0.2"), "%f %f %f", 
-                   &vbo_data[glow_count].color.x, &vbo_data[glow_count].color.y, &vbo_data[glow_count].color.z);
-
-            glow_count++;
-        }
-    }
+    glBindVertexArray(g_glow_vao);
+    glDrawArrays(GL_POINTS, first_vertex, written);
+    glBindVertexArray(0);
 
-    if (glow_count > 0) {
-        glBindVertexArray(g_glow_vao);
-        glBindBuffer(GL_ARRAY_BUFFER, g_glow_vbo);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, glow_count * sizeof(GlowVertex), vbo_data);
-        glDrawArrays(GL_POINTS, 0, glow_count);
-        glBindVertexArray(0);
-    }
-    
     glDisable(GL_BLEND);
     glDepthMask(GL_TRUE);
 }
\ No newline at end of file
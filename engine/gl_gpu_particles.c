@@ -0,0 +1,345 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 Soft Sprint Studios
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "gl_gpu_particles.h"
+#include "gl_misc.h"
+#include "cvar.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// GPU particles live in one pool shared by every emitter. Each frame the CPU
+// only fills a small per-emitter parameter block with this frame's spawn
+// count. Compute passes then age the live list, spawn from an atomic free
+// list into the other alive list, and bitonic-sort the survivors by view
+// depth so one premultiplied indirect draw blends correctly across emitters.
+//
+// The CPU never reads back how many particles are alive. It keeps an upper
+// bound instead: an emitter can hold at most maxParticles, and only for one
+// maximum lifetime after it last spawned. That bound sizes the update dispatch
+// and the sort.
+
+#define GPU_PARTICLE_GROUP_SIZE 256
+#define GPU_PARTICLE_SORT_BLOCK 1024
+
+// Mirrors Emitter in the gpu_particle shaders (std430, 160 bytes).
+typedef struct {
+    float position[4];
+    float gravity[4];
+    float startVelocity[4];
+    float velocityVariation[4];
+    float startColor[4];
+    float endColor[4];
+    float angles[4];
+    float startSize;
+    float endSize;
+    unsigned int spawnOffset;
+    unsigned int spawnCount;
+    unsigned int texture[2];
+    unsigned int flags;
+    int alive;
+    float lifetime;
+    float lifetimeVariation;
+    int maxParticles;
+    unsigned int padding;
+} GPUEmitter;
+
+// Mirrors CounterBlock.
+typedef struct {
+    int deadCount;
+    unsigned int aliveCount[2];
+    unsigned int padding;
+} GPUParticleCounters;
+
+#define GPU_EMITTER_ADDITIVE 1u
+#define GPU_PARTICLE_SIZE 48
+
+static GLuint g_particle_buffer = 0;
+static GLuint g_dead_buffer = 0;
+static GLuint g_alive_buffers[2] = { 0, 0 };
+static GLuint g_emitter_buffer = 0;
+static GLuint g_counter_buffer = 0;
+static GLuint g_sort_buffer = 0;
+static GLuint g_draw_buffer = 0;
+static GLuint g_update_shader = 0;
+static GLuint g_emit_shader = 0;
+static GLuint g_sort_shader = 0;
+static GLuint g_render_shader = 0;
+static GLuint g_vao = 0;
+
+static GPUEmitter g_emitters[MAX_PARTICLE_EMITTERS];
+static ParticleSystem* g_emitter_systems[MAX_PARTICLE_EMITTERS];
+static float g_emitter_alive_time[MAX_PARTICLE_EMITTERS];
+static int g_num_emitters = -1;
+static int g_alive_current = 0;
+static int g_alive_bound = 0;
+static unsigned int g_seed = 0;
+
+static GLuint GPUParticles_CreateBuffer(size_t size) {
+    GLuint buffer;
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, size, NULL, GL_DYNAMIC_DRAW);
+    return buffer;
+}
+
+static void GPUParticles_Dispatch(int threads, int group_size) {
+    glDispatchCompute((GLuint)((threads + group_size - 1) / group_size), 1, 1);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+}
+
+static void reset_pool(void) {
+    GLuint* indices = (GLuint*)malloc(GPU_PARTICLE_CAPACITY * sizeof(GLuint));
+    if (indices) {
+        for (int i = 0; i < GPU_PARTICLE_CAPACITY; ++i) {
+            indices[i] = (GLuint)(GPU_PARTICLE_CAPACITY - 1 - i);
+        }
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, g_dead_buffer);
+        glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, GPU_PARTICLE_CAPACITY * sizeof(GLuint), indices);
+        free(indices);
+    }
+    GPUParticleCounters counters = { indices ? GPU_PARTICLE_CAPACITY : 0, { 0, 0 }, 0 };
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, g_counter_buffer);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(counters), &counters);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    memset(g_emitter_alive_time, 0, sizeof(g_emitter_alive_time));
+    g_alive_current = 0;
+    g_alive_bound = 0;
+}
+
+void GPUParticles_Init(void) {
+    g_update_shader = createShaderProgramCompute("shaders/gpu_particle_update.comp");
+    g_emit_shader = createShaderProgramCompute("shaders/gpu_particle_emit.comp");
+    g_sort_shader = createShaderProgramCompute("shaders/gpu_particle_sort.comp");
+    g_render_shader = createShaderProgram("shaders/gpu_particle.vert", "shaders/gpu_particle.frag");
+
+    g_particle_buffer = GPUParticles_CreateBuffer((size_t)GPU_PARTICLE_CAPACITY * GPU_PARTICLE_SIZE);
+    g_dead_buffer = GPUParticles_CreateBuffer(GPU_PARTICLE_CAPACITY * sizeof(GLuint));
+    g_alive_buffers[0] = GPUParticles_CreateBuffer(GPU_PARTICLE_CAPACITY * sizeof(GLuint));
+    g_alive_buffers[1] = GPUParticles_CreateBuffer(GPU_PARTICLE_CAPACITY * sizeof(GLuint));
+    g_emitter_buffer = GPUParticles_CreateBuffer(MAX_PARTICLE_EMITTERS * sizeof(GPUEmitter));
+    g_counter_buffer = GPUParticles_CreateBuffer(sizeof(GPUParticleCounters));
+    g_sort_buffer = GPUParticles_CreateBuffer(GPU_PARTICLE_CAPACITY * 2 * sizeof(GLuint));
+    g_draw_buffer = GPUParticles_CreateBuffer(4 * sizeof(GLuint));
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    glGenVertexArrays(1, &g_vao);
+    g_num_emitters = -1;
+    reset_pool();
+}
+
+void GPUParticles_Reset(void) {
+    if (!g_update_shader) return;
+    reset_pool();
+    g_num_emitters = -1;
+}
+
+void GPUParticles_Shutdown(void) {
+    glDeleteProgram(g_update_shader);
+    glDeleteProgram(g_emit_shader);
+    glDeleteProgram(g_sort_shader);
+    glDeleteProgram(g_render_shader);
+    g_update_shader = g_emit_shader = g_sort_shader = g_render_shader = 0;
+    glDeleteBuffers(1, &g_particle_buffer);
+    glDeleteBuffers(1, &g_dead_buffer);
+    glDeleteBuffers(2, g_alive_buffers);
+    glDeleteBuffers(1, &g_emitter_buffer);
+    glDeleteBuffers(1, &g_counter_buffer);
+    glDeleteBuffers(1, &g_sort_buffer);
+    glDeleteBuffers(1, &g_draw_buffer);
+    if (g_vao) glDeleteVertexArrays(1, &g_vao);
+    g_vao = 0;
+}
+
+static void GPUParticles_PackEmitter(GPUEmitter* out, const ParticleEmitter* emitter, const ParticleSystem* ps) {
+    memset(out, 0, sizeof(*out));
+    out->position[0] = emitter->pos.x; out->position[1] = emitter->pos.y; out->position[2] = emitter->pos.z;
+    out->gravity[0] = ps->gravity.x; out->gravity[1] = ps->gravity.y; out->gravity[2] = ps->gravity.z;
+    out->startVelocity[0] = ps->startVelocity.x; out->startVelocity[1] = ps->startVelocity.y; out->startVelocity[2] = ps->startVelocity.z;
+    out->velocityVariation[0] = ps->velocityVariation.x; out->velocityVariation[1] = ps->velocityVariation.y; out->velocityVariation[2] = ps->velocityVariation.z;
+    memcpy(out->startColor, &ps->startColor, sizeof(out->startColor));
+    memcpy(out->endColor, &ps->endColor, sizeof(out->endColor));
+    out->angles[0] = ps->startAngle;
+    out->angles[1] = ps->angleVariation;
+    out->angles[2] = ps->startAngularVelocity;
+    out->angles[3] = ps->angularVelocityVariation;
+    out->startSize = ps->startSize;
+    out->endSize = ps->endSize;
+    GLuint64 handle = GL_GetResidentTextureHandle(ps->material ? ps->material->diffuseMap : 0);
+    out->texture[0] = (unsigned int)(handle & 0xFFFFFFFF);
+    out->texture[1] = (unsigned int)(handle >> 32);
+    out->flags = ps->blend_dfactor == GL_ONE ? GPU_EMITTER_ADDITIVE : 0u;
+    out->lifetime = ps->lifetime;
+    out->lifetimeVariation = ps->lifetimeVariation;
+    out->maxParticles = ps->maxParticles;
+}
+
+void GPUParticles_Update(Scene* scene, Vec3 camera_pos, float cull_distance, float delta_time) {
+    if (!g_update_shader) return;
+
+    int num_emitters = scene->numParticleEmitters < MAX_PARTICLE_EMITTERS ? scene->numParticleEmitters : MAX_PARTICLE_EMITTERS;
+
+    // Particles refer to their emitter by index, so any change to the emitter
+    // set (editor add/remove, .par reload) starts the pool over. Map changes
+    // call GPUParticles_Reset, since a reloaded template can land on the same
+    // address and pointer identity alone would miss it.
+    bool changed = num_emitters != g_num_emitters;
+    for (int i = 0; i < num_emitters && !changed; ++i) {
+        changed = scene->particleEmitters[i].system != g_emitter_systems[i];
+    }
+    if (changed) {
+        reset_pool();
+        for (int i = 0; i < num_emitters; ++i) g_emitter_systems[i] = scene->particleEmitters[i].system;
+        g_num_emitters = num_emitters;
+    }
+
+    float cull_distance_sq = cull_distance * cull_distance;
+    unsigned int total_spawn = 0;
+    int next_bound = 0;
+    for (int i = 0; i < num_emitters; ++i) {
+        ParticleEmitter* emitter = &scene->particleEmitters[i];
+        ParticleSystem* ps = emitter->system;
+        GPUEmitter* gpu = &g_emitters[i];
+        if (!ps) {
+            memset(gpu, 0, sizeof(*gpu));
+            gpu->spawnOffset = total_spawn;
+            continue;
+        }
+        GPUParticles_PackEmitter(gpu, emitter, ps);
+
+        int spawn = 0;
+        if (emitter->is_on && vec3_length_sq(vec3_sub(emitter->pos, camera_pos)) < cull_distance_sq) {
+            emitter->timeSinceLastSpawn += delta_time;
+            spawn = (int)(emitter->timeSinceLastSpawn * ps->spawnRate);
+            if (spawn > 0) emitter->timeSinceLastSpawn = 0.0f;
+            if (spawn > ps->maxParticles) spawn = ps->maxParticles;
+        }
+        gpu->spawnOffset = total_spawn;
+        gpu->spawnCount = (unsigned int)spawn;
+        total_spawn += (unsigned int)spawn;
+
+        // The update dispatch below ages existing particles by delta_time, while
+        // particles emitted this frame only start aging next frame. Age the
+        // window first so a fresh spawn keeps its full lifetime of slack.
+        if (g_emitter_alive_time[i] > 0.0f) {
+            g_emitter_alive_time[i] -= delta_time;
+        }
+        if (spawn > 0) {
+            g_emitter_alive_time[i] = ps->lifetime + fabsf(ps->lifetimeVariation);
+        }
+        if (g_emitter_alive_time[i] > 0.0f) {
+            next_bound += ps->maxParticles;
+        }
+    }
+    if (next_bound > GPU_PARTICLE_CAPACITY) next_bound = GPU_PARTICLE_CAPACITY;
+
+    int next = 1 - g_alive_current;
+    if (num_emitters > 0) {
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, g_emitter_buffer);
+        glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, num_emitters * sizeof(GPUEmitter), g_emitters);
+    }
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, g_counter_buffer);
+    glClearBufferSubData(GL_SHADER_STORAGE_BUFFER, GL_R32UI, offsetof(GPUParticleCounters, aliveCount) + next * sizeof(GLuint), sizeof(GLuint), GL_RED_INTEGER, GL_UNSIGNED_INT, NULL);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 6, g_particle_buffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 7, g_dead_buffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 8, g_alive_buffers[g_alive_current]);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 9, g_alive_buffers[next]);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 10, g_emitter_buffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 11, g_counter_buffer);
+
+    if (g_alive_bound > 0) {
+        glUseProgram(g_update_shader);
+        glUniform1ui(glGetUniformLocation(g_update_shader, "u_aliveIn"), (GLuint)g_alive_current);
+        glUniform1i(glGetUniformLocation(g_update_shader, "u_numEmitters"), num_emitters);
+        glUniform1f(glGetUniformLocation(g_update_shader, "u_deltaTime"), delta_time);
+        GPUParticles_Dispatch(g_alive_bound, GPU_PARTICLE_GROUP_SIZE);
+    }
+
+    if (total_spawn > 0) {
+        glUseProgram(g_emit_shader);
+        glUniform1ui(glGetUniformLocation(g_emit_shader, "u_aliveOut"), (GLuint)next);
+        glUniform1ui(glGetUniformLocation(g_emit_shader, "u_totalSpawn"), total_spawn);
+        glUniform1i(glGetUniformLocation(g_emit_shader, "u_numEmitters"), num_emitters);
+        glUniform1ui(glGetUniformLocation(g_emit_shader, "u_seed"), g_seed++);
+        GPUParticles_Dispatch((int)total_spawn, GPU_PARTICLE_GROUP_SIZE);
+    }
+
+    g_alive_current = next;
+    g_alive_bound = next_bound;
+}
+
+void GPUParticles_Render(const Mat4* view, const Mat4* projection) {
+    if (!g_render_shader || g_alive_bound == 0) return;
+
+    int sort_size = GPU_PARTICLE_SORT_BLOCK;
+    while (sort_size < g_alive_bound) sort_size <<= 1;
+    const int sort_groups = sort_size / GPU_PARTICLE_SORT_BLOCK;
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 6, g_particle_buffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 8, g_alive_buffers[g_alive_current]);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 10, g_emitter_buffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 11, g_counter_buffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 12, g_sort_buffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 13, g_draw_buffer);
+
+    glUseProgram(g_sort_shader);
+    GLint mode_loc = glGetUniformLocation(g_sort_shader, "u_mode");
+    GLint k_loc = glGetUniformLocation(g_sort_shader, "u_k");
+    GLint j_loc = glGetUniformLocation(g_sort_shader, "u_j");
+    glUniformMatrix4fv(glGetUniformLocation(g_sort_shader, "view"), 1, GL_FALSE, view->m);
+    glUniform1ui(glGetUniformLocation(g_sort_shader, "u_alive"), (GLuint)g_alive_current);
+
+    glUniform1i(mode_loc, 0);
+    glDispatchCompute((GLuint)(sort_groups * 2), 1, 1);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+    glUniform1i(mode_loc, 1);
+    glDispatchCompute((GLuint)sort_groups, 1, 1);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+    for (int k = GPU_PARTICLE_SORT_BLOCK * 2; k <= sort_size; k <<= 1) {
+        glUniform1ui(k_loc, (GLuint)k);
+        glUniform1i(mode_loc, 2);
+        for (int j = k >> 1; j >= GPU_PARTICLE_SORT_BLOCK; j >>= 1) {
+            glUniform1ui(j_loc, (GLuint)j);
+            glDispatchCompute((GLuint)sort_groups, 1, 1);
+            glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+        }
+        glUniform1i(mode_loc, 3);
+        glDispatchCompute((GLuint)sort_groups, 1, 1);
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+    }
+    glMemoryBarrier(GL_COMMAND_BARRIER_BIT);
+
+    glUseProgram(g_render_shader);
+    glUniformMatrix4fv(glGetUniformLocation(g_render_shader, "view"), 1, GL_FALSE, view->m);
+    glUniformMatrix4fv(glGetUniformLocation(g_render_shader, "projection"), 1, GL_FALSE, projection->m);
+    glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+    glBindVertexArray(g_vao);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, g_draw_buffer);
+    glDrawArraysIndirect(GL_TRIANGLES, (void*)0);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    glBindVertexArray(0);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+}
\ No newline at end of file
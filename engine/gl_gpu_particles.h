@@ -0,0 +1,59 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 Soft Sprint Studios
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+#ifndef GL_GPU_PARTICLES_H
+#define GL_GPU_PARTICLES_H
+
+//----------------------------------------//
+// Brief: Compute-shader particle simulation, sorting and indirect drawing
+//----------------------------------------//
+
+#include "map.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Total particles shared by every emitter. Must be a power of two of at least
+// 1024 so the bitonic sort covers it in whole blocks.
+#define GPU_PARTICLE_CAPACITY (256 * 1024)
+
+    void GPUParticles_Init(void);
+    void GPUParticles_Shutdown(void);
+    // Kills every live particle and forgets the tracked emitter set. Called
+    // whenever the scene is cleared.
+    void GPUParticles_Reset(void);
+    // Spawns and ages the particles of every emitter within cull_distance of
+    // the camera. Emitters outside it stop spawning but their particles finish
+    // their lifetime.
+    void GPUParticles_Update(Scene* scene, Vec3 camera_pos, float cull_distance, float delta_time);
+    // Sorts the live particles back to front for this view and draws them all
+    // with one indirect draw.
+    void GPUParticles_Render(const Mat4* view, const Mat4* projection);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GL_GPU_PARTICLES_H
\ No newline at end of file
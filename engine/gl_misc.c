@@ -24,6 +24,7 @@
 #include "gl_misc.h"
 #include "gl_console.h"
 #include <stdlib.h>
+#include <string.h>
 
 char* load_shader_source(const char* path) {
     char* buffer = NULL;
@@ -191,6 +192,37 @@ GLuint createShaderProgramCompute(const char* computePath) {
     return program;
 }
 
+GLuint64 GL_GetResidentTextureHandle(GLuint texture) {
+    if (texture == 0) return 0;
+    GLuint64 handle = glGetTextureHandleARB(texture);
+    if (handle != 0 && !glIsTextureHandleResidentARB(handle)) {
+        glMakeTextureHandleResidentARB(handle);
+    }
+    return handle;
+}
+
+void GL_DispatchCompute2D(int width, int height) {
+    if (width < 1) width = 1;
+    if (height < 1) height = 1;
+    glDispatchCompute((GLuint)((width + 7) / 8), (GLuint)((height + 7) / 8), 1);
+    glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+}
+
+int GL_TemporalHistory_Begin(GL_TemporalHistory* history, const Mat4* projection) {
+    if (history->valid && memcmp(&history->projection, projection, sizeof(Mat4)) != 0) {
+        history->valid = false;
+    }
+    int previous = history->current;
+    history->current = 1 - history->current;
+    return previous;
+}
+
+void GL_TemporalHistory_End(GL_TemporalHistory* history, const Mat4* projection) {
+    history->projection = *projection;
+    history->valid = true;
+    history->frame++;
+}
+
 void GLAPIENTRY
 GL_MessageCallback(GLenum source,
     GLenum type,
@@ -33,6 +33,8 @@
 #include <GL/glew.h>
 #include <SDL_opengl.h>
 #include <stdio.h>
+#include <stdbool.h>
+#include "math_lib.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -44,8 +46,26 @@ GLuint createShaderProgram(const char* vertPath, const char* fragPath);
 GLuint createShaderProgramGeom(const char* vertPath, const char* geomPath, const char* fragPath);
 GLuint createShaderProgramTess(const char* vertPath, const char* tcsPath, const char* tesPath, const char* fragPath);
 GLuint createShaderProgramCompute(const char* computePath);
+GLuint64 GL_GetResidentTextureHandle(GLuint texture);
 void GL_InitDebugOutput(void);
 
+// Ping-pong state for the temporal compute passes (SSAO, SSR).
+typedef struct {
+    int current;
+    bool valid;
+    unsigned int frame;
+    Mat4 projection;
+} GL_TemporalHistory;
+
+// Dispatches 8x8 workgroups over a width x height image and makes the writes
+// visible to the texture fetches and image loads of the next dispatch.
+void GL_DispatchCompute2D(int width, int height);
+// Flips the pair and returns the index holding last frame's result; current is
+// the one to write. History is dropped when the projection changed, since
+// stored depths no longer reproject correctly.
+int GL_TemporalHistory_Begin(GL_TemporalHistory* history, const Mat4* projection);
+void GL_TemporalHistory_End(GL_TemporalHistory* history, const Mat4* projection);
+
 #ifdef __cplusplus
 }
 #endif
@@ -24,19 +24,99 @@
 #include "gl_particle_system.h"
 #include "map.h"
 #include "gl_misc.h"
+#include "gl_stream_buffer.h"
+#include "content_cache.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
 
-static ParticleVertex vboData[MAX_PARTICLES_PER_SYSTEM];
+static GLuint g_particle_vao = 0;
+static GLuint g_particle_shader = 0;
 
-ParticleSystem* ParticleSystem_Load(const char* path) {
+static ParticleSystem* g_templates[MAX_PARTICLE_TEMPLATES];
+static int g_num_templates = 0;
+
+// Particle arrays come from power-of-two size classes. Released blocks go on a
+// per-class free list, so emitters spawned, deleted or undone in the editor
+// reuse storage instead of hitting the allocator every time.
+#define PARTICLE_POOL_CLASSES 8
+
+typedef struct ParticlePoolBlock {
+    struct ParticlePoolBlock* next;
+} ParticlePoolBlock;
+
+static ParticlePoolBlock* g_pool_free[PARTICLE_POOL_CLASSES];
+
+static int pool_class_for(int count, int* capacity) {
+    int size = PARTICLE_POOL_MIN_BLOCK;
+    int cls = 0;
+    while (size < count && cls < PARTICLE_POOL_CLASSES - 1) {
+        size <<= 1;
+        cls++;
+    }
+    *capacity = size;
+    return cls;
+}
+
+static Particle* pool_alloc(int count, int* capacity) {
+    int cls = pool_class_for(count, capacity);
+    if (g_pool_free[cls]) {
+        ParticlePoolBlock* block = g_pool_free[cls];
+        g_pool_free[cls] = block->next;
+        return (Particle*)block;
+    }
+    return (Particle*)malloc(*capacity * sizeof(Particle));
+}
+
+static void pool_release(Particle* particles, int capacity) {
+    if (!particles) return;
+    int rounded;
+    int cls = pool_class_for(capacity, &rounded);
+    ParticlePoolBlock* block = (ParticlePoolBlock*)particles;
+    block->next = g_pool_free[cls];
+    g_pool_free[cls] = block;
+}
+
+static void pool_shutdown(void) {
+    for (int i = 0; i < PARTICLE_POOL_CLASSES; ++i) {
+        while (g_pool_free[i]) {
+            ParticlePoolBlock* next = g_pool_free[i]->next;
+            free(g_pool_free[i]);
+            g_pool_free[i] = next;
+        }
+    }
+}
+
+void ParticleSystem_InitRenderer(void) {
+    g_particle_shader = createShaderProgramGeom("shaders/particle.vert", "shaders/particle.geom", "shaders/particle.frag");
+    glGenVertexArrays(1, &g_particle_vao);
+    glBindVertexArray(g_particle_vao);
+    glBindBuffer(GL_ARRAY_BUFFER, StreamBuffer_GetVertexBuffer());
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(ParticleVertex), (void*)offsetof(ParticleVertex, position));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 1, GL_FLOAT, GL_FALSE, sizeof(ParticleVertex), (void*)offsetof(ParticleVertex, size));
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, sizeof(ParticleVertex), (void*)offsetof(ParticleVertex, angle));
+    glEnableVertexAttribArray(3);
+    glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(ParticleVertex), (void*)offsetof(ParticleVertex, color));
+    glBindVertexArray(0);
+}
+
+void ParticleSystem_ShutdownRenderer(void) {
+    if (g_particle_vao) glDeleteVertexArrays(1, &g_particle_vao);
+    g_particle_vao = 0;
+    if (g_particle_shader) glDeleteProgram(g_particle_shader);
+    g_particle_shader = 0;
+    pool_shutdown();
+}
+
+static bool parse_particle_file(const char* path, ParticleSystem* ps) {
     FILE* file = fopen(path, "r");
-    if (!file) return NULL;
+    if (!file) return false;
 
-    ParticleSystem* ps = (ParticleSystem*)calloc(1, sizeof(ParticleSystem));
-    if (!ps) { fclose(file); return NULL; }
+    memset(ps, 0, sizeof(ParticleSystem));
 
     ps->maxParticles = 1000;
     ps->gravity = (Vec3){ 0.0f, -9.81f, 0.0f };
@@ -78,16 +158,85 @@ ParticleSystem* ParticleSystem_Load(const char* path) {
     fclose(file);
 
     if (ps->maxParticles > MAX_PARTICLES_PER_SYSTEM) ps->maxParticles = MAX_PARTICLES_PER_SYSTEM;
-    ps->shader = createShaderProgramGeom("shaders/particle.vert", "shaders/particle.geom", "shaders/particle.frag");
+    return true;
+}
+
+static void unregister_template(ParticleSystem* ps) {
+    for (int i = 0; i < g_num_templates; ++i) {
+        if (g_templates[i] == ps) {
+            g_templates[i] = g_templates[--g_num_templates];
+            break;
+        }
+    }
+    ps->registered = false;
+}
+
+// Emitters share one template per .par file. Parsed definitions are also kept
+// in the content cache, so even a template that was fully released comes back
+// without reaching the filesystem.
+ParticleSystem* ParticleSystem_Load(const char* path) {
+    if (!path) return NULL;
+    for (int i = 0; i < g_num_templates; ++i) {
+        if (_stricmp(g_templates[i]->path, path) == 0) return ParticleSystem_Acquire(g_templates[i]);
+    }
+
+    size_t size = 0;
+    const ParticleSystem* cached = (const ParticleSystem*)ContentCache_Find(path, &size);
+    ParticleSystem parsed;
+    if (!cached || size != sizeof(ParticleSystem)) {
+        if (!parse_particle_file(path, &parsed)) return NULL;
+        ContentStamp stamp;
+        cached = (const ParticleSystem*)ContentCache_Store(path, ContentCache_GetStamp(path, &stamp) ? &stamp : NULL, &parsed, sizeof(parsed));
+        if (!cached) cached = &parsed;
+    }
+
+    ParticleSystem* ps = (ParticleSystem*)malloc(sizeof(ParticleSystem));
+    if (!ps) return NULL;
+    *ps = *cached;
+    ps->shader = g_particle_shader;
+    strncpy(ps->path, path, sizeof(ps->path) - 1);
+    ps->path[sizeof(ps->path) - 1] = '\0';
+    ps->refCount = 1;
+    ps->registered = g_num_templates < MAX_PARTICLE_TEMPLATES;
+    if (ps->registered) g_templates[g_num_templates++] = ps;
     return ps;
 }
 
+ParticleSystem* ParticleSystem_Acquire(ParticleSystem* system) {
+    if (system) system->refCount++;
+    return system;
+}
+
+void ParticleSystem_InvalidateCache(const char* path) {
+    ContentCache_Invalidate(path);
+    for (int i = 0; i < g_num_templates; ++i) {
+        if (_stricmp(g_templates[i]->path, path) == 0) {
+            unregister_template(g_templates[i]);
+            break;
+        }
+    }
+}
+
 void ParticleSystem_Free(ParticleSystem* system) {
     if (!system) return;
-    glDeleteProgram(system->shader);
+    if (--system->refCount > 0) return;
+    if (system->registered) unregister_template(system);
     free(system);
 }
 
+static bool ensure_particle_storage(ParticleEmitter* emitter) {
+    int needed = emitter->system->maxParticles;
+    if (emitter->particles && emitter->particleCapacity >= needed) return true;
+    pool_release(emitter->particles, emitter->particleCapacity);
+    emitter->particles = pool_alloc(needed, &emitter->particleCapacity);
+    if (!emitter->particles) {
+        emitter->particleCapacity = 0;
+        return false;
+    }
+    for (int i = 0; i < emitter->particleCapacity; ++i) emitter->particles[i].life = -1.0f;
+    return true;
+}
+
 static int find_unused_particle(ParticleEmitter* emitter) {
     for (int i = emitter->activeParticles; i < emitter->system->maxParticles; ++i) if (emitter->particles[i].life < 0.0f) return i;
     for (int i = 0; i < emitter->activeParticles; ++i) if (emitter->particles[i].life < 0.0f) return i;
@@ -113,26 +262,21 @@ void ParticleEmitter_Init(ParticleEmitter* emitter, ParticleSystem* system, Vec3
     emitter->is_on = emitter->on_by_default;
     emitter->activeParticles = 0;
     emitter->timeSinceLastSpawn = 0.0f;
-    for (int i = 0; i < emitter->system->maxParticles; ++i) emitter->particles[i].life = -1.0f;
-    glGenVertexArrays(1, &emitter->vao);
-    glGenBuffers(1, &emitter->vbo);
-    glBindVertexArray(emitter->vao);
-    glBindBuffer(GL_ARRAY_BUFFER, emitter->vbo);
-    glBufferData(GL_ARRAY_BUFFER, emitter->system->maxParticles * sizeof(ParticleVertex), NULL, GL_STREAM_DRAW);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(ParticleVertex), (void*)offsetof(ParticleVertex, position));
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 1, GL_FLOAT, GL_FALSE, sizeof(ParticleVertex), (void*)offsetof(ParticleVertex, size));
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, sizeof(ParticleVertex), (void*)offsetof(ParticleVertex, angle));
-    glEnableVertexAttribArray(3);
-    glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(ParticleVertex), (void*)offsetof(ParticleVertex, color));
-    glBindVertexArray(0);
+    // Storage is taken from the pool on the first CPU update. Emitters driven
+    // by the GPU path or never switched on hold no particle memory at all.
+    // Init never inherits a pointer left in the struct, a live emitter being
+    // re-initialized must go through ParticleEmitter_Free first.
+    emitter->particles = NULL;
+    emitter->particleCapacity = 0;
 }
 
 void ParticleEmitter_Update(ParticleEmitter* emitter, float deltaTime) {
     if (!emitter || !emitter->system) return;
     ParticleSystem* ps = emitter->system;
+    if (!emitter->particles) {
+        if (!emitter->is_on) return;
+        if (!ensure_particle_storage(emitter)) return;
+    }
 
     if (emitter->is_on) {
         emitter->timeSinceLastSpawn += deltaTime;
@@ -164,27 +308,35 @@ void ParticleEmitter_Update(ParticleEmitter* emitter, float deltaTime) {
                 p->color.z = ps->startColor.z + (ps->endColor.z - ps->startColor.z) * lifeRatio;
                 p->color.w = ps->startColor.w + (ps->endColor.w - ps->startColor.w) * lifeRatio;
                 p->size = ps->startSize + (ps->endSize - ps->startSize) * lifeRatio;
-                if (emitter->activeParticles < ps->maxParticles) {
-                    vboData[emitter->activeParticles].position = p->position;
-                    vboData[emitter->activeParticles].size = p->size;
-                    vboData[emitter->activeParticles].angle = p->angle;
-                    vboData[emitter->activeParticles].color = p->color;
-                    emitter->activeParticles++;
-                }
+                emitter->activeParticles++;
             }
             else p->life = -1.0f;
         }
     }
-    if (emitter->activeParticles > 0) {
-        glBindBuffer(GL_ARRAY_BUFFER, emitter->vbo);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, emitter->activeParticles * sizeof(ParticleVertex), vboData);
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-    }
 }
 
 void ParticleEmitter_Render(ParticleEmitter* emitter, Mat4 view, Mat4 projection) {
-    if (!emitter || !emitter->system || emitter->activeParticles == 0) return;
+    if (!emitter || !emitter->system || !emitter->particles || emitter->activeParticles == 0) return;
     ParticleSystem* ps = emitter->system;
+
+    // Vertices are written at draw time straight into the frame's slice of the
+    // stream buffer, so an emitter that is rendered from several views or not
+    // updated this frame still draws valid data.
+    GLint first_vertex = 0;
+    ParticleVertex* vertices = (ParticleVertex*)StreamBuffer_AllocVertices(emitter->activeParticles, sizeof(ParticleVertex), &first_vertex);
+    if (!vertices) return;
+    int count = 0;
+    for (int i = 0; i < ps->maxParticles && count < emitter->activeParticles; ++i) {
+        const Particle* p = &emitter->particles[i];
+        if (p->life <= 0.0f) continue;
+        vertices[count].position = p->position;
+        vertices[count].size = p->size;
+        vertices[count].angle = p->angle;
+        vertices[count].color = p->color;
+        count++;
+    }
+    if (count == 0) return;
+
     glUseProgram(ps->shader);
     glUniformMatrix4fv(glGetUniformLocation(ps->shader, "view"), 1, GL_FALSE, view.m);
     glUniformMatrix4fv(glGetUniformLocation(ps->shader, "projection"), 1, GL_FALSE, projection.m);
@@ -192,13 +344,15 @@ void ParticleEmitter_Render(ParticleEmitter* emitter, Mat4 view, Mat4 projection
     glBindTexture(GL_TEXTURE_2D, ps->material->diffuseMap);
     glUniform1i(glGetUniformLocation(ps->shader, "particleTexture"), 0);
     glBlendFunc(ps->blend_sfactor, ps->blend_dfactor);
-    glBindVertexArray(emitter->vao);
-    glDrawArrays(GL_POINTS, 0, emitter->activeParticles);
+    glBindVertexArray(g_particle_vao);
+    glDrawArrays(GL_POINTS, first_vertex, count);
     glBindVertexArray(0);
 }
 
 void ParticleEmitter_Free(ParticleEmitter* emitter) {
     if (!emitter) return;
-    glDeleteVertexArrays(1, &emitter->vao);
-    glDeleteBuffers(1, &emitter->vbo);
+    pool_release(emitter->particles, emitter->particleCapacity);
+    emitter->particles = NULL;
+    emitter->particleCapacity = 0;
+    emitter->activeParticles = 0;
 }
\ No newline at end of file
@@ -32,12 +32,15 @@
 #include "math_lib.h"
 #include "texturemanager.h"
 #include <GL/glew.h>
+#include <stdbool.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 #define MAX_PARTICLES_PER_SYSTEM 8192
+#define MAX_PARTICLE_TEMPLATES 256
+#define PARTICLE_POOL_MIN_BLOCK 64
 
 typedef struct {
     Vec3 position;
@@ -70,6 +73,10 @@ typedef struct {
     GLuint shader;
     GLenum blend_sfactor;
     GLenum blend_dfactor;
+    // Systems are shared templates, one per .par file, released by refcount.
+    char path[128];
+    int refCount;
+    bool registered;
 } ParticleSystem;
 
 typedef struct {
@@ -81,7 +88,15 @@ typedef struct {
 
 struct ParticleEmitter;
 
+void ParticleSystem_InitRenderer(void);
+void ParticleSystem_ShutdownRenderer(void);
+// Returns the shared template for path with its refcount raised.
 ParticleSystem* ParticleSystem_Load(const char* path);
+ParticleSystem* ParticleSystem_Acquire(ParticleSystem* system);
+// Drops the cached parse of path so the next load re-reads the file. Emitters
+// still holding the old template keep it until they release it.
+void ParticleSystem_InvalidateCache(const char* path);
+// Releases one reference, the template is freed with its last user.
 void ParticleSystem_Free(ParticleSystem* system);
 void ParticleEmitter_Init(struct ParticleEmitter* emitter, ParticleSystem* system, Vec3 position);
 void ParticleEmitter_Update(struct ParticleEmitter* emitter, float deltaTime);
@@ -37,14 +37,12 @@ void PostProcess_RenderPass(Renderer* renderer, Scene* scene, Engine* engine, Ma
     glUniform1f(glGetUniformLocation(renderer->postProcessShader, "u_exposure"), renderer->currentExposure);
     glUniform1f(glGetUniformLocation(renderer->postProcessShader, "u_gamma"), Cvar_GetFloat("r_gamma"));
     glUniform1f(glGetUniformLocation(renderer->postProcessShader, "u_red_flash_intensity"), engine->red_flash_intensity);
-    LogicEntity* fog_ent = FindActiveEntityByClass(scene, "env_fog");
+    LogicEntity* fog_ent = Scene_FindActiveLogicEntity(scene, ENTITY_CLASS_ENV_FOG);
     if (fog_ent) {
         glUniform1i(glGetUniformLocation(renderer->postProcessShader, "u_fogEnabled"), 1);
-        Vec3 fog_color;
-        sscanf(LogicEntity_GetProperty(fog_ent, "color", "0.5 0.6 0.7"), "%f %f %f", &fog_color.x, &fog_color.y, &fog_color.z);
-        glUniform3fv(glGetUniformLocation(renderer->postProcessShader, "u_fogColor"), 1, &fog_color.x);
-        glUniform1f(glGetUniformLocation(renderer->postProcessShader, "u_fogStart"), atof(LogicEntity_GetProperty(fog_ent, "start", "50.0")));
-        glUniform1f(glGetUniformLocation(renderer->postProcessShader, "u_fogEnd"), atof(LogicEntity_GetProperty(fog_ent, "end", "200.0")));
+        glUniform3fv(glGetUniformLocation(renderer->postProcessShader, "u_fogColor"), 1, &fog_ent->comp.fog.color.x);
+        glUniform1f(glGetUniformLocation(renderer->postProcessShader, "u_fogStart"), fog_ent->comp.fog.start);
+        glUniform1f(glGetUniformLocation(renderer->postProcessShader, "u_fogEnd"), fog_ent->comp.fog.end);
     }
     else {
         glUniform1i(glGetUniformLocation(renderer->postProcessShader, "u_fogEnabled"), 0);
@@ -107,12 +105,12 @@ void PostProcess_RenderPass(Renderer* renderer, Scene* scene, Engine* engine, Ma
     glUniform2fv(glGetUniformLocation(renderer->postProcessShader, "lightPosOnScreen"), 1, &light_pos_on_screen.x);
     glUniform1f(glGetUniformLocation(renderer->postProcessShader, "flareIntensity"), flare_intensity);
     glActiveTexture(GL_TEXTURE0); glBindTexture(GL_TEXTURE_2D, renderer->gLitColor);
-    glActiveTexture(GL_TEXTURE1); glBindTexture(GL_TEXTURE_2D, renderer->pingpongColorbuffers[0]);
+    glActiveTexture(GL_TEXTURE1); glBindTexture(GL_TEXTURE_2D, renderer->bloomTexture);
     glActiveTexture(GL_TEXTURE2); glBindTexture(GL_TEXTURE_2D, renderer->gPosition);
-    glActiveTexture(GL_TEXTURE3); glBindTexture(GL_TEXTURE_2D, renderer->volPingpongTextures[0]);
+    glActiveTexture(GL_TEXTURE3); glBindTexture(GL_TEXTURE_2D, renderer->volumetricTexture);
     if (Cvar_GetInt("r_ssao")) {
         glActiveTexture(GL_TEXTURE4);
-        glBindTexture(GL_TEXTURE_2D, renderer->ssaoBlurColorBuffer);
+        glBindTexture(GL_TEXTURE_2D, renderer->ssaoTexture);
     }
     glUniform1i(glGetUniformLocation(renderer->postProcessShader, "u_fxaa_enabled"), Cvar_GetInt("r_fxaa"));
     glUniform1i(glGetUniformLocation(renderer->postProcessShader, "sceneTexture"), 0);
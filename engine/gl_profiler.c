@@ -0,0 +1,371 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 Soft Sprint Studios
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "gl_profiler.h"
+#include "gl_misc.h"
+#include "gl_console.h"
+#include "cvar.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define PROFILER_MAX_ZONES 64
+#define PROFILER_MAX_DEPTH 16
+#define PROFILER_FRAME_LATENCY 3
+#define PROFILER_SMOOTHING 0.1f
+#define PROFILER_MAX_CAPTURE_FRAMES 10000
+
+// GPU timestamps are read back PROFILER_FRAME_LATENCY frames later so the
+// queries never stall the pipeline. CPU times for a frame are kept alongside
+// until its GPU results arrive, then both are published together.
+
+typedef struct {
+    const char* name;
+    int depth;
+    bool gpu;
+    Uint64 cpuStart;
+    Uint64 cpuEnd;
+} ProfilerZone;
+
+typedef struct {
+    ProfilerZone zones[PROFILER_MAX_ZONES];
+    GLuint queries[PROFILER_MAX_ZONES * 2];
+    GLuint frameQueries[2];
+    int zoneCount;
+    Uint64 cpuStart;
+    Uint64 cpuEnd;
+    bool pending;
+    bool capture;
+} ProfilerFrame;
+
+typedef struct {
+    const char* name;
+    int depth;
+    bool gpu;
+    float cpuMs;
+    float gpuMs;
+} ProfilerStat;
+
+typedef struct {
+    const char* name;
+    int depth;
+    bool gpu;
+    double cpuStartUs;
+    double cpuDurUs;
+    double gpuStartUs;
+    double gpuDurUs;
+} ProfilerTraceEvent;
+
+typedef struct {
+    bool gpuTimers;
+    double ticksToMs;
+    int frameIndex;
+    ProfilerFrame frames[PROFILER_FRAME_LATENCY];
+    ProfilerFrame* current;
+    int stack[PROFILER_MAX_DEPTH];
+    int stackDepth;
+
+    ProfilerStat stats[PROFILER_MAX_ZONES];
+    int statCount;
+    int order[PROFILER_MAX_ZONES];
+    int orderCount;
+    float frameCpuMs;
+    float frameGpuMs;
+
+    int captureRemaining;
+    int captureInFlight;
+    char capturePath[256];
+    Uint64 captureOrigin;
+    double gpuOffsetUs;
+    ProfilerTraceEvent* events;
+    int eventCount;
+    int eventCapacity;
+} Profiler;
+
+static Profiler g_profiler;
+
+void Profiler_Init(void) {
+    memset(&g_profiler, 0, sizeof(g_profiler));
+    g_profiler.ticksToMs = 1000.0 / (double)SDL_GetPerformanceFrequency();
+    g_profiler.gpuTimers = GLEW_VERSION_3_3 || GLEW_ARB_timer_query;
+    if (!g_profiler.gpuTimers) {
+        Console_Printf_Warning("[Profiler] GL timer queries are not supported, only CPU times will be shown.");
+        return;
+    }
+    for (int i = 0; i < PROFILER_FRAME_LATENCY; ++i) {
+        glGenQueries(PROFILER_MAX_ZONES * 2, g_profiler.frames[i].queries);
+        glGenQueries(2, g_profiler.frames[i].frameQueries);
+    }
+}
+
+void Profiler_Shutdown(void) {
+    if (g_profiler.gpuTimers) {
+        for (int i = 0; i < PROFILER_FRAME_LATENCY; ++i) {
+            glDeleteQueries(PROFILER_MAX_ZONES * 2, g_profiler.frames[i].queries);
+            glDeleteQueries(2, g_profiler.frames[i].frameQueries);
+        }
+    }
+    free(g_profiler.events);
+    memset(&g_profiler, 0, sizeof(g_profiler));
+}
+
+static double ticks_to_us(Uint64 ticks) {
+    return (double)(ticks - g_profiler.captureOrigin) * g_profiler.ticksToMs * 1000.0;
+}
+
+static void push_trace_event(const char* name, int depth, bool gpu, Uint64 cpuStart, Uint64 cpuEnd, GLuint64 gpuStart, GLuint64 gpuEnd) {
+    if (g_profiler.eventCount == g_profiler.eventCapacity) {
+        int capacity = g_profiler.eventCapacity ? g_profiler.eventCapacity * 2 : 4096;
+        ProfilerTraceEvent* events = realloc(g_profiler.events, capacity * sizeof(ProfilerTraceEvent));
+        if (!events) return;
+        g_profiler.events = events;
+        g_profiler.eventCapacity = capacity;
+    }
+    ProfilerTraceEvent* e = &g_profiler.events[g_profiler.eventCount++];
+    e->name = name;
+    e->depth = depth;
+    e->gpu = gpu;
+    e->cpuStartUs = ticks_to_us(cpuStart);
+    e->cpuDurUs = ticks_to_us(cpuEnd) - e->cpuStartUs;
+    e->gpuStartUs = gpu ? (double)gpuStart / 1000.0 + g_profiler.gpuOffsetUs : 0.0;
+    e->gpuDurUs = gpu ? (double)(gpuEnd - gpuStart) / 1000.0 : 0.0;
+}
+
+static void write_json_string(FILE* file, const char* s) {
+    fputc('"', file);
+    for (; *s; ++s) {
+        if (*s == '"' || *s == '\\') fputc('\\', file);
+        fputc(*s, file);
+    }
+    fputc('"', file);
+}
+
+static void write_capture(void) {
+    FILE* file = fopen(g_profiler.capturePath, "w");
+    if (!file) {
+        Console_Printf_Error("[Profiler] Could not open '%s' for writing.", g_profiler.capturePath);
+        return;
+    }
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"CPU\"}},\n");
+    fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,\"args\":{\"name\":\"GPU\"}}");
+    for (int i = 0; i < g_profiler.eventCount; ++i) {
+        const ProfilerTraceEvent* e = &g_profiler.events[i];
+        fprintf(file, ",\n{\"name\":");
+        write_json_string(file, e->name);
+        fprintf(file, ",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f}", e->cpuStartUs, e->cpuDurUs);
+        if (e->gpu) {
+            fprintf(file, ",\n{\"name\":");
+            write_json_string(file, e->name);
+            fprintf(file, ",\"ph\":\"X\",\"pid\":1,\"tid\":2,\"ts\":%.3f,\"dur\":%.3f}", e->gpuStartUs, e->gpuDurUs);
+        }
+    }
+    fprintf(file, "\n]}\n");
+    fclose(file);
+    Console_Printf("[Profiler] Wrote %d events to '%s'.", g_profiler.eventCount, g_profiler.capturePath);
+}
+
+static ProfilerStat* find_stat(const char* name, int depth, bool gpu) {
+    for (int i = 0; i < g_profiler.statCount; ++i) {
+        ProfilerStat* s = &g_profiler.stats[i];
+        if (s->name == name && s->depth == depth) return s;
+    }
+    if (g_profiler.statCount >= PROFILER_MAX_ZONES) return NULL;
+    ProfilerStat* s = &g_profiler.stats[g_profiler.statCount++];
+    s->name = name;
+    s->depth = depth;
+    s->gpu = gpu;
+    s->cpuMs = 0.0f;
+    s->gpuMs = 0.0f;
+    return s;
+}
+
+static float smooth(float avg, float value) {
+    return avg + (value - avg) * PROFILER_SMOOTHING;
+}
+
+static void resolve_frame(ProfilerFrame* f) {
+    f->pending = false;
+
+    bool gpu_valid = g_profiler.gpuTimers;
+    if (gpu_valid) {
+        GLint available = 0;
+        glGetQueryObjectiv(f->frameQueries[1], GL_QUERY_RESULT_AVAILABLE, &available);
+        gpu_valid = available != 0;
+    }
+
+    GLuint64 frame_gpu[2] = { 0, 0 };
+    if (gpu_valid) {
+        glGetQueryObjectui64v(f->frameQueries[0], GL_QUERY_RESULT, &frame_gpu[0]);
+        glGetQueryObjectui64v(f->frameQueries[1], GL_QUERY_RESULT, &frame_gpu[1]);
+        g_profiler.frameGpuMs = smooth(g_profiler.frameGpuMs, (float)((double)(frame_gpu[1] - frame_gpu[0]) / 1.0e6));
+    }
+    g_profiler.frameCpuMs = smooth(g_profiler.frameCpuMs, (float)((double)(f->cpuEnd - f->cpuStart) * g_profiler.ticksToMs));
+    if (f->capture) {
+        push_trace_event("Frame", 0, gpu_valid, f->cpuStart, f->cpuEnd, frame_gpu[0], frame_gpu[1]);
+    }
+
+    g_profiler.orderCount = 0;
+    for (int i = 0; i < f->zoneCount; ++i) {
+        const ProfilerZone* z = &f->zones[i];
+        GLuint64 gpu[2] = { 0, 0 };
+        bool has_gpu = z->gpu && gpu_valid;
+        if (has_gpu) {
+            glGetQueryObjectui64v(f->queries[i * 2], GL_QUERY_RESULT, &gpu[0]);
+            glGetQueryObjectui64v(f->queries[i * 2 + 1], GL_QUERY_RESULT, &gpu[1]);
+        }
+
+        ProfilerStat* s = find_stat(z->name, z->depth, z->gpu);
+        if (s) {
+            s->cpuMs = smooth(s->cpuMs, (float)((double)(z->cpuEnd - z->cpuStart) * g_profiler.ticksToMs));
+            if (has_gpu) s->gpuMs = smooth(s->gpuMs, (float)((double)(gpu[1] - gpu[0]) / 1.0e6));
+            g_profiler.order[g_profiler.orderCount++] = (int)(s - g_profiler.stats);
+        }
+        if (f->capture) {
+            push_trace_event(z->name, z->depth + 1, has_gpu, z->cpuStart, z->cpuEnd, gpu[0], gpu[1]);
+        }
+    }
+
+    if (f->capture) {
+        f->capture = false;
+        if (--g_profiler.captureInFlight == 0 && g_profiler.captureRemaining == 0) {
+            write_capture();
+            g_profiler.eventCount = 0;
+        }
+    }
+}
+
+void Profiler_BeginFrame(bool enabled) {
+    ProfilerFrame* f = &g_profiler.frames[g_profiler.frameIndex % PROFILER_FRAME_LATENCY];
+    if (f->pending) resolve_frame(f);
+
+    g_profiler.current = NULL;
+    g_profiler.stackDepth = 0;
+    bool capturing = g_profiler.captureRemaining > 0;
+    if (!enabled && !capturing) return;
+
+    f->zoneCount = 0;
+    f->capture = capturing;
+    if (capturing) {
+        g_profiler.captureRemaining--;
+        g_profiler.captureInFlight++;
+    }
+    f->cpuStart = SDL_GetPerformanceCounter();
+    if (g_profiler.gpuTimers) glQueryCounter(f->frameQueries[0], GL_TIMESTAMP);
+    g_profiler.current = f;
+}
+
+void Profiler_EndFrame(void) {
+    ProfilerFrame* f = g_profiler.current;
+    g_profiler.frameIndex++;
+    if (!f) return;
+    while (g_profiler.stackDepth > 0) Profiler_EndZone();
+    f->cpuEnd = SDL_GetPerformanceCounter();
+    if (g_profiler.gpuTimers) glQueryCounter(f->frameQueries[1], GL_TIMESTAMP);
+    f->pending = true;
+    g_profiler.current = NULL;
+}
+
+static void begin_zone(const char* name, bool gpu) {
+    ProfilerFrame* f = g_profiler.current;
+    if (!f) return;
+    if (g_profiler.stackDepth >= PROFILER_MAX_DEPTH) {
+        g_profiler.stackDepth++;
+        return;
+    }
+    if (f->zoneCount >= PROFILER_MAX_ZONES) {
+        g_profiler.stack[g_profiler.stackDepth++] = -1;
+        return;
+    }
+    int index = f->zoneCount++;
+    ProfilerZone* z = &f->zones[index];
+    z->name = name;
+    z->depth = g_profiler.stackDepth;
+    z->gpu = gpu && g_profiler.gpuTimers;
+    z->cpuStart = SDL_GetPerformanceCounter();
+    if (z->gpu) glQueryCounter(f->queries[index * 2], GL_TIMESTAMP);
+    g_profiler.stack[g_profiler.stackDepth++] = index;
+}
+
+void Profiler_BeginZone(const char* name) {
+    begin_zone(name, true);
+}
+
+void Profiler_BeginCPUZone(const char* name) {
+    begin_zone(name, false);
+}
+
+void Profiler_EndZone(void) {
+    ProfilerFrame* f = g_profiler.current;
+    if (!f || g_profiler.stackDepth == 0) return;
+    if (--g_profiler.stackDepth >= PROFILER_MAX_DEPTH) return;
+    int index = g_profiler.stack[g_profiler.stackDepth];
+    if (index < 0) return;
+    ProfilerZone* z = &f->zones[index];
+    if (z->gpu) glQueryCounter(f->queries[index * 2 + 1], GL_TIMESTAMP);
+    z->cpuEnd = SDL_GetPerformanceCounter();
+}
+
+void Profiler_RenderOverlay(float screen_width) {
+    if (!Cvar_GetInt("r_profiler")) return;
+
+    const float WIDTH = 320.0f;
+    UI_SetNextWindowPos(screen_width - WIDTH - 10.0f, 10.0f);
+    UI_SetNextWindowSize(WIDTH, 0.0f);
+    if (UI_Begin_WithFlags("Profiler", NULL, 1 << 0 | 1 << 1 | 1 << 3 | 1 << 5 | 1 << 8)) {
+        UI_Text("%-20s %7s %7s", "Zone", "CPU ms", "GPU ms");
+        UI_Separator();
+        if (g_profiler.gpuTimers) UI_Text("%-20s %7.2f %7.2f", "Frame", g_profiler.frameCpuMs, g_profiler.frameGpuMs);
+        else UI_Text("%-20s %7.2f %7s", "Frame", g_profiler.frameCpuMs, "-");
+        for (int i = 0; i < g_profiler.orderCount; ++i) {
+            const ProfilerStat* s = &g_profiler.stats[g_profiler.order[i]];
+            int indent = (s->depth + 1) * 2;
+            if (s->gpu) UI_Text("%*s%-*s %7.2f %7.2f", indent, "", 20 - indent, s->name, s->cpuMs, s->gpuMs);
+            else UI_Text("%*s%-*s %7.2f %7s", indent, "", 20 - indent, s->name, s->cpuMs, "-");
+        }
+    }
+    UI_End();
+}
+
+bool Profiler_StartCapture(int frames, const char* path) {
+    if (g_profiler.captureRemaining > 0 || g_profiler.captureInFlight > 0) {
+        Console_Printf_Warning("[Profiler] A capture is already in progress.");
+        return false;
+    }
+    if (frames < 1) frames = 1;
+    if (frames > PROFILER_MAX_CAPTURE_FRAMES) frames = PROFILER_MAX_CAPTURE_FRAMES;
+
+    strncpy(g_profiler.capturePath, path, sizeof(g_profiler.capturePath) - 1);
+    g_profiler.capturePath[sizeof(g_profiler.capturePath) - 1] = '\0';
+    g_profiler.eventCount = 0;
+    g_profiler.captureOrigin = SDL_GetPerformanceCounter();
+    g_profiler.gpuOffsetUs = 0.0;
+    if (g_profiler.gpuTimers) {
+        // Align the GPU clock with the CPU clock so both tracks share a timeline.
+        GLint64 gpu_now = 0;
+        glGetInteger64v(GL_TIMESTAMP, &gpu_now);
+        g_profiler.gpuOffsetUs = ticks_to_us(SDL_GetPerformanceCounter()) - (double)gpu_now / 1000.0;
+    }
+    g_profiler.captureRemaining = frames;
+    Console_Printf("[Profiler] Capturing %d frames to '%s'.", frames, g_profiler.capturePath);
+    return true;
+}
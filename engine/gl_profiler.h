@@ -0,0 +1,53 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 Soft Sprint Studios
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+#ifndef GL_PROFILER_H
+#define GL_PROFILER_H
+
+//----------------------------------------//
+// Brief: Frame profiler, CPU zones and GPU timestamp queries
+//----------------------------------------//
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    void Profiler_Init(void);
+    void Profiler_Shutdown(void);
+    void Profiler_BeginFrame(bool enabled);
+    void Profiler_EndFrame(void);
+    // Zone names must be string literals, they are stored by pointer.
+    void Profiler_BeginZone(const char* name);
+    void Profiler_BeginCPUZone(const char* name);
+    void Profiler_EndZone(void);
+    void Profiler_RenderOverlay(float screen_width);
+    bool Profiler_StartCapture(int frames, const char* path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GL_PROFILER_H
@@ -0,0 +1,302 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 Soft Sprint Studios
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "gl_readback.h"
+#include "gl_console.h"
+#include <SDL_image.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define READBACK_RING_SIZE 4
+
+// A readback goes through three stages: glReadPixels into a pixel pack buffer
+// with a fence behind it, a copy out of the mapped buffer once the fence has
+// signalled (main thread, never waits), and PNG encoding on the writer thread.
+
+typedef struct {
+    GLuint pbo;
+    GLsizeiptr capacity;
+    GLsync fence;
+    bool pending;
+    int width;
+    int height;
+    bool flipY;
+    char path[256];
+    char label[64];
+} ReadbackSlot;
+
+typedef struct ReadbackJob {
+    unsigned char* pixels;
+    int width;
+    int height;
+    bool flipY;
+    bool success;
+    char path[256];
+    char label[64];
+    char error[256];
+    struct ReadbackJob* next;
+} ReadbackJob;
+
+static ReadbackSlot g_readback_slots[READBACK_RING_SIZE];
+static int g_readback_next_slot = 0;
+static bool g_readback_initialized = false;
+
+static SDL_Thread* g_readback_thread = NULL;
+static SDL_mutex* g_readback_mutex = NULL;
+static SDL_cond* g_readback_cond = NULL;
+static SDL_cond* g_readback_idle_cond = NULL;
+static ReadbackJob* g_readback_queue_head = NULL;
+static ReadbackJob* g_readback_queue_tail = NULL;
+static ReadbackJob* g_readback_done = NULL;
+static int g_readback_jobs_in_flight = 0;
+static bool g_readback_thread_running = false;
+
+static void readback_write_png(ReadbackJob* job) {
+    int row_size = job->width * 4;
+    if (job->flipY) {
+        unsigned char* temp_row = (unsigned char*)malloc(row_size);
+        if (!temp_row) {
+            snprintf(job->error, sizeof(job->error), "Failed to allocate row buffer for %s.", job->path);
+            return;
+        }
+        for (int y = 0; y < job->height / 2; ++y) {
+            unsigned char* top = job->pixels + y * row_size;
+            unsigned char* bottom = job->pixels + (job->height - 1 - y) * row_size;
+            memcpy(temp_row, top, row_size);
+            memcpy(top, bottom, row_size);
+            memcpy(bottom, temp_row, row_size);
+        }
+        free(temp_row);
+    }
+
+    SDL_Surface* surface = SDL_CreateRGBSurfaceFrom(job->pixels, job->width, job->height, 32, row_size, 0x000000FF, 0x0000FF00, 0x00FF0000, 0xFF000000);
+    if (!surface) {
+        snprintf(job->error, sizeof(job->error), "Failed to create SDL surface for %s.", job->path);
+        return;
+    }
+    if (IMG_SavePNG(surface, job->path) != 0) {
+        snprintf(job->error, sizeof(job->error), "Failed to save %s: %s", job->path, IMG_GetError());
+    }
+    else {
+        job->success = true;
+    }
+    SDL_FreeSurface(surface);
+}
+
+static int Readback_Thread_Worker(void* data) {
+    (void)data;
+    SDL_LockMutex(g_readback_mutex);
+    while (true) {
+        while (g_readback_thread_running && !g_readback_queue_head) {
+            SDL_CondWait(g_readback_cond, g_readback_mutex);
+        }
+        if (!g_readback_queue_head) break;
+
+        ReadbackJob* job = g_readback_queue_head;
+        g_readback_queue_head = job->next;
+        if (!g_readback_queue_head) g_readback_queue_tail = NULL;
+        SDL_UnlockMutex(g_readback_mutex);
+
+        readback_write_png(job);
+        free(job->pixels);
+        job->pixels = NULL;
+
+        SDL_LockMutex(g_readback_mutex);
+        job->next = g_readback_done;
+        g_readback_done = job;
+        g_readback_jobs_in_flight--;
+        SDL_CondBroadcast(g_readback_idle_cond);
+    }
+    SDL_UnlockMutex(g_readback_mutex);
+    return 0;
+}
+
+void Readback_Init(void) {
+    memset(g_readback_slots, 0, sizeof(g_readback_slots));
+    for (int i = 0; i < READBACK_RING_SIZE; ++i) {
+        glGenBuffers(1, &g_readback_slots[i].pbo);
+    }
+    g_readback_next_slot = 0;
+    g_readback_mutex = SDL_CreateMutex();
+    g_readback_cond = SDL_CreateCond();
+    g_readback_idle_cond = SDL_CreateCond();
+    g_readback_thread_running = true;
+    g_readback_thread = SDL_CreateThread(Readback_Thread_Worker, "ReadbackThread", NULL);
+    g_readback_initialized = true;
+}
+
+static void readback_report_done(void) {
+    SDL_LockMutex(g_readback_mutex);
+    ReadbackJob* done = g_readback_done;
+    g_readback_done = NULL;
+    SDL_UnlockMutex(g_readback_mutex);
+
+    while (done) {
+        ReadbackJob* next = done->next;
+        if (done->success) Console_Printf("%s saved to %s", done->label, done->path);
+        else Console_Printf_Error("[ERROR] %s", done->error);
+        free(done);
+        done = next;
+    }
+}
+
+static void readback_resolve_slot(ReadbackSlot* slot) {
+    glDeleteSync(slot->fence);
+    slot->fence = NULL;
+    slot->pending = false;
+
+    GLsizeiptr size = (GLsizeiptr)slot->width * slot->height * 4;
+    ReadbackJob* job = (ReadbackJob*)calloc(1, sizeof(ReadbackJob));
+    unsigned char* pixels = job ? (unsigned char*)malloc(size) : NULL;
+    if (!job || !pixels) {
+        Console_Printf_Error("[ERROR] Failed to allocate memory for readback of %s.", slot->path);
+        free(job);
+        return;
+    }
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot->pbo);
+    void* mapped = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT);
+    if (mapped) {
+        memcpy(pixels, mapped, size);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    if (!mapped) {
+        Console_Printf_Error("[ERROR] Failed to map readback buffer for %s.", slot->path);
+        free(pixels);
+        free(job);
+        return;
+    }
+
+    job->pixels = pixels;
+    job->width = slot->width;
+    job->height = slot->height;
+    job->flipY = slot->flipY;
+    strcpy(job->path, slot->path);
+    strcpy(job->label, slot->label);
+
+    SDL_LockMutex(g_readback_mutex);
+    if (g_readback_queue_tail) g_readback_queue_tail->next = job;
+    else g_readback_queue_head = job;
+    g_readback_queue_tail = job;
+    g_readback_jobs_in_flight++;
+    SDL_CondSignal(g_readback_cond);
+    SDL_UnlockMutex(g_readback_mutex);
+}
+
+static bool readback_poll_slot(ReadbackSlot* slot, bool wait) {
+    if (!slot->pending) return true;
+    GLenum status = glClientWaitSync(slot->fence, wait ? GL_SYNC_FLUSH_COMMANDS_BIT : 0, wait ? 5000000000ull : 0);
+    if (status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED || (wait && status == GL_WAIT_FAILED)) {
+        readback_resolve_slot(slot);
+        return true;
+    }
+    return false;
+}
+
+bool Readback_RequestPNG(GLuint fbo, int width, int height, bool flip_y, const char* filepath, const char* label) {
+    if (!g_readback_initialized || width <= 0 || height <= 0) return false;
+
+    ReadbackSlot* slot = &g_readback_slots[g_readback_next_slot];
+    // Ring is full, only now do we have to wait for the oldest read. If even
+    // that times out the slot still owns its fence and data, so drop the new
+    // request rather than the one already in flight.
+    if (slot->pending && !readback_poll_slot(slot, true)) {
+        Console_Printf_Warning("[Readback] Ring is full, %s is still in flight.", slot->path);
+        return false;
+    }
+    g_readback_next_slot = (g_readback_next_slot + 1) % READBACK_RING_SIZE;
+
+    GLsizeiptr size = (GLsizeiptr)width * height * 4;
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot->pbo);
+    if (slot->capacity != size) {
+        glBufferData(GL_PIXEL_PACK_BUFFER, size, NULL, GL_STREAM_READ);
+        slot->capacity = size;
+    }
+    GLint previous_fbo = 0;
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &previous_fbo);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, (void*)0);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, (GLuint)previous_fbo);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    slot->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot->pending = true;
+    slot->width = width;
+    slot->height = height;
+    slot->flipY = flip_y;
+    strncpy(slot->path, filepath, sizeof(slot->path) - 1);
+    slot->path[sizeof(slot->path) - 1] = '\0';
+    strncpy(slot->label, label ? label : "Image", sizeof(slot->label) - 1);
+    slot->label[sizeof(slot->label) - 1] = '\0';
+    return true;
+}
+
+void Readback_Update(void) {
+    if (!g_readback_initialized) return;
+    // Resolve in submission order so a burst is written in sequence.
+    for (int i = 0; i < READBACK_RING_SIZE; ++i) {
+        ReadbackSlot* slot = &g_readback_slots[(g_readback_next_slot + i) % READBACK_RING_SIZE];
+        if (!readback_poll_slot(slot, false)) break;
+    }
+    readback_report_done();
+}
+
+void Readback_Flush(void) {
+    if (!g_readback_initialized) return;
+    for (int i = 0; i < READBACK_RING_SIZE; ++i) {
+        readback_poll_slot(&g_readback_slots[(g_readback_next_slot + i) % READBACK_RING_SIZE], true);
+    }
+    SDL_LockMutex(g_readback_mutex);
+    while (g_readback_jobs_in_flight > 0) {
+        SDL_CondWait(g_readback_idle_cond, g_readback_mutex);
+    }
+    SDL_UnlockMutex(g_readback_mutex);
+    readback_report_done();
+}
+
+void Readback_Shutdown(void) {
+    if (!g_readback_initialized) return;
+    Readback_Flush();
+
+    SDL_LockMutex(g_readback_mutex);
+    g_readback_thread_running = false;
+    SDL_CondSignal(g_readback_cond);
+    SDL_UnlockMutex(g_readback_mutex);
+    SDL_WaitThread(g_readback_thread, NULL);
+    g_readback_thread = NULL;
+
+    for (int i = 0; i < READBACK_RING_SIZE; ++i) {
+        if (g_readback_slots[i].fence) glDeleteSync(g_readback_slots[i].fence);
+        glDeleteBuffers(1, &g_readback_slots[i].pbo);
+    }
+    memset(g_readback_slots, 0, sizeof(g_readback_slots));
+    SDL_DestroyCond(g_readback_cond);
+    SDL_DestroyCond(g_readback_idle_cond);
+    SDL_DestroyMutex(g_readback_mutex);
+    g_readback_cond = NULL;
+    g_readback_idle_cond = NULL;
+    g_readback_mutex = NULL;
+    g_readback_initialized = false;
+}
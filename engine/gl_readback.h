@@ -0,0 +1,54 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 Soft Sprint Studios
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+#ifndef GL_READBACK_H
+#define GL_READBACK_H
+
+//----------------------------------------//
+// Brief: Asynchronous framebuffer readback, PBO ring plus a PNG writer thread
+//----------------------------------------//
+
+#include <SDL.h>
+#include <GL/glew.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    void Readback_Init(void);
+    void Readback_Shutdown(void);
+    // Queues a read of the bound color attachment of fbo. The PNG is written on
+    // a worker thread once the GPU has finished, label is used in the log line.
+    // Returns false if every slot is still waiting on the GPU.
+    bool Readback_RequestPNG(GLuint fbo, int width, int height, bool flip_y, const char* filepath, const char* label);
+    void Readback_Update(void);
+    // Blocks until every queued readback has been written to disk.
+    void Readback_Flush(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GL_READBACK_H
@@ -24,6 +24,9 @@
 #include "gl_render_misc.h"
 #include "cvar.h"
 #include "io_system.h"
+#include "gl_readback.h"
+#include "gl_shadows.h"
+#include "gl_ssr.h"
 #include <SDL_image.h>
 
 void MiscRender_AutoexposurePass(Renderer* renderer, Engine* engine) {
@@ -153,100 +156,113 @@ void MiscRender_RefractiveGlass(Renderer* renderer, Scene* scene, Engine* engine
     glBindVertexArray(0);
 }
 
-static void SaveFramebufferToPNG(GLuint fbo, int width, int height, const char* filepath) {
-    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-    unsigned char* pixels = (unsigned char*)malloc(width * height * 4);
-    if (!pixels) {
-        Console_Printf_Error("[ERROR] Failed to allocate memory for screenshot pixels.");
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
-        return;
+void MiscRender_SaveScreenshot(Engine* engine, const char* filepath) {
+    if (!Readback_RequestPNG(0, engine->width, engine->height, true, filepath, "Screenshot")) {
+        Console_Printf_Error("[ERROR] Failed to queue screenshot %s.", filepath);
     }
+}
 
-    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+static bool MiscRender_WriteCubemapContainer(const char* path, GLuint probe_array, int resolution, Brush** probes, int probe_count) {
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        return false;
+    }
 
-    SDL_Surface* surface = SDL_CreateRGBSurfaceFrom(pixels, width, height, 32, width * 4,
-        0x000000FF, 0x0000FF00, 0x00FF0000, 0xFF000000);
+    ReflectionProbeFileHeader header;
+    memcpy(header.magic, REFLECTION_PROBE_MAGIC, 4);
+    header.version = REFLECTION_PROBE_VERSION;
+    header.resolution = resolution;
+    header.mipCount = REFLECTION_PROBE_MIP_COUNT;
+    header.probeCount = probe_count;
+    fwrite(&header, sizeof(header), 1, file);
+
+    for (int p = 0; p < probe_count; ++p) {
+        char name[REFLECTION_PROBE_NAME_LENGTH] = { 0 };
+        strncpy(name, probes[p]->name, REFLECTION_PROBE_NAME_LENGTH - 1);
+        fwrite(name, 1, sizeof(name), file);
+    }
 
-    if (!surface) {
-        Console_Printf_Error("[ERROR] Failed to create SDL surface for screenshot.");
+    size_t top_size = (size_t)resolution * resolution * 4 * sizeof(uint16_t) * 6 * probe_count;
+    void* pixels = malloc(top_size);
+    if (!pixels) {
+        fclose(file);
+        return false;
     }
-    else {
-        if (IMG_SavePNG(surface, filepath) != 0) {
-            Console_Printf_Error("[ERROR] Failed to save screenshot to %s: %s", filepath, IMG_GetError());
-        }
-        else {
-            Console_Printf("Saved cubemap face to %s", filepath);
-        }
-        SDL_FreeSurface(surface);
+
+    bool ok = true;
+    glBindTexture(GL_TEXTURE_CUBE_MAP_ARRAY, probe_array);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    for (int mip = 0; mip < REFLECTION_PROBE_MIP_COUNT && ok; ++mip) {
+        int size = resolution >> mip;
+        size_t mip_size = (size_t)size * size * 4 * sizeof(uint16_t) * 6 * probe_count;
+        glGetTexImage(GL_TEXTURE_CUBE_MAP_ARRAY, mip, GL_RGBA, GL_HALF_FLOAT, pixels);
+        ok = fwrite(pixels, 1, mip_size, file) == mip_size;
     }
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glBindTexture(GL_TEXTURE_CUBE_MAP_ARRAY, 0);
 
     free(pixels);
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    fclose(file);
+    return ok;
 }
 
-void MiscRender_SaveScreenshot(Engine* engine, const char* filepath) {
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    unsigned char* pixels = (unsigned char*)malloc(engine->width * engine->height * 4);
-    if (!pixels) {
-        Console_Printf_Error("[ERROR] Failed to allocate memory for screenshot pixels.");
-        return;
-    }
-
-    glReadPixels(0, 0, engine->width, engine->height, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+void MiscRender_BuildCubemaps(Renderer* renderer, Scene* scene, Engine* engine, int resolution) {
+    Console_Printf("Starting cubemap build with %dx%d resolution...", resolution, resolution);
 
-    int row_size = engine->width * 4;
-    unsigned char* temp_row = (unsigned char*)malloc(row_size);
-    if (!temp_row) {
-        Console_Printf_Error("[ERROR] Failed to allocate memory for screenshot row buffer.");
-        free(pixels);
+    if ((resolution >> (REFLECTION_PROBE_MIP_COUNT - 1)) < 1) {
+        Console_Printf_Error("[ERROR] Cubemap resolution %d is too small for %d roughness mips.", resolution, REFLECTION_PROBE_MIP_COUNT);
         return;
     }
 
-    for (int y = 0; y < engine->height / 2; ++y) {
-        unsigned char* top = pixels + y * row_size;
-        unsigned char* bottom = pixels + (engine->height - 1 - y) * row_size;
-        memcpy(temp_row, top, row_size);
-        memcpy(top, bottom, row_size);
-        memcpy(bottom, temp_row, row_size);
-    }
-    free(temp_row);
-
-    SDL_Surface* surface = SDL_CreateRGBSurfaceFrom(pixels, engine->width, engine->height, 32, row_size, 0x000000FF, 0x0000FF00, 0x00FF0000, 0xFF000000);
-
-    if (!surface) {
-        Console_Printf_Error("[ERROR] Failed to create SDL surface for screenshot.");
-    }
-    else {
-        if (IMG_SavePNG(surface, filepath) != 0) {
-            Console_Printf_Error("[ERROR] Failed to save screenshot to %s: %s", filepath, IMG_GetError());
+    Brush** probes = malloc(sizeof(Brush*) * scene->numBrushes);
+    int probe_count = 0;
+    for (int i = 0; probes && i < scene->numBrushes; ++i) {
+        Brush* b = &scene->brushes[i];
+        if (strcmp(b->classname, "env_reflectionprobe") != 0) {
+            continue;
         }
-        else {
-            Console_Printf("Screenshot saved to %s", filepath);
+        if (strlen(b->name) == 0) {
+            Console_Printf_Warning("[WARNING] Skipping unnamed reflection probe at index %d.", i);
+            continue;
         }
-        SDL_FreeSurface(surface);
+        probes[probe_count++] = b;
+    }
+    if (probe_count == 0) {
+        Console_Printf("No named reflection probes to build.");
+        free(probes);
+        return;
     }
-    free(pixels);
-}
-
-void MiscRender_BuildCubemaps(Renderer* renderer, Scene* scene, Engine* engine, int resolution) {
-    Console_Printf("Starting cubemap build with %dx%d resolution...", resolution, resolution);
-    glFinish();
 
     Camera original_camera = engine->camera;
 
     Vec3 targets[] = { {1,0,0}, {-1,0,0}, {0,1,0}, {0,-1,0}, {0,0,1}, {0,0,-1} };
     Vec3 ups[] = { {0,-1,0}, {0,-1,0}, {0,0,1}, {0,0,-1}, {0,-1,0}, {0,-1,0} };
-    const char* suffixes[] = { "px", "nx", "py", "ny", "pz", "nz" };
 
-    GLuint cubemap_fbo, cubemap_texture, cubemap_rbo;
+    // Every probe renders straight into its own slice of one HDR cubemap
+    // array. The array is immutable so the probes can be handed out as views.
+    GLuint probe_array;
+    glGenTextures(1, &probe_array);
+    glBindTexture(GL_TEXTURE_CUBE_MAP_ARRAY, probe_array);
+    glTexStorage3D(GL_TEXTURE_CUBE_MAP_ARRAY, REFLECTION_PROBE_MIP_COUNT, GL_RGBA16F, resolution, resolution, 6 * probe_count);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    // The prefilter reads from a standalone copy of the face being filtered,
+    // with a full mip chain for filtered importance sampling.
+    int source_mips = 1;
+    while ((resolution >> source_mips) > 0) source_mips++;
+    GLuint source_cubemap;
+    glGenTextures(1, &source_cubemap);
+    glBindTexture(GL_TEXTURE_CUBE_MAP, source_cubemap);
+    glTexStorage2D(GL_TEXTURE_CUBE_MAP, source_mips, GL_RGBA16F, resolution, resolution);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+
+    GLuint cubemap_fbo, cubemap_rbo;
     glGenFramebuffers(1, &cubemap_fbo);
     glBindFramebuffer(GL_FRAMEBUFFER, cubemap_fbo);
-    glGenTextures(1, &cubemap_texture);
-    glBindTexture(GL_TEXTURE_2D, cubemap_texture);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_SRGB, resolution, resolution, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, cubemap_texture, 0);
+    glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, probe_array, 0, 0);
     glGenRenderbuffers(1, &cubemap_rbo);
     glBindRenderbuffer(GL_RENDERBUFFER, cubemap_rbo);
     glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, resolution, resolution);
@@ -254,52 +270,64 @@ void MiscRender_BuildCubemaps(Renderer* renderer, Scene* scene, Engine* engine,
     if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
         Console_Printf_Error("[ERROR] Cubemap face FBO not complete!");
         glDeleteFramebuffers(1, &cubemap_fbo);
-        glDeleteTextures(1, &cubemap_texture);
+        glDeleteTextures(1, &probe_array);
+        glDeleteTextures(1, &source_cubemap);
         glDeleteRenderbuffers(1, &cubemap_rbo);
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        free(probes);
         return;
     }
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
-    for (int i = 0; i < scene->numBrushes; ++i) {
-        Brush* b = &scene->brushes[i];
-        if (strcmp(b->classname, "env_reflectionprobe") != 0) {
-            continue;
-        }
-        if (strlen(b->name) == 0) {
-            Console_Printf_Warning("[WARNING] Skipping unnamed reflection probe at index %d.", i);
-            continue;
-        }
+    // Shadows don't depend on the probe being rendered, so they are drawn once
+    // for the whole bake. The distance cull is relative to the player camera,
+    // not the probes, so it is off for this pass. The sun frustum is centred
+    // on the probes and only re-rendered for a probe that falls outside of it.
+    Shadows_SetDistanceCulling(false);
+    Shadows_RenderPointAndSpot(renderer, scene, engine);
+    Shadows_SetDistanceCulling(true);
+
+    Mat4 sunLightSpaceMatrix;
+    mat4_identity(&sunLightSpaceMatrix);
+    Vec3 sun_focus = { 0.0f, 0.0f, 0.0f };
+    for (int p = 0; p < probe_count; ++p) {
+        sun_focus = vec3_add(sun_focus, probes[p]->pos);
+    }
+    sun_focus = vec3_muls(sun_focus, 1.0f / (float)probe_count);
+    const float sun_share_radius = Cvar_GetFloat("r_sun_shadow_distance") * 0.5f;
+    if (scene->sun.enabled) {
+        Calculate_Sun_Light_Space_Matrix(&sunLightSpaceMatrix, &scene->sun, sun_focus);
+        Shadows_RenderSun(renderer, scene, &sunLightSpaceMatrix);
+    }
 
+    Mat4 projection = mat4_perspective(90.0f * (M_PI / 180.f), 1.0f, 0.1f, 1000.f);
+    const int LOW_RES_WIDTH = engine->width / GEOMETRY_PASS_DOWNSAMPLE_FACTOR;
+    const int LOW_RES_HEIGHT = engine->height / GEOMETRY_PASS_DOWNSAMPLE_FACTOR;
+
+    for (int p = 0; p < probe_count; ++p) {
+        Brush* b = probes[p];
         Console_Printf("Building cubemap for probe '%s'...", b->name);
 
+        if (scene->sun.enabled && vec3_length(vec3_sub(b->pos, sun_focus)) > sun_share_radius) {
+            sun_focus = b->pos;
+            Calculate_Sun_Light_Space_Matrix(&sunLightSpaceMatrix, &scene->sun, sun_focus);
+            Shadows_RenderSun(renderer, scene, &sunLightSpaceMatrix);
+        }
+
+        engine->camera.position = b->pos;
         for (int face_idx = 0; face_idx < 6; ++face_idx) {
-            engine->camera.position = b->pos;
             Vec3 target_pos = vec3_add(engine->camera.position, targets[face_idx]);
             Mat4 view = mat4_lookAt(engine->camera.position, target_pos, ups[face_idx]);
-            Mat4 projection = mat4_perspective(90.0f * (M_PI / 180.f), 1.0f, 0.1f, 1000.f);
-
-            Shadows_RenderPointAndSpot(renderer, scene, engine);
-            Mat4 sunLightSpaceMatrix;
-            mat4_identity(&sunLightSpaceMatrix);
-            if (scene->sun.enabled) {
-                Calculate_Sun_Light_Space_Matrix(&sunLightSpaceMatrix, &scene->sun, engine->camera.position);
-                Shadows_RenderSun(renderer, scene, &sunLightSpaceMatrix);
-            }
 
             Geometry_RenderPass(renderer, scene, engine, &view, &projection, &sunLightSpaceMatrix, engine->camera.position, false);
 
             glBindFramebuffer(GL_FRAMEBUFFER, cubemap_fbo);
+            glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, probe_array, 0, p * 6 + face_idx);
             glViewport(0, 0, resolution, resolution);
             if (Cvar_GetInt("r_clear")) {
                 glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
             }
 
-            glEnable(GL_FRAMEBUFFER_SRGB);
-
-            const int LOW_RES_WIDTH = engine->width / GEOMETRY_PASS_DOWNSAMPLE_FACTOR;
-            const int LOW_RES_HEIGHT = engine->height / GEOMETRY_PASS_DOWNSAMPLE_FACTOR;
-
             glBindFramebuffer(GL_READ_FRAMEBUFFER, renderer->gBufferFBO);
             glBindFramebuffer(GL_DRAW_FRAMEBUFFER, cubemap_fbo);
             glBlitFramebuffer(0, 0, LOW_RES_WIDTH, LOW_RES_HEIGHT, 0, 0, resolution, resolution, GL_COLOR_BUFFER_BIT, GL_LINEAR);
@@ -307,30 +335,60 @@ void MiscRender_BuildCubemaps(Renderer* renderer, Scene* scene, Engine* engine,
 
             glBindFramebuffer(GL_FRAMEBUFFER, cubemap_fbo);
             Skybox_Render(renderer, scene, engine, &view, &projection);
+        }
 
-            glDisable(GL_FRAMEBUFFER_SRGB);
+        // Mip 0 stays the mirror reflection, the rest are GGX prefiltered to
+        // the roughness that main.frag maps onto them.
+        glCopyImageSubData(probe_array, GL_TEXTURE_CUBE_MAP_ARRAY, 0, 0, 0, p * 6,
+            source_cubemap, GL_TEXTURE_CUBE_MAP, 0, 0, 0, 0, resolution, resolution, 6);
+        glBindTexture(GL_TEXTURE_CUBE_MAP, source_cubemap);
+        glGenerateMipmap(GL_TEXTURE_CUBE_MAP);
 
-            char filepath[256];
-            sprintf(filepath, "cubemaps/%s_%s.png", b->name, suffixes[face_idx]);
-            SaveFramebufferToPNG(cubemap_fbo, resolution, resolution, filepath);
+        glUseProgram(renderer->cubemapPrefilterShader);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_CUBE_MAP, source_cubemap);
+        glUniform1i(glGetUniformLocation(renderer->cubemapPrefilterShader, "u_source"), 0);
+        glUniform1i(glGetUniformLocation(renderer->cubemapPrefilterShader, "u_layer"), p);
+        glUniform1f(glGetUniformLocation(renderer->cubemapPrefilterShader, "u_sourceSize"), (float)resolution);
+        for (int mip = 1; mip < REFLECTION_PROBE_MIP_COUNT; ++mip) {
+            int size = resolution >> mip;
+            glBindImageTexture(0, probe_array, mip, GL_TRUE, 0, GL_WRITE_ONLY, GL_RGBA16F);
+            glUniform1f(glGetUniformLocation(renderer->cubemapPrefilterShader, "u_roughness"), (float)mip / (float)(REFLECTION_PROBE_MIP_COUNT - 1));
+            glUniform1i(glGetUniformLocation(renderer->cubemapPrefilterShader, "u_outputSize"), size);
+            glDispatchCompute((size + 7) / 8, (size + 7) / 8, 6);
         }
+        glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_TEXTURE_UPDATE_BARRIER_BIT | GL_FRAMEBUFFER_BARRIER_BIT);
+    }
+    glBindImageTexture(0, 0, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA16F);
+    glUseProgram(0);
+
+    char container_path[512];
+    Scene_GetReflectionProbePath(scene, container_path, sizeof(container_path));
+    if (MiscRender_WriteCubemapContainer(container_path, probe_array, resolution, probes, probe_count)) {
+        Console_Printf("Saved %d reflection probes to %s", probe_count, container_path);
+    }
+    else {
+        Console_Printf_Error("[ERROR] Failed to write reflection probes to %s", container_path);
+    }
 
-        const char* face_paths[6];
-        char paths_storage[6][256];
-        for (int k = 0; k < 6; ++k) {
-            sprintf(paths_storage[k], "cubemaps/%s_%s.png", b->name, suffixes[k]);
-            face_paths[k] = paths_storage[k];
+    for (int p = 0; p < probe_count; ++p) {
+        Brush* b = probes[p];
+        if (b->cubemapTexture && glIsTexture(b->cubemapTexture)) {
+            glDeleteTextures(1, &b->cubemapTexture);
         }
-        b->cubemapTexture = TextureManager_ReloadCubemap(face_paths, b->cubemapTexture);
+        b->cubemapTexture = Brush_CreateReflectionProbeView(probe_array, p, REFLECTION_PROBE_MIP_COUNT);
     }
+    SSR_InvalidateProbes();
 
     glDeleteFramebuffers(1, &cubemap_fbo);
-    glDeleteTextures(1, &cubemap_texture);
+    glDeleteTextures(1, &probe_array);
+    glDeleteTextures(1, &source_cubemap);
     glDeleteRenderbuffers(1, &cubemap_rbo);
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    free(probes);
 
     engine->camera = original_camera;
     glViewport(0, 0, engine->width, engine->height);
 
     Console_Printf("Cubemap build finished.");
-}
\ No newline at end of file
+}
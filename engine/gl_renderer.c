@@ -45,6 +45,10 @@
 #include "gl_postprocess.h"
 #include "gl_render_misc.h"
 #include "gl_video_player.h"
+#include "gl_profiler.h"
+#include "gl_readback.h"
+#include "gl_stream_buffer.h"
+#include "gl_gpu_particles.h"
 #include "model_loader.h"
 
 static float quadVertices[] = { -1.0f,1.0f,0.0f,1.0f,-1.0f,-1.0f,0.0f,0.0f,1.0f,-1.0f,1.0f,0.0f,-1.0f,1.0f,0.0f,1.0f,1.0f,-1.0f,1.0f,0.0f,1.0f,1.0f,1.0f,1.0f };
@@ -56,16 +60,23 @@ void Renderer_Init(Renderer* renderer, Engine* engine) {
     renderer->postProcessShader = createShaderProgram("shaders/postprocess.vert", "shaders/postprocess.frag");
     renderer->histogramShader = createShaderProgramCompute("shaders/histogram.comp");
     renderer->exposureShader = createShaderProgramCompute("shaders/exposure.comp");
-    renderer->bloomShader = createShaderProgram("shaders/bloom.vert", "shaders/bloom.frag");
-    renderer->bloomBlurShader = createShaderProgram("shaders/bloom_blur.vert", "shaders/bloom_blur.frag");
+    renderer->cubemapPrefilterShader = createShaderProgramCompute("shaders/cubemap_prefilter.comp");
+    renderer->bloomDownsampleShader = createShaderProgramCompute("shaders/bloom_downsample.comp");
+    renderer->bloomUpsampleShader = createShaderProgramCompute("shaders/bloom_upsample.comp");
     renderer->dofShader = createShaderProgram("shaders/dof.vert", "shaders/dof.frag");
     renderer->volumetricShader = createShaderProgram("shaders/volumetric.vert", "shaders/volumetric.frag");
-    renderer->volumetricBlurShader = createShaderProgram("shaders/volumetric_blur.vert", "shaders/volumetric_blur.frag");
+    renderer->volumetricInjectShader = createShaderProgramCompute("shaders/volumetric_inject.comp");
+    renderer->volumetricIntegrateShader = createShaderProgramCompute("shaders/volumetric_integrate.comp");
     renderer->motionBlurShader = createShaderProgram("shaders/motion_blur.vert", "shaders/motion_blur.frag");
-    renderer->ssaoShader = createShaderProgram("shaders/ssao.vert", "shaders/ssao.frag");
-    renderer->ssaoBlurShader = createShaderProgram("shaders/ssao_blur.vert", "shaders/ssao_blur.frag");
+    renderer->ssaoDepthShader = createShaderProgramCompute("shaders/ssao_depth.comp");
+    renderer->ssaoShader = createShaderProgramCompute("shaders/ssao.comp");
+    renderer->ssaoTemporalShader = createShaderProgramCompute("shaders/ssao_temporal.comp");
+    renderer->ssaoUpsampleShader = createShaderProgramCompute("shaders/ssao_upsample.comp");
     renderer->modelShadowShader = createShaderProgram("shaders/shadow_model.vert", "shaders/shadow_model.frag");
     renderer->ssrShader = createShaderProgram("shaders/ssr.vert", "shaders/ssr.frag");
+    renderer->ssrHiZShader = createShaderProgramCompute("shaders/ssr_hiz.comp");
+    renderer->ssrTraceShader = createShaderProgramCompute("shaders/ssr_trace.comp");
+    renderer->ssrTemporalShader = createShaderProgramCompute("shaders/ssr_temporal.comp");
     renderer->glassShader = createShaderProgram("shaders/glass.vert", "shaders/glass.frag");
     renderer->waterShader = createShaderProgram("shaders/water.vert", "shaders/water.frag");
     renderer->reflectiveGlassShader = createShaderProgram("shaders/reflective_glass.vert", "shaders/reflective_glass.frag");
@@ -115,25 +126,23 @@ void Renderer_Init(Renderer* renderer, Engine* engine) {
     glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT, LOW_RES_WIDTH, LOW_RES_HEIGHT);
     glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, rboDepth);
     if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) Console_Printf("G-Buffer Framebuffer not complete!\n");
-    const int bloom_width = engine->width / BLOOM_DOWNSAMPLE;
-    const int bloom_height = engine->height / BLOOM_DOWNSAMPLE;
-    glGenFramebuffers(1, &renderer->bloomFBO); glBindFramebuffer(GL_FRAMEBUFFER, renderer->bloomFBO);
-    glGenTextures(1, &renderer->bloomBrightnessTexture); glBindTexture(GL_TEXTURE_2D, renderer->bloomBrightnessTexture);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_R11F_G11F_B10F, bloom_width, bloom_height, 0, GL_RGB, GL_FLOAT, NULL);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR); glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE); glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, renderer->bloomBrightnessTexture, 0);
-    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) Console_Printf("Bloom FBO not complete!\n");
-    glGenFramebuffers(2, renderer->pingpongFBO); glGenTextures(2, renderer->pingpongColorbuffers);
-    for (unsigned int i = 0; i < 2; i++) {
-        glBindFramebuffer(GL_FRAMEBUFFER, renderer->pingpongFBO[i]); glBindTexture(GL_TEXTURE_2D, renderer->pingpongColorbuffers[i]);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_R11F_G11F_B10F, bloom_width, bloom_height, 0, GL_RGB, GL_FLOAT, NULL);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR); glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER); glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
-        float borderColor[] = { 0.0f, 0.0f, 0.0f, 1.0f }; glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, renderer->pingpongColorbuffers[i], 0);
-        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) Console_Printf("Ping-pong FBO %d not complete!\n", i);
+    const int bloom_width = engine->width / 2;
+    const int bloom_height = engine->height / 2;
+    renderer->bloomMipCount = 0;
+    while (renderer->bloomMipCount < BLOOM_MIP_COUNT && (bloom_width >> renderer->bloomMipCount) >= 4 && (bloom_height >> renderer->bloomMipCount) >= 4) {
+        renderer->bloomMipCount++;
     }
+    if (renderer->bloomMipCount < 1) renderer->bloomMipCount = 1;
+    glGenTextures(1, &renderer->bloomTexture); glBindTexture(GL_TEXTURE_2D, renderer->bloomTexture);
+    glTexStorage2D(GL_TEXTURE_2D, renderer->bloomMipCount, GL_R11F_G11F_B10F, bloom_width > 0 ? bloom_width : 1, bloom_height > 0 ? bloom_height : 1);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_NEAREST); glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE); glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, renderer->bloomMipCount - 1);
+    // gLitColor is point-sampled everywhere else, the bloom prefilter reads it
+    // through this sampler so its bilinear taps average four texels each.
+    glGenSamplers(1, &renderer->bloomLinearSampler);
+    glSamplerParameteri(renderer->bloomLinearSampler, GL_TEXTURE_MIN_FILTER, GL_LINEAR); glSamplerParameteri(renderer->bloomLinearSampler, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glSamplerParameteri(renderer->bloomLinearSampler, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE); glSamplerParameteri(renderer->bloomLinearSampler, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     glGenFramebuffers(1, &renderer->finalRenderFBO);
     glBindFramebuffer(GL_FRAMEBUFFER, renderer->finalRenderFBO);
     glGenTextures(1, &renderer->finalRenderTexture);
@@ -158,15 +167,6 @@ void Renderer_Init(Renderer* renderer, Engine* engine) {
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, renderer->postProcessTexture, 0);
     if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) Console_Printf("Post Process Framebuffer not complete!\n");
-    glGenFramebuffers(1, &renderer->ssrFBO);
-    glBindFramebuffer(GL_FRAMEBUFFER, renderer->ssrFBO);
-    glGenTextures(1, &renderer->ssrTexture);
-    glBindTexture(GL_TEXTURE_2D, renderer->ssrTexture);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, engine->width, engine->height, 0, GL_RGBA, GL_FLOAT, NULL);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, renderer->ssrTexture, 0);
-    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) Console_Printf("SSR Framebuffer not complete!\n");
     glGenFramebuffers(1, &renderer->volumetricFBO);
     glBindFramebuffer(GL_FRAMEBUFFER, renderer->volumetricFBO);
     glGenTextures(1, &renderer->volumetricTexture);
@@ -178,19 +178,19 @@ void Renderer_Init(Renderer* renderer, Engine* engine) {
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, renderer->volumetricTexture, 0);
     if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) Console_Printf("Volumetric FBO not complete!\n");
-    glGenFramebuffers(2, renderer->volPingpongFBO);
-    glGenTextures(2, renderer->volPingpongTextures);
-    for (unsigned int i = 0; i < 2; i++) {
-        glBindFramebuffer(GL_FRAMEBUFFER, renderer->volPingpongFBO[i]);
-        glBindTexture(GL_TEXTURE_2D, renderer->volPingpongTextures[i]);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_R11F_G11F_B10F, engine->width / VOLUMETRIC_DOWNSAMPLE, engine->height / VOLUMETRIC_DOWNSAMPLE, 0, GL_RGB, GL_FLOAT, NULL);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, renderer->volPingpongTextures[i], 0);
-        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) Console_Printf("Volumetric Ping-Pong FBO %d not complete!\n", i);
+    glGenTextures(2, renderer->froxelScatterTextures);
+    glGenTextures(1, &renderer->froxelIntegratedTexture);
+    for (int i = 0; i < 3; i++) {
+        GLuint froxel_texture = i < 2 ? renderer->froxelScatterTextures[i] : renderer->froxelIntegratedTexture;
+        glBindTexture(GL_TEXTURE_3D, froxel_texture);
+        glTexImage3D(GL_TEXTURE_3D, 0, GL_RGBA16F, VOLUMETRIC_FROXEL_X, VOLUMETRIC_FROXEL_Y, VOLUMETRIC_FROXEL_Z, 0, GL_RGBA, GL_FLOAT, NULL);
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
     }
+    glBindTexture(GL_TEXTURE_3D, 0);
     glGenFramebuffers(1, &renderer->sunShadowFBO);
     glBindFramebuffer(GL_FRAMEBUFFER, renderer->sunShadowFBO);
     glGenTextures(1, &renderer->sunShadowMap);
@@ -246,16 +246,17 @@ void Renderer_Init(Renderer* renderer, Engine* engine) {
     glUniform1i(glGetUniformLocation(renderer->mainShader, "heightMap4"), 24);
     glUseProgram(renderer->volumetricShader);
     glUniform1i(glGetUniformLocation(renderer->volumetricShader, "gPosition"), 0);
-    glUseProgram(renderer->volumetricBlurShader);
-    glUniform1i(glGetUniformLocation(renderer->volumetricBlurShader, "image"), 0);
+    glUniform1i(glGetUniformLocation(renderer->volumetricShader, "froxelVolume"), 1);
+    glUseProgram(renderer->volumetricInjectShader);
+    glUniform1i(glGetUniformLocation(renderer->volumetricInjectShader, "u_scatterHistory"), 0);
     glUseProgram(renderer->skyboxShader);
     glUseProgram(renderer->postProcessShader);
     glUniform1i(glGetUniformLocation(renderer->postProcessShader, "sceneTexture"), 0);
     glUniform1i(glGetUniformLocation(renderer->postProcessShader, "bloomBlur"), 1);
     glUniform1i(glGetUniformLocation(renderer->postProcessShader, "gPosition"), 2);
     glUniform1i(glGetUniformLocation(renderer->postProcessShader, "volumetricTexture"), 3);
-    glUseProgram(renderer->bloomShader); glUniform1i(glGetUniformLocation(renderer->bloomShader, "sceneTexture"), 0);
-    glUseProgram(renderer->bloomBlurShader); glUniform1i(glGetUniformLocation(renderer->bloomBlurShader, "image"), 0);
+    glUseProgram(renderer->bloomDownsampleShader); glUniform1i(glGetUniformLocation(renderer->bloomDownsampleShader, "u_source"), 0);
+    glUseProgram(renderer->bloomUpsampleShader); glUniform1i(glGetUniformLocation(renderer->bloomUpsampleShader, "u_source"), 0);
     glUseProgram(renderer->dofShader);
     glUniform1i(glGetUniformLocation(renderer->dofShader, "screenTexture"), 0);
     glUniform1i(glGetUniformLocation(renderer->dofShader, "depthTexture"), 1);
@@ -275,26 +276,53 @@ void Renderer_Init(Renderer* renderer, Engine* engine) {
     const int ssao_width = engine->width / SSAO_DOWNSAMPLE;
     const int ssao_height = engine->height / SSAO_DOWNSAMPLE;
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    glGenFramebuffers(1, &renderer->ssaoFBO);
-    glBindFramebuffer(GL_FRAMEBUFFER, renderer->ssaoFBO);
-    glGenTextures(1, &renderer->ssaoColorBuffer);
-    glBindTexture(GL_TEXTURE_2D, renderer->ssaoColorBuffer);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, ssao_width, ssao_height, 0, GL_RED, GL_UNSIGNED_BYTE, NULL);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, renderer->ssaoColorBuffer, 0);
-    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
-        Console_Printf("SSAO Framebuffer not complete!\n");
-    glGenFramebuffers(1, &renderer->ssaoBlurFBO);
-    glBindFramebuffer(GL_FRAMEBUFFER, renderer->ssaoBlurFBO);
-    glGenTextures(1, &renderer->ssaoBlurColorBuffer);
-    glBindTexture(GL_TEXTURE_2D, renderer->ssaoBlurColorBuffer);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, ssao_width, ssao_height, 0, GL_RED, GL_UNSIGNED_BYTE, NULL);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, renderer->ssaoBlurColorBuffer, 0);
-    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
-        Console_Printf("SSAO Blur Framebuffer not complete!\n");
+    renderer->ssaoDepthMipCount = 0;
+    while (renderer->ssaoDepthMipCount < SSAO_DEPTH_MIP_COUNT && (ssao_width >> renderer->ssaoDepthMipCount) >= 1 && (ssao_height >> renderer->ssaoDepthMipCount) >= 1) {
+        renderer->ssaoDepthMipCount++;
+    }
+    if (renderer->ssaoDepthMipCount < 1) renderer->ssaoDepthMipCount = 1;
+    glGenTextures(1, &renderer->ssaoDepthTexture); glBindTexture(GL_TEXTURE_2D, renderer->ssaoDepthTexture);
+    glTexStorage2D(GL_TEXTURE_2D, renderer->ssaoDepthMipCount, GL_R32F, ssao_width > 0 ? ssao_width : 1, ssao_height > 0 ? ssao_height : 1);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST); glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE); glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, renderer->ssaoDepthMipCount - 1);
+    glGenTextures(1, &renderer->ssaoRawTexture); glBindTexture(GL_TEXTURE_2D, renderer->ssaoRawTexture);
+    glTexStorage2D(GL_TEXTURE_2D, 1, GL_R8, ssao_width > 0 ? ssao_width : 1, ssao_height > 0 ? ssao_height : 1);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST); glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glGenTextures(2, renderer->ssaoHistoryTextures);
+    for (int i = 0; i < 2; ++i) {
+        glBindTexture(GL_TEXTURE_2D, renderer->ssaoHistoryTextures[i]);
+        glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA16F, ssao_width > 0 ? ssao_width : 1, ssao_height > 0 ? ssao_height : 1);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST); glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE); glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
+    glGenTextures(1, &renderer->ssaoTexture); glBindTexture(GL_TEXTURE_2D, renderer->ssaoTexture);
+    glTexStorage2D(GL_TEXTURE_2D, 1, GL_R8, engine->width, engine->height);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR); glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE); glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    const int ssr_width = engine->width / SSR_DOWNSAMPLE > 0 ? engine->width / SSR_DOWNSAMPLE : 1;
+    const int ssr_height = engine->height / SSR_DOWNSAMPLE > 0 ? engine->height / SSR_DOWNSAMPLE : 1;
+    renderer->ssrHiZMipCount = 1;
+    while (renderer->ssrHiZMipCount < SSR_HIZ_MIP_COUNT && (ssr_width >> renderer->ssrHiZMipCount) >= 1 && (ssr_height >> renderer->ssrHiZMipCount) >= 1) {
+        renderer->ssrHiZMipCount++;
+    }
+    glGenTextures(1, &renderer->ssrHiZTexture); glBindTexture(GL_TEXTURE_2D, renderer->ssrHiZTexture);
+    glTexStorage2D(GL_TEXTURE_2D, renderer->ssrHiZMipCount, GL_R32F, ssr_width, ssr_height);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST); glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE); glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, renderer->ssrHiZMipCount - 1);
+    glGenTextures(1, &renderer->ssrTraceTexture); glBindTexture(GL_TEXTURE_2D, renderer->ssrTraceTexture);
+    glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA16F, ssr_width, ssr_height);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST); glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glGenTextures(2, renderer->ssrHistoryTextures);
+    for (int i = 0; i < 2; ++i) {
+        glBindTexture(GL_TEXTURE_2D, renderer->ssrHistoryTextures[i]);
+        glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA16F, ssr_width, ssr_height);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR); glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE); glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
+    glGenBuffers(1, &renderer->ssrProbeSSBO);
+    SSR_InvalidateProbes();
     int downsample = Cvar_GetInt("r_planar_downsample");
     if (downsample < 1) downsample = 1;
     int reflection_width = engine->width / downsample;
@@ -327,15 +355,32 @@ void Renderer_Init(Renderer* renderer, Engine* engine) {
 
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
     glUseProgram(renderer->ssaoShader);
-    glUniform1i(glGetUniformLocation(renderer->ssaoShader, "gPosition"), 0);
-    glUniform1i(glGetUniformLocation(renderer->ssaoShader, "gGeometryNormal"), 1);
-    glUniform1i(glGetUniformLocation(renderer->ssaoShader, "texNoise"), 2);
-    glUseProgram(renderer->ssaoBlurShader);
-    glUniform1i(glGetUniformLocation(renderer->ssaoBlurShader, "ssaoInput"), 0);
-    glUseProgram(renderer->postProcessShader);
-    glUniform1i(glGetUniformLocation(renderer->postProcessShader, "ssao"), 4);
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    glUniform1i(glGetUniformLocation(renderer->ssaoBlurShader, "ssaoInput"), 0);
+    glUniform1i(glGetUniformLocation(renderer->ssaoShader, "u_depth"), 0);
+    glUniform1i(glGetUniformLocation(renderer->ssaoShader, "u_normal"), 1);
+    glUseProgram(renderer->ssaoTemporalShader);
+    glUniform1i(glGetUniformLocation(renderer->ssaoTemporalShader, "u_current"), 0);
+    glUniform1i(glGetUniformLocation(renderer->ssaoTemporalShader, "u_previous"), 1);
+    glUniform1i(glGetUniformLocation(renderer->ssaoTemporalShader, "u_depth"), 2);
+    glUniform1i(glGetUniformLocation(renderer->ssaoTemporalShader, "u_velocity"), 3);
+    glUseProgram(renderer->ssaoUpsampleShader);
+    glUniform1i(glGetUniformLocation(renderer->ssaoUpsampleShader, "u_history"), 0);
+    glUniform1i(glGetUniformLocation(renderer->ssaoUpsampleShader, "u_position"), 1);
+    glUseProgram(renderer->ssrTraceShader);
+    glUniform1i(glGetUniformLocation(renderer->ssrTraceShader, "u_hiz"), 0);
+    glUniform1i(glGetUniformLocation(renderer->ssrTraceShader, "u_color"), 1);
+    glUniform1i(glGetUniformLocation(renderer->ssrTraceShader, "u_position"), 2);
+    glUniform1i(glGetUniformLocation(renderer->ssrTraceShader, "u_normal"), 3);
+    glUniform1i(glGetUniformLocation(renderer->ssrTraceShader, "u_pbrParams"), 4);
+    glUseProgram(renderer->ssrTemporalShader);
+    glUniform1i(glGetUniformLocation(renderer->ssrTemporalShader, "u_current"), 0);
+    glUniform1i(glGetUniformLocation(renderer->ssrTemporalShader, "u_previous"), 1);
+    glUniform1i(glGetUniformLocation(renderer->ssrTemporalShader, "u_velocity"), 2);
+    glUseProgram(renderer->ssrShader);
+    glUniform1i(glGetUniformLocation(renderer->ssrShader, "colorBuffer"), 0);
+    glUniform1i(glGetUniformLocation(renderer->ssrShader, "gNormal"), 1);
+    glUniform1i(glGetUniformLocation(renderer->ssrShader, "gPBRParams"), 2);
+    glUniform1i(glGetUniformLocation(renderer->ssrShader, "gPosition"), 3);
+    glUniform1i(glGetUniformLocation(renderer->ssrShader, "reflectionBuffer"), 4);
     glUseProgram(renderer->postProcessShader);
     glUniform1i(glGetUniformLocation(renderer->postProcessShader, "ssao"), 4);
     glUseProgram(renderer->waterShader);
@@ -354,9 +399,14 @@ void Renderer_Init(Renderer* renderer, Engine* engine) {
     glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, renderer->lightSSBO);
     glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    StreamBuffer_Init();
+    ParticleSystem_InitRenderer();
+    GPUParticles_Init();
     Beams_Init();
     Cable_Init();
     Overlay_Init();
+    Profiler_Init();
+    Readback_Init();
     Glow_Init();
     Decals_Init(renderer);
     Skybox_Init(renderer);
@@ -405,17 +455,24 @@ void Renderer_Shutdown(Renderer* renderer) {
     glDeleteProgram(renderer->debugBufferShader);
     glDeleteProgram(renderer->skyboxShader);
     glDeleteProgram(renderer->postProcessShader);
-    glDeleteProgram(renderer->bloomShader);
-    glDeleteProgram(renderer->bloomBlurShader);
+    glDeleteProgram(renderer->bloomDownsampleShader);
+    glDeleteProgram(renderer->bloomUpsampleShader);
     glDeleteProgram(renderer->dofShader);
+    glDeleteProgram(renderer->ssaoDepthShader);
     glDeleteProgram(renderer->ssaoShader);
-    glDeleteProgram(renderer->ssaoBlurShader);
+    glDeleteProgram(renderer->ssaoTemporalShader);
+    glDeleteProgram(renderer->ssaoUpsampleShader);
     glDeleteProgram(renderer->parallaxInteriorShader);
     glDeleteProgram(renderer->ssrShader);
+    glDeleteProgram(renderer->ssrHiZShader);
+    glDeleteProgram(renderer->ssrTraceShader);
+    glDeleteProgram(renderer->ssrTemporalShader);
     glDeleteProgram(renderer->volumetricShader);
-    glDeleteProgram(renderer->volumetricBlurShader);
+    glDeleteProgram(renderer->volumetricInjectShader);
+    glDeleteProgram(renderer->volumetricIntegrateShader);
     glDeleteProgram(renderer->histogramShader);
     glDeleteProgram(renderer->exposureShader);
+    glDeleteProgram(renderer->cubemapPrefilterShader);
     glDeleteProgram(renderer->modelShadowShader);
     glDeleteProgram(renderer->motionBlurShader);
     glDeleteProgram(renderer->waterShader);
@@ -428,12 +485,14 @@ void Renderer_Shutdown(Renderer* renderer) {
     glDeleteTextures(1, &renderer->gGeometryNormal);
     glDeleteTextures(1, &renderer->gPBRParams);
     glDeleteTextures(1, &renderer->gVelocity);
-    glDeleteFramebuffers(1, &renderer->ssaoFBO);
-    glDeleteFramebuffers(1, &renderer->ssaoBlurFBO);
-    glDeleteTextures(1, &renderer->ssaoColorBuffer);
-    glDeleteTextures(1, &renderer->ssaoBlurColorBuffer);
-    glDeleteFramebuffers(1, &renderer->ssrFBO);
-    glDeleteTextures(1, &renderer->ssrTexture);
+    glDeleteTextures(1, &renderer->ssaoDepthTexture);
+    glDeleteTextures(1, &renderer->ssaoRawTexture);
+    glDeleteTextures(2, renderer->ssaoHistoryTextures);
+    glDeleteTextures(1, &renderer->ssaoTexture);
+    glDeleteTextures(1, &renderer->ssrHiZTexture);
+    glDeleteTextures(1, &renderer->ssrTraceTexture);
+    glDeleteTextures(2, renderer->ssrHistoryTextures);
+    glDeleteBuffers(1, &renderer->ssrProbeSSBO);
     glDeleteFramebuffers(1, &renderer->finalRenderFBO);
     glDeleteTextures(1, &renderer->finalRenderTexture);
     glDeleteTextures(1, &renderer->finalDepthTexture);
@@ -449,19 +508,24 @@ void Renderer_Shutdown(Renderer* renderer) {
     glDeleteFramebuffers(1, &renderer->sunShadowFBO);
     glDeleteTextures(1, &renderer->sunShadowMap);
     glDeleteVertexArrays(1, &renderer->parallaxRoomVAO); glDeleteBuffers(1, &renderer->parallaxRoomVBO);
-    glDeleteFramebuffers(1, &renderer->bloomFBO); glDeleteTextures(1, &renderer->bloomBrightnessTexture);
-    glDeleteFramebuffers(2, renderer->pingpongFBO); glDeleteTextures(2, renderer->pingpongColorbuffers);
+    glDeleteTextures(1, &renderer->bloomTexture);
+    glDeleteSamplers(1, &renderer->bloomLinearSampler);
     glDeleteFramebuffers(1, &renderer->volumetricFBO);
     glDeleteTextures(1, &renderer->volumetricTexture);
-    glDeleteFramebuffers(2, renderer->volPingpongFBO);
-    glDeleteTextures(2, renderer->volPingpongTextures);
+    glDeleteTextures(2, renderer->froxelScatterTextures);
+    glDeleteTextures(1, &renderer->froxelIntegratedTexture);
     glDeleteBuffers(1, &renderer->lightSSBO);
     glDeleteBuffers(1, &renderer->histogramSSBO);
     glDeleteBuffers(1, &renderer->exposureSSBO);
     Beams_Shutdown();
     Cable_Shutdown();
     Overlay_Shutdown();
+    Profiler_Shutdown();
+    Readback_Shutdown();
     Glow_Shutdown();
+    GPUParticles_Shutdown();
+    ParticleSystem_ShutdownRenderer();
+    StreamBuffer_Shutdown();
     Decals_Shutdown(renderer);
     Skybox_Shutdown(renderer);
     Zprepass_Shutdown(renderer);
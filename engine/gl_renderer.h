@@ -31,9 +31,18 @@
 extern "C" {
 #endif
 
-#define BLOOM_DOWNSAMPLE 8
+#define BLOOM_MIP_COUNT 6
 #define SSAO_DOWNSAMPLE 2
+#define SSAO_DEPTH_MIP_COUNT 4
+#define SSR_DOWNSAMPLE 2
+#define SSR_HIZ_MIP_COUNT 7
+#define SSR_MAX_PROBES 64
 #define VOLUMETRIC_DOWNSAMPLE 4
+#define VOLUMETRIC_FROXEL_X 160
+#define VOLUMETRIC_FROXEL_Y 90
+#define VOLUMETRIC_FROXEL_Z 64
+#define VOLUMETRIC_FROXEL_NEAR 0.1f
+#define VOLUMETRIC_FROXEL_FAR 150.0f
 
 void Renderer_Init(Renderer* renderer, Engine* engine);
 void Renderer_Shutdown(Renderer* renderer);
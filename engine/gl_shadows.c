@@ -25,6 +25,12 @@
 #include "gl_misc.h"
 #include "cvar.h"
 
+static bool g_shadow_distance_culling = true;
+
+void Shadows_SetDistanceCulling(bool enabled) {
+    g_shadow_distance_culling = enabled;
+}
+
 void Shadows_RenderPointAndSpot(Renderer* renderer, Scene* scene, Engine* engine) {
     glEnable(GL_DEPTH_TEST);
     glCullFace(GL_FRONT);
@@ -43,7 +49,7 @@ void Shadows_RenderPointAndSpot(Renderer* renderer, Scene* scene, Engine* engine
         }
         if (light->is_static) continue;
         if (light->intensity <= 0.0f) continue;
-        if (vec3_length_sq(vec3_sub(light->position, engine->camera.position)) > max_shadow_dist_sq) continue;
+        if (g_shadow_distance_culling && vec3_length_sq(vec3_sub(light->position, engine->camera.position)) > max_shadow_dist_sq) continue;
         
         glBindFramebuffer(GL_FRAMEBUFFER, light->shadowFBO);
         glClear(GL_DEPTH_BUFFER_BIT);
@@ -40,6 +40,9 @@ struct Renderer;
 void Shadows_Init(Renderer* renderer);
 void Shadows_Shutdown(Renderer* renderer);
 void Shadows_RenderPointAndSpot(Renderer* renderer, Scene* scene, Engine* engine);
+// Point and spot shadows skip lights beyond r_shadow_distance_max from the
+// camera. Offline bakes that view the scene from many places turn this off.
+void Shadows_SetDistanceCulling(bool enabled);
 void Shadows_RenderSun(Renderer* renderer, Scene* scene, const Mat4* sunLightSpaceMatrix);
 
 #ifdef __cplusplus
@@ -23,6 +23,7 @@
  */
 #include "gl_sprites.h"
 #include "gl_misc.h"
+#include <stddef.h>
 
 static float sprite_vertices[] = {
     -0.5f, -0.5f, 0.0f,  0.0f, 0.0f,
@@ -31,6 +32,14 @@ static float sprite_vertices[] = {
      0.5f,  0.5f, 0.0f,  1.0f, 1.0f,
 };
 
+// Per-instance data streamed each frame; layout matches the instanced
+// attributes declared in sprite.vert.
+typedef struct {
+    float posScale[4];
+    unsigned int textureHandle[2];
+    unsigned int padding[2];
+} SpriteInstance;
+
 void Sprites_Init(Renderer* renderer) {
     renderer->spriteShader = createShaderProgram("shaders/sprite.vert", "shaders/sprite.frag");
 
@@ -43,6 +52,16 @@ void Sprites_Init(Renderer* renderer) {
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
     glEnableVertexAttribArray(1);
     glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
+
+    glGenBuffers(1, &renderer->spriteInstanceVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, renderer->spriteInstanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, MAX_SPRITES * sizeof(SpriteInstance), NULL, GL_STREAM_DRAW);
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(SpriteInstance), (void*)offsetof(SpriteInstance, posScale));
+    glVertexAttribDivisor(2, 1);
+    glEnableVertexAttribArray(3);
+    glVertexAttribIPointer(3, 2, GL_UNSIGNED_INT, sizeof(SpriteInstance), (void*)offsetof(SpriteInstance, textureHandle));
+    glVertexAttribDivisor(3, 1);
     glBindVertexArray(0);
 }
 
@@ -50,9 +69,34 @@ void Sprites_Shutdown(Renderer* renderer) {
     glDeleteProgram(renderer->spriteShader);
     glDeleteVertexArrays(1, &renderer->spriteVAO);
     glDeleteBuffers(1, &renderer->spriteVBO);
+    glDeleteBuffers(1, &renderer->spriteInstanceVBO);
 }
 
 void Sprites_Render(Renderer* renderer, Scene* scene, Mat4* view, Mat4* projection) {
+    static SpriteInstance instances[MAX_SPRITES];
+    int count = 0;
+    for (int i = 0; i < scene->numSprites && count < MAX_SPRITES; ++i) {
+        Sprite* s = &scene->sprites[i];
+        if (!s->visible) continue;
+
+        SpriteInstance* inst = &instances[count++];
+        inst->posScale[0] = s->pos.x;
+        inst->posScale[1] = s->pos.y;
+        inst->posScale[2] = s->pos.z;
+        inst->posScale[3] = s->scale;
+        GLuint64 handle = GL_GetResidentTextureHandle(s->material->diffuseMap);
+        inst->textureHandle[0] = (unsigned int)(handle & 0xFFFFFFFF);
+        inst->textureHandle[1] = (unsigned int)(handle >> 32);
+        inst->padding[0] = inst->padding[1] = 0;
+    }
+    if (count == 0) return;
+
+    // Orphan the buffer so the upload never waits on last frame's draw.
+    glBindBuffer(GL_ARRAY_BUFFER, renderer->spriteInstanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, MAX_SPRITES * sizeof(SpriteInstance), NULL, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, count * sizeof(SpriteInstance), instances);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
     glUseProgram(renderer->spriteShader);
     glUniformMatrix4fv(glGetUniformLocation(renderer->spriteShader, "view"), 1, GL_FALSE, view->m);
     glUniformMatrix4fv(glGetUniformLocation(renderer->spriteShader, "projection"), 1, GL_FALSE, projection->m);
@@ -62,20 +106,7 @@ void Sprites_Render(Renderer* renderer, Scene* scene, Mat4* view, Mat4* projecti
     glDepthMask(GL_FALSE);
 
     glBindVertexArray(renderer->spriteVAO);
-
-    for (int i = 0; i < scene->numSprites; ++i) {
-        Sprite* s = &scene->sprites[i];
-        if (!s->visible) continue;
-
-        glUniform3fv(glGetUniformLocation(renderer->spriteShader, "spritePos"), 1, &s->pos.x);
-        glUniform1f(glGetUniformLocation(renderer->spriteShader, "spriteScale"), s->scale);
-
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, s->material->diffuseMap);
-        glUniform1i(glGetUniformLocation(renderer->spriteShader, "spriteTexture"), 0);
-
-        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-    }
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, count);
 
     glBindVertexArray(0);
     glDepthMask(GL_TRUE);
@@ -23,32 +23,83 @@
  */
 #include "gl_ssao.h"
 #include "gl_renderer.h"
+#include "gl_misc.h"
 #include "cvar.h"
 
+// SSAO runs at SSAO_DOWNSAMPLE resolution. A depth pyramid is built from
+// gPosition, a sparse spiral of taps per pixel is evaluated against it with a
+// rotation that changes every frame, and the result is accumulated with
+// velocity reprojection before a depth-aware upsample to full resolution.
+
+#define SSAO_RADIUS 1.0f
+#define SSAO_INTENSITY 1.0f
+#define SSAO_BIAS 0.01f
+#define SSAO_MAX_HISTORY 16.0f
+#define SSAO_DEPTH_TOLERANCE 0.1f
+#define SSAO_UPSAMPLE_SHARPNESS 20.0f
+
+static GL_TemporalHistory g_ssao_history;
+
 void SSAO_RenderPass(Renderer* renderer, Engine* engine, Mat4* projection) {
     const int ssao_width = engine->width / SSAO_DOWNSAMPLE;
     const int ssao_height = engine->height / SSAO_DOWNSAMPLE;
-    glViewport(0, 0, ssao_width, ssao_height);
-    glBindFramebuffer(GL_FRAMEBUFFER, renderer->ssaoFBO);
-    glClear(GL_COLOR_BUFFER_BIT);
+
+    int history = GL_TemporalHistory_Begin(&g_ssao_history, projection);
+
+    glUseProgram(renderer->ssaoDepthShader);
+    glActiveTexture(GL_TEXTURE0);
+    for (int mip = 0; mip < renderer->ssaoDepthMipCount; ++mip) {
+        bool from_position = (mip == 0);
+        glBindTexture(GL_TEXTURE_2D, from_position ? renderer->gPosition : renderer->ssaoDepthTexture);
+        glUniform1i(glGetUniformLocation(renderer->ssaoDepthShader, "u_fromPosition"), from_position);
+        glUniform1i(glGetUniformLocation(renderer->ssaoDepthShader, "u_sourceLod"), from_position ? 0 : mip - 1);
+        glBindImageTexture(0, renderer->ssaoDepthTexture, mip, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+        GL_DispatchCompute2D(ssao_width >> mip, ssao_height >> mip);
+    }
+
     glUseProgram(renderer->ssaoShader);
-    glUniformMatrix4fv(glGetUniformLocation(renderer->ssaoShader, "projection"), 1, GL_FALSE, projection->m);
-    glUniform2f(glGetUniformLocation(renderer->ssaoShader, "screenSize"), (float)ssao_width, (float)ssao_height);
+    glUniform4f(glGetUniformLocation(renderer->ssaoShader, "u_projInfo"), projection->m[0], projection->m[5], projection->m[8], projection->m[9]);
+    glUniform1f(glGetUniformLocation(renderer->ssaoShader, "u_radius"), SSAO_RADIUS);
+    glUniform1f(glGetUniformLocation(renderer->ssaoShader, "u_intensity"), SSAO_INTENSITY);
+    glUniform1f(glGetUniformLocation(renderer->ssaoShader, "u_bias"), SSAO_BIAS);
+    glUniform1i(glGetUniformLocation(renderer->ssaoShader, "u_frame"), (int)(g_ssao_history.frame & 0x7FFFFFFF));
+    glUniform1i(glGetUniformLocation(renderer->ssaoShader, "u_maxMip"), renderer->ssaoDepthMipCount - 1);
     glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, renderer->gPosition);
+    glBindTexture(GL_TEXTURE_2D, renderer->ssaoDepthTexture);
     glActiveTexture(GL_TEXTURE1);
-    glBindTexture(GL_TEXTURE_2D, renderer->gGeometryNormal);
-    glBindVertexArray(renderer->quadVAO);
-    glDrawArrays(GL_TRIANGLES, 0, 6);
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-
-    glBindFramebuffer(GL_FRAMEBUFFER, renderer->ssaoBlurFBO);
-    glClear(GL_COLOR_BUFFER_BIT);
-    glUseProgram(renderer->ssaoBlurShader);
+    glBindTexture(GL_TEXTURE_2D, renderer->gNormal);
+    glBindImageTexture(0, renderer->ssaoRawTexture, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_R8);
+    GL_DispatchCompute2D(ssao_width, ssao_height);
+
+    glUseProgram(renderer->ssaoTemporalShader);
+    glUniform1i(glGetUniformLocation(renderer->ssaoTemporalShader, "u_historyValid"), g_ssao_history.valid);
+    glUniform1f(glGetUniformLocation(renderer->ssaoTemporalShader, "u_maxHistory"), SSAO_MAX_HISTORY);
+    glUniform1f(glGetUniformLocation(renderer->ssaoTemporalShader, "u_depthTolerance"), SSAO_DEPTH_TOLERANCE);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, renderer->ssaoRawTexture);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, renderer->ssaoHistoryTextures[history]);
+    glActiveTexture(GL_TEXTURE2);
+    glBindTexture(GL_TEXTURE_2D, renderer->ssaoDepthTexture);
+    glActiveTexture(GL_TEXTURE3);
+    glBindTexture(GL_TEXTURE_2D, renderer->gVelocity);
+    glBindImageTexture(0, renderer->ssaoHistoryTextures[g_ssao_history.current], 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA16F);
+    GL_DispatchCompute2D(ssao_width, ssao_height);
+
+    glUseProgram(renderer->ssaoUpsampleShader);
+    glUniform1f(glGetUniformLocation(renderer->ssaoUpsampleShader, "u_depthSharpness"), SSAO_UPSAMPLE_SHARPNESS);
     glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, renderer->ssaoColorBuffer);
-    glBindVertexArray(renderer->quadVAO);
-    glDrawArrays(GL_TRIANGLES, 0, 6);
-    glViewport(0, 0, engine->width, engine->height);
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glBindTexture(GL_TEXTURE_2D, renderer->ssaoHistoryTextures[g_ssao_history.current]);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, renderer->gPosition);
+    glBindImageTexture(0, renderer->ssaoTexture, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_R8);
+    GL_DispatchCompute2D(engine->width, engine->height);
+
+    glBindImageTexture(0, 0, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_R8);
+    for (int unit = 3; unit >= 0; --unit) {
+        glActiveTexture(GL_TEXTURE0 + unit);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+
+    GL_TemporalHistory_End(&g_ssao_history, projection);
 }
\ No newline at end of file
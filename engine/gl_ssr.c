@@ -22,9 +22,87 @@
  * SOFTWARE.
  */
 #include "gl_ssr.h"
+#include "gl_renderer.h"
+#include "gl_misc.h"
 #include "cvar.h"
+#include <float.h>
+#include <math.h>
+#include <string.h>
 
-void SSR_RenderPass(Renderer* renderer, Engine* engine, GLuint sourceTexture, GLuint destFBO, Mat4* view, Mat4* projection) {
+// SSR traces at SSR_DOWNSAMPLE resolution. A min-depth pyramid is built from
+// gPosition, each reflective pixel walks it hierarchically in screen space,
+// misses fall back to the surrounding reflection probe, and the result is
+// filtered over time before ssr.frag resolves it onto the full-resolution
+// scene.
+
+#define SSR_MAX_ITERATIONS 96
+#define SSR_MAX_DISTANCE 50.0f
+#define SSR_THICKNESS 0.02f
+#define SSR_TEMPORAL_FEEDBACK 0.9f
+
+// Mirrors ReflectionProbe in ssr_trace.comp (std430, 64 bytes).
+typedef struct {
+    float boxMin[4];
+    float boxMax[4];
+    float position[4];
+    unsigned int cubemap[2];
+    unsigned int padding[2];
+} SSRProbe;
+
+static GL_TemporalHistory g_ssr_history;
+
+// Probe boxes come from the brush vertices, so they are only rebuilt and sent
+// to the GPU when the entity set changes or a bake replaces the cubemaps.
+static SSRProbe g_ssr_probes[SSR_MAX_PROBES];
+static int g_ssr_probe_count = 0;
+static unsigned int g_ssr_probe_generation = 0;
+static bool g_ssr_probes_stale = true;
+
+void SSR_InvalidateProbes(void) {
+    g_ssr_probes_stale = true;
+}
+
+static int ssr_upload_probes(Renderer* renderer, Scene* scene) {
+    if (g_ssr_probes_stale || g_ssr_probe_generation != scene->entityClassesGeneration) {
+        const int* indices;
+        int num_brushes = Scene_GetBrushesOfClass(scene, ENTITY_CLASS_ENV_REFLECTIONPROBE, &indices);
+        int count = 0;
+        for (int i = 0; i < num_brushes && count < SSR_MAX_PROBES; ++i) {
+            Brush* b = &scene->brushes[indices[i]];
+            if (b->cubemapTexture == 0 || b->numVertices == 0 || b->vertices == NULL) continue;
+
+            Vec3 min_aabb = { FLT_MAX, FLT_MAX, FLT_MAX };
+            Vec3 max_aabb = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+            for (int j = 0; j < b->numVertices; ++j) {
+                Vec3 world_v = mat4_mul_vec3(&b->modelMatrix, b->vertices[j].pos);
+                min_aabb.x = fminf(min_aabb.x, world_v.x); min_aabb.y = fminf(min_aabb.y, world_v.y); min_aabb.z = fminf(min_aabb.z, world_v.z);
+                max_aabb.x = fmaxf(max_aabb.x, world_v.x); max_aabb.y = fmaxf(max_aabb.y, world_v.y); max_aabb.z = fmaxf(max_aabb.z, world_v.z);
+            }
+
+            SSRProbe* probe = &g_ssr_probes[count++];
+            memset(probe, 0, sizeof(*probe));
+            probe->boxMin[0] = min_aabb.x; probe->boxMin[1] = min_aabb.y; probe->boxMin[2] = min_aabb.z;
+            probe->boxMax[0] = max_aabb.x; probe->boxMax[1] = max_aabb.y; probe->boxMax[2] = max_aabb.z;
+            probe->position[0] = b->pos.x; probe->position[1] = b->pos.y; probe->position[2] = b->pos.z;
+            GLuint64 handle = GL_GetResidentTextureHandle(b->cubemapTexture);
+            probe->cubemap[0] = (unsigned int)(handle & 0xFFFFFFFF);
+            probe->cubemap[1] = (unsigned int)(handle >> 32);
+        }
+
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, renderer->ssrProbeSSBO);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, SSR_MAX_PROBES * sizeof(SSRProbe), NULL, GL_STATIC_DRAW);
+        glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, count * sizeof(SSRProbe), g_ssr_probes);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+        g_ssr_probe_count = count;
+        g_ssr_probe_generation = scene->entityClassesGeneration;
+        g_ssr_probes_stale = false;
+    }
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 5, renderer->ssrProbeSSBO);
+    return g_ssr_probe_count;
+}
+
+void SSR_RenderPass(Renderer* renderer, Scene* scene, Engine* engine, GLuint sourceTexture, GLuint destFBO, Mat4* view, Mat4* projection) {
     if (!Cvar_GetInt("r_ssr")) {
         glBindFramebuffer(GL_READ_FRAMEBUFFER, renderer->finalRenderFBO);
         glBindFramebuffer(GL_DRAW_FRAMEBUFFER, destFBO);
@@ -33,35 +111,91 @@ void SSR_RenderPass(Renderer* renderer, Engine* engine, GLuint sourceTexture, GL
         return;
     }
 
+    const int ssr_width = engine->width / SSR_DOWNSAMPLE;
+    const int ssr_height = engine->height / SSR_DOWNSAMPLE;
+
+    int history = GL_TemporalHistory_Begin(&g_ssr_history, projection);
+
+    glUseProgram(renderer->ssrHiZShader);
+    glUniformMatrix4fv(glGetUniformLocation(renderer->ssrHiZShader, "u_projection"), 1, GL_FALSE, projection->m);
+    glActiveTexture(GL_TEXTURE0);
+    for (int mip = 0; mip < renderer->ssrHiZMipCount; ++mip) {
+        bool from_position = (mip == 0);
+        glBindTexture(GL_TEXTURE_2D, from_position ? renderer->gPosition : renderer->ssrHiZTexture);
+        glUniform1i(glGetUniformLocation(renderer->ssrHiZShader, "u_fromPosition"), from_position);
+        glUniform1i(glGetUniformLocation(renderer->ssrHiZShader, "u_sourceLod"), from_position ? 0 : mip - 1);
+        glBindImageTexture(0, renderer->ssrHiZTexture, mip, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+        GL_DispatchCompute2D(ssr_width >> mip, ssr_height >> mip);
+    }
+
+    Mat4 inv_view;
+    if (!mat4_inverse(view, &inv_view)) {
+        mat4_identity(&inv_view);
+    }
+    int num_probes = ssr_upload_probes(renderer, scene);
+    if (!Cvar_GetInt("r_cubemaps")) num_probes = 0;
+
+    glUseProgram(renderer->ssrTraceShader);
+    glUniformMatrix4fv(glGetUniformLocation(renderer->ssrTraceShader, "u_projection"), 1, GL_FALSE, projection->m);
+    glUniformMatrix4fv(glGetUniformLocation(renderer->ssrTraceShader, "u_invView"), 1, GL_FALSE, inv_view.m);
+    glUniform1i(glGetUniformLocation(renderer->ssrTraceShader, "u_maxLevel"), renderer->ssrHiZMipCount - 1);
+    glUniform1i(glGetUniformLocation(renderer->ssrTraceShader, "u_maxIterations"), SSR_MAX_ITERATIONS);
+    glUniform1i(glGetUniformLocation(renderer->ssrTraceShader, "u_numProbes"), num_probes);
+    glUniform1i(glGetUniformLocation(renderer->ssrTraceShader, "u_frame"), (int)(g_ssr_history.frame & 0x7FFFFFFF));
+    glUniform1f(glGetUniformLocation(renderer->ssrTraceShader, "u_maxDistance"), SSR_MAX_DISTANCE);
+    glUniform1f(glGetUniformLocation(renderer->ssrTraceShader, "u_thickness"), SSR_THICKNESS);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, renderer->ssrHiZTexture);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, sourceTexture);
+    glActiveTexture(GL_TEXTURE2);
+    glBindTexture(GL_TEXTURE_2D, renderer->gPosition);
+    glActiveTexture(GL_TEXTURE3);
+    glBindTexture(GL_TEXTURE_2D, renderer->gNormal);
+    glActiveTexture(GL_TEXTURE4);
+    glBindTexture(GL_TEXTURE_2D, renderer->gPBRParams);
+    glBindImageTexture(0, renderer->ssrTraceTexture, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA16F);
+    GL_DispatchCompute2D(ssr_width, ssr_height);
+
+    glUseProgram(renderer->ssrTemporalShader);
+    glUniform1i(glGetUniformLocation(renderer->ssrTemporalShader, "u_historyValid"), g_ssr_history.valid);
+    glUniform1f(glGetUniformLocation(renderer->ssrTemporalShader, "u_feedback"), SSR_TEMPORAL_FEEDBACK);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, renderer->ssrTraceTexture);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, renderer->ssrHistoryTextures[history]);
+    glActiveTexture(GL_TEXTURE2);
+    glBindTexture(GL_TEXTURE_2D, renderer->gVelocity);
+    glBindImageTexture(0, renderer->ssrHistoryTextures[g_ssr_history.current], 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA16F);
+    GL_DispatchCompute2D(ssr_width, ssr_height);
+    glBindImageTexture(0, 0, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA16F);
+
     glBindFramebuffer(GL_FRAMEBUFFER, destFBO);
     glViewport(0, 0, engine->width, engine->height);
     glClear(GL_COLOR_BUFFER_BIT);
     glDisable(GL_DEPTH_TEST);
 
     glUseProgram(renderer->ssrShader);
-
-    glUniformMatrix4fv(glGetUniformLocation(renderer->ssrShader, "projection"), 1, GL_FALSE, projection->m);
-    glUniformMatrix4fv(glGetUniformLocation(renderer->ssrShader, "view"), 1, GL_FALSE, view->m);
-
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, sourceTexture);
-    glUniform1i(glGetUniformLocation(renderer->ssrShader, "colorBuffer"), 0);
-
     glActiveTexture(GL_TEXTURE1);
     glBindTexture(GL_TEXTURE_2D, renderer->gNormal);
-    glUniform1i(glGetUniformLocation(renderer->ssrShader, "gNormal"), 1);
-
     glActiveTexture(GL_TEXTURE2);
     glBindTexture(GL_TEXTURE_2D, renderer->gPBRParams);
-    glUniform1i(glGetUniformLocation(renderer->ssrShader, "ssrValuesMap"), 2);
-
     glActiveTexture(GL_TEXTURE3);
     glBindTexture(GL_TEXTURE_2D, renderer->gPosition);
-    glUniform1i(glGetUniformLocation(renderer->ssrShader, "gPosition"), 3);
+    glActiveTexture(GL_TEXTURE4);
+    glBindTexture(GL_TEXTURE_2D, renderer->ssrHistoryTextures[g_ssr_history.current]);
 
     glBindVertexArray(renderer->quadVAO);
     glDrawArrays(GL_TRIANGLES, 0, 6);
 
+    for (int unit = 4; unit >= 0; --unit) {
+        glActiveTexture(GL_TEXTURE0 + unit);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
     glEnable(GL_DEPTH_TEST);
+
+    GL_TemporalHistory_End(&g_ssr_history, projection);
 }
\ No newline at end of file
@@ -31,7 +31,10 @@
 extern "C" {
 #endif
 
-void SSR_RenderPass(Renderer* renderer, Engine* engine, GLuint sourceTexture, GLuint destFBO, Mat4* view, Mat4* projection);
+void SSR_RenderPass(Renderer* renderer, Scene* scene, Engine* engine, GLuint sourceTexture, GLuint destFBO, Mat4* view, Mat4* projection);
+// Forces the probe list to be rebuilt, call when the probe SSBO is recreated or
+// the cubemaps are replaced outside of a map load.
+void SSR_InvalidateProbes(void);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,146 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 Soft Sprint Studios
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "gl_stream_buffer.h"
+#include "gl_console.h"
+#include <stdbool.h>
+#include <string.h>
+
+// Beams, cables, glows and particles are rebuilt on the CPU every frame. They
+// all write into one persistently mapped buffer split into per-frame slices, so
+// nothing is re-specified or copied by the driver mid-frame; a fence per slice
+// keeps the CPU from overwriting data the GPU has not consumed yet.
+
+typedef struct {
+    GLuint buffer;
+    unsigned char* mapped;
+    size_t frameSize;
+    size_t head;
+    bool overflowReported;
+} StreamRing;
+
+static StreamRing g_vertex_ring;
+static StreamRing g_index_ring;
+static GLsync g_frame_fences[STREAM_BUFFER_FRAMES];
+static int g_frame_index = 0;
+
+static void StreamRing_Create(StreamRing* ring, size_t frame_size) {
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    ring->frameSize = frame_size;
+    ring->head = 0;
+    ring->overflowReported = false;
+    glGenBuffers(1, &ring->buffer);
+    glBindBuffer(GL_ARRAY_BUFFER, ring->buffer);
+    glBufferStorage(GL_ARRAY_BUFFER, frame_size * STREAM_BUFFER_FRAMES, NULL, flags);
+    ring->mapped = (unsigned char*)glMapBufferRange(GL_ARRAY_BUFFER, 0, frame_size * STREAM_BUFFER_FRAMES, flags);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    if (!ring->mapped) {
+        Console_Printf_Error("[StreamBuffer] Failed to map %zu byte stream buffer.", frame_size * STREAM_BUFFER_FRAMES);
+    }
+}
+
+static void StreamRing_Destroy(StreamRing* ring) {
+    if (!ring->buffer) return;
+    if (ring->mapped) {
+        glBindBuffer(GL_ARRAY_BUFFER, ring->buffer);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+    glDeleteBuffers(1, &ring->buffer);
+    memset(ring, 0, sizeof(*ring));
+}
+
+static void* StreamRing_Alloc(StreamRing* ring, size_t size, size_t alignment, size_t* offset) {
+    if (!ring->mapped || size == 0) return NULL;
+    size_t base = (size_t)g_frame_index * ring->frameSize;
+    size_t start = base + ring->head;
+    start = ((start + alignment - 1) / alignment) * alignment;
+    if (start + size > base + ring->frameSize) {
+        if (!ring->overflowReported) {
+            Console_Printf_Warning("[StreamBuffer] Frame slice of %zu bytes is full, dropping transient geometry.", ring->frameSize);
+            ring->overflowReported = true;
+        }
+        return NULL;
+    }
+    ring->head = start + size - base;
+    *offset = start;
+    return ring->mapped + start;
+}
+
+void StreamBuffer_Init(void) {
+    StreamRing_Create(&g_vertex_ring, STREAM_VERTEX_BYTES_PER_FRAME);
+    StreamRing_Create(&g_index_ring, STREAM_INDEX_BYTES_PER_FRAME);
+    memset(g_frame_fences, 0, sizeof(g_frame_fences));
+    g_frame_index = 0;
+}
+
+void StreamBuffer_Shutdown(void) {
+    for (int i = 0; i < STREAM_BUFFER_FRAMES; ++i) {
+        if (g_frame_fences[i]) {
+            glDeleteSync(g_frame_fences[i]);
+            g_frame_fences[i] = 0;
+        }
+    }
+    StreamRing_Destroy(&g_vertex_ring);
+    StreamRing_Destroy(&g_index_ring);
+}
+
+void StreamBuffer_EndFrame(void) {
+    if (!g_vertex_ring.buffer) return;
+    if (g_frame_fences[g_frame_index]) glDeleteSync(g_frame_fences[g_frame_index]);
+    g_frame_fences[g_frame_index] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    g_frame_index = (g_frame_index + 1) % STREAM_BUFFER_FRAMES;
+    GLsync fence = g_frame_fences[g_frame_index];
+    if (fence) {
+        GLenum status = glClientWaitSync(fence, 0, 0);
+        while (status == GL_TIMEOUT_EXPIRED) {
+            status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull);
+        }
+        glDeleteSync(fence);
+        g_frame_fences[g_frame_index] = 0;
+    }
+    g_vertex_ring.head = 0;
+    g_index_ring.head = 0;
+    g_vertex_ring.overflowReported = false;
+    g_index_ring.overflowReported = false;
+}
+
+void* StreamBuffer_AllocVertices(int count, size_t stride, GLint* first_vertex) {
+    size_t offset = 0;
+    void* ptr = StreamRing_Alloc(&g_vertex_ring, (size_t)count * stride, stride, &offset);
+    if (ptr) *first_vertex = (GLint)(offset / stride);
+    return ptr;
+}
+
+GLuint* StreamBuffer_AllocIndices(int count, size_t* offset) {
+    return (GLuint*)StreamRing_Alloc(&g_index_ring, (size_t)count * sizeof(GLuint), sizeof(GLuint), offset);
+}
+
+GLuint StreamBuffer_GetVertexBuffer(void) {
+    return g_vertex_ring.buffer;
+}
+
+GLuint StreamBuffer_GetIndexBuffer(void) {
+    return g_index_ring.buffer;
+}
\ No newline at end of file
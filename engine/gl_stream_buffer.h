@@ -0,0 +1,62 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 Soft Sprint Studios
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+#ifndef GL_STREAM_BUFFER_H
+#define GL_STREAM_BUFFER_H
+
+//----------------------------------------//
+// Brief: Persistently mapped frame ring for transient vertex and index data
+//----------------------------------------//
+
+#include <SDL.h>
+#include <GL/glew.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define STREAM_BUFFER_FRAMES 3
+#define STREAM_VERTEX_BYTES_PER_FRAME (4 * 1024 * 1024)
+#define STREAM_INDEX_BYTES_PER_FRAME (512 * 1024)
+
+    void StreamBuffer_Init(void);
+    void StreamBuffer_Shutdown(void);
+    // Fences the frame's slice and moves to the next one, waiting only if the
+    // GPU is still STREAM_BUFFER_FRAMES frames behind.
+    void StreamBuffer_EndFrame(void);
+    // Returns write-only mapped memory for count vertices of the given stride, or
+    // NULL when the frame's slice is full. first_vertex is the index to pass as
+    // the first/base vertex when drawing from StreamBuffer_GetVertexBuffer().
+    void* StreamBuffer_AllocVertices(int count, size_t stride, GLint* first_vertex);
+    // Same for 32-bit indices, offset is the byte offset for glDrawElements*.
+    GLuint* StreamBuffer_AllocIndices(int count, size_t* offset);
+    GLuint StreamBuffer_GetVertexBuffer(void);
+    GLuint StreamBuffer_GetIndexBuffer(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GL_STREAM_BUFFER_H
\ No newline at end of file
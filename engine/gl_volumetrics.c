@@ -24,6 +24,21 @@
 #include "gl_volumetrics.h"
 #include "gl_renderer.h"
 
+// Volumetric light lives in a camera-aligned froxel grid. The inject pass
+// writes per-froxel in-scattering for the sun and the lights culled into each
+// block of froxels, blended with the previous frame's grid. The integrate pass
+// accumulates it front to back along every column, and the composite pass
+// resolves each pixel with one 3D lookup at its depth.
+
+#define FROXEL_HISTORY_WEIGHT 0.9f
+
+static const float g_froxel_jitter[8] = { 0.5f, 0.25f, 0.75f, 0.125f, 0.625f, 0.375f, 0.875f, 0.0625f };
+
+static Mat4 g_froxel_prev_view_projection;
+static bool g_froxel_history_valid = false;
+static int g_froxel_current = 0;
+static unsigned int g_froxel_frame = 0;
+
 void Volumetrics_RenderPass(Renderer* renderer, Scene* scene, Engine* engine, Mat4* view, Mat4* projection, const Mat4* sunLightSpaceMatrix) {
     bool should_render_volumetrics = false;
     if (scene->sun.enabled && scene->sun.volumetricIntensity > 0.001f) {
@@ -41,59 +56,77 @@ void Volumetrics_RenderPass(Renderer* renderer, Scene* scene, Engine* engine, Ma
     if (!should_render_volumetrics) {
         glBindFramebuffer(GL_FRAMEBUFFER, renderer->volumetricFBO);
         glClear(GL_COLOR_BUFFER_BIT);
-        glBindFramebuffer(GL_FRAMEBUFFER, renderer->volPingpongFBO[0]);
-        glClear(GL_COLOR_BUFFER_BIT);
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        g_froxel_history_valid = false;
         return;
     }
-    glBindFramebuffer(GL_FRAMEBUFFER, renderer->volumetricFBO);
-    glViewport(0, 0, engine->width / VOLUMETRIC_DOWNSAMPLE, engine->height / VOLUMETRIC_DOWNSAMPLE);
-    glClear(GL_COLOR_BUFFER_BIT);
 
-    glUseProgram(renderer->volumetricShader);
-    glUniform3fv(glGetUniformLocation(renderer->volumetricShader, "viewPos"), 1, &engine->camera.position.x);
+    int history = g_froxel_current;
+    g_froxel_current = 1 - g_froxel_current;
 
-    Mat4 invView, invProj;
+    Mat4 invView, invProj, viewProjection;
     mat4_inverse(view, &invView);
     mat4_inverse(projection, &invProj);
-    glUniformMatrix4fv(glGetUniformLocation(renderer->volumetricShader, "invView"), 1, GL_FALSE, invView.m);
-    glUniformMatrix4fv(glGetUniformLocation(renderer->volumetricShader, "invProjection"), 1, GL_FALSE, invProj.m);
-    glUniformMatrix4fv(glGetUniformLocation(renderer->volumetricShader, "projection"), 1, GL_FALSE, projection->m);
-    glUniformMatrix4fv(glGetUniformLocation(renderer->volumetricShader, "view"), 1, GL_FALSE, view->m);
+    mat4_multiply(&viewProjection, projection, view);
 
-    glUniform1i(glGetUniformLocation(renderer->volumetricShader, "numActiveLights"), scene->numActiveLights);
+    glUseProgram(renderer->volumetricInjectShader);
+    glUniform3fv(glGetUniformLocation(renderer->volumetricInjectShader, "viewPos"), 1, &engine->camera.position.x);
+    glUniformMatrix4fv(glGetUniformLocation(renderer->volumetricInjectShader, "invView"), 1, GL_FALSE, invView.m);
+    glUniformMatrix4fv(glGetUniformLocation(renderer->volumetricInjectShader, "invProjection"), 1, GL_FALSE, invProj.m);
+    glUniformMatrix4fv(glGetUniformLocation(renderer->volumetricInjectShader, "prevViewProjection"), 1, GL_FALSE, g_froxel_prev_view_projection.m);
+    glUniform1f(glGetUniformLocation(renderer->volumetricInjectShader, "u_near"), VOLUMETRIC_FROXEL_NEAR);
+    glUniform1f(glGetUniformLocation(renderer->volumetricInjectShader, "u_far"), VOLUMETRIC_FROXEL_FAR);
+    glUniform1f(glGetUniformLocation(renderer->volumetricInjectShader, "u_jitter"), g_froxel_jitter[g_froxel_frame++ % 8]);
+    glUniform1f(glGetUniformLocation(renderer->volumetricInjectShader, "u_historyWeight"), g_froxel_history_valid ? FROXEL_HISTORY_WEIGHT : 0.0f);
+    glUniform1i(glGetUniformLocation(renderer->volumetricInjectShader, "numActiveLights"), scene->numActiveLights);
 
-    glUniform1i(glGetUniformLocation(renderer->volumetricShader, "sun.enabled"), scene->sun.enabled);
+    glUniform1i(glGetUniformLocation(renderer->volumetricInjectShader, "sun.enabled"), scene->sun.enabled);
     if (scene->sun.enabled) {
         glActiveTexture(GL_TEXTURE15);
         glBindTexture(GL_TEXTURE_2D, renderer->sunShadowMap);
-        glUniform1i(glGetUniformLocation(renderer->volumetricShader, "sunShadowMap"), 15);
-        glUniformMatrix4fv(glGetUniformLocation(renderer->volumetricShader, "sunLightSpaceMatrix"), 1, GL_FALSE, sunLightSpaceMatrix->m);
-        glUniform3fv(glGetUniformLocation(renderer->volumetricShader, "sun.direction"), 1, &scene->sun.direction.x);
-        glUniform3fv(glGetUniformLocation(renderer->volumetricShader, "sun.color"), 1, &scene->sun.color.x);
-        glUniform1f(glGetUniformLocation(renderer->volumetricShader, "sun.intensity"), scene->sun.intensity);
-        glUniform1f(glGetUniformLocation(renderer->volumetricShader, "sun.volumetricIntensity"), scene->sun.volumetricIntensity / 100.0f);
+        glUniform1i(glGetUniformLocation(renderer->volumetricInjectShader, "sunShadowMap"), 15);
+        glUniformMatrix4fv(glGetUniformLocation(renderer->volumetricInjectShader, "sunLightSpaceMatrix"), 1, GL_FALSE, sunLightSpaceMatrix->m);
+        glUniform3fv(glGetUniformLocation(renderer->volumetricInjectShader, "sun.direction"), 1, &scene->sun.direction.x);
+        glUniform3fv(glGetUniformLocation(renderer->volumetricInjectShader, "sun.color"), 1, &scene->sun.color.x);
+        glUniform1f(glGetUniformLocation(renderer->volumetricInjectShader, "sun.intensity"), scene->sun.intensity);
+        glUniform1f(glGetUniformLocation(renderer->volumetricInjectShader, "sun.volumetricIntensity"), scene->sun.volumetricIntensity / 100.0f);
     }
 
     glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, renderer->gPosition);
+    glBindTexture(GL_TEXTURE_3D, renderer->froxelScatterTextures[history]);
+    glBindImageTexture(0, renderer->froxelScatterTextures[g_froxel_current], 0, GL_TRUE, 0, GL_WRITE_ONLY, GL_RGBA16F);
+    glDispatchCompute((VOLUMETRIC_FROXEL_X + 3) / 4, (VOLUMETRIC_FROXEL_Y + 3) / 4, (VOLUMETRIC_FROXEL_Z + 3) / 4);
+    glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
 
+    glUseProgram(renderer->volumetricIntegrateShader);
+    glUniformMatrix4fv(glGetUniformLocation(renderer->volumetricIntegrateShader, "invProjection"), 1, GL_FALSE, invProj.m);
+    glUniform1f(glGetUniformLocation(renderer->volumetricIntegrateShader, "u_near"), VOLUMETRIC_FROXEL_NEAR);
+    glUniform1f(glGetUniformLocation(renderer->volumetricIntegrateShader, "u_far"), VOLUMETRIC_FROXEL_FAR);
+    glBindImageTexture(0, renderer->froxelScatterTextures[g_froxel_current], 0, GL_TRUE, 0, GL_READ_ONLY, GL_RGBA16F);
+    glBindImageTexture(1, renderer->froxelIntegratedTexture, 0, GL_TRUE, 0, GL_WRITE_ONLY, GL_RGBA16F);
+    glDispatchCompute((VOLUMETRIC_FROXEL_X + 7) / 8, (VOLUMETRIC_FROXEL_Y + 7) / 8, 1);
+    glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+    glBindImageTexture(0, 0, 0, GL_FALSE, 0, GL_READ_ONLY, GL_RGBA16F);
+    glBindImageTexture(1, 0, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA16F);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, renderer->volumetricFBO);
+    glViewport(0, 0, engine->width / VOLUMETRIC_DOWNSAMPLE, engine->height / VOLUMETRIC_DOWNSAMPLE);
+    glUseProgram(renderer->volumetricShader);
+    glUniform1f(glGetUniformLocation(renderer->volumetricShader, "u_near"), VOLUMETRIC_FROXEL_NEAR);
+    glUniform1f(glGetUniformLocation(renderer->volumetricShader, "u_far"), VOLUMETRIC_FROXEL_FAR);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, renderer->gPosition);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_3D, renderer->froxelIntegratedTexture);
     glBindVertexArray(renderer->quadVAO);
     glDrawArrays(GL_TRIANGLES, 0, 6);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_3D, 0);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_3D, 0);
 
-    bool horizontal = true, first_iteration = true;
-    unsigned int amount = 4;
-    glUseProgram(renderer->volumetricBlurShader);
-    for (unsigned int i = 0; i < amount; i++) {
-        glBindFramebuffer(GL_FRAMEBUFFER, renderer->volPingpongFBO[horizontal]);
-        glUniform1i(glGetUniformLocation(renderer->volumetricBlurShader, "horizontal"), horizontal);
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, first_iteration ? renderer->volumetricTexture : renderer->volPingpongTextures[!horizontal]);
-        glBindVertexArray(renderer->quadVAO);
-        glDrawArrays(GL_TRIANGLES, 0, 6);
-        horizontal = !horizontal;
-        if (first_iteration) first_iteration = false;
-    }
+    g_froxel_prev_view_projection = viewProjection;
+    g_froxel_history_valid = true;
 
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
     glViewport(0, 0, engine->width, engine->height);
@@ -1,5 +1,6 @@
 #include "gl_zprepass.h"
 #include "gl_misc.h"
+#include "gl_geometry.h"
 
 void Zprepass_Init(Renderer* renderer) {
     renderer->zPrepassShader = createShaderProgram("shaders/zprepass.vert", "shaders/zprepass.frag");
@@ -49,6 +50,7 @@ void Zprepass_Render(Renderer* renderer, Scene* scene, Engine* engine, const Mat
 
         if (hasTessellatedMesh) {
             glPatchParameteri(GL_PATCH_VERTICES, 3);
+            Geometry_SetTessellationUniforms(shader, engine);
             for (int meshIdx = 0; meshIdx < obj->model->meshCount; ++meshIdx) {
                 Mesh* mesh = &obj->model->meshes[meshIdx];
                 Material* mat = mesh->material;
@@ -110,6 +112,7 @@ void Zprepass_Render(Renderer* renderer, Scene* scene, Engine* engine, const Mat
             glUniformMatrix4fv(glGetUniformLocation(renderer->zPrepassTessShader, "view"), 1, GL_FALSE, view->m);
             glUniformMatrix4fv(glGetUniformLocation(renderer->zPrepassTessShader, "projection"), 1, GL_FALSE, projection->m);
             glUniformMatrix4fv(glGetUniformLocation(renderer->zPrepassTessShader, "model"), 1, GL_FALSE, b->modelMatrix.m);
+            Geometry_SetTessellationUniforms(renderer->zPrepassTessShader, engine);
 
             glBindVertexArray(b->vao);
             int vbo_offset = 0;
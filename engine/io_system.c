@@ -32,24 +32,98 @@
 
 IOConnection g_io_connections[MAX_IO_CONNECTIONS];
 int g_num_io_connections = 0;
-static PendingEvent g_pending_events[MAX_PENDING_EVENTS];
-static int g_num_pending_events = 0;
 extern g_player_input_disabled;
 
+// Delayed events live in a binary min-heap ordered by execution time, with a
+// sequence number so events due on the same frame run in the order they fired.
+#define IO_INITIAL_EVENT_CAPACITY 256
+// A chain of zero-delay outputs that keeps re-firing itself would otherwise
+// never leave IO_ProcessPendingEvents.
+#define IO_MAX_EVENTS_PER_FRAME 65536
+
+static PendingEvent* g_pending_events = NULL;
+static int g_num_pending_events = 0;
+static int g_pending_capacity = 0;
+static unsigned int g_next_event_sequence = 0;
+
+// Connections are bucketed by source entity. Each bucket is a run in
+// g_conn_order, and the output names are pre-hashed so a fired output only
+// compares strings against connections on that entity with the same hash.
+#define IO_SOURCE_TABLE_SIZE (MAX_IO_CONNECTIONS * 2)
+
+typedef struct {
+    bool used;
+    int key;
+    int start;
+    int count;
+} IOSourceBucket;
+
+static IOSourceBucket g_source_table[IO_SOURCE_TABLE_SIZE];
+static int g_conn_order[MAX_IO_CONNECTIONS];
+static unsigned int g_conn_output_hash[MAX_IO_CONNECTIONS];
+static bool g_connection_index_dirty = true;
+
+// Every named entity in the scene, grouped by targetname. Handles within a
+// name keep the order ExecuteInput has always visited them in.
+typedef struct {
+    EntityType type;
+    int index;
+} IOTargetHandle;
+
+typedef struct {
+    char name[64];
+    unsigned int hash;
+    int start;
+    int count;
+} IOTargetBucket;
+
+static IOTargetBucket* g_target_table = NULL;
+static int g_target_table_size = 0;
+static IOTargetHandle* g_target_handles = NULL;
+static int g_target_handle_capacity = 0;
+
+static unsigned int io_hash_string(const char* s) {
+    unsigned int h = 2166136261u;
+    while (*s) {
+        h ^= (unsigned char)*s++;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static int io_source_key(EntityType type, int index) {
+    return ((int)type << 24) | (index & 0xFFFFFF);
+}
+
+static int io_source_slot(int key) {
+    unsigned int h = (unsigned int)key * 2654435761u;
+    return (int)((h >> 8) & (IO_SOURCE_TABLE_SIZE - 1));
+}
+
 void IO_Init() {
     IO_Clear();
-    memset(g_pending_events, 0, sizeof(g_pending_events));
-    g_num_pending_events = 0;
+    IO_ClearPendingEvents();
     Console_Printf("IO System Initialized.\n");
 }
 
 void IO_Shutdown() {
+    free(g_pending_events);
+    g_pending_events = NULL;
+    g_num_pending_events = 0;
+    g_pending_capacity = 0;
+    free(g_target_table);
+    g_target_table = NULL;
+    g_target_table_size = 0;
+    free(g_target_handles);
+    g_target_handles = NULL;
+    g_target_handle_capacity = 0;
     Console_Printf("IO System Shutdown.\n");
 }
 
 void IO_Clear() {
     memset(g_io_connections, 0, sizeof(g_io_connections));
     g_num_io_connections = 0;
+    g_connection_index_dirty = true;
 }
 
 IOConnection* IO_AddConnection(EntityType sourceType, int sourceIndex, const char* output) {
@@ -69,6 +143,7 @@ IOConnection* IO_AddConnection(EntityType sourceType, int sourceIndex, const cha
     conn->fireOnce = false;
     conn->hasFired = false;
     g_num_io_connections++;
+    g_connection_index_dirty = true;
     return conn;
 }
 
@@ -78,6 +153,125 @@ void IO_RemoveConnection(int connection_index) {
         g_io_connections[i] = g_io_connections[i + 1];
     }
     g_num_io_connections--;
+    g_connection_index_dirty = true;
+}
+
+static IOSourceBucket* io_find_source(int key, bool insert) {
+    int slot = io_source_slot(key);
+    while (g_source_table[slot].used) {
+        if (g_source_table[slot].key == key) return &g_source_table[slot];
+        slot = (slot + 1) & (IO_SOURCE_TABLE_SIZE - 1);
+    }
+    if (!insert) return NULL;
+    g_source_table[slot].used = true;
+    g_source_table[slot].key = key;
+    return &g_source_table[slot];
+}
+
+static void io_rebuild_connection_index(void) {
+    memset(g_source_table, 0, sizeof(g_source_table));
+
+    for (int i = 0; i < g_num_io_connections; ++i) {
+        IOConnection* conn = &g_io_connections[i];
+        g_conn_output_hash[i] = io_hash_string(conn->outputName);
+        io_find_source(io_source_key(conn->sourceType, conn->sourceIndex), true)->count++;
+    }
+
+    int offset = 0;
+    for (int slot = 0; slot < IO_SOURCE_TABLE_SIZE; ++slot) {
+        if (!g_source_table[slot].used) continue;
+        g_source_table[slot].start = offset;
+        offset += g_source_table[slot].count;
+        g_source_table[slot].count = 0;
+    }
+    for (int i = 0; i < g_num_io_connections; ++i) {
+        IOSourceBucket* bucket = io_find_source(io_source_key(g_io_connections[i].sourceType, g_io_connections[i].sourceIndex), false);
+        g_conn_order[bucket->start + bucket->count++] = i;
+    }
+    g_connection_index_dirty = false;
+}
+
+static void io_add_target(const char* name, EntityType type, int index, bool count_only) {
+    if (!name || name[0] == '\0') return;
+    unsigned int hash = io_hash_string(name);
+    int mask = g_target_table_size - 1;
+    int slot = (int)(hash & mask);
+    while (g_target_table[slot].name[0] != '\0') {
+        if (g_target_table[slot].hash == hash && strcmp(g_target_table[slot].name, name) == 0) break;
+        slot = (slot + 1) & mask;
+    }
+    IOTargetBucket* bucket = &g_target_table[slot];
+    if (bucket->name[0] == '\0') {
+        strncpy(bucket->name, name, sizeof(bucket->name) - 1);
+        bucket->hash = hash;
+    }
+    if (count_only) {
+        bucket->count++;
+    }
+    else {
+        g_target_handles[bucket->start + bucket->count++] = (IOTargetHandle){ type, index };
+    }
+}
+
+static void io_visit_targets(Scene* scene, bool count_only) {
+    for (int i = 0; i < scene->numLogicEntities; ++i) io_add_target(scene->logicEntities[i].targetname, ENTITY_LOGIC, i, count_only);
+    for (int i = 0; i < scene->numObjects; ++i) io_add_target(scene->objects[i].targetname, ENTITY_MODEL, i, count_only);
+    for (int i = 0; i < scene->numBrushes; ++i) io_add_target(scene->brushes[i].targetname, ENTITY_BRUSH, i, count_only);
+    for (int i = 0; i < scene->numActiveLights; ++i) io_add_target(scene->lights[i].targetname, ENTITY_LIGHT, i, count_only);
+    for (int i = 0; i < scene->numSoundEntities; ++i) io_add_target(scene->soundEntities[i].targetname, ENTITY_SOUND, i, count_only);
+    for (int i = 0; i < scene->numParticleEmitters; ++i) io_add_target(scene->particleEmitters[i].targetname, ENTITY_PARTICLE_EMITTER, i, count_only);
+    for (int i = 0; i < scene->numVideoPlayers; ++i) io_add_target(scene->videoPlayers[i].targetname, ENTITY_VIDEO_PLAYER, i, count_only);
+    for (int i = 0; i < scene->numSprites; ++i) io_add_target(scene->sprites[i].targetname, ENTITY_SPRITE, i, count_only);
+}
+
+void IO_RebuildIndex(Scene* scene) {
+    io_rebuild_connection_index();
+
+    int num_entities = scene->numLogicEntities + scene->numObjects + scene->numBrushes + scene->numActiveLights +
+        scene->numSoundEntities + scene->numParticleEmitters + scene->numVideoPlayers + scene->numSprites;
+    int table_size = 64;
+    while (table_size < num_entities * 2) table_size *= 2;
+    if (table_size != g_target_table_size) {
+        IOTargetBucket* table = realloc(g_target_table, table_size * sizeof(IOTargetBucket));
+        if (!table) {
+            Console_Printf_Error("[ERROR] Out of memory building the IO target table.");
+            return;
+        }
+        g_target_table = table;
+        g_target_table_size = table_size;
+    }
+    if (num_entities > g_target_handle_capacity) {
+        IOTargetHandle* handles = realloc(g_target_handles, num_entities * sizeof(IOTargetHandle));
+        if (!handles) {
+            Console_Printf_Error("[ERROR] Out of memory building the IO target table.");
+            return;
+        }
+        g_target_handles = handles;
+        g_target_handle_capacity = num_entities;
+    }
+    memset(g_target_table, 0, g_target_table_size * sizeof(IOTargetBucket));
+
+    io_visit_targets(scene, true);
+    int offset = 0;
+    for (int slot = 0; slot < g_target_table_size; ++slot) {
+        if (g_target_table[slot].name[0] == '\0') continue;
+        g_target_table[slot].start = offset;
+        offset += g_target_table[slot].count;
+        g_target_table[slot].count = 0;
+    }
+    io_visit_targets(scene, false);
+}
+
+static const IOTargetBucket* io_find_target(const char* name) {
+    if (!name || name[0] == '\0' || g_target_table_size == 0) return NULL;
+    unsigned int hash = io_hash_string(name);
+    int mask = g_target_table_size - 1;
+    int slot = (int)(hash & mask);
+    while (g_target_table[slot].name[0] != '\0') {
+        if (g_target_table[slot].hash == hash && strcmp(g_target_table[slot].name, name) == 0) return &g_target_table[slot];
+        slot = (slot + 1) & mask;
+    }
+    return NULL;
 }
 
 int IO_GetConnectionsForEntity(EntityType type, int index, IOConnection** connections_out, int max_out) {
@@ -94,71 +288,144 @@ int IO_GetConnectionsForEntity(EntityType type, int index, IOConnection** connec
 }
 
 bool IO_FindNamedEntity(Scene* scene, const char* name, Vec3* out_pos, Vec3* out_angles) {
-    if (!name || *name == '\0') return false;
+    const IOTargetBucket* bucket = io_find_target(name);
+    if (!bucket) return false;
 
-    for (int i = 0; i < scene->numLogicEntities; ++i) {
-        if (strcmp(scene->logicEntities[i].targetname, name) == 0 && strcmp(scene->logicEntities[i].classname, "info_target") == 0) {
-            if (out_pos) *out_pos = scene->logicEntities[i].pos;
-            if (out_angles) *out_angles = scene->logicEntities[i].rot;
+    for (int k = 0; k < bucket->count; ++k) {
+        const IOTargetHandle* handle = &g_target_handles[bucket->start + k];
+        if (handle->type != ENTITY_LOGIC) continue;
+        LogicEntity* ent = &scene->logicEntities[handle->index];
+        if (ent->classId == ENTITY_CLASS_INFO_TARGET) {
+            if (out_pos) *out_pos = ent->pos;
+            if (out_angles) *out_angles = ent->rot;
             return true;
         }
     }
     return false;
 }
 
-void IO_FireOutput(EntityType sourceType, int sourceIndex, const char* outputName, float currentTime, const char* parameter) {
-    for (int i = 0; i < g_num_io_connections; ++i) {
-        IOConnection* conn = &g_io_connections[i];
-        if (conn->active && conn->sourceType == sourceType && conn->sourceIndex == sourceIndex && strcmp(conn->outputName, outputName) == 0) {
-            if (conn->fireOnce && conn->hasFired) {
-                continue;
-            }
+static bool io_event_before(const PendingEvent* a, const PendingEvent* b) {
+    if (a->executionTime != b->executionTime) return a->executionTime < b->executionTime;
+    return a->sequence < b->sequence;
+}
 
-            if (g_num_pending_events >= MAX_PENDING_EVENTS) {
-                Console_Printf_Error("ERROR: Max pending events reached!\n");
-                return;
-            }
+static PendingEvent* io_push_event(void) {
+    if (g_num_pending_events >= g_pending_capacity) {
+        int capacity = g_pending_capacity > 0 ? g_pending_capacity * 2 : IO_INITIAL_EVENT_CAPACITY;
+        PendingEvent* events = realloc(g_pending_events, capacity * sizeof(PendingEvent));
+        if (!events) {
+            Console_Printf_Error("ERROR: Out of memory queueing IO event!\n");
+            return NULL;
+        }
+        g_pending_events = events;
+        g_pending_capacity = capacity;
+    }
+    PendingEvent* event = &g_pending_events[g_num_pending_events++];
+    memset(event, 0, sizeof(*event));
+    event->active = true;
+    event->sequence = g_next_event_sequence++;
+    return event;
+}
 
-            PendingEvent* event = &g_pending_events[g_num_pending_events++];
-            event->active = true;
-            strncpy(event->targetName, conn->targetName, 63);
-            strncpy(event->inputName, conn->inputName, 63);
-            if (parameter) {
-                strncpy(event->parameter, parameter, 63);
-            }
-            else {
-                strncpy(event->parameter, conn->parameter, 63);
-            }
-            event->parameter[63] = '\0';
-            event->executionTime = currentTime + conn->delay;
+// Called once the pushed event's fields are filled in.
+static void io_sift_up(int i) {
+    PendingEvent event = g_pending_events[i];
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (!io_event_before(&event, &g_pending_events[parent])) break;
+        g_pending_events[i] = g_pending_events[parent];
+        i = parent;
+    }
+    g_pending_events[i] = event;
+}
 
-            conn->hasFired = true;
-        }
+static void io_pop_event(PendingEvent* out) {
+    *out = g_pending_events[0];
+    PendingEvent last = g_pending_events[--g_num_pending_events];
+    int i = 0;
+    for (;;) {
+        int child = i * 2 + 1;
+        if (child >= g_num_pending_events) break;
+        if (child + 1 < g_num_pending_events && io_event_before(&g_pending_events[child + 1], &g_pending_events[child])) child++;
+        if (!io_event_before(&g_pending_events[child], &last)) break;
+        g_pending_events[i] = g_pending_events[child];
+        i = child;
     }
+    if (g_num_pending_events > 0) g_pending_events[i] = last;
 }
 
-void IO_ProcessPendingEvents(float currentTime, Scene* scene, Engine* engine) {
-    for (int i = 0; i < g_num_pending_events; ++i) {
-        PendingEvent* event = &g_pending_events[i];
-        if (event->active && currentTime >= event->executionTime) {
-            ExecuteInput(event->targetName, event->inputName, event->parameter, scene, engine);
-            event->active = false;
+void IO_FireOutput(EntityType sourceType, int sourceIndex, const char* outputName, float currentTime, const char* parameter) {
+    if (g_connection_index_dirty) io_rebuild_connection_index();
+
+    const IOSourceBucket* bucket = io_find_source(io_source_key(sourceType, sourceIndex), false);
+    if (!bucket) return;
+
+    unsigned int output_hash = io_hash_string(outputName);
+    for (int k = 0; k < bucket->count; ++k) {
+        int i = g_conn_order[bucket->start + k];
+        IOConnection* conn = &g_io_connections[i];
+        if (g_conn_output_hash[i] != output_hash || !conn->active || strcmp(conn->outputName, outputName) != 0) continue;
+        if (conn->fireOnce && conn->hasFired) {
+            continue;
+        }
+
+        PendingEvent* event = io_push_event();
+        if (!event) return;
+        strncpy(event->targetName, conn->targetName, 63);
+        strncpy(event->inputName, conn->inputName, 63);
+        if (parameter) {
+            strncpy(event->parameter, parameter, 63);
+        }
+        else {
+            strncpy(event->parameter, conn->parameter, 63);
         }
+        event->parameter[63] = '\0';
+        event->executionTime = currentTime + conn->delay;
+        io_sift_up(g_num_pending_events - 1);
+
+        conn->hasFired = true;
     }
+}
 
-    int write_idx = 0;
-    for (int read_idx = 0; read_idx < g_num_pending_events; ++read_idx) {
-        if (g_pending_events[read_idx].active) {
-            if (write_idx != read_idx) {
-                g_pending_events[write_idx] = g_pending_events[read_idx];
-            }
-            write_idx++;
+int IO_GetPendingEvents(const PendingEvent** events_out) {
+    if (events_out) *events_out = g_pending_events;
+    return g_num_pending_events;
+}
+
+void IO_ClearPendingEvents(void) {
+    g_num_pending_events = 0;
+    g_next_event_sequence = 0;
+}
+
+bool IO_QueueEvent(const char* targetName, const char* inputName, const char* parameter, float executionTime) {
+    PendingEvent* event = io_push_event();
+    if (!event) return false;
+    strncpy(event->targetName, targetName, 63);
+    strncpy(event->inputName, inputName, 63);
+    strncpy(event->parameter, parameter ? parameter : "", 63);
+    event->executionTime = executionTime;
+    io_sift_up(g_num_pending_events - 1);
+    return true;
+}
+
+void IO_ProcessPendingEvents(float currentTime, Scene* scene, Engine* engine) {
+    int dispatched = 0;
+    while (g_num_pending_events > 0 && currentTime >= g_pending_events[0].executionTime) {
+        if (dispatched++ >= IO_MAX_EVENTS_PER_FRAME) {
+            Console_Printf_Warning("[IO] Over %d events fired this frame, deferring the rest. Check for outputs that trigger themselves.", IO_MAX_EVENTS_PER_FRAME);
+            break;
         }
+        PendingEvent event;
+        io_pop_event(&event);
+        ExecuteInput(event.targetName, event.inputName, event.parameter, scene, engine);
     }
-    g_num_pending_events = write_idx;
 }
 
 LogicEntity* FindActiveEntityByClass(Scene* scene, const char* classname) {
+    EntityClassId id = EntityClass_FromName(classname);
+    if (id != ENTITY_CLASS_UNKNOWN) {
+        return Scene_FindActiveLogicEntity(scene, id);
+    }
     for (int i = 0; i < scene->numLogicEntities; ++i) {
         if (strcmp(scene->logicEntities[i].classname, classname) == 0 && scene->logicEntities[i].runtime_active) {
             return &scene->logicEntities[i];
@@ -167,490 +434,604 @@ LogicEntity* FindActiveEntityByClass(Scene* scene, const char* classname) {
     return NULL;
 }
 
-void ExecuteInput(const char* targetName, const char* inputName, const char* parameter, Scene* scene, Engine* engine) {
-    for (int i = 0; i < scene->numLogicEntities; ++i) {
-        if (strcmp(scene->logicEntities[i].targetname, targetName) == 0) {
-            LogicEntity* ent = &scene->logicEntities[i];
-            if (strcmp(ent->classname, "logic_timer") == 0) {
-                if (strcmp(inputName, "StartTimer") == 0) {
-                    ent->runtime_active = true;
-                    const char* delay_val = LogicEntity_GetProperty(ent, "delay", "1.0");
-                    ent->runtime_float_a = atof(delay_val);
-                }
-                else if (strcmp(inputName, "StopTimer") == 0) {
-                    ent->runtime_active = false;
-                }
-                else if (strcmp(inputName, "ToggleTimer") == 0) {
-                    ent->runtime_active = !ent->runtime_active;
-                    if (ent->runtime_active && ent->runtime_float_a <= 0) {
-                        const char* delay_val = LogicEntity_GetProperty(ent, "delay", "1.0");
-                        ent->runtime_float_a = atof(delay_val);
-                    }
-                }
-            }
-            else if (strcmp(ent->classname, "math_counter") == 0) {
-                int min = atoi(LogicEntity_GetProperty(ent, "min", "0"));
-                int max = atoi(LogicEntity_GetProperty(ent, "max", "0"));
-                int value = (parameter && strlen(parameter) > 0) ? atoi(parameter) : 1;
-
-                if (strcmp(inputName, "Add") == 0) ent->runtime_float_a += value;
-                else if (strcmp(inputName, "Subtract") == 0) ent->runtime_float_a -= value;
-                else if (strcmp(inputName, "Multiply") == 0) ent->runtime_float_a *= value;
-                else if (strcmp(inputName, "Divide") == 0) {
-                    if (value != 0) ent->runtime_float_a /= value;
-                    else Console_Printf_Error("[error] math_counter '%s' tried to divide by zero.", ent->targetname);
-                }
+// Inputs are dispatched through one handler per entity class. The handler
+// still picks the input by name, but only among the few that class accepts.
+typedef void (*LogicInputHandler)(LogicEntity* ent, int index, const char* inputName, const char* parameter, Engine* engine);
+typedef void (*BrushInputHandler)(Brush* b, int index, const char* inputName, const char* parameter, Engine* engine);
 
-                if (max != 0 && ent->runtime_float_a >= max) IO_FireOutput(ENTITY_LOGIC, i, "OnHitMax", 0, NULL);
-                if (min != 0 && ent->runtime_float_a <= min) IO_FireOutput(ENTITY_LOGIC, i, "OnHitMin", 0, NULL);
-            }
-            else if (strcmp(ent->classname, "logic_random") == 0) {
-                if (strcmp(inputName, "Enable") == 0) {
-                    if (!ent->runtime_active) {
-                        const char* min_time_str = LogicEntity_GetProperty(ent, "min_time", "0.0");
-                        const char* max_time_str = LogicEntity_GetProperty(ent, "max_time", "0.0");
-                        ent->runtime_float_a = rand_float_range(atof(min_time_str), atof(max_time_str));
-                    }
-                    ent->runtime_active = true;
-                }
-                else if (strcmp(inputName, "Disable") == 0) ent->runtime_active = false;
-            }
-            else if (strcmp(ent->classname, "logic_relay") == 0) {
-                if (strcmp(inputName, "Trigger") == 0 && ent->runtime_active) IO_FireOutput(ENTITY_LOGIC, i, "OnTrigger", engine->lastFrame, NULL);
-                else if (strcmp(inputName, "Enable") == 0) ent->runtime_active = true;
-                else if (strcmp(inputName, "Disable") == 0) ent->runtime_active = false;
-                else if (strcmp(inputName, "Toggle") == 0) ent->runtime_active = !ent->runtime_active;
-            }
-            else if (strcmp(ent->classname, "logic_repeat") == 0) {
-                if (strcmp(inputName, "EnableRepeat") == 0) {
-                    ent->runtime_active = true;
-                    ent->runtime_float_a = atof(LogicEntity_GetProperty(ent, "delay", "1.0"));
-                    ent->runtime_int_a = atoi(LogicEntity_GetProperty(ent, "repeats", "-1"));
-                }
-                else if (strcmp(inputName, "StopRepeat") == 0) {
-                    ent->runtime_active = false;
-                }
-                else if (strcmp(inputName, "ResetRepeat") == 0) {
-                    ent->runtime_active = false;
-                    ent->runtime_int_a = atoi(LogicEntity_GetProperty(ent, "repeats", "-1"));
-                }
-            }
-            else if (strcmp(ent->classname, "env_overlay") == 0) {
-                if (strcmp(inputName, "TurnOn") == 0) ent->runtime_active = true;
-                else if (strcmp(inputName, "TurnOff") == 0) ent->runtime_active = false;
-                else if (strcmp(inputName, "Toggle") == 0) ent->runtime_active = !ent->runtime_active;
-            }
-            else if (strcmp(ent->classname, "point_servercommand") == 0) {
-                if (strcmp(inputName, "Command") == 0) {
-                    if (parameter && strlen(parameter) > 0) {
-                        char cmd_copy[MAX_COMMAND_LENGTH];
-                        strncpy(cmd_copy, parameter, MAX_COMMAND_LENGTH - 1);
-                        cmd_copy[MAX_COMMAND_LENGTH - 1] = '\0';
-
-                        char* argv[16];
-                        int argc = 0;
-                        char* p = strtok(cmd_copy, " ");
-                        while (p != NULL && argc < 16) {
-                            argv[argc++] = p;
-                            p = strtok(NULL, " ");
-                        }
-                        if (argc > 0) {
-                            Commands_Execute(argc, argv);
-                        }
-                    }
-                }
-            }
-            else if (strcmp(ent->classname, "logic_compare") == 0) {
-                if (strcmp(inputName, "SetValue") == 0) {
-                    ent->runtime_float_a = atof(parameter);
-                }
-                else if (strcmp(inputName, "SetCompareValue") == 0) {
-                    for (int prop_idx = 0; prop_idx < ent->numProperties; ++prop_idx) {
-                        if (strcmp(ent->properties[prop_idx].key, "CompareValue") == 0) {
-                            strncpy(ent->properties[prop_idx].value, parameter, sizeof(ent->properties[prop_idx].value) - 1);
-                            break;
-                        }
-                    }
-                }
-                else if (strcmp(inputName, "Compare") == 0 || strcmp(inputName, "SetValueCompare") == 0) {
-                    if (strcmp(inputName, "SetValueCompare") == 0) {
-                        ent->runtime_float_a = atof(parameter);
-                    }
-
-                    float val_a = ent->runtime_float_a;
-                    float val_b = atof(LogicEntity_GetProperty(ent, "CompareValue", "0"));
-                    char param_out[32];
-                    sprintf(param_out, "%f", val_a);
-
-                    if (val_a < val_b) IO_FireOutput(ENTITY_LOGIC, i, "OnLessThan", engine->lastFrame, param_out);
-                    if (val_a == val_b) IO_FireOutput(ENTITY_LOGIC, i, "OnEqualTo", engine->lastFrame, param_out);
-                    if (val_a != val_b) IO_FireOutput(ENTITY_LOGIC, i, "OnNotEqualTo", engine->lastFrame, param_out);
-                    if (val_a > val_b) IO_FireOutput(ENTITY_LOGIC, i, "OnGreaterThan", engine->lastFrame, param_out);
-                }
-            }
-            else if (strcmp(ent->classname, "env_blackhole") == 0) {
-                if (strcmp(inputName, "Enable") == 0) {
-                    ent->runtime_active = true;
-                }
-                else if (strcmp(inputName, "Disable") == 0) {
-                    ent->runtime_active = false;
-                }
-            }
-            else if (strcmp(ent->classname, "env_fade") == 0) {
-                if (strcmp(inputName, "FadeIn") == 0) {
-                    ent->runtime_int_a = 1;
-                    ent->runtime_float_a = 0.0f;
-                }
-                else if (strcmp(inputName, "FadeOut") == 0) {
-                    ent->runtime_int_a = 2;
-                    ent->runtime_float_a = 0.0f;
-                }
-                else if (strcmp(inputName, "Fade") == 0) {
-                    ent->runtime_int_a = 4;
-                    ent->runtime_float_a = 0.0f;
-                }
-            }
-            else if (strcmp(ent->classname, "env_shake") == 0) {
-                bool global_shake = atoi(LogicEntity_GetProperty(ent, "GlobalShake", "0"));
-                float radius = atof(LogicEntity_GetProperty(ent, "radius", "500.0"));
-                float dist_sq = vec3_length_sq(vec3_sub(engine->camera.position, ent->pos));
-
-                if (strcmp(inputName, "StartShake") == 0) {
-                    if (global_shake || dist_sq < (radius * radius)) {
-                        engine->shake_amplitude = atof(LogicEntity_GetProperty(ent, "amplitude", "4.0"));
-                        engine->shake_frequency = atof(LogicEntity_GetProperty(ent, "frequency", "40.0"));
-                        engine->shake_duration_timer = atof(LogicEntity_GetProperty(ent, "duration", "1.0"));
-                    }
-                }
-                else if (strcmp(inputName, "StopShake") == 0) {
-                    if (global_shake || dist_sq < (radius * radius)) {
-                        engine->shake_amplitude = 0.0f;
-                        engine->shake_duration_timer = 0.0f;
-                    }
-                }
-            }
-            else if (strcmp(ent->classname, "env_fog") == 0) {
-                if (strcmp(inputName, "Enable") == 0) ent->runtime_active = true;
-                else if (strcmp(inputName, "Disable") == 0) ent->runtime_active = false;
-            }
-            else if (strcmp(ent->classname, "env_beam") == 0) {
-                if (strcmp(inputName, "TurnOn") == 0) {
-                    ent->runtime_active = true;
-                    IO_FireOutput(ENTITY_LOGIC, i, "OnUsed", engine->lastFrame, NULL);
-                }
-                else if (strcmp(inputName, "TurnOff") == 0) {
-                    ent->runtime_active = false;
-                    IO_FireOutput(ENTITY_LOGIC, i, "OnUsed", engine->lastFrame, NULL);
-                }
-                else if (strcmp(inputName, "Toggle") == 0) {
-                    ent->runtime_active = !ent->runtime_active;
-                    IO_FireOutput(ENTITY_LOGIC, i, "OnUsed", engine->lastFrame, NULL);
-                }
-            }
-            else if (strcmp(ent->classname, "env_glow") == 0) {
-                if (strcmp(inputName, "TurnOn") == 0) {
-                    ent->runtime_active = true;
-                }
-                else if (strcmp(inputName, "TurnOff") == 0) {
-                    ent->runtime_active = false;
-                }
-                else if (strcmp(inputName, "Toggle") == 0) {
-                    ent->runtime_active = !ent->runtime_active;
-                }
-            }
-            else if (strcmp(ent->classname, "game_end") == 0) {
-                if (strcmp(inputName, "EndGame") == 0) {
-                    char* disconnect_argv[] = { (char*)"disconnect" };
-                    Commands_Execute(1, disconnect_argv);
-                }
-            }
-            else if (strcmp(ent->classname, "trigger_keypad") == 0) {
-                if (strcmp(inputName, "Use") == 0 && !engine->keypad_active) {
-                    engine->keypad_active = true;
-                    engine->active_keypad_entity_index = i;
-                    memset(engine->keypad_input_buffer, 0, sizeof(engine->keypad_input_buffer));
-                    g_player_input_disabled = true;
-                    SDL_SetRelativeMouseMode(SDL_FALSE);
-                }
-            }
-            else if (strcmp(ent->classname, "logic_branch") == 0) {
-                bool test_now = false;
+static void io_input_logic_timer(LogicEntity* ent, int index, const char* inputName, const char* parameter, Engine* engine) {
+    (void)index;
+    (void)parameter;
+    (void)engine;
+    if (strcmp(inputName, "StartTimer") == 0) {
+        ent->runtime_active = true;
+        ent->runtime_float_a = ent->comp.timer.delay;
+    }
+    else if (strcmp(inputName, "StopTimer") == 0) {
+        ent->runtime_active = false;
+    }
+    else if (strcmp(inputName, "ToggleTimer") == 0) {
+        ent->runtime_active = !ent->runtime_active;
+        if (ent->runtime_active && ent->runtime_float_a <= 0) {
+            ent->runtime_float_a = ent->comp.timer.delay;
+        }
+    }
+}
 
-                if (strcmp(inputName, "SetValue") == 0) {
-                    ent->runtime_int_a = (parameter && atoi(parameter) != 0) ? 1 : 0;
-                }
-                else if (strcmp(inputName, "SetValueTest") == 0) {
-                    ent->runtime_int_a = (parameter && atoi(parameter) != 0) ? 1 : 0;
-                    test_now = true;
-                }
-                else if (strcmp(inputName, "Toggle") == 0) {
-                    ent->runtime_int_a = !ent->runtime_int_a;
-                }
-                else if (strcmp(inputName, "ToggleTest") == 0) {
-                    ent->runtime_int_a = !ent->runtime_int_a;
-                    test_now = true;
-                }
-                else if (strcmp(inputName, "Test") == 0) {
-                    test_now = true;
-                }
+static void io_input_math_counter(LogicEntity* ent, int index, const char* inputName, const char* parameter, Engine* engine) {
+    (void)engine;
+    int min = atoi(LogicEntity_GetProperty(ent, "min", "0"));
+    int max = atoi(LogicEntity_GetProperty(ent, "max", "0"));
+    int value = (parameter && strlen(parameter) > 0) ? atoi(parameter) : 1;
 
-                if (test_now) {
-                    if (ent->runtime_int_a == 1) {
-                        IO_FireOutput(ENTITY_LOGIC, i, "OnTrue", engine->lastFrame, NULL);
-                    }
-                    else {
-                        IO_FireOutput(ENTITY_LOGIC, i, "OnFalse", engine->lastFrame, NULL);
-                    }
-                }
-                }
+    if (strcmp(inputName, "Add") == 0) ent->runtime_float_a += value;
+    else if (strcmp(inputName, "Subtract") == 0) ent->runtime_float_a -= value;
+    else if (strcmp(inputName, "Multiply") == 0) ent->runtime_float_a *= value;
+    else if (strcmp(inputName, "Divide") == 0) {
+        if (value != 0) ent->runtime_float_a /= value;
+        else Console_Printf_Error("[error] math_counter '%s' tried to divide by zero.", ent->targetname);
+    }
+
+    if (max != 0 && ent->runtime_float_a >= max) IO_FireOutput(ENTITY_LOGIC, index, "OnHitMax", 0, NULL);
+    if (min != 0 && ent->runtime_float_a <= min) IO_FireOutput(ENTITY_LOGIC, index, "OnHitMin", 0, NULL);
+}
+
+static void io_input_logic_random(LogicEntity* ent, int index, const char* inputName, const char* parameter, Engine* engine) {
+    (void)index;
+    (void)parameter;
+    (void)engine;
+    if (strcmp(inputName, "Enable") == 0) {
+        if (!ent->runtime_active) {
+            ent->runtime_float_a = rand_float_range(ent->comp.random.minTime, ent->comp.random.maxTime);
         }
+        ent->runtime_active = true;
     }
-    for (int i = 0; i < scene->numObjects; ++i) {
-        if (strcmp(scene->objects[i].targetname, targetName) == 0) {
-            if (strcmp(inputName, "EnablePhysics") == 0) {
-                scene->objects[i].isPhysicsEnabled = true;
-                Physics_ToggleCollision(engine->physicsWorld, scene->objects[i].physicsBody, true);
-            }
-            else if (strcmp(inputName, "DisablePhysics") == 0) {
-                scene->objects[i].isPhysicsEnabled = false;
-                Physics_ToggleCollision(engine->physicsWorld, scene->objects[i].physicsBody, false);
+    else if (strcmp(inputName, "Disable") == 0) ent->runtime_active = false;
+}
+
+static void io_input_logic_relay(LogicEntity* ent, int index, const char* inputName, const char* parameter, Engine* engine) {
+    (void)parameter;
+    if (strcmp(inputName, "Trigger") == 0 && ent->runtime_active) IO_FireOutput(ENTITY_LOGIC, index, "OnTrigger", engine->lastFrame, NULL);
+    else if (strcmp(inputName, "Enable") == 0) ent->runtime_active = true;
+    else if (strcmp(inputName, "Disable") == 0) ent->runtime_active = false;
+    else if (strcmp(inputName, "Toggle") == 0) ent->runtime_active = !ent->runtime_active;
+}
+
+static void io_input_logic_repeat(LogicEntity* ent, int index, const char* inputName, const char* parameter, Engine* engine) {
+    (void)index;
+    (void)parameter;
+    (void)engine;
+    if (strcmp(inputName, "EnableRepeat") == 0) {
+        ent->runtime_active = true;
+        ent->runtime_float_a = ent->comp.repeat.delay;
+        ent->runtime_int_a = atoi(LogicEntity_GetProperty(ent, "repeats", "-1"));
+    }
+    else if (strcmp(inputName, "StopRepeat") == 0) {
+        ent->runtime_active = false;
+    }
+    else if (strcmp(inputName, "ResetRepeat") == 0) {
+        ent->runtime_active = false;
+        ent->runtime_int_a = atoi(LogicEntity_GetProperty(ent, "repeats", "-1"));
+    }
+}
+
+static void io_input_on_off(LogicEntity* ent, int index, const char* inputName, const char* parameter, Engine* engine) {
+    (void)index;
+    (void)parameter;
+    (void)engine;
+    if (strcmp(inputName, "TurnOn") == 0) ent->runtime_active = true;
+    else if (strcmp(inputName, "TurnOff") == 0) ent->runtime_active = false;
+    else if (strcmp(inputName, "Toggle") == 0) ent->runtime_active = !ent->runtime_active;
+}
+
+static void io_input_enable_disable(LogicEntity* ent, int index, const char* inputName, const char* parameter, Engine* engine) {
+    (void)index;
+    (void)parameter;
+    (void)engine;
+    if (strcmp(inputName, "Enable") == 0) ent->runtime_active = true;
+    else if (strcmp(inputName, "Disable") == 0) ent->runtime_active = false;
+}
+
+static void io_input_point_servercommand(LogicEntity* ent, int index, const char* inputName, const char* parameter, Engine* engine) {
+    (void)ent;
+    (void)index;
+    (void)engine;
+    if (strcmp(inputName, "Command") == 0) {
+        if (parameter && strlen(parameter) > 0) {
+            char cmd_copy[MAX_COMMAND_LENGTH];
+            strncpy(cmd_copy, parameter, MAX_COMMAND_LENGTH - 1);
+            cmd_copy[MAX_COMMAND_LENGTH - 1] = '\0';
+
+            char* argv[16];
+            int argc = 0;
+            char* p = strtok(cmd_copy, " ");
+            while (p != NULL && argc < 16) {
+                argv[argc++] = p;
+                p = strtok(NULL, " ");
             }
-            SceneObject* obj = &scene->objects[i];
-            if (strcmp(inputName, "PlayAnimation") == 0) {
-                if (obj->model && obj->model->num_animations > 0) {
-                    int anim_index = -1;
-                    for (int j = 0; j < obj->model->num_animations; ++j) {
-                        if (strcmp(obj->model->animations[j].name, parameter) == 0) {
-                            anim_index = j;
-                            break;
-                        }
-                    }
-                    if (anim_index != -1) {
-                        obj->current_animation = anim_index;
-                        obj->animation_time = 0.0f;
-                        obj->animation_playing = true;
-                        obj->animation_looping = false;
-                    }
-                    else {
-                        Console_Printf_Warning("Animation '%s' not found for model '%s'", parameter, obj->targetname);
-                    }
-                }
-                return;
+            if (argc > 0) {
+                Commands_Execute(argc, argv);
             }
         }
     }
-    for (int i = 0; i < scene->numBrushes; ++i) {
-        if (strcmp(scene->brushes[i].targetname, targetName) == 0) {
-            Brush* b = &scene->brushes[i];
-            if (strlen(b->classname) > 0) {
-                if (strcmp(b->classname, "func_button") == 0) {
-                    if (strcmp(inputName, "Lock") == 0) {
-                        for (int k = 0; k < b->numProperties; ++k) if (strcmp(b->properties[k].key, "locked") == 0) strcpy(b->properties[k].value, "1");
-                    }
-                    else if (strcmp(inputName, "Unlock") == 0) {
-                        for (int k = 0; k < b->numProperties; ++k) if (strcmp(b->properties[k].key, "locked") == 0) strcpy(b->properties[k].value, "0");
-                    }
-                    else if (strcmp(inputName, "Press") == 0) {
-                        IO_FireOutput(ENTITY_BRUSH, i, "OnPressed", engine->lastFrame, NULL);
-                    }
-                }
-                else if (strcmp(b->classname, "func_rotating") == 0) {
-                    float speed = atof(Brush_GetProperty(b, "speed", "10"));
-                    if (strcmp(inputName, "Start") == 0) {
-                        b->target_angular_velocity = speed;
-                    }
-                    else if (strcmp(inputName, "Stop") == 0) {
-                        b->target_angular_velocity = 0.0f;
-                    }
-                    else if (strcmp(inputName, "Toggle") == 0) {
-                        b->target_angular_velocity = (b->target_angular_velocity > 0.001f) ? 0.0f : speed;
-                    }
-                }
-                else if (strcmp(b->classname, "func_plat") == 0) {
-                    if (strcmp(inputName, "Raise") == 0) {
-                        if (b->plat_state == PLAT_STATE_BOTTOM) b->plat_state = PLAT_STATE_UP;
-                    }
-                    else if (strcmp(inputName, "Lower") == 0) {
-                        if (b->plat_state == PLAT_STATE_TOP) b->plat_state = PLAT_STATE_DOWN;
-                    }
-                    else if (strcmp(inputName, "Toggle") == 0) {
-                        if (b->plat_state == PLAT_STATE_TOP) b->plat_state = PLAT_STATE_DOWN;
-                        else if (b->plat_state == PLAT_STATE_BOTTOM) b->plat_state = PLAT_STATE_UP;
-                    }
-                }
-                else if (strcmp(b->classname, "func_wall_toggle") == 0) {
-                    bool should_be_visible = b->runtime_is_visible;
-                    if (strcmp(inputName, "Toggle") == 0) {
-                        should_be_visible = !b->runtime_is_visible;
-                    }
-                    else if (strcmp(inputName, "TurnOn") == 0) {
-                        should_be_visible = true;
-                    }
-                    else if (strcmp(inputName, "TurnOff") == 0) {
-                        should_be_visible = false;
-                    }
-
-                    if (should_be_visible != b->runtime_is_visible) {
-                        b->runtime_is_visible = should_be_visible;
-                        if (b->physicsBody) {
-                            Physics_ToggleCollision(engine->physicsWorld, b->physicsBody, b->runtime_is_visible);
-                        }
-                    }
-                }
-                else if (strcmp(b->classname, "func_door") == 0) {
-                    if (strcmp(inputName, "Open") == 0) {
-                        b->door_state = DOOR_STATE_OPENING;
-                        IO_FireOutput(ENTITY_BRUSH, i, "OnUsed", engine->lastFrame, NULL);
-                    }
-                    else if (strcmp(inputName, "Close") == 0) {
-                        b->door_state = DOOR_STATE_CLOSING;
-                        IO_FireOutput(ENTITY_BRUSH, i, "OnUsed", engine->lastFrame, NULL);
-                    }
-                    else if (strcmp(inputName, "Toggle") == 0) {
-                        if (b->door_state == DOOR_STATE_CLOSED || b->door_state == DOOR_STATE_CLOSING) {
-                            b->door_state = DOOR_STATE_OPENING;
-                        }
-                        else if (b->door_state == DOOR_STATE_OPEN || b->door_state == DOOR_STATE_OPENING) {
-                            b->door_state = DOOR_STATE_CLOSING;
-                        }
-                        IO_FireOutput(ENTITY_BRUSH, i, "OnUsed", engine->lastFrame, NULL);
-                    }
-                }
-                else if (strcmp(b->classname, "func_pendulum") == 0) {
-                    if (strcmp(inputName, "Start") == 0) {
-                        b->runtime_active = true;
-                    }
-                    else if (strcmp(inputName, "Stop") == 0) {
-                        b->runtime_active = false;
-                    }
-                    else if (strcmp(inputName, "Toggle") == 0) {
-                        b->runtime_active = !b->runtime_active;
-                    }
-                }
-                else if (strcmp(b->classname, "trigger_camera") == 0) {
-                    if (strcmp(inputName, "Enable") == 0) {
-                        if (engine->active_camera_brush_index == -1) {
-                            engine->active_camera_brush_index = i;
-                            engine->camera_transition_timer = 0.0f;
-                            engine->camera_original_pos = engine->camera.position;
-                            engine->camera_original_yaw = engine->camera.yaw;
-                            engine->camera_original_pitch = engine->camera.pitch;
-                            g_player_input_disabled = true;
-                        }
-                    }
-                    else if (strcmp(inputName, "Disable") == 0) {
-                        if (engine->active_camera_brush_index == i) {
-                            engine->active_camera_brush_index = -1;
-                            g_player_input_disabled = false;
-                            engine->camera.position = engine->camera_original_pos;
-                            engine->camera.yaw = engine->camera_original_yaw;
-                            engine->camera.pitch = engine->camera_original_pitch;
-                        }
-                    }
-                }
-                if (strcmp(inputName, "Enable") == 0) {
-                    b->runtime_active = true;
-                }
-                else if (strcmp(inputName, "Disable") == 0) {
-                    b->runtime_active = false;
-                }
-                else if (strcmp(inputName, "Toggle") == 0) {
-                    b->runtime_active = !b->runtime_active;
-                }
+}
+
+static void io_input_logic_compare(LogicEntity* ent, int index, const char* inputName, const char* parameter, Engine* engine) {
+    if (strcmp(inputName, "SetValue") == 0) {
+        ent->runtime_float_a = atof(parameter);
+    }
+    else if (strcmp(inputName, "SetCompareValue") == 0) {
+        for (int prop_idx = 0; prop_idx < ent->numProperties; ++prop_idx) {
+            if (strcmp(ent->properties[prop_idx].key, "CompareValue") == 0) {
+                strncpy(ent->properties[prop_idx].value, parameter, sizeof(ent->properties[prop_idx].value) - 1);
+                LogicEntity_ParseComponent(ent);
+                break;
             }
         }
     }
-    for (int i = 0; i < scene->numActiveLights; ++i) {
-        if (strcmp(scene->lights[i].targetname, targetName) == 0) {
-            if (strcmp(inputName, "TurnOn") == 0) scene->lights[i].is_on = true;
-            else if (strcmp(inputName, "TurnOff") == 0) scene->lights[i].is_on = false;
-            else if (strcmp(inputName, "Toggle") == 0) scene->lights[i].is_on = !scene->lights[i].is_on;
-            else if (strcmp(inputName, "SetLightStyle") == 0) {
-                if (parameter && strlen(parameter) > 0) {
-                    int style = atoi(parameter);
-                    if (style >= 0 && style <= 12) {
-                        scene->lights[i].preset = style;
-                    }
-                    else {
-                        Console_Printf_Warning("SetLightStyle: Invalid style index '%d'. Must be between 0 and 12.", style);
-                    }
-                }
-            }
-            else if (strcmp(inputName, "SetCustomLightStyle") == 0) {
-                if (parameter) {
-                    strncpy(scene->lights[i].custom_style_string, parameter, sizeof(scene->lights[i].custom_style_string) - 1);
-                    scene->lights[i].custom_style_string[sizeof(scene->lights[i].custom_style_string) - 1] = '\0';
-                    scene->lights[i].preset = 13;
-                }
-            }
+    else if (strcmp(inputName, "Compare") == 0 || strcmp(inputName, "SetValueCompare") == 0) {
+        if (strcmp(inputName, "SetValueCompare") == 0) {
+            ent->runtime_float_a = atof(parameter);
+        }
+
+        float val_a = ent->runtime_float_a;
+        float val_b = atof(LogicEntity_GetProperty(ent, "CompareValue", "0"));
+        char param_out[32];
+        sprintf(param_out, "%f", val_a);
+
+        if (val_a < val_b) IO_FireOutput(ENTITY_LOGIC, index, "OnLessThan", engine->lastFrame, param_out);
+        if (val_a == val_b) IO_FireOutput(ENTITY_LOGIC, index, "OnEqualTo", engine->lastFrame, param_out);
+        if (val_a != val_b) IO_FireOutput(ENTITY_LOGIC, index, "OnNotEqualTo", engine->lastFrame, param_out);
+        if (val_a > val_b) IO_FireOutput(ENTITY_LOGIC, index, "OnGreaterThan", engine->lastFrame, param_out);
+    }
+}
+
+static void io_input_env_fade(LogicEntity* ent, int index, const char* inputName, const char* parameter, Engine* engine) {
+    (void)index;
+    (void)parameter;
+    (void)engine;
+    if (strcmp(inputName, "FadeIn") == 0) {
+        ent->runtime_int_a = 1;
+        ent->runtime_float_a = 0.0f;
+    }
+    else if (strcmp(inputName, "FadeOut") == 0) {
+        ent->runtime_int_a = 2;
+        ent->runtime_float_a = 0.0f;
+    }
+    else if (strcmp(inputName, "Fade") == 0) {
+        ent->runtime_int_a = 4;
+        ent->runtime_float_a = 0.0f;
+    }
+}
+
+static void io_input_env_shake(LogicEntity* ent, int index, const char* inputName, const char* parameter, Engine* engine) {
+    (void)index;
+    (void)parameter;
+    bool global_shake = atoi(LogicEntity_GetProperty(ent, "GlobalShake", "0"));
+    float radius = atof(LogicEntity_GetProperty(ent, "radius", "500.0"));
+    float dist_sq = vec3_length_sq(vec3_sub(engine->camera.position, ent->pos));
+
+    if (strcmp(inputName, "StartShake") == 0) {
+        if (global_shake || dist_sq < (radius * radius)) {
+            engine->shake_amplitude = atof(LogicEntity_GetProperty(ent, "amplitude", "4.0"));
+            engine->shake_frequency = atof(LogicEntity_GetProperty(ent, "frequency", "40.0"));
+            engine->shake_duration_timer = atof(LogicEntity_GetProperty(ent, "duration", "1.0"));
+        }
+    }
+    else if (strcmp(inputName, "StopShake") == 0) {
+        if (global_shake || dist_sq < (radius * radius)) {
+            engine->shake_amplitude = 0.0f;
+            engine->shake_duration_timer = 0.0f;
+        }
+    }
+}
+
+static void io_input_env_beam(LogicEntity* ent, int index, const char* inputName, const char* parameter, Engine* engine) {
+    (void)parameter;
+    if (strcmp(inputName, "TurnOn") == 0) {
+        ent->runtime_active = true;
+        IO_FireOutput(ENTITY_LOGIC, index, "OnUsed", engine->lastFrame, NULL);
+    }
+    else if (strcmp(inputName, "TurnOff") == 0) {
+        ent->runtime_active = false;
+        IO_FireOutput(ENTITY_LOGIC, index, "OnUsed", engine->lastFrame, NULL);
+    }
+    else if (strcmp(inputName, "Toggle") == 0) {
+        ent->runtime_active = !ent->runtime_active;
+        IO_FireOutput(ENTITY_LOGIC, index, "OnUsed", engine->lastFrame, NULL);
+    }
+}
+
+static void io_input_game_end(LogicEntity* ent, int index, const char* inputName, const char* parameter, Engine* engine) {
+    (void)ent;
+    (void)index;
+    (void)parameter;
+    (void)engine;
+    if (strcmp(inputName, "EndGame") == 0) {
+        char* disconnect_argv[] = { (char*)"disconnect" };
+        Commands_Execute(1, disconnect_argv);
+    }
+}
+
+static void io_input_trigger_keypad(LogicEntity* ent, int index, const char* inputName, const char* parameter, Engine* engine) {
+    (void)ent;
+    (void)parameter;
+    if (strcmp(inputName, "Use") == 0 && !engine->keypad_active) {
+        engine->keypad_active = true;
+        engine->active_keypad_entity_index = index;
+        memset(engine->keypad_input_buffer, 0, sizeof(engine->keypad_input_buffer));
+        g_player_input_disabled = true;
+        SDL_SetRelativeMouseMode(SDL_FALSE);
+    }
+}
+
+static void io_input_logic_branch(LogicEntity* ent, int index, const char* inputName, const char* parameter, Engine* engine) {
+    bool test_now = false;
+
+    if (strcmp(inputName, "SetValue") == 0) {
+        ent->runtime_int_a = (parameter && atoi(parameter) != 0) ? 1 : 0;
+    }
+    else if (strcmp(inputName, "SetValueTest") == 0) {
+        ent->runtime_int_a = (parameter && atoi(parameter) != 0) ? 1 : 0;
+        test_now = true;
+    }
+    else if (strcmp(inputName, "Toggle") == 0) {
+        ent->runtime_int_a = !ent->runtime_int_a;
+    }
+    else if (strcmp(inputName, "ToggleTest") == 0) {
+        ent->runtime_int_a = !ent->runtime_int_a;
+        test_now = true;
+    }
+    else if (strcmp(inputName, "Test") == 0) {
+        test_now = true;
+    }
+
+    if (test_now) {
+        if (ent->runtime_int_a == 1) {
+            IO_FireOutput(ENTITY_LOGIC, index, "OnTrue", engine->lastFrame, NULL);
+        }
+        else {
+            IO_FireOutput(ENTITY_LOGIC, index, "OnFalse", engine->lastFrame, NULL);
+        }
+    }
+}
+
+static const LogicInputHandler g_logic_input_handlers[ENTITY_CLASS_COUNT] = {
+    [ENTITY_CLASS_LOGIC_TIMER] = io_input_logic_timer,
+    [ENTITY_CLASS_MATH_COUNTER] = io_input_math_counter,
+    [ENTITY_CLASS_LOGIC_RANDOM] = io_input_logic_random,
+    [ENTITY_CLASS_LOGIC_RELAY] = io_input_logic_relay,
+    [ENTITY_CLASS_LOGIC_REPEAT] = io_input_logic_repeat,
+    [ENTITY_CLASS_ENV_OVERLAY] = io_input_on_off,
+    [ENTITY_CLASS_POINT_SERVERCOMMAND] = io_input_point_servercommand,
+    [ENTITY_CLASS_LOGIC_COMPARE] = io_input_logic_compare,
+    [ENTITY_CLASS_ENV_BLACKHOLE] = io_input_enable_disable,
+    [ENTITY_CLASS_ENV_FADE] = io_input_env_fade,
+    [ENTITY_CLASS_ENV_SHAKE] = io_input_env_shake,
+    [ENTITY_CLASS_ENV_FOG] = io_input_enable_disable,
+    [ENTITY_CLASS_ENV_BEAM] = io_input_env_beam,
+    [ENTITY_CLASS_ENV_GLOW] = io_input_on_off,
+    [ENTITY_CLASS_GAME_END] = io_input_game_end,
+    [ENTITY_CLASS_TRIGGER_KEYPAD] = io_input_trigger_keypad,
+    [ENTITY_CLASS_LOGIC_BRANCH] = io_input_logic_branch,
+};
+
+static void io_input_func_button(Brush* b, int index, const char* inputName, const char* parameter, Engine* engine) {
+    (void)parameter;
+    if (strcmp(inputName, "Lock") == 0) {
+        for (int k = 0; k < b->numProperties; ++k) if (strcmp(b->properties[k].key, "locked") == 0) strcpy(b->properties[k].value, "1");
+        Brush_ParseComponent(b);
+    }
+    else if (strcmp(inputName, "Unlock") == 0) {
+        for (int k = 0; k < b->numProperties; ++k) if (strcmp(b->properties[k].key, "locked") == 0) strcpy(b->properties[k].value, "0");
+        Brush_ParseComponent(b);
+    }
+    else if (strcmp(inputName, "Press") == 0) {
+        IO_FireOutput(ENTITY_BRUSH, index, "OnPressed", engine->lastFrame, NULL);
+    }
+}
+
+static void io_input_func_rotating(Brush* b, int index, const char* inputName, const char* parameter, Engine* engine) {
+    (void)index;
+    (void)parameter;
+    (void)engine;
+    float speed = b->comp.rotating.speed;
+    if (strcmp(inputName, "Start") == 0) {
+        b->target_angular_velocity = speed;
+    }
+    else if (strcmp(inputName, "Stop") == 0) {
+        b->target_angular_velocity = 0.0f;
+    }
+    else if (strcmp(inputName, "Toggle") == 0) {
+        b->target_angular_velocity = (b->target_angular_velocity > 0.001f) ? 0.0f : speed;
+    }
+}
+
+static void io_input_func_plat(Brush* b, int index, const char* inputName, const char* parameter, Engine* engine) {
+    (void)index;
+    (void)parameter;
+    (void)engine;
+    if (strcmp(inputName, "Raise") == 0) {
+        if (b->plat_state == PLAT_STATE_BOTTOM) b->plat_state = PLAT_STATE_UP;
+    }
+    else if (strcmp(inputName, "Lower") == 0) {
+        if (b->plat_state == PLAT_STATE_TOP) b->plat_state = PLAT_STATE_DOWN;
+    }
+    else if (strcmp(inputName, "Toggle") == 0) {
+        if (b->plat_state == PLAT_STATE_TOP) b->plat_state = PLAT_STATE_DOWN;
+        else if (b->plat_state == PLAT_STATE_BOTTOM) b->plat_state = PLAT_STATE_UP;
+    }
+}
+
+static void io_input_func_wall_toggle(Brush* b, int index, const char* inputName, const char* parameter, Engine* engine) {
+    (void)index;
+    (void)parameter;
+    bool should_be_visible = b->runtime_is_visible;
+    if (strcmp(inputName, "Toggle") == 0) {
+        should_be_visible = !b->runtime_is_visible;
+    }
+    else if (strcmp(inputName, "TurnOn") == 0) {
+        should_be_visible = true;
+    }
+    else if (strcmp(inputName, "TurnOff") == 0) {
+        should_be_visible = false;
+    }
+
+    if (should_be_visible != b->runtime_is_visible) {
+        b->runtime_is_visible = should_be_visible;
+        if (b->physicsBody) {
+            Physics_ToggleCollision(engine->physicsWorld, b->physicsBody, b->runtime_is_visible);
+        }
+    }
+}
+
+static void io_input_func_door(Brush* b, int index, const char* inputName, const char* parameter, Engine* engine) {
+    (void)parameter;
+    if (strcmp(inputName, "Open") == 0) {
+        b->door_state = DOOR_STATE_OPENING;
+        IO_FireOutput(ENTITY_BRUSH, index, "OnUsed", engine->lastFrame, NULL);
+    }
+    else if (strcmp(inputName, "Close") == 0) {
+        b->door_state = DOOR_STATE_CLOSING;
+        IO_FireOutput(ENTITY_BRUSH, index, "OnUsed", engine->lastFrame, NULL);
+    }
+    else if (strcmp(inputName, "Toggle") == 0) {
+        if (b->door_state == DOOR_STATE_CLOSED || b->door_state == DOOR_STATE_CLOSING) {
+            b->door_state = DOOR_STATE_OPENING;
+        }
+        else if (b->door_state == DOOR_STATE_OPEN || b->door_state == DOOR_STATE_OPENING) {
+            b->door_state = DOOR_STATE_CLOSING;
+        }
+        IO_FireOutput(ENTITY_BRUSH, index, "OnUsed", engine->lastFrame, NULL);
+    }
+}
+
+static void io_input_func_pendulum(Brush* b, int index, const char* inputName, const char* parameter, Engine* engine) {
+    (void)index;
+    (void)parameter;
+    (void)engine;
+    if (strcmp(inputName, "Start") == 0) {
+        b->runtime_active = true;
+    }
+    else if (strcmp(inputName, "Stop") == 0) {
+        b->runtime_active = false;
+    }
+    else if (strcmp(inputName, "Toggle") == 0) {
+        b->runtime_active = !b->runtime_active;
+    }
+}
+
+static void io_input_trigger_camera(Brush* b, int index, const char* inputName, const char* parameter, Engine* engine) {
+    (void)b;
+    (void)parameter;
+    if (strcmp(inputName, "Enable") == 0) {
+        if (engine->active_camera_brush_index == -1) {
+            engine->active_camera_brush_index = index;
+            engine->camera_transition_timer = 0.0f;
+            engine->camera_original_pos = engine->camera.position;
+            engine->camera_original_yaw = engine->camera.yaw;
+            engine->camera_original_pitch = engine->camera.pitch;
+            g_player_input_disabled = true;
+        }
+    }
+    else if (strcmp(inputName, "Disable") == 0) {
+        if (engine->active_camera_brush_index == index) {
+            engine->active_camera_brush_index = -1;
+            g_player_input_disabled = false;
+            engine->camera.position = engine->camera_original_pos;
+            engine->camera.yaw = engine->camera_original_yaw;
+            engine->camera.pitch = engine->camera_original_pitch;
         }
     }
-    for (int i = 0; i < scene->numSoundEntities; ++i) {
-        if (strcmp(scene->soundEntities[i].targetname, targetName) == 0) {
-            if (strcmp(inputName, "PlaySound") == 0) {
-                if (scene->soundEntities[i].sourceID != 0) {
-                    SoundSystem_DeleteSource(scene->soundEntities[i].sourceID);
+}
+
+static const BrushInputHandler g_brush_input_handlers[ENTITY_CLASS_COUNT] = {
+    [ENTITY_CLASS_FUNC_BUTTON] = io_input_func_button,
+    [ENTITY_CLASS_FUNC_ROTATING] = io_input_func_rotating,
+    [ENTITY_CLASS_FUNC_PLAT] = io_input_func_plat,
+    [ENTITY_CLASS_FUNC_WALL_TOGGLE] = io_input_func_wall_toggle,
+    [ENTITY_CLASS_FUNC_DOOR] = io_input_func_door,
+    [ENTITY_CLASS_FUNC_PENDULUM] = io_input_func_pendulum,
+    [ENTITY_CLASS_TRIGGER_CAMERA] = io_input_trigger_camera,
+};
+
+static void io_input_brush(Brush* b, int index, const char* inputName, const char* parameter, Engine* engine) {
+    if (b->classId == ENTITY_CLASS_NONE) return;
+
+    BrushInputHandler handler = g_brush_input_handlers[b->classId];
+    if (handler) handler(b, index, inputName, parameter, engine);
+
+    if (strcmp(inputName, "Enable") == 0) {
+        b->runtime_active = true;
+    }
+    else if (strcmp(inputName, "Disable") == 0) {
+        b->runtime_active = false;
+    }
+    else if (strcmp(inputName, "Toggle") == 0) {
+        b->runtime_active = !b->runtime_active;
+    }
+}
+
+// Returns true when the input must not reach any later entity with the same name.
+static bool io_input_object(Scene* scene, Engine* engine, int index, const char* inputName, const char* parameter) {
+    SceneObject* obj = &scene->objects[index];
+    if (strcmp(inputName, "EnablePhysics") == 0) {
+        obj->isPhysicsEnabled = true;
+        Physics_ToggleCollision(engine->physicsWorld, obj->physicsBody, true);
+    }
+    else if (strcmp(inputName, "DisablePhysics") == 0) {
+        obj->isPhysicsEnabled = false;
+        Physics_ToggleCollision(engine->physicsWorld, obj->physicsBody, false);
+    }
+    if (strcmp(inputName, "PlayAnimation") == 0) {
+        if (obj->model && obj->model->num_animations > 0) {
+            int anim_index = -1;
+            for (int j = 0; j < obj->model->num_animations; ++j) {
+                if (strcmp(obj->model->animations[j].name, parameter) == 0) {
+                    anim_index = j;
+                    break;
                 }
-                scene->soundEntities[i].sourceID = SoundSystem_PlaySound(scene->soundEntities[i].bufferID, scene->soundEntities[i].pos, scene->soundEntities[i].volume, scene->soundEntities[i].pitch, scene->soundEntities[i].maxDistance, scene->soundEntities[i].is_looping);
             }
-            else if (strcmp(inputName, "StopSound") == 0) {
-                if (scene->soundEntities[i].sourceID != 0) {
-                    SoundSystem_DeleteSource(scene->soundEntities[i].sourceID);
-                    scene->soundEntities[i].sourceID = 0;
-                }
+            if (anim_index != -1) {
+                obj->current_animation = anim_index;
+                obj->animation_time = 0.0f;
+                obj->animation_playing = true;
+                obj->animation_looping = false;
             }
-            else if (strcmp(inputName, "EnableLoop") == 0) {
-                scene->soundEntities[i].is_looping = true;
-                if (scene->soundEntities[i].sourceID != 0) {
-                    SoundSystem_SetSourceLooping(scene->soundEntities[i].sourceID, true);
-                }
+            else {
+                Console_Printf_Warning("Animation '%s' not found for model '%s'", parameter, obj->targetname);
             }
-            else if (strcmp(inputName, "DisableLoop") == 0) {
-                scene->soundEntities[i].is_looping = false;
-                if (scene->soundEntities[i].sourceID != 0) {
-                    SoundSystem_SetSourceLooping(scene->soundEntities[i].sourceID, false);
-                }
+        }
+        return true;
+    }
+    return false;
+}
+
+static void io_input_light(Light* light, const char* inputName, const char* parameter) {
+    if (strcmp(inputName, "TurnOn") == 0) light->is_on = true;
+    else if (strcmp(inputName, "TurnOff") == 0) light->is_on = false;
+    else if (strcmp(inputName, "Toggle") == 0) light->is_on = !light->is_on;
+    else if (strcmp(inputName, "SetLightStyle") == 0) {
+        if (parameter && strlen(parameter) > 0) {
+            int style = atoi(parameter);
+            if (style >= 0 && style <= 12) {
+                light->preset = style;
             }
-            else if (strcmp(inputName, "ToggleLoop") == 0) {
-                scene->soundEntities[i].is_looping = !scene->soundEntities[i].is_looping;
-                if (scene->soundEntities[i].sourceID != 0) {
-                    SoundSystem_SetSourceLooping(scene->soundEntities[i].sourceID, scene->soundEntities[i].is_looping);
-                }
+            else {
+                Console_Printf_Warning("SetLightStyle: Invalid style index '%d'. Must be between 0 and 12.", style);
             }
         }
     }
-    for (int i = 0; i < scene->numParticleEmitters; ++i) {
-        if (strcmp(scene->particleEmitters[i].targetname, targetName) == 0) {
-            if (strcmp(inputName, "TurnOn") == 0) scene->particleEmitters[i].is_on = true;
-            else if (strcmp(inputName, "TurnOff") == 0) scene->particleEmitters[i].is_on = false;
-            else if (strcmp(inputName, "Toggle") == 0) scene->particleEmitters[i].is_on = !scene->particleEmitters[i].is_on;
+    else if (strcmp(inputName, "SetCustomLightStyle") == 0) {
+        if (parameter) {
+            strncpy(light->custom_style_string, parameter, sizeof(light->custom_style_string) - 1);
+            light->custom_style_string[sizeof(light->custom_style_string) - 1] = '\0';
+            light->preset = 13;
         }
     }
-    for (int i = 0; i < scene->numVideoPlayers; ++i) {
-        if (strcmp(scene->videoPlayers[i].targetname, targetName) == 0) {
-            if (strcmp(inputName, "startvideo") == 0) {
-                VideoPlayer_Play(&scene->videoPlayers[i]);
-            }
-            else if (strcmp(inputName, "stopvideo") == 0) {
-                VideoPlayer_Stop(&scene->videoPlayers[i]);
-            }
-            else if (strcmp(inputName, "restartvideo") == 0) {
-                VideoPlayer_Restart(&scene->videoPlayers[i]);
-            }
+}
+
+static void io_input_sound(SoundEntity* sound, const char* inputName, const char* parameter) {
+    if (strcmp(inputName, "PlaySound") == 0) {
+        if (sound->sourceID != 0) {
+            SoundSystem_DeleteSource(sound->sourceID);
+        }
+        sound->sourceID = SoundSystem_PlaySound(sound->bufferID, sound->pos, sound->volume, sound->pitch, sound->maxDistance, sound->is_looping);
+    }
+    else if (strcmp(inputName, "StopSound") == 0) {
+        if (sound->sourceID != 0) {
+            SoundSystem_StopSound(sound->sourceID);
+        }
+    }
+    else if (strcmp(inputName, "Seek") == 0) {
+        if (sound->sourceID != 0 && parameter) {
+            SoundSystem_SeekSource(sound->sourceID, (float)atof(parameter));
+        }
+    }
+    else if (strcmp(inputName, "EnableLoop") == 0) {
+        sound->is_looping = true;
+        if (sound->sourceID != 0) {
+            SoundSystem_SetSourceLooping(sound->sourceID, true);
+        }
+    }
+    else if (strcmp(inputName, "DisableLoop") == 0) {
+        sound->is_looping = false;
+        if (sound->sourceID != 0) {
+            SoundSystem_SetSourceLooping(sound->sourceID, false);
+        }
+    }
+    else if (strcmp(inputName, "ToggleLoop") == 0) {
+        sound->is_looping = !sound->is_looping;
+        if (sound->sourceID != 0) {
+            SoundSystem_SetSourceLooping(sound->sourceID, sound->is_looping);
         }
     }
-    for (int i = 0; i < scene->numSprites; ++i) {
-        if (strcmp(scene->sprites[i].targetname, targetName) == 0) {
-            if (strcmp(inputName, "TurnOn") == 0) {
-                scene->sprites[i].visible = true;
+}
+
+void ExecuteInput(const char* targetName, const char* inputName, const char* parameter, Scene* scene, Engine* engine) {
+    const IOTargetBucket* bucket = io_find_target(targetName);
+    if (!bucket) return;
+
+    for (int k = 0; k < bucket->count; ++k) {
+        IOTargetHandle handle = g_target_handles[bucket->start + k];
+        int i = handle.index;
+        switch (handle.type) {
+        case ENTITY_LOGIC: {
+            if (i >= scene->numLogicEntities) break;
+            LogicEntity* ent = &scene->logicEntities[i];
+            LogicInputHandler handler = g_logic_input_handlers[ent->classId];
+            if (handler) handler(ent, i, inputName, parameter, engine);
+            break;
+        }
+        case ENTITY_MODEL:
+            if (i < scene->numObjects && io_input_object(scene, engine, i, inputName, parameter)) return;
+            break;
+        case ENTITY_BRUSH:
+            if (i < scene->numBrushes) io_input_brush(&scene->brushes[i], i, inputName, parameter, engine);
+            break;
+        case ENTITY_LIGHT:
+            if (i < scene->numActiveLights) io_input_light(&scene->lights[i], inputName, parameter);
+            break;
+        case ENTITY_SOUND:
+            if (i < scene->numSoundEntities) io_input_sound(&scene->soundEntities[i], inputName, parameter);
+            break;
+        case ENTITY_PARTICLE_EMITTER:
+            if (i < scene->numParticleEmitters) {
+                ParticleEmitter* emitter = &scene->particleEmitters[i];
+                if (strcmp(inputName, "TurnOn") == 0) emitter->is_on = true;
+                else if (strcmp(inputName, "TurnOff") == 0) emitter->is_on = false;
+                else if (strcmp(inputName, "Toggle") == 0) emitter->is_on = !emitter->is_on;
             }
-            else if (strcmp(inputName, "TurnOff") == 0) {
-                scene->sprites[i].visible = false;
+            break;
+        case ENTITY_VIDEO_PLAYER:
+            if (i < scene->numVideoPlayers) {
+                if (strcmp(inputName, "startvideo") == 0) {
+                    VideoPlayer_Play(&scene->videoPlayers[i]);
+                }
+                else if (strcmp(inputName, "stopvideo") == 0) {
+                    VideoPlayer_Stop(&scene->videoPlayers[i]);
+                }
+                else if (strcmp(inputName, "restartvideo") == 0) {
+                    VideoPlayer_Restart(&scene->videoPlayers[i]);
+                }
             }
-            else if (strcmp(inputName, "Toggle") == 0) {
-                scene->sprites[i].visible = !scene->sprites[i].visible;
+            break;
+        case ENTITY_SPRITE:
+            if (i < scene->numSprites) {
+                if (strcmp(inputName, "TurnOn") == 0) {
+                    scene->sprites[i].visible = true;
+                }
+                else if (strcmp(inputName, "TurnOff") == 0) {
+                    scene->sprites[i].visible = false;
+                }
+                else if (strcmp(inputName, "Toggle") == 0) {
+                    scene->sprites[i].visible = !scene->sprites[i].visible;
+                }
+                return;
             }
-            return;
+            break;
+        default:
+            break;
         }
     }
 }
@@ -674,109 +1055,111 @@ const char* LogicEntity_GetProperty(LogicEntity* ent, const char* key, const cha
 }
 
 void LogicSystem_Update(Scene* scene, float deltaTime) {
-    for (int i = 0; i < scene->numLogicEntities; ++i) {
+    const int* indices;
+    int count = Scene_GetLogicEntitiesOfClass(scene, ENTITY_CLASS_LOGIC_TIMER, &indices);
+    for (int k = 0; k < count; ++k) {
+        int i = indices[k];
         LogicEntity* ent = &scene->logicEntities[i];
-        if (strcmp(ent->classname, "logic_timer") == 0) {
-            if (ent->runtime_active) {
-                ent->runtime_float_a -= deltaTime;
-                if (ent->runtime_float_a <= 0) {
-                    IO_FireOutput(ENTITY_LOGIC, i, "OnTimer", 0, NULL);
-
-                    const char* repeat_val = LogicEntity_GetProperty(ent, "repeat", "1");
-                    int repeat = atoi(repeat_val);
-
-                    if (repeat == -1) {
-                        const char* delay_val = LogicEntity_GetProperty(ent, "delay", "1.0");
-                        ent->runtime_float_a = atof(delay_val);
-                    }
-                    else {
-                        ent->runtime_active = false;
-                    }
+        if (ent->runtime_active) {
+            ent->runtime_float_a -= deltaTime;
+            if (ent->runtime_float_a <= 0) {
+                IO_FireOutput(ENTITY_LOGIC, i, "OnTimer", 0, NULL);
+
+                if (ent->comp.timer.repeat == -1) {
+                    ent->runtime_float_a = ent->comp.timer.delay;
+                }
+                else {
+                    ent->runtime_active = false;
                 }
             }
         }
-        else if (strcmp(ent->classname, "logic_random") == 0) {
-            if (ent->runtime_active) {
-                ent->runtime_float_a -= deltaTime;
-                if (ent->runtime_float_a <= 0) {
-                    IO_FireOutput(ENTITY_LOGIC, i, "OnRandom", 0, NULL);
-                    const char* min_time_str = LogicEntity_GetProperty(ent, "min_time", "0.0");
-                    const char* max_time_str = LogicEntity_GetProperty(ent, "max_time", "0.0");
-                    ent->runtime_float_a = rand_float_range(atof(min_time_str), atof(max_time_str));
-                }
+    }
+    count = Scene_GetLogicEntitiesOfClass(scene, ENTITY_CLASS_LOGIC_RANDOM, &indices);
+    for (int k = 0; k < count; ++k) {
+        int i = indices[k];
+        LogicEntity* ent = &scene->logicEntities[i];
+        if (ent->runtime_active) {
+            ent->runtime_float_a -= deltaTime;
+            if (ent->runtime_float_a <= 0) {
+                IO_FireOutput(ENTITY_LOGIC, i, "OnRandom", 0, NULL);
+                ent->runtime_float_a = rand_float_range(ent->comp.random.minTime, ent->comp.random.maxTime);
             }
         }
-        else if (strcmp(ent->classname, "logic_repeat") == 0) {
-            if (ent->runtime_active) {
-                ent->runtime_float_a -= deltaTime;
-                if (ent->runtime_float_a <= 0) {
-                    IO_FireOutput(ENTITY_LOGIC, i, "OnRepeat", 0, NULL);
-
-                    if (ent->runtime_int_a != -1) {
-                        ent->runtime_int_a--;
-                    }
-
-                    if (ent->runtime_int_a == 0) {
-                        ent->runtime_active = false;
-                    }
-                    else {
-                        ent->runtime_float_a = atof(LogicEntity_GetProperty(ent, "delay", "1.0"));
-                    }
+    }
+    count = Scene_GetLogicEntitiesOfClass(scene, ENTITY_CLASS_LOGIC_REPEAT, &indices);
+    for (int k = 0; k < count; ++k) {
+        int i = indices[k];
+        LogicEntity* ent = &scene->logicEntities[i];
+        if (ent->runtime_active) {
+            ent->runtime_float_a -= deltaTime;
+            if (ent->runtime_float_a <= 0) {
+                IO_FireOutput(ENTITY_LOGIC, i, "OnRepeat", 0, NULL);
+
+                if (ent->runtime_int_a != -1) {
+                    ent->runtime_int_a--;
+                }
+
+                if (ent->runtime_int_a == 0) {
+                    ent->runtime_active = false;
+                }
+                else {
+                    ent->runtime_float_a = ent->comp.repeat.delay;
                 }
             }
         }
-        else if (strcmp(ent->classname, "env_blackhole") == 0) {
-            if (ent->runtime_active) {
-                const char* rot_speed_str = LogicEntity_GetProperty(ent, "rotationspeed", "10.0");
-                ent->rot.y += atof(rot_speed_str) * deltaTime;
-                if (ent->rot.y > 360.0f) ent->rot.y -= 360.0f;
-            }
+    }
+    count = Scene_GetLogicEntitiesOfClass(scene, ENTITY_CLASS_ENV_BLACKHOLE, &indices);
+    for (int k = 0; k < count; ++k) {
+        LogicEntity* ent = &scene->logicEntities[indices[k]];
+        if (ent->runtime_active) {
+            ent->rot.y += ent->comp.blackhole.rotationSpeed * deltaTime;
+            if (ent->rot.y > 360.0f) ent->rot.y -= 360.0f;
         }
-        else if (strcmp(ent->classname, "env_fade") == 0) {
-            if (ent->runtime_int_a != 0) {
-                scene->post.fade_active = true;
-                scene->post.fade_color = (Vec3){ 0, 0, 0 };
-
-                float duration = atof(LogicEntity_GetProperty(ent, "duration", "2.0"));
-                if (duration <= 0.0f) duration = 0.01f;
-                float holdtime = atof(LogicEntity_GetProperty(ent, "holdtime", "1.0"));
-                int renderamt = atoi(LogicEntity_GetProperty(ent, "renderamt", "255"));
-                float target_alpha = (float)renderamt / 255.0f;
-
-                ent->runtime_float_a += deltaTime;
-
-                if (ent->runtime_int_a == 1) {
-                    scene->post.fade_alpha = fminf(target_alpha, (ent->runtime_float_a / duration) * target_alpha);
-                    if (ent->runtime_float_a >= duration) {
-                        ent->runtime_int_a = 3;
-                        ent->runtime_float_a = 0.0f;
-                    }
+    }
+    count = Scene_GetLogicEntitiesOfClass(scene, ENTITY_CLASS_ENV_FADE, &indices);
+    for (int k = 0; k < count; ++k) {
+        LogicEntity* ent = &scene->logicEntities[indices[k]];
+        if (ent->runtime_int_a != 0) {
+            scene->post.fade_active = true;
+            scene->post.fade_color = (Vec3){ 0, 0, 0 };
+
+            float duration = ent->comp.fade.duration;
+            float holdtime = ent->comp.fade.holdTime;
+            float target_alpha = ent->comp.fade.targetAlpha;
+
+            ent->runtime_float_a += deltaTime;
+
+            if (ent->runtime_int_a == 1) {
+                scene->post.fade_alpha = fminf(target_alpha, (ent->runtime_float_a / duration) * target_alpha);
+                if (ent->runtime_float_a >= duration) {
+                    ent->runtime_int_a = 3;
+                    ent->runtime_float_a = 0.0f;
                 }
-                else if (ent->runtime_int_a == 2) {
-                    scene->post.fade_alpha = fmaxf(0.0f, target_alpha - (ent->runtime_float_a / duration) * target_alpha);
-                    if (ent->runtime_float_a >= duration) {
-                        ent->runtime_int_a = 0;
-                        scene->post.fade_active = false;
-                    }
+            }
+            else if (ent->runtime_int_a == 2) {
+                scene->post.fade_alpha = fmaxf(0.0f, target_alpha - (ent->runtime_float_a / duration) * target_alpha);
+                if (ent->runtime_float_a >= duration) {
+                    ent->runtime_int_a = 0;
+                    scene->post.fade_active = false;
                 }
-                else if (ent->runtime_int_a == 3) {
-                    scene->post.fade_alpha = target_alpha;
-                    if (holdtime > 0 && ent->runtime_float_a >= holdtime) {
-                    }
+            }
+            else if (ent->runtime_int_a == 3) {
+                scene->post.fade_alpha = target_alpha;
+                if (holdtime > 0 && ent->runtime_float_a >= holdtime) {
                 }
-                else if (ent->runtime_int_a == 4) {
-                    scene->post.fade_alpha = fminf(target_alpha, (ent->runtime_float_a / duration) * target_alpha);
-                    if (ent->runtime_float_a >= duration) {
-                        ent->runtime_int_a = 5;
-                        ent->runtime_float_a = 0.0f;
-                    }
+            }
+            else if (ent->runtime_int_a == 4) {
+                scene->post.fade_alpha = fminf(target_alpha, (ent->runtime_float_a / duration) * target_alpha);
+                if (ent->runtime_float_a >= duration) {
+                    ent->runtime_int_a = 5;
+                    ent->runtime_float_a = 0.0f;
                 }
-                else if (ent->runtime_int_a == 5) {
-                    scene->post.fade_alpha = target_alpha;
-                    if (ent->runtime_float_a >= holdtime) {
-                        ent->runtime_int_a = 2;
-                        ent->runtime_float_a = 0.0f;
-                    }
+            }
+            else if (ent->runtime_int_a == 5) {
+                scene->post.fade_alpha = target_alpha;
+                if (ent->runtime_float_a >= holdtime) {
+                    ent->runtime_int_a = 2;
+                    ent->runtime_float_a = 0.0f;
                 }
             }
         }
@@ -36,8 +36,7 @@
 extern "C" {
 #endif
 
-#define MAX_IO_CONNECTIONS 1024
-#define MAX_PENDING_EVENTS 256
+#define MAX_IO_CONNECTIONS 8192
 
     typedef struct {
         bool active;
@@ -58,6 +57,7 @@ extern "C" {
         char inputName[64];
         char parameter[64];
         float executionTime;
+        unsigned int sequence;
     } PendingEvent;
 
     void IO_Init();
@@ -66,10 +66,16 @@ extern "C" {
 
     IOConnection* IO_AddConnection(EntityType sourceType, int sourceIndex, const char* output);
     void IO_RemoveConnection(int connection_index);
+    // Rebuilds the connection lookup and the targetname table from the scene.
+    // Scene_RefreshEntityClasses calls this, so it runs whenever entities change.
+    void IO_RebuildIndex(Scene* scene);
     int IO_GetConnectionsForEntity(EntityType type, int index, IOConnection** connections_out, int max_out);
 
     bool IO_FindNamedEntity(Scene* scene, const char* name, Vec3* out_pos, Vec3* out_angles);
     void IO_FireOutput(EntityType sourceType, int sourceIndex, const char* outputName, float currentTime, const char* parameter);
+    int IO_GetPendingEvents(const PendingEvent** events_out);
+    void IO_ClearPendingEvents(void);
+    bool IO_QueueEvent(const char* targetName, const char* inputName, const char* parameter, float executionTime);
     LogicEntity* FindActiveEntityByClass(Scene* scene, const char* classname);
     void ExecuteInput(const char* targetName, const char* inputName, const char* parameter, Scene* scene, Engine* engine);
 
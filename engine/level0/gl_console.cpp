@@ -32,6 +32,11 @@
 #include <cstdarg>
 #include <stdint.h>
 #include <time.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 #include "gl_console.h"
 #include "ipc_system.h"
@@ -41,37 +46,123 @@
 static bool show_console = false;
 static command_callback_t command_handler = nullptr;
 static FILE* g_log_file = NULL;
+static bool g_log_to_stdout = false;
+
+// Console_Printf only formats the line into a slot of a fixed-size ring and
+// returns. A writer thread drains the ring to the log file, the IPC peer,
+// stdout and the in-memory scrollback, so callers on any thread never wait on
+// disk or socket I/O. When the ring is full new lines are dropped and counted
+// instead of blocking. Consecutive identical lines are collapsed into one
+// scrollback entry with a repeat count, and the file only receives a repeat
+// summary at most once per LOG_REPEAT_REPORT_MS.
+
+#define LOG_LINE_LENGTH 1024
+#define LOG_RING_CAPACITY 2048
+#define CONSOLE_SCROLLBACK_LINES 4096
+#define LOG_REPEAT_REPORT_MS 1000
+
+struct LogSlot {
+    std::atomic<uint32_t> sequence;
+    ConsoleTextColor color;
+    char text[LOG_LINE_LENGTH];
+};
+
+struct LogRing {
+    LogSlot slots[LOG_RING_CAPACITY];
+    std::atomic<uint32_t> enqueuePos;
+    uint32_t dequeuePos;
+    LogRing() {
+        for (uint32_t i = 0; i < LOG_RING_CAPACITY; ++i) slots[i].sequence.store(i, std::memory_order_relaxed);
+        enqueuePos.store(0, std::memory_order_relaxed);
+        dequeuePos = 0;
+    }
+};
+
+static LogRing g_log_ring;
+static std::atomic<uint32_t> g_log_dropped(0);
+
+static std::thread g_log_thread;
+static std::mutex g_log_thread_mutex;
+static std::atomic<bool> g_log_thread_running(false);
+static bool g_log_closed = false;
+static std::atomic<bool> g_log_writer_sleeping(false);
+static std::mutex g_log_wake_mutex;
+static std::condition_variable g_log_wake;
+static std::mutex g_log_file_mutex;
+
+static char g_log_repeat_text[LOG_LINE_LENGTH];
+static ConsoleTextColor g_log_repeat_color = CONSOLE_COLOR_WHITE;
+static int g_log_repeat_pending = 0;
+static std::chrono::steady_clock::time_point g_log_repeat_reported;
 
 struct ConsoleItem {
     char* text;
     ConsoleTextColor color;
+    int repeat;
 };
 
 struct Console {
     char                  InputBuf[256];
-    std::vector<ConsoleItem> Items;
-    bool                  ScrollToBottom;
-    Console() { ClearLog(); memset(InputBuf, 0, sizeof(InputBuf)); ScrollToBottom = true; }
+    ConsoleItem           Items[CONSOLE_SCROLLBACK_LINES];
+    int                   ItemStart;
+    int                   ItemCount;
+    std::mutex            ItemsMutex;
+    std::atomic<bool>     ScrollToBottom;
+    Console() { memset(Items, 0, sizeof(Items)); ItemStart = 0; ItemCount = 0; memset(InputBuf, 0, sizeof(InputBuf)); ScrollToBottom = true; }
     ~Console() { ClearLog(); }
-    void ClearLog() { for (int i = 0; i < Items.size(); i++) free(Items[i].text); Items.clear(); }
-
-    void AddLog(ConsoleTextColor color, const char* fmt, va_list args) {
-        char buf[1024];
-        vsnprintf(buf, IM_ARRAYSIZE(buf), fmt, args);
-        buf[IM_ARRAYSIZE(buf) - 1] = 0;
-
-        IPC_SendMessage(buf);
+    void ClearLog() {
+        std::lock_guard<std::mutex> lock(ItemsMutex);
+        for (int i = 0; i < CONSOLE_SCROLLBACK_LINES; i++) { free(Items[i].text); Items[i].text = NULL; }
+        ItemStart = 0;
+        ItemCount = 0;
+    }
+    ConsoleItem& ItemAt(int i) { return Items[(ItemStart + i) % CONSOLE_SCROLLBACK_LINES]; }
+
+    // Writer thread only.
+    void AppendLine(ConsoleTextColor color, const char* text) {
+        std::lock_guard<std::mutex> lock(ItemsMutex);
+        if (ItemCount > 0) {
+            ConsoleItem& last = ItemAt(ItemCount - 1);
+            if (last.color == color && last.text && strcmp(last.text, text) == 0) {
+                last.repeat++;
+                ScrollToBottom = true;
+                return;
+            }
+        }
+        ConsoleItem* item;
+        if (ItemCount < CONSOLE_SCROLLBACK_LINES) {
+            item = &ItemAt(ItemCount++);
+        }
+        else {
+            item = &Items[ItemStart];
+            ItemStart = (ItemStart + 1) % CONSOLE_SCROLLBACK_LINES;
+        }
+        free(item->text);
+        item->text = _strdup(text);
+        item->color = color;
+        item->repeat = 1;
+        ScrollToBottom = true;
+    }
 
-        if (g_log_file) {
-            fprintf(g_log_file, "%s\n", buf);
-            fflush(g_log_file);
+    static void DrawItem(const ConsoleItem& item) {
+        ImVec4 color;
+        bool has_color = false;
+        if (item.color == CONSOLE_COLOR_RED) {
+            color = ImVec4(1.0f, 0.4f, 0.4f, 1.0f);
+            has_color = true;
+        }
+        else if (item.color == CONSOLE_COLOR_YELLOW) {
+            color = ImVec4(1.0f, 1.0f, 0.4f, 1.0f);
+            has_color = true;
         }
 
-        ConsoleItem item;
-        item.text = _strdup(buf);
-        item.color = color;
-        Items.push_back(item);
-        ScrollToBottom = true;
+        if (has_color) ImGui::PushStyleColor(ImGuiCol_Text, color);
+        ImGui::TextUnformatted(item.text ? item.text : "");
+        if (has_color) ImGui::PopStyleColor();
+        if (item.repeat > 1) {
+            ImGui::SameLine();
+            ImGui::TextDisabled("(x%d)", item.repeat);
+        }
     }
 
     static int TextEditCallback(ImGuiInputTextCallbackData* data) {
@@ -117,25 +208,17 @@ struct Console {
         if (!ImGui::Begin("Console", &show_console)) { ImGui::End(); return; }
         const float footer_height_to_reserve = ImGui::GetStyle().ItemSpacing.y + ImGui::GetFrameHeightWithSpacing();
         ImGui::BeginChild("ScrollingRegion", ImVec2(0, -footer_height_to_reserve), false, ImGuiWindowFlags_HorizontalScrollbar);
-        for (int i = 0; i < Items.size(); i++) {
-            const ConsoleItem& item = Items[i];
-            ImVec4 color;
-            bool has_color = false;
-            if (item.color == CONSOLE_COLOR_RED) {
-                color = ImVec4(1.0f, 0.4f, 0.4f, 1.0f);
-                has_color = true;
-            }
-            else if (item.color == CONSOLE_COLOR_YELLOW) {
-                color = ImVec4(1.0f, 1.0f, 0.4f, 1.0f);
-                has_color = true;
+        {
+            std::lock_guard<std::mutex> lock(ItemsMutex);
+            ImGuiListClipper clipper;
+            clipper.Begin(ItemCount);
+            while (clipper.Step()) {
+                for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
+                    DrawItem(ItemAt(i));
+                }
             }
-
-            if (has_color) ImGui::PushStyleColor(ImGuiCol_Text, color);
-            ImGui::TextUnformatted(item.text);
-            if (has_color) ImGui::PopStyleColor();
         }
-        if (ScrollToBottom) ImGui::SetScrollY(ImGui::GetScrollMaxY());
-        ScrollToBottom = false;
+        if (ScrollToBottom.exchange(false)) ImGui::SetScrollY(ImGui::GetScrollMaxY());
         ImGui::EndChild();
         ImGui::Separator();
         bool reclaim_focus = false;
@@ -157,6 +240,150 @@ struct Console {
 
 static Console console_instance;
 
+static void Log_EmitLine(ConsoleTextColor color, const char* text) {
+    IPC_SendMessage(text);
+    if (g_log_file) {
+        fprintf(g_log_file, "%s\n", text);
+    }
+    if (g_log_to_stdout) {
+        fprintf(color == CONSOLE_COLOR_RED ? stderr : stdout, "%s\n", text);
+    }
+}
+
+static void Log_ReportRepeats(void) {
+    if (g_log_repeat_pending == 0) return;
+    char buf[128];
+    snprintf(buf, sizeof(buf), "(previous message repeated %d more time%s)", g_log_repeat_pending, g_log_repeat_pending == 1 ? "" : "s");
+    Log_EmitLine(g_log_repeat_color, buf);
+    g_log_repeat_pending = 0;
+    g_log_repeat_reported = std::chrono::steady_clock::now();
+}
+
+static void Log_ProcessLine(ConsoleTextColor color, const char* text) {
+    console_instance.AppendLine(color, text);
+
+    if (color == g_log_repeat_color && strcmp(text, g_log_repeat_text) == 0) {
+        g_log_repeat_pending++;
+        if (std::chrono::steady_clock::now() - g_log_repeat_reported >= std::chrono::milliseconds(LOG_REPEAT_REPORT_MS)) {
+            Log_ReportRepeats();
+        }
+        return;
+    }
+
+    Log_ReportRepeats();
+    Log_EmitLine(color, text);
+    strcpy(g_log_repeat_text, text);
+    g_log_repeat_color = color;
+    g_log_repeat_reported = std::chrono::steady_clock::now();
+}
+
+static bool Log_PopLine(ConsoleTextColor* color, char* text) {
+    LogSlot* slot = &g_log_ring.slots[g_log_ring.dequeuePos & (LOG_RING_CAPACITY - 1)];
+    uint32_t seq = slot->sequence.load(std::memory_order_acquire);
+    if ((int32_t)(seq - (g_log_ring.dequeuePos + 1)) < 0) return false;
+    *color = slot->color;
+    memcpy(text, slot->text, LOG_LINE_LENGTH);
+    slot->sequence.store(g_log_ring.dequeuePos + LOG_RING_CAPACITY, std::memory_order_release);
+    g_log_ring.dequeuePos++;
+    return true;
+}
+
+static bool Log_RingHasLine(void) {
+    const LogSlot* slot = &g_log_ring.slots[g_log_ring.dequeuePos & (LOG_RING_CAPACITY - 1)];
+    return (int32_t)(slot->sequence.load(std::memory_order_seq_cst) - (g_log_ring.dequeuePos + 1)) >= 0;
+}
+
+static void Log_Drain(void) {
+    static char text[LOG_LINE_LENGTH];
+    ConsoleTextColor color;
+    std::lock_guard<std::mutex> lock(g_log_file_mutex);
+    bool wrote = false;
+    while (Log_PopLine(&color, text)) {
+        Log_ProcessLine(color, text);
+        wrote = true;
+    }
+    uint32_t dropped = g_log_dropped.exchange(0, std::memory_order_relaxed);
+    if (dropped > 0) {
+        snprintf(text, sizeof(text), "[WARNING] Console log ring full, %u messages dropped.", dropped);
+        Log_ProcessLine(CONSOLE_COLOR_YELLOW, text);
+        wrote = true;
+    }
+    if (g_log_repeat_pending > 0 && std::chrono::steady_clock::now() - g_log_repeat_reported >= std::chrono::milliseconds(LOG_REPEAT_REPORT_MS)) {
+        Log_ReportRepeats();
+        wrote = true;
+    }
+    if (wrote && g_log_file) fflush(g_log_file);
+}
+
+static void Log_WriterThread(void) {
+    while (g_log_thread_running.load()) {
+        Log_Drain();
+        std::unique_lock<std::mutex> lock(g_log_wake_mutex);
+        g_log_writer_sleeping.store(true);
+        if (!Log_RingHasLine() && g_log_thread_running.load()) {
+            g_log_wake.wait_for(lock, std::chrono::milliseconds(100));
+        }
+        g_log_writer_sleeping.store(false);
+    }
+    Log_Drain();
+}
+
+static void Log_StartWriter(void) {
+    std::lock_guard<std::mutex> lock(g_log_thread_mutex);
+    if (g_log_thread_running.load() || g_log_closed) return;
+    g_log_thread_running.store(true);
+    g_log_thread = std::thread(Log_WriterThread);
+}
+
+static void Log_StopWriter(void) {
+    std::lock_guard<std::mutex> lock(g_log_thread_mutex);
+    if (!g_log_thread_running.load()) return;
+    {
+        std::lock_guard<std::mutex> wake_lock(g_log_wake_mutex);
+        g_log_thread_running.store(false);
+        g_log_wake.notify_one();
+    }
+    g_log_thread.join();
+}
+
+// Processes that exit without Log_Shutdown must not run std::thread's
+// destructor on a joinable writer, which would terminate.
+static struct LogWriterGuard {
+    ~LogWriterGuard() { if (g_log_thread.joinable()) g_log_thread.detach(); }
+} g_log_writer_guard;
+
+static void Log_Push(ConsoleTextColor color, const char* fmt, va_list args) {
+    if (!g_log_thread_running.load(std::memory_order_acquire)) Log_StartWriter();
+
+    uint32_t pos = g_log_ring.enqueuePos.load(std::memory_order_relaxed);
+    LogSlot* slot;
+    for (;;) {
+        slot = &g_log_ring.slots[pos & (LOG_RING_CAPACITY - 1)];
+        uint32_t seq = slot->sequence.load(std::memory_order_acquire);
+        int32_t diff = (int32_t)(seq - pos);
+        if (diff == 0) {
+            if (g_log_ring.enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        }
+        else if (diff < 0) {
+            g_log_dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        else {
+            pos = g_log_ring.enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    vsnprintf(slot->text, LOG_LINE_LENGTH, fmt, args);
+    slot->text[LOG_LINE_LENGTH - 1] = 0;
+    slot->color = color;
+    slot->sequence.store(pos + 1, std::memory_order_seq_cst);
+
+    if (g_log_writer_sleeping.load()) {
+        std::lock_guard<std::mutex> lock(g_log_wake_mutex);
+        g_log_wake.notify_one();
+    }
+}
+
 extern "C" {
 
     void UI_Init(SDL_Window* window, SDL_GLContext context) {
@@ -175,21 +402,36 @@ extern "C" {
     void Console_SetCommandHandler(command_callback_t handler) { command_handler = handler; }
 
     void Log_Init(const char* filename) {
-        if (g_log_file) {
-            fclose(g_log_file);
+        {
+            std::lock_guard<std::mutex> lock(g_log_file_mutex);
+            if (g_log_file) {
+                fclose(g_log_file);
+            }
+            g_log_file = fopen(filename, "w");
+            if (!g_log_file) {
+                fprintf(stderr, "[ERROR] Failed to open log file: %s\n", filename);
+            }
+            else {
+                time_t now = time(NULL);
+                fprintf(g_log_file, "Log started at %s\n", ctime(&now));
+                fflush(g_log_file);
+            }
         }
-        g_log_file = fopen(filename, "w");
-        if (!g_log_file) {
-            fprintf(stderr, "[ERROR] Failed to open log file: %s\n", filename);
-        }
-        else {
-            time_t now = time(NULL);
-            fprintf(g_log_file, "Log started at %s\n", ctime(&now));
-            fflush(g_log_file);
+        {
+            std::lock_guard<std::mutex> lock(g_log_thread_mutex);
+            g_log_closed = false;
         }
+        Log_StartWriter();
     }
 
     void Log_Shutdown(void) {
+        {
+            std::lock_guard<std::mutex> lock(g_log_thread_mutex);
+            g_log_closed = true;
+        }
+        Log_StopWriter();
+        std::lock_guard<std::mutex> lock(g_log_file_mutex);
+        Log_ReportRepeats();
         if (g_log_file) {
             time_t now = time(NULL);
             fprintf(g_log_file, "\nLog ended at %s\n", ctime(&now));
@@ -198,24 +440,28 @@ extern "C" {
         }
     }
 
+    void Log_SetStdoutEcho(bool enabled) {
+        g_log_to_stdout = enabled;
+    }
+
     void Console_Printf(const char* fmt, ...) {
         va_list args;
         va_start(args, fmt);
-        console_instance.AddLog(CONSOLE_COLOR_WHITE, fmt, args);
+        Log_Push(CONSOLE_COLOR_WHITE, fmt, args);
         va_end(args);
     }
 
     void Console_Printf_Error(const char* fmt, ...) {
         va_list args;
         va_start(args, fmt);
-        console_instance.AddLog(CONSOLE_COLOR_RED, fmt, args);
+        Log_Push(CONSOLE_COLOR_RED, fmt, args);
         va_end(args);
     }
 
     void Console_Printf_Warning(const char* fmt, ...) {
         va_list args;
         va_start(args, fmt);
-        console_instance.AddLog(CONSOLE_COLOR_YELLOW, fmt, args);
+        Log_Push(CONSOLE_COLOR_YELLOW, fmt, args);
         va_end(args);
     }
 
@@ -298,19 +544,12 @@ extern "C" {
         ImGuiWindowFlags window_flags = ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoFocusOnAppearing | ImGuiWindowFlags_NoNav | ImGuiWindowFlags_NoMove;
 
         if (ImGui::Begin("DeveloperOverlay", NULL, window_flags)) {
-            int start_index = console_instance.Items.size() - 10;
+            std::lock_guard<std::mutex> lock(console_instance.ItemsMutex);
+            int start_index = console_instance.ItemCount - 10;
             if (start_index < 0) start_index = 0;
 
-            for (int i = start_index; i < console_instance.Items.size(); i++) {
-                const ConsoleItem& item = console_instance.Items[i];
-                ImVec4 color;
-                bool has_color = false;
-                if (item.color == CONSOLE_COLOR_RED) { color = ImVec4(1.0f, 0.4f, 0.4f, 1.0f); has_color = true; }
-                else if (item.color == CONSOLE_COLOR_YELLOW) { color = ImVec4(1.0f, 1.0f, 0.4f, 1.0f); has_color = true; }
-
-                if (has_color) ImGui::PushStyleColor(ImGuiCol_Text, color);
-                ImGui::TextUnformatted(item.text);
-                if (has_color) ImGui::PopStyleColor();
+            for (int i = start_index; i < console_instance.ItemCount; i++) {
+                Console::DrawItem(console_instance.ItemAt(i));
             }
         }
         ImGui::End();
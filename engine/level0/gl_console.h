@@ -64,6 +64,7 @@ extern "C" {
 
 	LEVEL0_API void Log_Init(const char* filename);
 	LEVEL0_API void Log_Shutdown(void);
+	LEVEL0_API void Log_SetStdoutEcho(bool enabled);
 
 	LEVEL0_API bool UI_Begin(const char* name, bool* p_open);
 	LEVEL0_API bool UI_Begin_NoBringToFront(const char* name, bool* p_open);
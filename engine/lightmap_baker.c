@@ -0,0 +1,125 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 Soft Sprint Studios
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "engine.h"
+#include <SDL.h>
+#include <SDL_image.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cvar.h"
+#include "commands.h"
+#include "map.h"
+#include "lightmapper.h"
+#include "engine_commands.h"
+#include "engine_api.h"
+#include "gl_console.h"
+
+// Headless entry point used by the lightmap_baker tool. Loads a map without a
+// window or GL context and runs the lightmapper on it, so bakes can run on
+// build machines and in CI.
+
+static void Baker_PrintUsage(const char* exe) {
+    printf("Usage: %s -map <path.map> [-res <resolution>] [-bounces <count>] [-threads <count>]\n", exe);
+    printf("  -res      Lightmap resolution, must be a power of two (default 128)\n");
+    printf("  -bounces  Indirect light bounces (default 1)\n");
+    printf("  -threads  Worker threads, 0 uses all hardware threads (default 0)\n");
+}
+
+ENGINE_API int Engine_BakeMain(int argc, char* argv[]) {
+    const char* map_path = NULL;
+    int resolution = 128;
+    int bounces = 1;
+    int threads = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        if (_stricmp(argv[i], "-map") == 0 && i + 1 < argc) map_path = argv[++i];
+        else if (_stricmp(argv[i], "-res") == 0 && i + 1 < argc) resolution = atoi(argv[++i]);
+        else if (_stricmp(argv[i], "-bounces") == 0 && i + 1 < argc) bounces = atoi(argv[++i]);
+        else if (_stricmp(argv[i], "-threads") == 0 && i + 1 < argc) threads = atoi(argv[++i]);
+        else if (_stricmp(argv[i], "-help") == 0 || _stricmp(argv[i], "-h") == 0) {
+            Baker_PrintUsage(argv[0]);
+            return 0;
+        }
+    }
+
+    if (!map_path) {
+        Baker_PrintUsage(argv[0]);
+        return 1;
+    }
+    if (resolution <= 0 || (resolution & (resolution - 1)) != 0) {
+        fprintf(stderr, "[ERROR] Invalid lightmap resolution %d. Must be a power of two.\n", resolution);
+        return 1;
+    }
+    if (bounces < 0 || threads < 0) {
+        fprintf(stderr, "[ERROR] Bounce and thread counts must be >= 0.\n");
+        return 1;
+    }
+
+    g_is_headless_mode = true;
+    Log_SetStdoutEcho(true);
+    Log_Init("lightmap_baker_log.txt");
+
+    Uint64 start = SDL_GetPerformanceCounter();
+
+    IMG_Init(IMG_INIT_PNG | IMG_INIT_JPG);
+    Cvar_Init();
+    Commands_Init();
+    RegisterEngineCommandsAndCvars();
+    Cvar_Load("cvars.txt");
+    TextureManager_Init();
+    TextureManager_ParseMaterialsFromFile("materials.def");
+
+    memset(&g_scene, 0, sizeof(g_scene));
+    g_engine->physicsWorld = NULL;
+
+    int result = 1;
+    if (Scene_LoadMap(&g_scene, &g_renderer, map_path, g_engine)) {
+        Console_Printf("[Baker] Loaded '%s': %d brushes, %d models, %d lights, %d decals.",
+            map_path, g_scene.numBrushes, g_scene.numObjects, g_scene.numActiveLights, g_scene.numDecals);
+        if (Lightmapper_Generate(&g_scene, g_engine, resolution, bounces, threads)) {
+            result = 0;
+        }
+    }
+
+    if (g_scene.objects) {
+        for (int i = 0; i < g_scene.numObjects; ++i) {
+            if (g_scene.objects[i].model) Model_Free(g_scene.objects[i].model);
+        }
+        free(g_scene.objects);
+        g_scene.objects = NULL;
+    }
+    for (int i = 0; i < g_scene.numBrushes; ++i) {
+        Brush_FreeData(&g_scene.brushes[i]);
+    }
+    ModelLoader_Shutdown();
+    TextureManager_Shutdown();
+    Commands_Shutdown();
+
+    double seconds = (double)(SDL_GetPerformanceCounter() - start) / (double)SDL_GetPerformanceFrequency();
+    Console_Printf("[Baker] %s in %.2f seconds.", result == 0 ? "Bake finished" : "Bake failed", seconds);
+
+    Log_Shutdown();
+    IMG_Quit();
+    return result;
+}
@@ -24,7 +24,9 @@
 #ifdef ARCH_64BIT
 #include "lightmapper.h"
 #include "gl_console.h"
+#include "cvar.h"
 #include "math_lib.h"
+#include "image_kernels.h"
 #include <vector>
 #include <string>
 #include <thread>
@@ -36,6 +38,7 @@
 #include <fstream>
 #include <algorithm>
 #include <chrono>
+#include <functional>
 #include <cctype>
 #include <cmath>
 #include <cfloat>
@@ -62,6 +65,8 @@ namespace
     constexpr int INDIRECT_SAMPLES_PER_POINT_AMBIENT_PROBES = 64;
     constexpr int INDIRECT_SAMPLES_PER_POINT_DECALS = 64;
     constexpr float LUXELS_PER_UNIT = 16.0f;
+    constexpr int DENOISE_GUTTER = 4;
+    constexpr int DILATE_ITERATIONS = 4;
 
     void embree_error_function(void* userPtr, RTCError error, const char* str)
     {
@@ -102,6 +107,34 @@ namespace
 
     using JobPayload = std::variant<BrushFaceJobData, ModelVertexJobData, DecalJobData>;
 
+    struct TracedLightmap
+    {
+        int width;
+        int height;
+        bool is_brush_face;
+        Vec3 albedo;
+        fs::path color_path;
+        fs::path dir_path;
+        std::vector<float> base;
+        std::vector<float> indirect;
+        std::vector<float> normal;
+        std::vector<float> direction;
+        std::vector<unsigned char> coverage;
+        int out_width;
+        int out_height;
+        std::vector<float> out_color;
+        std::vector<unsigned char> out_dir;
+    };
+
+    enum BakeStage
+    {
+        STAGE_TRACE,
+        STAGE_DENOISE,
+        STAGE_DILATE,
+        STAGE_WRITE,
+        STAGE_COUNT
+    };
+
     uint32_t generate_seed_from_pos(const Vec3& pos)
     {
         std::hash<float> hasher;
@@ -143,9 +176,9 @@ namespace
     class Lightmapper
     {
     public:
-        Lightmapper(Scene* scene, int resolution, int bounces);
+        Lightmapper(Scene* scene, int resolution, int bounces, int num_threads);
         ~Lightmapper();
-        void generate();
+        bool generate();
 
     private:
         void build_embree_scene();
@@ -157,6 +190,12 @@ namespace
         void process_brush_face(const BrushFaceJobData& data);
         void process_decal(const DecalJobData& data);
         void process_model_vertex(const ModelVertexJobData& data);
+        void submit_traced_lightmap(std::unique_ptr<TracedLightmap> lm);
+        void flush_pending();
+        void denoise_pending();
+        void dilate_lightmap(TracedLightmap& lm);
+        void write_lightmap(const TracedLightmap& lm);
+        void run_parallel(size_t count, const std::function<void(size_t)>& fn) const;
 
         Vec3 calculate_direct_light(const Vec3& pos, const Vec3& normal, Vec3& out_dominant_dir) const;
         Vec3 calculate_direct_sun_light_only(const Vec3& pos, const Vec3& normal) const;
@@ -166,18 +205,29 @@ namespace
         void precalculate_material_reflectivity();
         bool is_in_shadow(const Vec3& start, const Vec3& end) const;
         static void apply_gaussian_blur(std::vector<float>& data, int width, int height, int channels);
-        static void apply_gaussian_blur(std::vector<unsigned char>& data, int width, int height, int channels);
         static std::string sanitize_filename(std::string input);
         static Vec3 cosine_weighted_direction_in_hemisphere(const Vec3& normal, std::mt19937& gen);
 
         Scene* m_scene;
         int m_resolution;
         int m_bounces;
+        int m_num_threads;
         fs::path m_output_path;
 
         RTCDevice m_rtc_device;
         RTCScene m_rtc_scene;
         OIDNDevice m_oidn_device;
+        OIDNFilter m_denoise_filter = nullptr;
+        int m_atlas_page_size;
+        int m_denoise_max_memory_mb;
+        int m_denoised_pages = 0;
+        unsigned int m_thread_count = 1;
+
+        std::vector<std::unique_ptr<TracedLightmap>> m_pending;
+        std::mutex m_pending_mutex;
+        std::atomic<size_t> m_pending_bytes{ 0 };
+        size_t m_pending_budget;
+        double m_stage_seconds[STAGE_COUNT] = {};
 
         std::vector<JobPayload> m_jobs;
         std::atomic<size_t> m_next_job_index{ 0 };
@@ -192,9 +242,12 @@ namespace
         std::vector<const Material*> m_primID_to_material_map;
     };
 
-    Lightmapper::Lightmapper(Scene* scene, int resolution, int bounces)
-        : m_scene(scene), m_resolution(resolution), m_bounces(bounces), m_rtc_device(nullptr), m_rtc_scene(nullptr)
+    Lightmapper::Lightmapper(Scene* scene, int resolution, int bounces, int num_threads)
+        : m_scene(scene), m_resolution(resolution), m_bounces(bounces), m_num_threads(num_threads), m_rtc_device(nullptr), m_rtc_scene(nullptr)
     {
+        m_atlas_page_size = std::max(256, Cvar_GetInt("lightmap_denoise_page_size"));
+        m_denoise_max_memory_mb = std::max(0, Cvar_GetInt("lightmap_denoise_max_memory"));
+        m_pending_budget = (size_t)std::max(0, Cvar_GetInt("lightmap_batch_memory")) * 1024 * 1024;
         m_rtc_device = rtcNewDevice(nullptr);
         if (!m_rtc_device)
         {
@@ -222,6 +275,10 @@ namespace
         {
             rtcReleaseDevice(m_rtc_device);
         }
+        if (m_denoise_filter)
+        {
+            oidnReleaseFilter(m_denoise_filter);
+        }
         if (m_oidn_device)
         {
             oidnReleaseDevice(m_oidn_device);
@@ -538,168 +595,28 @@ namespace
 
     void Lightmapper::apply_gaussian_blur(std::vector<float>& data, int width, int height, int channels)
     {
-        std::vector<float> temp_data(data.size());
-        constexpr int KERNEL_SIZE = BLUR_RADIUS * 2 + 1;
+        float kernel[BLUR_RADIUS * 2 + 1];
+        Image_BuildGaussianKernel(kernel, BLUR_RADIUS);
 
-        std::vector<float> kernel(KERNEL_SIZE);
-        float sigma = static_cast<float>(BLUR_RADIUS) / 2.0f;
-        float sum = 0.0f;
-        for (int i = 0; i < KERNEL_SIZE; ++i)
+        size_t count = (size_t)width * height;
+        std::vector<float> planar(count * channels);
+        std::vector<float*> planes(channels);
+        for (int c = 0; c < channels; ++c)
         {
-            int x = i - BLUR_RADIUS;
-            kernel[i] = expf(-static_cast<float>(x * x) / (2.0f * sigma * sigma));
-            sum += kernel[i];
-        }
-        for (float& val : kernel)
-        {
-            val /= sum;
+            planes[c] = planar.data() + count * c;
         }
 
-        std::vector<float> totals(channels);
-        for (int y = 0; y < height; ++y)
+        Image_Deinterleave(data.data(), planes.data(), channels, (int)count);
+        for (int c = 0; c < channels; ++c)
         {
-            for (int x = 0; x < width; ++x)
-            {
-                std::fill(totals.begin(), totals.end(), 0.0f);
-                for (int k = -BLUR_RADIUS; k <= BLUR_RADIUS; ++k)
-                {
-                    int sample_x = std::clamp(x + k, 0, width - 1);
-                    int src_idx = (y * width + sample_x) * channels;
-                    float weight = kernel[k + BLUR_RADIUS];
-                    for (int c = 0; c < channels; ++c)
-                    {
-                        totals[c] += data[src_idx + c] * weight;
-                    }
-                }
-                int dst_idx = (y * width + x) * channels;
-                for (int c = 0; c < channels; ++c)
-                {
-                    temp_data[dst_idx + c] = totals[c];
-                }
-            }
-        }
-
-        for (int y = 0; y < height; ++y)
-        {
-            for (int x = 0; x < width; ++x)
-            {
-                std::fill(totals.begin(), totals.end(), 0.0f);
-                for (int k = -BLUR_RADIUS; k <= BLUR_RADIUS; ++k)
-                {
-                    int sample_y = std::clamp(y + k, 0, height - 1);
-                    int src_idx = (sample_y * width + x) * channels;
-                    float weight = kernel[k + BLUR_RADIUS];
-                    for (int c = 0; c < channels; ++c)
-                    {
-                        totals[c] += temp_data[src_idx + c] * weight;
-                    }
-                }
-                int dst_idx = (y * width + x) * channels;
-                for (int c = 0; c < channels; ++c)
-                {
-                    data[dst_idx + c] = totals[c];
-                }
-            }
-        }
-    }
-
-    void Lightmapper::apply_gaussian_blur(std::vector<unsigned char>& data, int width, int height, int channels)
-    {
-        std::vector<unsigned char> temp_data(data.size());
-        constexpr int KERNEL_SIZE = BLUR_RADIUS * 2 + 1;
-
-        std::vector<float> kernel(KERNEL_SIZE);
-        float sigma = static_cast<float>(BLUR_RADIUS) / 2.0f;
-        float sum = 0.0f;
-        for (int i = 0; i < KERNEL_SIZE; ++i)
-        {
-            int x = i - BLUR_RADIUS;
-            kernel[i] = expf(-static_cast<float>(x * x) / (2.0f * sigma * sigma));
-            sum += kernel[i];
-        }
-        for (float& val : kernel)
-        {
-            val /= sum;
-        }
-
-        std::vector<float> totals(channels);
-        for (int y = 0; y < height; ++y)
-        {
-            for (int x = 0; x < width; ++x)
-            {
-                std::fill(totals.begin(), totals.end(), 0.0f);
-                for (int k = -BLUR_RADIUS; k <= BLUR_RADIUS; ++k)
-                {
-                    int sample_x = std::clamp(x + k, 0, width - 1);
-                    int src_idx = (y * width + sample_x) * channels;
-                    float weight = kernel[k + BLUR_RADIUS];
-                    for (int c = 0; c < channels; ++c)
-                    {
-                        totals[c] += data[src_idx + c] * weight;
-                    }
-                }
-                int dst_idx = (y * width + x) * channels;
-                for (int c = 0; c < channels; ++c)
-                {
-                    temp_data[dst_idx + c] = static_cast<unsigned char>(std::min(255.0f, totals[c]));
-                }
-            }
-        }
-
-        for (int y = 0; y < height; ++y)
-        {
-            for (int x = 0; x < width; ++x)
-            {
-                std::fill(totals.begin(), totals.end(), 0.0f);
-                for (int k = -BLUR_RADIUS; k <= BLUR_RADIUS; ++k)
-                {
-                    int sample_y = std::clamp(y + k, 0, height - 1);
-                    int src_idx = (sample_y * width + x) * channels;
-                    float weight = kernel[k + BLUR_RADIUS];
-                    for (int c = 0; c < channels; ++c)
-                    {
-                        totals[c] += temp_data[src_idx + c] * weight;
-                    }
-                }
-                int dst_idx = (y * width + x) * channels;
-                for (int c = 0; c < channels; ++c)
-                {
-                    data[dst_idx + c] = static_cast<unsigned char>(std::min(255.0f, totals[c]));
-                }
-            }
+            Image_SeparableBlur(planes[c], width, height, kernel, BLUR_RADIUS);
         }
+        Image_Interleave(planes.data(), data.data(), channels, (int)count);
     }
 
     void box_blur(std::vector<float>& out, const std::vector<float>& in, int width, int height, int radius)
     {
-        std::vector<float> temp(width * height);
-        float scale = 1.0f / (2 * radius + 1);
-
-        for (int y = 0; y < height; ++y) {
-            float sum = 0;
-            for (int x = -radius; x <= radius; ++x) {
-                sum += in[y * width + std::clamp(x, 0, width - 1)];
-            }
-            for (int x = 0; x < width; ++x) {
-                temp[y * width + x] = sum * scale;
-                int prev_idx = std::clamp(x - radius, 0, width - 1);
-                int next_idx = std::clamp(x + radius + 1, 0, width - 1);
-                sum += in[y * width + next_idx] - in[y * width + prev_idx];
-            }
-        }
-
-        for (int x = 0; x < width; ++x) {
-            float sum = 0;
-            for (int y = -radius; y <= radius; ++y) {
-                sum += temp[std::clamp(y, 0, height - 1) * width + x];
-            }
-            for (int y = 0; y < height; ++y) {
-                out[y * width + x] = sum * scale;
-                int prev_idx = std::clamp(y - radius, 0, height - 1);
-                int next_idx = std::clamp(y + radius + 1, 0, height - 1);
-                sum += temp[next_idx * width + x] - temp[prev_idx * width + x];
-            }
-        }
+        Image_BoxBlur(out.data(), in.data(), width, height, radius);
     }
 
     void apply_guided_filter(std::vector<float>& out_p, const std::vector<float>& in_p, const std::vector<float>& guide, int width, int height, int radius, float epsilon)
@@ -828,13 +745,6 @@ namespace
         int lightmap_width = std::clamp(static_cast<int>(ceilf(u_range * effective_luxels_per_unit)), 4, m_resolution);
         int lightmap_height = std::clamp(static_cast<int>(ceilf(v_range * effective_luxels_per_unit)), 4, m_resolution);
 
-        std::vector<float> direct_lightmap_data(lightmap_width * lightmap_height * 3);
-        std::vector<float> indirect_lightmap_data(lightmap_width * lightmap_height * 3);
-        std::vector<float> albedo_lightmap_data(lightmap_width * lightmap_height * 3);
-        std::vector<float> normal_lightmap_data(lightmap_width * lightmap_height * 3);
-        std::vector<float> direction_float_data(lightmap_width * lightmap_height * 3);
-        std::vector<unsigned char> dir_lightmap_data(lightmap_width * lightmap_height * 4, 0);
-
         Vec4 face_reflectivity_v4 = { 0.5f, 0.5f, 0.5f, 1.0f };
         if (face.material) {
             auto it = m_material_reflectivity.find(face.material);
@@ -843,11 +753,25 @@ namespace
             }
         }
 
+        auto lm = std::make_unique<TracedLightmap>();
+        lm->width = lightmap_width;
+        lm->height = lightmap_height;
+        lm->is_brush_face = true;
+        lm->albedo = { face_reflectivity_v4.x, face_reflectivity_v4.y, face_reflectivity_v4.z };
+        lm->color_path = data.output_dir / ("face_" + std::to_string(data.face_index) + "_color.hdr");
+        lm->dir_path = data.output_dir / ("face_" + std::to_string(data.face_index) + "_dir.png");
+        lm->base.resize(lightmap_width * lightmap_height * 3);
+        lm->indirect.resize(lightmap_width * lightmap_height * 3);
+        lm->normal.resize(lightmap_width * lightmap_height * 3);
+        lm->direction.resize(lightmap_width * lightmap_height * 3);
+        lm->coverage.resize(lightmap_width * lightmap_height, 0);
+
         for (int y = 0; y < lightmap_height; ++y)
         {
             for (int x = 0; x < lightmap_width; ++x)
             {
                 Vec3 direct_light_color = { 0, 0, 0 };
+                Vec3 direct_sun_light = { 0, 0, 0 };
                 Vec3 indirect_light_color = { 0, 0, 0 };
                 Vec3 accumulated_direction = { 0, 0, 0 };
                 Vec3 indirect_direction = { 0, 0, 0 };
@@ -889,178 +813,34 @@ namespace
                 {
                     std::mt19937 rng(generate_seed_from_pos(world_pos));
                     direct_light_color = calculate_direct_light(world_pos, point_normal, accumulated_direction);
+                    direct_sun_light = calculate_direct_sun_light_only(world_pos, point_normal);
                     indirect_light_color = calculate_indirect_light(world_pos, point_normal, rng, indirect_direction, INDIRECT_SAMPLES_PER_POINT_BRUSHES);
                     accumulated_direction = vec3_add(accumulated_direction, indirect_direction);
-                    normal_lightmap_data[hdr_idx + 0] = point_normal.x;
-                    normal_lightmap_data[hdr_idx + 1] = point_normal.y;
-                    normal_lightmap_data[hdr_idx + 2] = point_normal.z;
-                }
-                else
-                {
-                    normal_lightmap_data[hdr_idx + 0] = 0.0f;
-                    normal_lightmap_data[hdr_idx + 1] = 0.0f;
-                    normal_lightmap_data[hdr_idx + 2] = 0.0f;
+                    lm->normal[hdr_idx + 0] = point_normal.x;
+                    lm->normal[hdr_idx + 1] = point_normal.y;
+                    lm->normal[hdr_idx + 2] = point_normal.z;
+                    lm->coverage[y * lightmap_width + x] = 1;
                 }
 
                 if (vec3_length_sq(accumulated_direction) > 0.0001f) vec3_normalize(&accumulated_direction);
                 else accumulated_direction = { 0,0,0 };
 
-                direction_float_data[hdr_idx + 0] = accumulated_direction.x;
-                direction_float_data[hdr_idx + 1] = accumulated_direction.y;
-                direction_float_data[hdr_idx + 2] = accumulated_direction.z;
-
-                direct_lightmap_data[hdr_idx + 0] = direct_light_color.x;
-                direct_lightmap_data[hdr_idx + 1] = direct_light_color.y;
-                direct_lightmap_data[hdr_idx + 2] = direct_light_color.z;
-
-                indirect_lightmap_data[hdr_idx + 0] = indirect_light_color.x;
-                indirect_lightmap_data[hdr_idx + 1] = indirect_light_color.y;
-                indirect_lightmap_data[hdr_idx + 2] = indirect_light_color.z;
-
-                albedo_lightmap_data[hdr_idx + 0] = face_reflectivity_v4.x;
-                albedo_lightmap_data[hdr_idx + 1] = face_reflectivity_v4.y;
-                albedo_lightmap_data[hdr_idx + 2] = face_reflectivity_v4.z;
-            }
-        }
-
-        std::vector<float> denoised_indirect_data(lightmap_width * lightmap_height * 3);
-        constexpr float BLACK_THRESHOLD = 0.0001f;
-        float indirect_sum = 0.0f;
-        for (float val : indirect_lightmap_data) {
-            indirect_sum += val;
-        }
-
-        if (indirect_sum > BLACK_THRESHOLD)
-        {
-            size_t pixelStride = sizeof(float) * 3;
-            size_t rowStride = pixelStride * lightmap_width;
-
-            OIDNFilter filter = oidnNewFilter(m_oidn_device, "RTLightmap");
-
-            oidnSetSharedFilterImage(filter, "color", indirect_lightmap_data.data(), OIDN_FORMAT_FLOAT3, lightmap_width, lightmap_height, 0, pixelStride, rowStride);
-            oidnSetSharedFilterImage(filter, "albedo", albedo_lightmap_data.data(), OIDN_FORMAT_FLOAT3, lightmap_width, lightmap_height, 0, pixelStride, rowStride);
-            oidnSetSharedFilterImage(filter, "normal", normal_lightmap_data.data(), OIDN_FORMAT_FLOAT3, lightmap_width, lightmap_height, 0, pixelStride, rowStride);
-            oidnSetSharedFilterImage(filter, "output", denoised_indirect_data.data(), OIDN_FORMAT_FLOAT3, lightmap_width, lightmap_height, 0, pixelStride, rowStride);
-
-            oidnSetFilterBool(filter, "hdr", true);
-            oidnSetFilterBool(filter, "cleanAux", true);
-            oidnCommitFilter(filter);
-            oidnExecuteFilter(filter);
-
-            const char* errorMessage;
-            if (oidnGetDeviceError(m_oidn_device, &errorMessage) != OIDN_ERROR_NONE)
-                Console_Printf_Error("[OIDN] Filter execution error: %s", errorMessage);
-
-            oidnReleaseFilter(filter);
-        }
-        else
-        {
-            std::fill(denoised_indirect_data.begin(), denoised_indirect_data.end(), 0.0f);
-        }
-
-        std::vector<float> final_hdr_lightmap_data(lightmap_width * lightmap_height * 3);
-        for (int y = 0; y < lightmap_height; ++y) {
-            for (int x = 0; x < lightmap_width; ++x) {
-                int idx = (y * lightmap_width + x) * 3;
-                Vec3 direct_light = { direct_lightmap_data[idx], direct_lightmap_data[idx + 1], direct_lightmap_data[idx + 2] };
-                Vec3 indirect_light = { denoised_indirect_data[idx], denoised_indirect_data[idx + 1], denoised_indirect_data[idx + 2] };
-
-                float u_tex = (static_cast<float>(x) + 0.5f) / lightmap_width;
-                float v_tex = (static_cast<float>(y) + 0.5f) / lightmap_height;
-                float target_u = min_uv.x + u_tex * uv_range.x;
-                float target_v = min_uv.y + v_tex * uv_range.y;
-                Vec3 world_pos;
-                bool inside = false;
-                Vec3 point_normal = { 0.0f, 0.0f, 1.0f };
-
-                for (int k = 0; k < face.numVertexIndices - 2; ++k)
-                {
-                    int idx0 = face.vertexIndices[0];
-                    int idx1 = face.vertexIndices[k + 1];
-                    int idx2 = face.vertexIndices[k + 2];
-                    Vec2 uv0 = calculate_texture_uv_for_vertex(&b, data.face_index, idx0);
-                    Vec2 uv1 = calculate_texture_uv_for_vertex(&b, data.face_index, idx1);
-                    Vec2 uv2 = calculate_texture_uv_for_vertex(&b, data.face_index, idx2);
-                    Vec3 p0 = world_verts[0], p1 = world_verts[k + 1], p2 = world_verts[k + 2];
-                    Vec3 barycentric = barycentric_coords({ target_u, target_v }, uv0, uv1, uv2);
-                    if (barycentric.x >= -1e-4f && barycentric.y >= -1e-4f && barycentric.z >= -1e-4f) {
-                        inside = true;
-                        world_pos = vec3_add(vec3_muls(p0, barycentric.x), vec3_add(vec3_muls(p1, barycentric.y), vec3_muls(p2, barycentric.z)));
-                        Vec3 tri_normal = vec3_cross(vec3_sub(p1, p0), vec3_sub(p2, p0));
-                        vec3_normalize(&tri_normal);
-                        point_normal = tri_normal;
-                        break;
-                    }
-                }
-
-                Vec3 direct_sun_light = { 0,0,0 };
-                if (inside) {
-                    direct_sun_light = calculate_direct_sun_light_only(world_pos, point_normal);
-                }
-
-                Vec3 final_light = vec3_add(vec3_sub(direct_light, direct_sun_light), indirect_light);
-                final_hdr_lightmap_data[idx] = final_light.x;
-                final_hdr_lightmap_data[idx + 1] = final_light.y;
-                final_hdr_lightmap_data[idx + 2] = final_light.z;
-            }
-        }
+                lm->direction[hdr_idx + 0] = accumulated_direction.x;
+                lm->direction[hdr_idx + 1] = accumulated_direction.y;
+                lm->direction[hdr_idx + 2] = accumulated_direction.z;
 
-        std::vector<float> filtered_direction_data;
-        apply_guided_filter(filtered_direction_data, direction_float_data, final_hdr_lightmap_data, lightmap_width, lightmap_height, 4, 0.01f);
+                Vec3 base_light = vec3_sub(direct_light_color, direct_sun_light);
+                lm->base[hdr_idx + 0] = base_light.x;
+                lm->base[hdr_idx + 1] = base_light.y;
+                lm->base[hdr_idx + 2] = base_light.z;
 
-        for (int i = 0; i < lightmap_width * lightmap_height; ++i) {
-            int idx3 = i * 3;
-            Vec3 dir = { filtered_direction_data[idx3], filtered_direction_data[idx3 + 1], filtered_direction_data[idx3 + 2] };
-            if (vec3_length_sq(dir) > 0.0001f) {
-                vec3_normalize(&dir);
-            }
-            else {
-                dir = { 0,0,0 };
-            }
-
-            int idx4 = i * 4;
-            dir_lightmap_data[idx4 + 0] = static_cast<unsigned char>((dir.x * 0.5f + 0.5f) * 255.0f);
-            dir_lightmap_data[idx4 + 1] = static_cast<unsigned char>((dir.y * 0.5f + 0.5f) * 255.0f);
-            dir_lightmap_data[idx4 + 2] = static_cast<unsigned char>((dir.z * 0.5f + 0.5f) * 255.0f);
-            dir_lightmap_data[idx4 + 3] = 255;
-        }
-
-        apply_gaussian_blur(final_hdr_lightmap_data, lightmap_width, lightmap_height, 3);
-
-        int padded_width = lightmap_width + LIGHTMAPPADDING * 2;
-        int padded_height = lightmap_height + LIGHTMAPPADDING * 2;
-
-        std::vector<float> padded_hdr_data(padded_width * padded_height * 3);
-        for (int y = 0; y < padded_height; ++y) {
-            for (int x = 0; x < padded_width; ++x) {
-                int src_x = std::clamp(x - LIGHTMAPPADDING, 0, lightmap_width - 1);
-                int src_y = std::clamp(y - LIGHTMAPPADDING, 0, lightmap_height - 1);
-                for (int c = 0; c < 3; ++c) {
-                    padded_hdr_data[(y * padded_width + x) * 3 + c] = final_hdr_lightmap_data[(src_y * lightmap_width + src_x) * 3 + c];
-                }
-            }
-        }
-
-        std::vector<unsigned char> padded_dir_data(padded_width * padded_height * 4);
-        for (int y = 0; y < padded_height; ++y) {
-            for (int x = 0; x < padded_width; ++x) {
-                int src_x = std::clamp(x - LIGHTMAPPADDING, 0, lightmap_width - 1);
-                int src_y = std::clamp(y - LIGHTMAPPADDING, 0, lightmap_height - 1);
-                for (int c = 0; c < 4; ++c) {
-                    padded_dir_data[(y * padded_width + x) * 4 + c] = dir_lightmap_data[(src_y * lightmap_width + src_x) * 4 + c];
-                }
+                lm->indirect[hdr_idx + 0] = indirect_light_color.x;
+                lm->indirect[hdr_idx + 1] = indirect_light_color.y;
+                lm->indirect[hdr_idx + 2] = indirect_light_color.z;
             }
         }
 
-        fs::path color_path = data.output_dir / ("face_" + std::to_string(data.face_index) + "_color.hdr");
-        stbi_write_hdr(color_path.string().c_str(), padded_width, padded_height, 3, padded_hdr_data.data());
-        fs::path dir_path = data.output_dir / ("face_" + std::to_string(data.face_index) + "_dir.png");
-        SDL_Surface* dir_surface = SDL_CreateRGBSurfaceFrom(padded_dir_data.data(), padded_width, padded_height, 32, padded_width * 4,
-            0x000000ff, 0x0000ff00, 0x00ff0000, 0xff000000);
-        if (dir_surface) {
-            IMG_SavePNG(dir_surface, dir_path.string().c_str());
-            SDL_FreeSurface(dir_surface);
-        }
+        submit_traced_lightmap(std::move(lm));
     }
 
     void Lightmapper::process_decal(const DecalJobData& data)
@@ -1074,12 +854,6 @@ namespace
         Vec3 normal = { transform.m[8], transform.m[9], transform.m[10] };
         vec3_normalize(&normal);
 
-        std::vector<float> direct_lightmap_data(lightmap_res * lightmap_res * 3);
-        std::vector<float> indirect_lightmap_data(lightmap_res * lightmap_res * 3);
-        std::vector<float> albedo_lightmap_data(lightmap_res * lightmap_res * 3);
-        std::vector<float> normal_lightmap_data(lightmap_res * lightmap_res * 3);
-        std::vector<float> direction_float_data(lightmap_res * lightmap_res * 3);
-
         Vec4 decal_reflectivity = { 0.5f, 0.5f, 0.5f, 1.0f };
         if (decal.material) {
             auto it = m_material_reflectivity.find(decal.material);
@@ -1088,6 +862,20 @@ namespace
             }
         }
 
+        auto lm = std::make_unique<TracedLightmap>();
+        lm->width = lightmap_res;
+        lm->height = lightmap_res;
+        lm->is_brush_face = false;
+        lm->albedo = { decal_reflectivity.x, decal_reflectivity.y, decal_reflectivity.z };
+        lm->color_path = data.output_dir / "lightmap_color.hdr";
+        lm->dir_path = data.output_dir / "lightmap_dir.png";
+        lm->base.resize(lightmap_res * lightmap_res * 3);
+        lm->indirect.resize(lightmap_res * lightmap_res * 3);
+        lm->normal.resize(lightmap_res * lightmap_res * 3);
+        lm->direction.resize(lightmap_res * lightmap_res * 3);
+
+        Vec3 direct_sun_light = calculate_direct_sun_light_only(decal.pos, normal);
+
         for (int y = 0; y < lightmap_res; ++y) {
             for (int x = 0; x < lightmap_res; ++x) {
                 float u = (static_cast<float>(x) + 0.5f) / lightmap_res;
@@ -1105,80 +893,266 @@ namespace
                 Vec3 dominant_dir = { 0,0,0 }, indirect_dir = { 0,0,0 };
                 Vec3 direct_light = calculate_direct_light(sampling_pos, normal, dominant_dir);
                 Vec3 indirect_light = calculate_indirect_light(sampling_pos, normal, rng, indirect_dir, INDIRECT_SAMPLES_PER_POINT_DECALS);
+                Vec3 base_light = vec3_sub(direct_light, direct_sun_light);
 
                 int idx = (y * lightmap_res + x) * 3;
 
-                direct_lightmap_data[idx + 0] = direct_light.x;
-                direct_lightmap_data[idx + 1] = direct_light.y;
-                direct_lightmap_data[idx + 2] = direct_light.z;
+                lm->base[idx + 0] = base_light.x;
+                lm->base[idx + 1] = base_light.y;
+                lm->base[idx + 2] = base_light.z;
 
-                indirect_lightmap_data[idx + 0] = indirect_light.x;
-                indirect_lightmap_data[idx + 1] = indirect_light.y;
-                indirect_lightmap_data[idx + 2] = indirect_light.z;
+                lm->indirect[idx + 0] = indirect_light.x;
+                lm->indirect[idx + 1] = indirect_light.y;
+                lm->indirect[idx + 2] = indirect_light.z;
 
-                albedo_lightmap_data[idx + 0] = decal_reflectivity.x;
-                albedo_lightmap_data[idx + 1] = decal_reflectivity.y;
-                albedo_lightmap_data[idx + 2] = decal_reflectivity.z;
-
-                normal_lightmap_data[idx + 0] = normal.x;
-                normal_lightmap_data[idx + 1] = normal.y;
-                normal_lightmap_data[idx + 2] = normal.z;
+                lm->normal[idx + 0] = normal.x;
+                lm->normal[idx + 1] = normal.y;
+                lm->normal[idx + 2] = normal.z;
 
                 Vec3 total_dir = vec3_add(dominant_dir, indirect_dir);
                 if (vec3_length_sq(total_dir) > 0.0001f) vec3_normalize(&total_dir);
-                direction_float_data[idx + 0] = total_dir.x;
-                direction_float_data[idx + 1] = total_dir.y;
-                direction_float_data[idx + 2] = total_dir.z;
-            }
-        }
-
-        std::vector<float> denoised_indirect_data(lightmap_res * lightmap_res * 3);
-        float indirect_sum = 0.0f; for (float val : indirect_lightmap_data) indirect_sum += val;
-        if (indirect_sum > 0.0001f) {
-            OIDNFilter filter = oidnNewFilter(m_oidn_device, "RTLightmap");
-            oidnSetSharedFilterImage(filter, "color", indirect_lightmap_data.data(), OIDN_FORMAT_FLOAT3, lightmap_res, lightmap_res, 0, sizeof(float) * 3, sizeof(float) * 3 * lightmap_res);
-            oidnSetSharedFilterImage(filter, "albedo", albedo_lightmap_data.data(), OIDN_FORMAT_FLOAT3, lightmap_res, lightmap_res, 0, sizeof(float) * 3, sizeof(float) * 3 * lightmap_res);
-            oidnSetSharedFilterImage(filter, "normal", normal_lightmap_data.data(), OIDN_FORMAT_FLOAT3, lightmap_res, lightmap_res, 0, sizeof(float) * 3, sizeof(float) * 3 * lightmap_res);
-            oidnSetSharedFilterImage(filter, "output", denoised_indirect_data.data(), OIDN_FORMAT_FLOAT3, lightmap_res, lightmap_res, 0, sizeof(float) * 3, sizeof(float) * 3 * lightmap_res);
-            oidnSetFilterBool(filter, "hdr", true);
-            oidnSetFilterBool(filter, "cleanAux", true);
-            oidnCommitFilter(filter);
-            oidnExecuteFilter(filter);
-            oidnReleaseFilter(filter);
+                lm->direction[idx + 0] = total_dir.x;
+                lm->direction[idx + 1] = total_dir.y;
+                lm->direction[idx + 2] = total_dir.z;
+            }
         }
-        else {
-            std::fill(denoised_indirect_data.begin(), denoised_indirect_data.end(), 0.0f);
+
+        submit_traced_lightmap(std::move(lm));
+    }
+
+    void Lightmapper::submit_traced_lightmap(std::unique_ptr<TracedLightmap> lm)
+    {
+        size_t bytes = (lm->base.size() + lm->indirect.size() + lm->normal.size() + lm->direction.size()) * sizeof(float) + lm->coverage.size();
+        std::lock_guard<std::mutex> lock(m_pending_mutex);
+        m_pending.push_back(std::move(lm));
+        m_pending_bytes += bytes;
+    }
+
+    void Lightmapper::run_parallel(size_t count, const std::function<void(size_t)>& fn) const
+    {
+        std::atomic<size_t> next{ 0 };
+        auto worker = [&]() {
+            for (size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+                fn(i);
+            }
+        };
+        unsigned int num_threads = std::min<unsigned int>(m_thread_count, (unsigned int)std::max<size_t>(count, 1));
+        std::vector<std::thread> threads;
+        for (unsigned int i = 1; i < num_threads; ++i) {
+            threads.emplace_back(worker);
+        }
+        worker();
+        for (auto& t : threads) {
+            t.join();
+        }
+    }
+
+    void Lightmapper::denoise_pending()
+    {
+        constexpr float BLACK_THRESHOLD = 0.0001f;
+
+        std::vector<TracedLightmap*> items;
+        for (auto& lm : m_pending) {
+            float indirect_sum = 0.0f;
+            for (float val : lm->indirect) {
+                indirect_sum += val;
+            }
+            if (indirect_sum > BLACK_THRESHOLD) {
+                items.push_back(lm.get());
+            }
+            else {
+                std::fill(lm->indirect.begin(), lm->indirect.end(), 0.0f);
+            }
+        }
+        if (items.empty()) return;
+
+        // Shelf-pack every lightmap into atlas pages so the denoiser runs once per
+        // page with a single filter object instead of once per face. Each entry
+        // keeps a gutter of clamped edge texels so neighbours don't bleed into it.
+        int page_width = std::max(m_atlas_page_size, m_resolution + DENOISE_GUTTER * 2);
+        std::sort(items.begin(), items.end(), [](const TracedLightmap* a, const TracedLightmap* b) { return a->height > b->height; });
+
+        struct AtlasPlacement { TracedLightmap* lm; int x, y; };
+        struct AtlasPage { std::vector<AtlasPlacement> placements; int height = 0; };
+        std::vector<AtlasPage> pages(1);
+        int shelf_x = 0, shelf_y = 0, shelf_h = 0;
+        for (TracedLightmap* lm : items) {
+            int w = lm->width + DENOISE_GUTTER * 2;
+            int h = lm->height + DENOISE_GUTTER * 2;
+            if (shelf_x + w > page_width) {
+                shelf_y += shelf_h;
+                shelf_x = 0;
+                shelf_h = 0;
+            }
+            if (shelf_y + h > page_width) {
+                pages.emplace_back();
+                shelf_x = shelf_y = shelf_h = 0;
+            }
+            pages.back().placements.push_back({ lm, shelf_x + DENOISE_GUTTER, shelf_y + DENOISE_GUTTER });
+            pages.back().height = std::max(pages.back().height, shelf_y + h);
+            shelf_x += w;
+            shelf_h = std::max(shelf_h, h);
+        }
+
+        if (!m_denoise_filter) {
+            m_denoise_filter = oidnNewFilter(m_oidn_device, "RTLightmap");
+            oidnSetFilterBool(m_denoise_filter, "hdr", true);
+            oidnSetFilterBool(m_denoise_filter, "cleanAux", true);
+            if (m_denoise_max_memory_mb > 0) {
+                oidnSetFilterInt(m_denoise_filter, "maxMemoryMB", m_denoise_max_memory_mb);
+            }
         }
 
-        std::vector<float> final_hdr_lightmap_data(lightmap_res * lightmap_res * 3);
-        for (size_t i = 0; i < final_hdr_lightmap_data.size() / 3; ++i) {
-            Vec3 direct_light = { direct_lightmap_data[i * 3], direct_lightmap_data[i * 3 + 1], direct_lightmap_data[i * 3 + 2] };
-            Vec3 indirect_light = { denoised_indirect_data[i * 3], denoised_indirect_data[i * 3 + 1], denoised_indirect_data[i * 3 + 2] };
-            Vec3 direct_sun_light = calculate_direct_sun_light_only(decal.pos, normal);
-            Vec3 final_light = vec3_add(vec3_sub(direct_light, direct_sun_light), indirect_light);
-            final_hdr_lightmap_data[i * 3] = final_light.x;
-            final_hdr_lightmap_data[i * 3 + 1] = final_light.y;
-            final_hdr_lightmap_data[i * 3 + 2] = final_light.z;
+        std::vector<float> page_color, page_albedo, page_normal, page_output;
+        for (const AtlasPage& page : pages) {
+            int page_height = (page.height + 15) & ~15;
+            size_t page_floats = (size_t)page_width * page_height * 3;
+            page_color.assign(page_floats, 0.0f);
+            page_albedo.assign(page_floats, 0.0f);
+            page_normal.assign(page_floats, 0.0f);
+            page_output.resize(page_floats);
+
+            for (const AtlasPlacement& p : page.placements) {
+                const TracedLightmap& lm = *p.lm;
+                for (int y = -DENOISE_GUTTER; y < lm.height + DENOISE_GUTTER; ++y) {
+                    int src_y = std::clamp(y, 0, lm.height - 1);
+                    for (int x = -DENOISE_GUTTER; x < lm.width + DENOISE_GUTTER; ++x) {
+                        int src_x = std::clamp(x, 0, lm.width - 1);
+                        size_t src = ((size_t)src_y * lm.width + src_x) * 3;
+                        size_t dst = ((size_t)(p.y + y) * page_width + (p.x + x)) * 3;
+                        for (int c = 0; c < 3; ++c) {
+                            page_color[dst + c] = lm.indirect[src + c];
+                            page_normal[dst + c] = lm.normal[src + c];
+                        }
+                        page_albedo[dst + 0] = lm.albedo.x;
+                        page_albedo[dst + 1] = lm.albedo.y;
+                        page_albedo[dst + 2] = lm.albedo.z;
+                    }
+                }
+            }
+
+            size_t pixelStride = sizeof(float) * 3;
+            size_t rowStride = pixelStride * page_width;
+            oidnSetSharedFilterImage(m_denoise_filter, "color", page_color.data(), OIDN_FORMAT_FLOAT3, page_width, page_height, 0, pixelStride, rowStride);
+            oidnSetSharedFilterImage(m_denoise_filter, "albedo", page_albedo.data(), OIDN_FORMAT_FLOAT3, page_width, page_height, 0, pixelStride, rowStride);
+            oidnSetSharedFilterImage(m_denoise_filter, "normal", page_normal.data(), OIDN_FORMAT_FLOAT3, page_width, page_height, 0, pixelStride, rowStride);
+            oidnSetSharedFilterImage(m_denoise_filter, "output", page_output.data(), OIDN_FORMAT_FLOAT3, page_width, page_height, 0, pixelStride, rowStride);
+            oidnCommitFilter(m_denoise_filter);
+            oidnExecuteFilter(m_denoise_filter);
+
+            const char* errorMessage;
+            if (oidnGetDeviceError(m_oidn_device, &errorMessage) != OIDN_ERROR_NONE)
+                Console_Printf_Error("[OIDN] Filter execution error: %s", errorMessage);
+
+            for (const AtlasPlacement& p : page.placements) {
+                TracedLightmap& lm = *p.lm;
+                for (int y = 0; y < lm.height; ++y) {
+                    const float* src = &page_output[((size_t)(p.y + y) * page_width + p.x) * 3];
+                    std::copy(src, src + lm.width * 3, &lm.indirect[(size_t)y * lm.width * 3]);
+                }
+            }
+            m_denoised_pages++;
+        }
+    }
+
+    void Lightmapper::dilate_lightmap(TracedLightmap& lm)
+    {
+        int width = lm.width;
+        int height = lm.height;
+
+        std::vector<float> final_hdr_lightmap_data(width * height * 3);
+        for (size_t i = 0; i < final_hdr_lightmap_data.size(); ++i) {
+            final_hdr_lightmap_data[i] = lm.base[i] + lm.indirect[i];
+        }
+
+        // Luxels outside the face polygon were never traced. Grow the covered
+        // lighting into them so bilinear filtering doesn't pull in black at edges.
+        if (!lm.coverage.empty()) {
+            size_t count = (size_t)width * height;
+            std::vector<float> planar(count * 6);
+            float* planes[6];
+            for (int c = 0; c < 6; ++c) {
+                planes[c] = planar.data() + count * c;
+            }
+            Image_Deinterleave(final_hdr_lightmap_data.data(), planes, 3, (int)count);
+            Image_Deinterleave(lm.direction.data(), planes + 3, 3, (int)count);
+            Image_Dilate(planes, 6, lm.coverage.data(), width, height, DILATE_ITERATIONS);
+            Image_Interleave(planes, final_hdr_lightmap_data.data(), 3, (int)count);
+            Image_Interleave(planes + 3, lm.direction.data(), 3, (int)count);
         }
 
         std::vector<float> filtered_direction_data;
-        apply_guided_filter(filtered_direction_data, direction_float_data, final_hdr_lightmap_data, lightmap_res, lightmap_res, 4, 0.01f);
+        apply_guided_filter(filtered_direction_data, lm.direction, final_hdr_lightmap_data, width, height, 4, 0.01f);
 
-        std::vector<unsigned char> dir_data_u8(lightmap_res * lightmap_res * 4);
-        for (int i = 0; i < lightmap_res * lightmap_res; ++i) {
-            Vec3 dir = { filtered_direction_data[i * 3], filtered_direction_data[i * 3 + 1], filtered_direction_data[i * 3 + 2] };
-            if (vec3_length_sq(dir) > 0.0001f) vec3_normalize(&dir); else dir = { 0,0,0 };
-            dir_data_u8[i * 4 + 0] = static_cast<unsigned char>((dir.x * 0.5f + 0.5f) * 255.0f);
-            dir_data_u8[i * 4 + 1] = static_cast<unsigned char>((dir.y * 0.5f + 0.5f) * 255.0f);
-            dir_data_u8[i * 4 + 2] = static_cast<unsigned char>((dir.z * 0.5f + 0.5f) * 255.0f);
-            dir_data_u8[i * 4 + 3] = 255;
+        std::vector<unsigned char> dir_lightmap_data(width * height * 4);
+        for (int i = 0; i < width * height; ++i) {
+            int idx3 = i * 3;
+            Vec3 dir = { filtered_direction_data[idx3], filtered_direction_data[idx3 + 1], filtered_direction_data[idx3 + 2] };
+            if (vec3_length_sq(dir) > 0.0001f) {
+                vec3_normalize(&dir);
+            }
+            else {
+                dir = { 0,0,0 };
+            }
+
+            int idx4 = i * 4;
+            dir_lightmap_data[idx4 + 0] = static_cast<unsigned char>((dir.x * 0.5f + 0.5f) * 255.0f);
+            dir_lightmap_data[idx4 + 1] = static_cast<unsigned char>((dir.y * 0.5f + 0.5f) * 255.0f);
+            dir_lightmap_data[idx4 + 2] = static_cast<unsigned char>((dir.z * 0.5f + 0.5f) * 255.0f);
+            dir_lightmap_data[idx4 + 3] = 255;
+        }
+
+        lm.base.clear(); lm.base.shrink_to_fit();
+        lm.indirect.clear(); lm.indirect.shrink_to_fit();
+        lm.normal.clear(); lm.normal.shrink_to_fit();
+        lm.direction.clear(); lm.direction.shrink_to_fit();
+        lm.coverage.clear(); lm.coverage.shrink_to_fit();
+
+        if (!lm.is_brush_face) {
+            lm.out_width = width;
+            lm.out_height = height;
+            lm.out_color = std::move(final_hdr_lightmap_data);
+            lm.out_dir = std::move(dir_lightmap_data);
+            return;
         }
 
-        fs::path color_path = data.output_dir / "lightmap_color.hdr";
-        stbi_write_hdr(color_path.string().c_str(), lightmap_res, lightmap_res, 3, final_hdr_lightmap_data.data());
+        apply_gaussian_blur(final_hdr_lightmap_data, width, height, 3);
 
-        fs::path dir_path = data.output_dir / "lightmap_dir.png";
-        stbi_write_png(dir_path.string().c_str(), lightmap_res, lightmap_res, 4, dir_data_u8.data(), lightmap_res * 4);
+        int padded_width = width + LIGHTMAPPADDING * 2;
+        int padded_height = height + LIGHTMAPPADDING * 2;
+
+        lm.out_width = padded_width;
+        lm.out_height = padded_height;
+        lm.out_color.resize(padded_width * padded_height * 3);
+        lm.out_dir.resize(padded_width * padded_height * 4);
+        Image_PadEdges(lm.out_color.data(), final_hdr_lightmap_data.data(), width, height, LIGHTMAPPADDING, sizeof(float) * 3);
+        Image_PadEdges(lm.out_dir.data(), dir_lightmap_data.data(), width, height, LIGHTMAPPADDING, 4);
+    }
+
+    void Lightmapper::write_lightmap(const TracedLightmap& lm)
+    {
+        stbi_write_hdr(lm.color_path.string().c_str(), lm.out_width, lm.out_height, 3, lm.out_color.data());
+        stbi_write_png(lm.dir_path.string().c_str(), lm.out_width, lm.out_height, 4, lm.out_dir.data(), lm.out_width * 4);
+    }
+
+    void Lightmapper::flush_pending()
+    {
+        if (m_pending.empty()) return;
+
+        auto stage_start = std::chrono::high_resolution_clock::now();
+        denoise_pending();
+        auto denoise_end = std::chrono::high_resolution_clock::now();
+        run_parallel(m_pending.size(), [this](size_t i) { dilate_lightmap(*m_pending[i]); });
+        auto dilate_end = std::chrono::high_resolution_clock::now();
+        run_parallel(m_pending.size(), [this](size_t i) { write_lightmap(*m_pending[i]); });
+        auto write_end = std::chrono::high_resolution_clock::now();
+
+        m_stage_seconds[STAGE_DENOISE] += std::chrono::duration<double>(denoise_end - stage_start).count();
+        m_stage_seconds[STAGE_DILATE] += std::chrono::duration<double>(dilate_end - denoise_end).count();
+        m_stage_seconds[STAGE_WRITE] += std::chrono::duration<double>(write_end - dilate_end).count();
+
+        m_pending.clear();
+        m_pending_bytes = 0;
     }
 
     void Lightmapper::process_model_vertex(const ModelVertexJobData& data)
@@ -1226,6 +1200,10 @@ namespace
     {
         while (true)
         {
+            if (m_pending_budget > 0 && m_pending_bytes.load() >= m_pending_budget)
+            {
+                break;
+            }
             size_t job_index = m_next_job_index.fetch_add(1);
             if (job_index >= m_jobs.size())
             {
@@ -1781,7 +1759,7 @@ namespace
         return vec3_muls(accumulated_color, 1.0f / (float)num_samples);
     }
 
-    void Lightmapper::generate()
+    bool Lightmapper::generate()
     {
         Console_Printf("[Lightmapper] Starting lightmap generation...");
         auto start_time = std::chrono::high_resolution_clock::now();
@@ -1789,19 +1767,32 @@ namespace
 
         precalculate_material_reflectivity();
         prepare_jobs();
-        if (m_jobs.empty()) return;
+        if (m_jobs.empty())
+        {
+            Console_Printf_Warning("[Lightmapper] Nothing to bake.");
+            return false;
+        }
 
-        unsigned int num_threads = std::thread::hardware_concurrency();
-        std::vector<std::thread> threads;
+        unsigned int num_threads = m_num_threads > 0 ? (unsigned int)m_num_threads : std::thread::hardware_concurrency();
+        if (num_threads == 0) num_threads = 1;
+        m_thread_count = num_threads;
         Console_Printf("[Lightmapper] Using %u threads for final gather.", num_threads);
 
-        for (unsigned int i = 0; i < num_threads; ++i)
-        {
-            threads.emplace_back(&Lightmapper::worker_main, this);
-        }
-        for (auto& t : threads)
+        while (m_next_job_index.load() < m_jobs.size())
         {
-            t.join();
+            auto trace_start = std::chrono::high_resolution_clock::now();
+            std::vector<std::thread> threads;
+            for (unsigned int i = 0; i < num_threads; ++i)
+            {
+                threads.emplace_back(&Lightmapper::worker_main, this);
+            }
+            for (auto& t : threads)
+            {
+                t.join();
+            }
+            m_stage_seconds[STAGE_TRACE] += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - trace_start).count();
+
+            flush_pending();
         }
 
         generate_ambient_probes();
@@ -1849,16 +1840,19 @@ namespace
 
         auto end_time = std::chrono::high_resolution_clock::now();
         std::chrono::duration<float> duration = end_time - start_time;
+        Console_Printf("[Lightmapper] Stage timings: trace %.2fs, denoise %.2fs (%d atlas pages), dilate %.2fs, write %.2fs.",
+            m_stage_seconds[STAGE_TRACE], m_stage_seconds[STAGE_DENOISE], m_denoised_pages, m_stage_seconds[STAGE_DILATE], m_stage_seconds[STAGE_WRITE]);
         Console_Printf("[Lightmapper] Finished in %.2f seconds.", duration.count());
+        return true;
     }
 }
 
-void Lightmapper_Generate(Scene* scene, Engine* engine, int resolution, int bounces)
+bool Lightmapper_Generate(Scene* scene, Engine* engine, int resolution, int bounces, int num_threads)
 {
     try
     {
-        Lightmapper mapper(scene, resolution, bounces);
-        mapper.generate();
+        Lightmapper mapper(scene, resolution, bounces, num_threads);
+        return mapper.generate();
     }
     catch (const std::exception& e)
     {
@@ -1868,13 +1862,15 @@ void Lightmapper_Generate(Scene* scene, Engine* engine, int resolution, int boun
     {
         Console_Printf_Error("[Lightmapper] Unknown C++ exception occurred.");
     }
+    return false;
 }
 #else
 #include "lightmapper.h"
 #include "gl_console.h"
 
-void Lightmapper_Generate(Scene* scene, Engine* engine, int resolution, int bounces)
+bool Lightmapper_Generate(Scene* scene, Engine* engine, int resolution, int bounces, int num_threads)
 {
     Console_Printf_Error("[Lightmapper] Not available on x86 builds.");
+    return false;
 }
 #endif
\ No newline at end of file
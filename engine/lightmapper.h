@@ -31,7 +31,7 @@
 extern "C" {
 #endif
 
-	void Lightmapper_Generate(Scene* scene, Engine* engine, int resolution, int bounces);
+	bool Lightmapper_Generate(Scene* scene, Engine* engine, int resolution, int bounces, int num_threads);
 
 #ifdef __cplusplus
 }
@@ -33,6 +33,9 @@
 #include "gl_video_player.h"
 #include "gl_console.h"
 #include "water_manager.h"
+#include "savegame.h"
+#include "content_cache.h"
+#include "gl_gpu_particles.h"
 #include "mikktspace/mikktspace.h"
 #include <float.h>
 #include <SDL_image.h>
@@ -1289,6 +1292,7 @@ void Brush_CreateRenderData(Brush* b) {
 
 void Scene_Clear(Scene* scene, Engine* engine) {
     IO_Clear();
+    GPUParticles_Reset();
 
     if (scene->objects) {
         for (int i = 0; i < scene->numObjects; ++i) {
@@ -1503,6 +1507,133 @@ void Scene_LoadAmbientProbes(Scene* scene) {
     }
 }
 
+void Scene_GetReflectionProbePath(const Scene* scene, char* out_path, size_t out_size) {
+    char map_name_sanitized[128];
+    const char* last_slash = strrchr(scene->mapPath, '/');
+    const char* last_bslash = strrchr(scene->mapPath, '\\');
+    const char* map_filename_start = (last_slash > last_bslash) ? last_slash + 1 : (last_bslash ? last_bslash + 1 : scene->mapPath);
+
+    const char* dot = strrchr(map_filename_start, '.');
+    size_t len = dot ? (size_t)(dot - map_filename_start) : strlen(map_filename_start);
+    if (len >= sizeof(map_name_sanitized)) len = sizeof(map_name_sanitized) - 1;
+    strncpy(map_name_sanitized, map_filename_start, len);
+    map_name_sanitized[len] = '\0';
+
+    snprintf(out_path, out_size, "cubemaps/%s.rpb", map_name_sanitized);
+}
+
+GLuint Brush_CreateReflectionProbeView(GLuint probe_array, int layer, int mip_count) {
+    GLuint view;
+    glGenTextures(1, &view);
+    glTextureView(view, GL_TEXTURE_CUBE_MAP, probe_array, GL_RGBA16F, 0, mip_count, layer * 6, 6);
+    glBindTexture(GL_TEXTURE_CUBE_MAP, view);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+    return view;
+}
+
+static void Scene_LoadLegacyReflectionProbe(Brush* b) {
+    const char* faces_suffixes[] = { "px", "nx", "py", "ny", "pz", "nz" };
+    char face_paths[6][256];
+    const char* face_pointers[6];
+    for (int i = 0; i < 6; ++i) {
+        sprintf(face_paths[i], "cubemaps/%s_%s.png", b->name, faces_suffixes[i]);
+        face_pointers[i] = face_paths[i];
+    }
+    b->cubemapTexture = loadCubemap(face_pointers);
+}
+
+void Scene_LoadReflectionProbes(Scene* scene) {
+    if (g_is_headless_mode) {
+        return;
+    }
+
+    char probe_path[512];
+    Scene_GetReflectionProbePath(scene, probe_path, sizeof(probe_path));
+
+    ReflectionProbeFileHeader header;
+    memset(&header, 0, sizeof(header));
+    char (*names)[REFLECTION_PROBE_NAME_LENGTH] = NULL;
+    GLuint probe_array = 0;
+
+    FILE* file = fopen(probe_path, "rb");
+    if (file) {
+        unsigned char* data = NULL;
+        size_t data_size = 0;
+        bool valid = fread(&header, sizeof(header), 1, file) == 1 &&
+            strncmp(header.magic, REFLECTION_PROBE_MAGIC, 4) == 0 &&
+            header.version == REFLECTION_PROBE_VERSION &&
+            header.resolution > 0 && header.probeCount > 0 &&
+            header.mipCount > 0 && header.mipCount < 16 && (header.resolution >> (header.mipCount - 1)) > 0;
+        if (valid) {
+            for (int mip = 0; mip < header.mipCount; ++mip) {
+                size_t size = (size_t)(header.resolution >> mip);
+                data_size += size * size * 4 * sizeof(uint16_t) * 6 * header.probeCount;
+            }
+            names = malloc(sizeof(*names) * header.probeCount);
+            data = malloc(data_size);
+            valid = names && data &&
+                fread(names, sizeof(*names), header.probeCount, file) == (size_t)header.probeCount &&
+                fread(data, 1, data_size, file) == data_size;
+        }
+        fclose(file);
+
+        if (valid) {
+            glGenTextures(1, &probe_array);
+            glBindTexture(GL_TEXTURE_CUBE_MAP_ARRAY, probe_array);
+            glTexStorage3D(GL_TEXTURE_CUBE_MAP_ARRAY, header.mipCount, GL_RGBA16F, header.resolution, header.resolution, 6 * header.probeCount);
+            const unsigned char* mip_data = data;
+            for (int mip = 0; mip < header.mipCount; ++mip) {
+                int size = header.resolution >> mip;
+                glTexSubImage3D(GL_TEXTURE_CUBE_MAP_ARRAY, mip, 0, 0, 0, size, size, 6 * header.probeCount, GL_RGBA, GL_HALF_FLOAT, mip_data);
+                mip_data += (size_t)size * size * 4 * sizeof(uint16_t) * 6 * header.probeCount;
+            }
+            glBindTexture(GL_TEXTURE_CUBE_MAP_ARRAY, 0);
+        }
+        else {
+            Console_Printf_Error("Invalid reflection probe file: %s", probe_path);
+        }
+        free(data);
+    }
+
+    for (int i = 0; i < scene->numBrushes; ++i) {
+        Brush* b = &scene->brushes[i];
+        if (strcmp(b->classname, "env_reflectionprobe") != 0) {
+            continue;
+        }
+
+        int layer = -1;
+        for (int p = 0; probe_array && p < header.probeCount; ++p) {
+            if (strncmp(names[p], b->name, REFLECTION_PROBE_NAME_LENGTH) == 0) {
+                layer = p;
+                break;
+            }
+        }
+
+        if (b->cubemapTexture && glIsTexture(b->cubemapTexture)) {
+            glDeleteTextures(1, &b->cubemapTexture);
+        }
+        b->cubemapTexture = 0;
+        if (layer >= 0) {
+            b->cubemapTexture = Brush_CreateReflectionProbeView(probe_array, layer, header.mipCount);
+        }
+        else {
+            // Maps baked before the probe container still ship per-face PNGs.
+            Scene_LoadLegacyReflectionProbe(b);
+        }
+    }
+
+    // Every probe holds a view of its own slice, the views keep the storage alive.
+    if (probe_array) {
+        glDeleteTextures(1, &probe_array);
+    }
+    free(names);
+}
+
 void Brush_GenerateLightmapAtlas(Brush* b, const char* map_name_sanitized, int brush_index, int resolution) {
     if (b->numFaces == 0) return;
 
@@ -1631,6 +1762,7 @@ bool Scene_LoadMap(Scene* scene, Renderer* renderer, const char* mapPath, Engine
         Console_Printf_Error("[error] Could not find map file: %s", mapPath);
         return false;
     }
+    ContentCache_InvalidateStale();
 
     char version_line[256];
     int map_file_version = 0;
@@ -1656,7 +1788,9 @@ bool Scene_LoadMap(Scene* scene, Renderer* renderer, const char* mapPath, Engine
     strncpy(scene->mapPath, mapPath, sizeof(scene->mapPath) - 1);
     scene->mapPath[sizeof(scene->mapPath) - 1] = '\0';
 
-    engine->physicsWorld = Physics_CreateWorld(Cvar_GetFloat("gravity") * -1.0f);
+    if (!g_is_headless_mode) {
+        engine->physicsWorld = Physics_CreateWorld(Cvar_GetFloat("gravity") * -1.0f);
+    }
 
     char line[2048];
     while (fgets(line, sizeof(line), file)) {
@@ -1812,14 +1946,6 @@ bool Scene_LoadMap(Scene* scene, Renderer* renderer, const char* mapPath, Engine
                     b->groupName[0] = '\0';
                 }
             }
-            if (strcmp(b->classname, "env_reflectionprobe") == 0) {
-                const char* faces_suffixes[] = { "px", "nx", "py", "ny", "pz", "nz" };
-                char face_paths[6][256];
-                for (int i = 0; i < 6; ++i) sprintf(face_paths[i], "cubemaps/%s_%s.png", b->name, faces_suffixes[i]);
-                const char* face_pointers[6];
-                for (int i = 0; i < 6; ++i) face_pointers[i] = face_paths[i];
-                b->cubemapTexture = loadCubemap(face_pointers);
-            }
             Brush_UpdateMatrix(b);
             char map_name_sanitized[128];
             char* dot = strrchr(scene->mapPath, '.');
@@ -1829,9 +1955,11 @@ bool Scene_LoadMap(Scene* scene, Renderer* renderer, const char* mapPath, Engine
                 map_name_sanitized[len] = '\0';
             }
             else { strcpy(map_name_sanitized, scene->mapPath); }
-            Brush_GenerateLightmapAtlas(b, map_name_sanitized, scene->numBrushes, scene->lightmapResolution);
-            Brush_CreateRenderData(b);
-            if (Brush_IsSolid(b) && b->numVertices > 0) {
+            if (!g_is_headless_mode) {
+                Brush_GenerateLightmapAtlas(b, map_name_sanitized, scene->numBrushes, scene->lightmapResolution);
+                Brush_CreateRenderData(b);
+            }
+            if (engine->physicsWorld && Brush_IsSolid(b) && b->numVertices > 0) {
                 if (strcmp(b->classname, "func_plat") == 0) {
                     b->start_pos = b->pos;
                     float height = atof(Brush_GetProperty(b, "height", "0"));
@@ -1905,6 +2033,7 @@ bool Scene_LoadMap(Scene* scene, Renderer* renderer, const char* mapPath, Engine
             SceneObject_LoadVertexLighting(newObj, scene->numObjects - 1, scene->mapPath);
             SceneObject_LoadVertexDirectionalLighting(newObj, scene->numObjects - 1, scene->mapPath);
             if (!newObj->model) { scene->numObjects--; continue; }
+            if (!engine->physicsWorld) continue;
             if (newObj->mass > 0.0f) { newObj->physicsBody = Physics_CreateDynamicConvexHull(engine->physicsWorld, newObj->model->combinedVertexData, newObj->model->totalVertexCount, newObj->mass, newObj->modelMatrix); if (!newObj->isPhysicsEnabled) Physics_ToggleCollision(engine->physicsWorld, newObj->physicsBody, false); }
             else if (newObj->model && newObj->model->combinedVertexData && newObj->model->totalIndexCount > 0) { Mat4 physics_transform = create_trs_matrix(newObj->pos, newObj->rot, (Vec3) { 1.0f, 1.0f, 1.0f }); newObj->physicsBody = Physics_CreateStaticTriangleMesh(engine->physicsWorld, newObj->model->combinedVertexData, newObj->model->totalVertexCount, newObj->model->combinedIndexData, newObj->model->totalIndexCount, physics_transform, newObj->scale); }
         }
@@ -1976,7 +2105,7 @@ bool Scene_LoadMap(Scene* scene, Renderer* renderer, const char* mapPath, Engine
 
             if (strlen(light->cookiePath) > 0 && strcmp(light->cookiePath, "none") != 0) {
                 Material* cookieMat = TextureManager_FindMaterial(light->cookiePath);
-                if (cookieMat && cookieMat != &g_MissingMaterial) {
+                if (cookieMat && cookieMat != &g_MissingMaterial && !g_is_headless_mode) {
                     light->cookieMap = cookieMat->diffuseMap;
                     light->cookieMapHandle = glGetTextureHandleARB(light->cookieMap);
                     glMakeTextureHandleResidentARB(light->cookieMapHandle);
@@ -1988,7 +2117,9 @@ bool Scene_LoadMap(Scene* scene, Renderer* renderer, const char* mapPath, Engine
                 light->cookieMapHandle = 0;
             }
 
-            Light_InitShadowMap(light);
+            if (!g_is_headless_mode) {
+                Light_InitShadowMap(light);
+            }
             scene->numActiveLights++;
             }
         else if (strcmp(keyword, "decal") == 0) {
@@ -2025,7 +2156,9 @@ bool Scene_LoadMap(Scene* scene, Renderer* renderer, const char* mapPath, Engine
                 else {
                     strcpy(map_name_sanitized, map_filename);
                 }
-                Decal_LoadLightmaps(d, map_name_sanitized, scene->numDecals);
+                if (!g_is_headless_mode) {
+                    Decal_LoadLightmaps(d, map_name_sanitized, scene->numDecals);
+                }
                 scene->numDecals++;
             }
         }
@@ -2048,6 +2181,7 @@ bool Scene_LoadMap(Scene* scene, Renderer* renderer, const char* mapPath, Engine
                     s->groupName[0] = '\0';
                     fseek(file, current_pos, SEEK_SET);
                 }
+                if (g_is_headless_mode) { scene->numSoundEntities++; continue; }
                 s->bufferID = SoundSystem_LoadSound(s->soundPath);
                 if (s->play_on_start) s->sourceID = SoundSystem_PlaySound(s->bufferID, s->pos, s->volume, s->pitch, s->maxDistance, s->is_looping);
                 scene->numSoundEntities++;
@@ -2067,6 +2201,7 @@ bool Scene_LoadMap(Scene* scene, Renderer* renderer, const char* mapPath, Engine
                     emitter->groupName[0] = '\0';
                     fseek(file, current_pos, SEEK_SET);
                 }
+                if (g_is_headless_mode) continue;
                 ParticleSystem* ps = ParticleSystem_Load(emitter->parFile);
                 if (ps) { ParticleEmitter_Init(emitter, ps, emitter->pos); scene->numParticleEmitters++; }
             }
@@ -2108,7 +2243,7 @@ bool Scene_LoadMap(Scene* scene, Renderer* renderer, const char* mapPath, Engine
                     vp->groupName[0] = '\0';
                     fseek(file, current_pos, SEEK_SET);
                 }
-                VideoPlayer_Load(vp); if (vp->playOnStart) VideoPlayer_Play(vp);
+                if (!g_is_headless_mode) { VideoPlayer_Load(vp); if (vp->playOnStart) VideoPlayer_Play(vp); }
                 scene->numVideoPlayers++;
             }
         }
@@ -2214,7 +2349,9 @@ bool Scene_LoadMap(Scene* scene, Renderer* renderer, const char* mapPath, Engine
         scene->skybox_cubemap = loadCubemap(face_pointers);
     }
     else { scene->skybox_cubemap = 0; }
-    engine->camera.physicsBody = Physics_CreatePlayerCapsule(engine->physicsWorld, 0.4f, PLAYER_HEIGHT_NORMAL, 80.0f, scene->playerStart.position);
+    if (engine->physicsWorld) {
+        engine->camera.physicsBody = Physics_CreatePlayerCapsule(engine->physicsWorld, 0.4f, PLAYER_HEIGHT_NORMAL, 80.0f, scene->playerStart.position);
+    }
     engine->camera.position = scene->playerStart.position;
     engine->camera.yaw = scene->playerStart.yaw;
     engine->camera.pitch = scene->playerStart.pitch;
@@ -2230,12 +2367,20 @@ bool Scene_LoadMap(Scene* scene, Renderer* renderer, const char* mapPath, Engine
         strcpy(map_name_sanitized, scene->mapPath);
     }
 
+    Scene_RefreshEntityClasses(scene);
+
+    if (g_is_headless_mode) {
+        return true;
+    }
+
     Scene_LoadAmbientProbes(scene);
+    Scene_LoadReflectionProbes(scene);
+    SaveGame_CaptureBaseline(scene);
 
-    for (int i = 0; i < scene->numLogicEntities; ++i) {
-        if (strcmp(scene->logicEntities[i].classname, "logic_auto") == 0) {
-            IO_FireOutput(ENTITY_LOGIC, i, "OnMapSpawn", 0.0f, NULL);
-        }
+    const int* autos;
+    int num_autos = Scene_GetLogicEntitiesOfClass(scene, ENTITY_CLASS_LOGIC_AUTO, &autos);
+    for (int k = 0; k < num_autos; ++k) {
+        IO_FireOutput(ENTITY_LOGIC, autos[k], "OnMapSpawn", 0.0f, NULL);
     }
 
     return true;
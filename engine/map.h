@@ -39,6 +39,7 @@
 #include "physics_wrapper.h"
 #include "gl_particle_system.h"
 #include "dsp_reverb.h"
+#include "entity_classes.h"
 #include <AL/al.h>
 
 #ifdef __cplusplus
@@ -69,6 +70,21 @@ extern "C" {
 
 #define LIGHTMAPPADDING 2
 
+// Baked reflection probes live in one container per map: a header, the probe
+// names, then every mip of the whole RGBA16F cubemap array in upload order.
+#define REFLECTION_PROBE_MAGIC "RPRB"
+#define REFLECTION_PROBE_VERSION 1
+#define REFLECTION_PROBE_MIP_COUNT 5
+#define REFLECTION_PROBE_NAME_LENGTH 64
+
+    typedef struct {
+        char magic[4];
+        int version;
+        int resolution;
+        int mipCount;
+        int probeCount;
+    } ReflectionProbeFileHeader;
+
     typedef enum {
         ENTITY_NONE, ENTITY_MODEL, ENTITY_BRUSH, ENTITY_LIGHT, ENTITY_PLAYERSTART, ENTITY_DECAL, ENTITY_SOUND, ENTITY_PARTICLE_EMITTER, ENTITY_VIDEO_PLAYER, ENTITY_PARALLAX_ROOM, ENTITY_LOGIC, ENTITY_SPRITE
     } EntityType;
@@ -199,36 +215,47 @@ extern "C" {
         GLuint gGeometryNormal;
         GLuint spriteShader;
         GLuint spriteVAO, spriteVBO;
+        GLuint spriteInstanceVBO;
         GLuint cloudTexture;
         GLuint brdfLUTTexture;
         GLuint decalVAO, decalVBO;
+        GLuint decalInstanceSSBO;
         GLuint parallaxRoomVAO, parallaxRoomVBO;
         GLuint sunShadowFBO;
         GLuint sunShadowMap;
         GLuint finalRenderFBO;
         GLuint finalRenderTexture;
         GLuint finalDepthTexture;
-        GLuint bloomShader;
-        GLuint bloomBlurShader;
-        GLuint bloomFBO;
-        GLuint bloomBrightnessTexture;
-        GLuint pingpongFBO[2];
-        GLuint pingpongColorbuffers[2];
+        GLuint bloomDownsampleShader;
+        GLuint bloomUpsampleShader;
+        GLuint bloomTexture;
+        GLuint bloomLinearSampler;
+        int bloomMipCount;
         GLuint volumetricShader;
-        GLuint volumetricBlurShader;
+        GLuint volumetricInjectShader;
+        GLuint volumetricIntegrateShader;
         GLuint volumetricFBO;
         GLuint volumetricTexture;
-        GLuint volPingpongFBO[2];
-        GLuint volPingpongTextures[2];
+        GLuint froxelScatterTextures[2];
+        GLuint froxelIntegratedTexture;
         GLuint dofShader;
-        GLuint ssaoFBO, ssaoBlurFBO;
-        GLuint ssaoColorBuffer, ssaoBlurColorBuffer;
-        GLuint ssaoShader, ssaoBlurShader;
+        GLuint ssaoDepthShader, ssaoShader, ssaoTemporalShader, ssaoUpsampleShader;
+        GLuint ssaoDepthTexture;
+        int ssaoDepthMipCount;
+        GLuint ssaoRawTexture;
+        GLuint ssaoHistoryTextures[2];
+        GLuint ssaoTexture;
         GLuint postProcessFBO;
         GLuint postProcessTexture;
-        GLuint ssrShader, ssrFBO, ssrTexture;
+        GLuint ssrShader, ssrHiZShader, ssrTraceShader, ssrTemporalShader;
+        GLuint ssrHiZTexture;
+        int ssrHiZMipCount;
+        GLuint ssrTraceTexture;
+        GLuint ssrHistoryTextures[2];
+        GLuint ssrProbeSSBO;
         GLuint histogramShader;
         GLuint exposureShader;
+        GLuint cubemapPrefilterShader;
         GLuint modelShadowShader;
         GLuint histogramSSBO;
         GLuint exposureSSBO;
@@ -353,6 +380,8 @@ extern "C" {
         char classname[64];
         KeyValue properties[MAX_ENTITY_PROPERTIES];
         int numProperties;
+        EntityClassId classId;
+        BrushComponent comp;
 
         DoorState door_state;
         Vec3 door_start_pos;
@@ -459,11 +488,12 @@ extern "C" {
         bool on_by_default;
         ParticleSystem* system;
         Vec3 pos;
-        Particle particles[MAX_PARTICLES_PER_SYSTEM];
+        // Pooled storage, allocated on first use and sized to the system's
+        // maxParticles. NULL until the emitter simulates on the CPU.
+        Particle* particles;
+        int particleCapacity;
         int activeParticles;
         float timeSinceLastSpawn;
-        GLuint vao;
-        GLuint vbo;
         bool isGrouped;
         char groupName[64];
     } ParticleEmitter;
@@ -486,6 +516,8 @@ extern "C" {
 
         KeyValue properties[MAX_ENTITY_PROPERTIES];
         int numProperties;
+        EntityClassId classId;
+        LogicComponent comp;
 
         bool runtime_active;
         float runtime_float_a;
@@ -515,6 +547,18 @@ extern "C" {
         int numSprites;
         LogicEntity logicEntities[MAX_LOGIC_ENTITIES];
         int numLogicEntities;
+        // Entity indices bucketed by class, rebuilt by Scene_RefreshEntityClasses.
+        // Class c owns order[classStart[c]] up to order[classStart[c + 1]].
+        int brushClassStart[ENTITY_CLASS_COUNT + 1];
+        int brushClassOrder[MAX_BRUSHES];
+        int logicClassStart[ENTITY_CLASS_COUNT + 1];
+        int logicClassOrder[MAX_LOGIC_ENTITIES];
+        // Set by edits that add, remove or change entities, the editor rebuilds
+        // the class lists on its next frame instead of every frame.
+        bool entityClassesDirty;
+        // New value on every Scene_RefreshEntityClasses, unique across scenes,
+        // so renderer caches built from the entity set know when to rebuild.
+        unsigned int entityClassesGeneration;
         VideoPlayer videoPlayers[MAX_VIDEO_PLAYERS];
         int numVideoPlayers;
         ParallaxRoom parallaxRooms[MAX_PARALLAX_ROOMS];
@@ -585,6 +629,23 @@ extern "C" {
     void SceneObject_LoadVertexDirectionalLighting(SceneObject* obj, int index, const char* mapPath);
     void Decal_LoadLightmaps(Decal* decal, const char* map_name_sanitized, int decal_index);
     void Scene_LoadAmbientProbes(Scene* scene);
+    void Scene_GetReflectionProbePath(const Scene* scene, char* out_path, size_t out_size);
+    void Scene_LoadReflectionProbes(Scene* scene);
+    GLuint Brush_CreateReflectionProbeView(GLuint probe_array, int layer, int mip_count);
+    // Interns every classname, parses the typed components and rebuilds the
+    // per-class lists and the IO lookup tables. Call after anything adds,
+    // removes or renames entities.
+    void Scene_RefreshEntityClasses(Scene* scene);
+    void Scene_MarkEntityClassesDirty(Scene* scene);
+    // Re-parses one entity's component after its properties changed. The
+    // class lists are left alone, so the classname must not have changed.
+    void Brush_ParseComponent(Brush* b);
+    void LogicEntity_ParseComponent(LogicEntity* ent);
+    int Scene_GetBrushesOfClass(const Scene* scene, EntityClassId id, const int** indices_out);
+    // Every brush with a non-empty classname, grouped by class.
+    int Scene_GetEntityBrushes(const Scene* scene, const int** indices_out);
+    int Scene_GetLogicEntitiesOfClass(const Scene* scene, EntityClassId id, const int** indices_out);
+    LogicEntity* Scene_FindActiveLogicEntity(Scene* scene, EntityClassId id);
 
 #ifdef __cplusplus
 }
@@ -46,6 +46,7 @@ MATERIALS_API Material g_NodrawMaterial;
 MATERIALS_API bool g_is_editor_mode = false;
 MATERIALS_API bool g_is_thumbnail_mode = false;
 MATERIALS_API bool g_is_unlit_mode = false;
+MATERIALS_API bool g_is_headless_mode = false;
 
 static char* prependTexturePath(const char* filename) {
     if (filename == NULL || filename[0] == '\0') return NULL;
@@ -112,6 +113,9 @@ static GLuint createPlaceholderTexture(unsigned char r, unsigned char g, unsigne
 }
 
 GLuint TextureManager_LoadFromMemory(const void* data, int data_size, bool isSrgb, TextureLoadContext context) {
+    if (g_is_headless_mode) {
+        return 0;
+    }
     if (!data || data_size <= 0) {
         return missingTextureID;
     }
@@ -205,6 +209,9 @@ GLuint TextureManager_LoadFromMemory(const void* data, int data_size, bool isSrg
 }
 
 GLuint loadTexture(const char* path, bool isSrgb, TextureLoadContext context) {
+    if (g_is_headless_mode) {
+        return 0;
+    }
     char* fullPath = prependTexturePath(path);
     if (!fullPath) {
         Console_Printf_Warning("TextureManager WARNING: Failed to load texture '%s'. Using placeholder.\n", path);
@@ -300,6 +307,10 @@ void TextureManager_LoadMaterialTextures(Material* material) {
     if (!material || material->isLoaded) {
         return;
     }
+    if (g_is_headless_mode) {
+        material->isLoaded = true;
+        return;
+    }
 
     TextureLoadContext context = g_is_thumbnail_mode ? TEXTURE_LOAD_CONTEXT_UI_THUMBNAIL : TEXTURE_LOAD_CONTEXT_WORLD;
     if (strlen(material->diffusePath) > 0) material->diffuseMap = loadTexture(material->diffusePath, true, context); else material->diffuseMap = missingTextureID;
@@ -312,6 +323,9 @@ void TextureManager_LoadMaterialTextures(Material* material) {
 }
 
 GLuint loadCubemap(const char* faces[6]) {
+    if (g_is_headless_mode) {
+        return 0;
+    }
     GLuint textureID;
     glGenTextures(1, &textureID);
     glBindTexture(GL_TEXTURE_CUBE_MAP, textureID);
@@ -339,6 +353,9 @@ GLuint loadCubemap(const char* faces[6]) {
 }
 
 GLuint TextureManager_LoadLUT(const char* filename_only) {
+    if (g_is_headless_mode) {
+        return 0;
+    }
     char* fullPath = prependTexturePath(filename_only);
     if (!fullPath) {
         return missingTextureID;
@@ -416,9 +433,11 @@ void TextureManager_Init() {
     memset(materials, 0, sizeof(materials));
     num_materials = 0;
 
-    missingTextureID = createMissingTexture();
-    defaultNormalMapID = createPlaceholderTexture(128, 128, 255);
-    defaultRmaMapID = createDefaultRmaTexture();
+    if (!g_is_headless_mode) {
+        missingTextureID = createMissingTexture();
+        defaultNormalMapID = createPlaceholderTexture(128, 128, 255);
+        defaultRmaMapID = createDefaultRmaTexture();
+    }
 
     strncpy(g_MissingMaterial.name, "___MISSING___", 63);
     g_MissingMaterial.diffuseMap = missingTextureID;
@@ -436,6 +455,10 @@ void TextureManager_Init() {
 }
 
 void TextureManager_Shutdown() {
+    if (g_is_headless_mode) {
+        Console_Printf("Texture Manager Shutdown.\n");
+        return;
+    }
     for (int i = 0; i < num_materials; ++i) {
         if (materials[i].diffuseMap != missingTextureID) glDeleteTextures(1, &materials[i].diffuseMap);
         if (materials[i].normalMap != defaultNormalMapID) glDeleteTextures(1, &materials[i].normalMap);
@@ -71,6 +71,7 @@ extern MATERIALS_API Material g_NodrawMaterial;
 extern MATERIALS_API bool g_is_editor_mode;
 extern MATERIALS_API bool g_is_thumbnail_mode;
 extern MATERIALS_API bool g_is_unlit_mode;
+extern MATERIALS_API bool g_is_headless_mode;
 
 extern MATERIALS_API GLuint missingTextureID;
 extern MATERIALS_API GLuint defaultNormalMapID;
@@ -0,0 +1,346 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 Soft Sprint Studios
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "image_kernels.h"
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define IMG_LANES 8
+typedef __m256 ImgVec;
+#define img_load(p) _mm256_loadu_ps(p)
+#define img_store(p, v) _mm256_storeu_ps((p), (v))
+#define img_set1(f) _mm256_set1_ps(f)
+#define img_zero() _mm256_setzero_ps()
+#define img_add(a, b) _mm256_add_ps((a), (b))
+#define img_sub(a, b) _mm256_sub_ps((a), (b))
+#define img_mul(a, b) _mm256_mul_ps((a), (b))
+#define img_div(a, b) _mm256_div_ps((a), (b))
+#define img_min(a, b) _mm256_min_ps((a), (b))
+#define img_max(a, b) _mm256_max_ps((a), (b))
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define IMG_LANES 4
+typedef __m128 ImgVec;
+#define img_load(p) _mm_loadu_ps(p)
+#define img_store(p, v) _mm_storeu_ps((p), (v))
+#define img_set1(f) _mm_set1_ps(f)
+#define img_zero() _mm_setzero_ps()
+#define img_add(a, b) _mm_add_ps((a), (b))
+#define img_sub(a, b) _mm_sub_ps((a), (b))
+#define img_mul(a, b) _mm_mul_ps((a), (b))
+#define img_div(a, b) _mm_div_ps((a), (b))
+#define img_min(a, b) _mm_min_ps((a), (b))
+#define img_max(a, b) _mm_max_ps((a), (b))
+#else
+#define IMG_LANES 1
+typedef float ImgVec;
+#define img_load(p) (*(p))
+#define img_store(p, v) (*(p) = (v))
+#define img_set1(f) (f)
+#define img_zero() (0.0f)
+#define img_add(a, b) ((a) + (b))
+#define img_sub(a, b) ((a) - (b))
+#define img_mul(a, b) ((a) * (b))
+#define img_div(a, b) ((a) / (b))
+#define img_min(a, b) ((a) < (b) ? (a) : (b))
+#define img_max(a, b) ((a) > (b) ? (a) : (b))
+#endif
+
+static int clampi(int v, int lo, int hi) {
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+void Image_Deinterleave(const float* src, float* const* planes, int channels, int count) {
+    for (int i = 0; i < count; ++i) {
+        for (int c = 0; c < channels; ++c) {
+            planes[c][i] = src[i * channels + c];
+        }
+    }
+}
+
+void Image_Interleave(const float* const* planes, float* dst, int channels, int count) {
+    for (int i = 0; i < count; ++i) {
+        for (int c = 0; c < channels; ++c) {
+            dst[i * channels + c] = planes[c][i];
+        }
+    }
+}
+
+void Image_BuildGaussianKernel(float* kernel, int radius) {
+    float sigma = (float)radius / 2.0f;
+    float sum = 0.0f;
+    for (int i = 0; i <= radius * 2; ++i) {
+        int x = i - radius;
+        kernel[i] = expf(-(float)(x * x) / (2.0f * sigma * sigma));
+        sum += kernel[i];
+    }
+    for (int i = 0; i <= radius * 2; ++i) {
+        kernel[i] /= sum;
+    }
+}
+
+void Image_SeparableBlur(float* plane, int width, int height, const float* kernel, int radius) {
+    if (width <= 0 || height <= 0) return;
+    int taps = radius * 2 + 1;
+    float* temp = (float*)malloc(sizeof(float) * (size_t)width * height);
+    float* row = (float*)malloc(sizeof(float) * (size_t)(width + radius * 2));
+    const float** rows = (const float**)malloc(sizeof(float*) * taps);
+    if (!temp || !row || !rows) {
+        free(temp); free(row); free(rows);
+        return;
+    }
+
+    for (int y = 0; y < height; ++y) {
+        const float* src = plane + (size_t)y * width;
+        float* dst = temp + (size_t)y * width;
+        for (int i = 0; i < radius; ++i) {
+            row[i] = src[0];
+            row[radius + width + i] = src[width - 1];
+        }
+        memcpy(row + radius, src, sizeof(float) * width);
+
+        int x = 0;
+        for (; x + IMG_LANES <= width; x += IMG_LANES) {
+            ImgVec acc = img_zero();
+            for (int k = 0; k < taps; ++k) {
+                acc = img_add(acc, img_mul(img_load(row + x + k), img_set1(kernel[k])));
+            }
+            img_store(dst + x, acc);
+        }
+        for (; x < width; ++x) {
+            float acc = 0.0f;
+            for (int k = 0; k < taps; ++k) {
+                acc += row[x + k] * kernel[k];
+            }
+            dst[x] = acc;
+        }
+    }
+
+    for (int y = 0; y < height; ++y) {
+        for (int k = 0; k < taps; ++k) {
+            rows[k] = temp + (size_t)clampi(y + k - radius, 0, height - 1) * width;
+        }
+        float* dst = plane + (size_t)y * width;
+
+        int x = 0;
+        for (; x + IMG_LANES <= width; x += IMG_LANES) {
+            ImgVec acc = img_zero();
+            for (int k = 0; k < taps; ++k) {
+                acc = img_add(acc, img_mul(img_load(rows[k] + x), img_set1(kernel[k])));
+            }
+            img_store(dst + x, acc);
+        }
+        for (; x < width; ++x) {
+            float acc = 0.0f;
+            for (int k = 0; k < taps; ++k) {
+                acc += rows[k][x] * kernel[k];
+            }
+            dst[x] = acc;
+        }
+    }
+
+    free(rows);
+    free(row);
+    free(temp);
+}
+
+void Image_BoxBlur(float* out, const float* in, int width, int height, int radius) {
+    if (width <= 0 || height <= 0) return;
+    float* temp = (float*)malloc(sizeof(float) * (size_t)width * height);
+    float* sums = (float*)malloc(sizeof(float) * (size_t)width);
+    if (!temp || !sums) {
+        free(temp); free(sums);
+        return;
+    }
+    float scale = 1.0f / (2 * radius + 1);
+
+    // Horizontal running sums are inherently serial, so this pass stays scalar.
+    for (int y = 0; y < height; ++y) {
+        const float* src = in + (size_t)y * width;
+        float* dst = temp + (size_t)y * width;
+        float sum = 0.0f;
+        for (int x = -radius; x <= radius; ++x) {
+            sum += src[clampi(x, 0, width - 1)];
+        }
+        for (int x = 0; x < width; ++x) {
+            dst[x] = sum * scale;
+            sum += src[clampi(x + radius + 1, 0, width - 1)] - src[clampi(x - radius, 0, width - 1)];
+        }
+    }
+
+    // The vertical pass keeps one running sum per column and walks rows, so
+    // every step is a contiguous, vectorizable row operation.
+    memset(sums, 0, sizeof(float) * width);
+    for (int k = -radius; k <= radius; ++k) {
+        const float* src = temp + (size_t)clampi(k, 0, height - 1) * width;
+        int x = 0;
+        for (; x + IMG_LANES <= width; x += IMG_LANES) {
+            img_store(sums + x, img_add(img_load(sums + x), img_load(src + x)));
+        }
+        for (; x < width; ++x) {
+            sums[x] += src[x];
+        }
+    }
+
+    ImgVec vscale = img_set1(scale);
+    for (int y = 0; y < height; ++y) {
+        const float* next = temp + (size_t)clampi(y + radius + 1, 0, height - 1) * width;
+        const float* prev = temp + (size_t)clampi(y - radius, 0, height - 1) * width;
+        float* dst = out + (size_t)y * width;
+        int x = 0;
+        for (; x + IMG_LANES <= width; x += IMG_LANES) {
+            ImgVec s = img_load(sums + x);
+            img_store(dst + x, img_mul(s, vscale));
+            img_store(sums + x, img_add(s, img_sub(img_load(next + x), img_load(prev + x))));
+        }
+        for (; x < width; ++x) {
+            dst[x] = sums[x] * scale;
+            sums[x] += next[x] - prev[x];
+        }
+    }
+
+    free(sums);
+    free(temp);
+}
+
+static void dilate_accumulate(float* acc, float* weight, const float* plane, const float* mask, int width, int dx) {
+    int x0 = dx < 0 ? 1 : 0;
+    int x1 = dx > 0 ? width - 1 : width;
+    int x = x0;
+    for (; x + IMG_LANES <= x1; x += IMG_LANES) {
+        ImgVec m = img_load(mask + x + dx);
+        img_store(acc + x, img_add(img_load(acc + x), img_mul(img_load(plane + x + dx), m)));
+        if (weight) img_store(weight + x, img_add(img_load(weight + x), m));
+    }
+    for (; x < x1; ++x) {
+        acc[x] += plane[x + dx] * mask[x + dx];
+        if (weight) weight[x] += mask[x + dx];
+    }
+}
+
+void Image_Dilate(float* const* planes, int num_planes, unsigned char* mask, int width, int height, int iterations) {
+    if (width <= 0 || height <= 0 || num_planes <= 0) return;
+    size_t count = (size_t)width * height;
+    float* fmask = (float*)malloc(sizeof(float) * count);
+    float* src = (float*)malloc(sizeof(float) * count * num_planes);
+    float* acc = (float*)malloc(sizeof(float) * width);
+    float* weight = (float*)malloc(sizeof(float) * width);
+    if (!fmask || !src || !acc || !weight) {
+        free(fmask); free(src); free(acc); free(weight);
+        return;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        fmask[i] = mask[i] ? 1.0f : 0.0f;
+    }
+
+    ImgVec one = img_set1(1.0f);
+    for (int it = 0; it < iterations; ++it) {
+        for (int p = 0; p < num_planes; ++p) {
+            memcpy(src + count * p, planes[p], sizeof(float) * count);
+        }
+
+        for (int y = 0; y < height; ++y) {
+            size_t row_offset = (size_t)y * width;
+            for (int p = 0; p < num_planes; ++p) {
+                const float* plane = src + count * p;
+                bool first = p == 0;
+                memset(acc, 0, sizeof(float) * width);
+                if (first) memset(weight, 0, sizeof(float) * width);
+                for (int dy = -1; dy <= 1; ++dy) {
+                    int ny = y + dy;
+                    if (ny < 0 || ny >= height) continue;
+                    const float* nplane = plane + (size_t)ny * width;
+                    const float* nmask = fmask + (size_t)ny * width;
+                    for (int dx = -1; dx <= 1; ++dx) {
+                        if (dx == 0 && dy == 0) continue;
+                        dilate_accumulate(acc, first ? weight : NULL, nplane, nmask, width, dx);
+                    }
+                }
+
+                // out = m * v + (1 - m) * (has ? acc / weight : v), written branch-free
+                // so it vectorizes; m and has are always exactly 0 or 1.
+                const float* m_row = fmask + row_offset;
+                const float* v_row = plane + row_offset;
+                float* dst = planes[p] + row_offset;
+                int x = 0;
+                for (; x + IMG_LANES <= width; x += IMG_LANES) {
+                    ImgVec m = img_load(m_row + x);
+                    ImgVec v = img_load(v_row + x);
+                    ImgVec w = img_load(weight + x);
+                    ImgVec has = img_min(w, one);
+                    ImgVec avg = img_div(img_load(acc + x), img_max(w, one));
+                    ImgVec fill = img_add(img_mul(has, avg), img_mul(img_sub(one, has), v));
+                    img_store(dst + x, img_add(img_mul(m, v), img_mul(img_sub(one, m), fill)));
+                }
+                for (; x < width; ++x) {
+                    if (m_row[x] == 0.0f && weight[x] > 0.0f) {
+                        dst[x] = acc[x] / weight[x];
+                    }
+                    else {
+                        dst[x] = v_row[x];
+                    }
+                }
+            }
+
+            // Neighbours are read from fmask, so the byte mask can grow right away.
+            for (int x = 0; x < width; ++x) {
+                if (weight[x] > 0.0f) mask[row_offset + x] = 1;
+            }
+        }
+
+        for (size_t i = 0; i < count; ++i) {
+            fmask[i] = mask[i] ? 1.0f : 0.0f;
+        }
+    }
+
+    free(weight);
+    free(acc);
+    free(src);
+    free(fmask);
+}
+
+void Image_PadEdges(void* dst, const void* src, int width, int height, int pad, size_t texel_size) {
+    int padded_width = width + pad * 2;
+    size_t src_pitch = (size_t)width * texel_size;
+    size_t dst_pitch = (size_t)padded_width * texel_size;
+    unsigned char* out = (unsigned char*)dst;
+    const unsigned char* in = (const unsigned char*)src;
+
+    for (int y = 0; y < height; ++y) {
+        unsigned char* dst_row = out + (size_t)(y + pad) * dst_pitch;
+        const unsigned char* src_row = in + (size_t)y * src_pitch;
+        for (int x = 0; x < pad; ++x) {
+            memcpy(dst_row + (size_t)x * texel_size, src_row, texel_size);
+            memcpy(dst_row + (size_t)(pad + width + x) * texel_size, src_row + (size_t)(width - 1) * texel_size, texel_size);
+        }
+        memcpy(dst_row + (size_t)pad * texel_size, src_row, src_pitch);
+    }
+    for (int y = 0; y < pad; ++y) {
+        memcpy(out + (size_t)y * dst_pitch, out + (size_t)pad * dst_pitch, dst_pitch);
+        memcpy(out + (size_t)(pad + height + y) * dst_pitch, out + (size_t)(pad + height - 1) * dst_pitch, dst_pitch);
+    }
+}
@@ -0,0 +1,60 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 Soft Sprint Studios
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+#ifndef IMAGE_KERNELS_H
+#define IMAGE_KERNELS_H
+
+//----------------------------------------//
+// Brief: Vectorized filters for planar float images
+//----------------------------------------//
+
+#include <stddef.h>
+#include "math_api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+	// Splits an interleaved image into one plane per channel, and back.
+	MATH_API void Image_Deinterleave(const float* src, float* const* planes, int channels, int count);
+	MATH_API void Image_Interleave(const float* const* planes, float* dst, int channels, int count);
+
+	// Fills kernel[0 .. 2 * radius] with normalized gaussian weights (sigma = radius / 2).
+	MATH_API void Image_BuildGaussianKernel(float* kernel, int radius);
+	// Separable convolution in place with clamp-to-edge sampling.
+	MATH_API void Image_SeparableBlur(float* plane, int width, int height, const float* kernel, int radius);
+	// Box filter with clamp-to-edge sampling. out and in must not alias.
+	MATH_API void Image_BoxBlur(float* out, const float* in, int width, int height, int radius);
+	// Grows covered texels (mask != 0) into uncovered neighbours by averaging the covered
+	// 8-neighbourhood, once per iteration. All planes share the mask, which is updated in place.
+	MATH_API void Image_Dilate(float* const* planes, int num_planes, unsigned char* mask, int width, int height, int iterations);
+	// Copies src into the centre of dst and repeats the edge texels into a border of pad texels.
+	// Works on any interleaved format, dst is (width + 2 * pad) x (height + 2 * pad).
+	MATH_API void Image_PadEdges(void* dst, const void* src, int width, int height, int pad, size_t texel_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // IMAGE_KERNELS_H
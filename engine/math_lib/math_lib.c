@@ -446,6 +446,53 @@ Mat4 create_trs_matrix(Vec3 pos, Vec3 rot_deg, Vec3 scale) {
     return model_mat;
 }
 
+Vec4 mat4_to_quat(const Mat4* m) {
+    float r00 = m->m[0], r10 = m->m[1], r20 = m->m[2];
+    float r01 = m->m[4], r11 = m->m[5], r21 = m->m[6];
+    float r02 = m->m[8], r12 = m->m[9], r22 = m->m[10];
+    float trace = r00 + r11 + r22;
+    Vec4 q;
+    if (trace > 0.0f) {
+        float s = sqrtf(trace + 1.0f) * 2.0f;
+        q = (Vec4){ (r21 - r12) / s, (r02 - r20) / s, (r10 - r01) / s, 0.25f * s };
+    }
+    else if (r00 > r11 && r00 > r22) {
+        float s = sqrtf(1.0f + r00 - r11 - r22) * 2.0f;
+        q = (Vec4){ 0.25f * s, (r01 + r10) / s, (r02 + r20) / s, (r21 - r12) / s };
+    }
+    else if (r11 > r22) {
+        float s = sqrtf(1.0f + r11 - r00 - r22) * 2.0f;
+        q = (Vec4){ (r01 + r10) / s, 0.25f * s, (r12 + r21) / s, (r02 - r20) / s };
+    }
+    else {
+        float s = sqrtf(1.0f + r22 - r00 - r11) * 2.0f;
+        q = (Vec4){ (r02 + r20) / s, (r12 + r21) / s, 0.25f * s, (r10 - r01) / s };
+    }
+    return q;
+}
+
+Mat4 mat4_interpolate_transform(const Mat4* a, const Mat4* b, float t) {
+    Vec3 scale_a = { vec3_length((Vec3) { a->m[0], a->m[1], a->m[2] }), vec3_length((Vec3) { a->m[4], a->m[5], a->m[6] }), vec3_length((Vec3) { a->m[8], a->m[9], a->m[10] }) };
+    Vec3 scale_b = { vec3_length((Vec3) { b->m[0], b->m[1], b->m[2] }), vec3_length((Vec3) { b->m[4], b->m[5], b->m[6] }), vec3_length((Vec3) { b->m[8], b->m[9], b->m[10] }) };
+    if (scale_a.x < 1e-6f || scale_a.y < 1e-6f || scale_a.z < 1e-6f || scale_b.x < 1e-6f || scale_b.y < 1e-6f || scale_b.z < 1e-6f) {
+        return t < 0.5f ? *a : *b;
+    }
+
+    Mat4 rot_a = *a, rot_b = *b;
+    for (int i = 0; i < 3; ++i) {
+        rot_a.m[i] /= scale_a.x; rot_a.m[4 + i] /= scale_a.y; rot_a.m[8 + i] /= scale_a.z;
+        rot_b.m[i] /= scale_b.x; rot_b.m[4 + i] /= scale_b.y; rot_b.m[8 + i] /= scale_b.z;
+    }
+
+    Vec3 translation = vec3_lerp((Vec3) { a->m[12], a->m[13], a->m[14] }, (Vec3) { b->m[12], b->m[13], b->m[14] }, t);
+    Vec3 scale = vec3_lerp(scale_a, scale_b, t);
+    Vec4 rotation = quat_slerp(mat4_to_quat(&rot_a), mat4_to_quat(&rot_b), t);
+
+    Mat4 result;
+    mat4_compose(&result, translation, rotation, scale);
+    return result;
+}
+
 void mat4_decompose(const Mat4* matrix, Vec3* translation, Vec3* rotation, Vec3* scale) {
     translation->x = matrix->m[12];
     translation->y = matrix->m[13];
@@ -74,6 +74,8 @@ extern "C" {
 	MATH_API Vec3 mat4_mul_vec3_dir(const Mat4* m, Vec3 v);
 	MATH_API Vec4 mat4_mul_vec4(const Mat4* m, Vec4 v);
 	MATH_API void mat4_compose(Mat4* result, Vec3 translation, Vec4 rotation, Vec3 scale);
+	MATH_API Vec4 mat4_to_quat(const Mat4* m);
+	MATH_API Mat4 mat4_interpolate_transform(const Mat4* a, const Mat4* b, float t);
 	MATH_API void mat4_decompose(const Mat4* matrix, Vec3* translation, Vec3* rotation, Vec3* scale);
 	MATH_API Mat4 create_trs_matrix(Vec3 pos, Vec3 rot_deg, Vec3 scale);
 	MATH_API bool RayIntersectsOBB(Vec3 rayOrigin, Vec3 rayDir, const Mat4* modelMatrix, Vec3 localAABBMin, Vec3 localAABBMax, float* t);
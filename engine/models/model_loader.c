@@ -108,36 +108,38 @@ static void create_error_model() {
     errorMesh->indexData = malloc(sizeof(indices));
     memcpy(errorMesh->indexData, indices, sizeof(indices));
 
-    glGenVertexArrays(1, &errorMesh->VAO);
-    glGenBuffers(1, &errorMesh->VBO);
-    glGenBuffers(1, &errorMesh->EBO);
-
-    glBindVertexArray(errorMesh->VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, errorMesh->VBO);
-    glBufferData(GL_ARRAY_BUFFER, errorMesh->final_vbo_data_size, errorMesh->final_vbo_data, GL_STATIC_DRAW);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, errorMesh->EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), errorMesh->indexData, GL_STATIC_DRAW);
-
-    size_t offset = 0;
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, MODEL_VERTEX_STRIDE_FLOATS * sizeof(float), (void*)offset);
-    glEnableVertexAttribArray(0);
-    offset += 3 * sizeof(float);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, MODEL_VERTEX_STRIDE_FLOATS * sizeof(float), (void*)offset);
-    glEnableVertexAttribArray(1);
-    offset += 3 * sizeof(float);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, MODEL_VERTEX_STRIDE_FLOATS * sizeof(float), (void*)offset);
-    glEnableVertexAttribArray(2);
-    offset += 2 * sizeof(float);
-    glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, MODEL_VERTEX_STRIDE_FLOATS * sizeof(float), (void*)offset);
-    glEnableVertexAttribArray(3);
-    offset += 4 * sizeof(float);
-    glVertexAttribPointer(4, 4, GL_FLOAT, GL_FALSE, MODEL_VERTEX_STRIDE_FLOATS * sizeof(float), (void*)offset);
-    glEnableVertexAttribArray(4);
-    offset += 4 * sizeof(float);
-    glVertexAttribPointer(9, 4, GL_FLOAT, GL_FALSE, MODEL_VERTEX_STRIDE_FLOATS * sizeof(float), (void*)offset);
-    glEnableVertexAttribArray(9);
-
-    glBindVertexArray(0);
+    if (!g_is_headless_mode) {
+        glGenVertexArrays(1, &errorMesh->VAO);
+        glGenBuffers(1, &errorMesh->VBO);
+        glGenBuffers(1, &errorMesh->EBO);
+
+        glBindVertexArray(errorMesh->VAO);
+        glBindBuffer(GL_ARRAY_BUFFER, errorMesh->VBO);
+        glBufferData(GL_ARRAY_BUFFER, errorMesh->final_vbo_data_size, errorMesh->final_vbo_data, GL_STATIC_DRAW);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, errorMesh->EBO);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), errorMesh->indexData, GL_STATIC_DRAW);
+
+        size_t offset = 0;
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, MODEL_VERTEX_STRIDE_FLOATS * sizeof(float), (void*)offset);
+        glEnableVertexAttribArray(0);
+        offset += 3 * sizeof(float);
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, MODEL_VERTEX_STRIDE_FLOATS * sizeof(float), (void*)offset);
+        glEnableVertexAttribArray(1);
+        offset += 3 * sizeof(float);
+        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, MODEL_VERTEX_STRIDE_FLOATS * sizeof(float), (void*)offset);
+        glEnableVertexAttribArray(2);
+        offset += 2 * sizeof(float);
+        glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, MODEL_VERTEX_STRIDE_FLOATS * sizeof(float), (void*)offset);
+        glEnableVertexAttribArray(3);
+        offset += 4 * sizeof(float);
+        glVertexAttribPointer(4, 4, GL_FLOAT, GL_FALSE, MODEL_VERTEX_STRIDE_FLOATS * sizeof(float), (void*)offset);
+        glEnableVertexAttribArray(4);
+        offset += 4 * sizeof(float);
+        glVertexAttribPointer(9, 4, GL_FLOAT, GL_FALSE, MODEL_VERTEX_STRIDE_FLOATS * sizeof(float), (void*)offset);
+        glEnableVertexAttribArray(9);
+
+        glBindVertexArray(0);
+    }
 
     g_ErrorModel->aabb_min = (Vec3){ -size, -size, -size };
     g_ErrorModel->aabb_max = (Vec3){ size, size, size };
@@ -189,6 +191,57 @@ static void Model_CombineMeshData(LoadedModel* model) {
     }
 }
 
+static void Model_UploadMesh(Mesh* newMesh, const SkinningVertexData* skinning_data, unsigned int vertexCount) {
+    glGenVertexArrays(1, &newMesh->VAO);
+    glGenBuffers(1, &newMesh->VBO);
+    if (skinning_data) {
+        glGenBuffers(1, &newMesh->skinningVBO);
+    }
+    if (newMesh->useEBO) {
+        glGenBuffers(1, &newMesh->EBO);
+    }
+
+    glBindVertexArray(newMesh->VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, newMesh->VBO);
+    glBufferData(GL_ARRAY_BUFFER, newMesh->final_vbo_data_size, newMesh->final_vbo_data, GL_DYNAMIC_DRAW);
+    if (skinning_data) {
+        glBindBuffer(GL_ARRAY_BUFFER, newMesh->skinningVBO);
+        glBufferData(GL_ARRAY_BUFFER, vertexCount * sizeof(SkinningVertexData), skinning_data, GL_STATIC_DRAW);
+    }
+
+    if (newMesh->useEBO) {
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, newMesh->EBO);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, newMesh->indexCount * sizeof(unsigned int), newMesh->indexData, GL_STATIC_DRAW);
+    }
+
+    size_t offset = 0;
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, MODEL_VERTEX_STRIDE_FLOATS * sizeof(float), (void*)offset);
+    glEnableVertexAttribArray(0);
+    offset += 3 * sizeof(float);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, MODEL_VERTEX_STRIDE_FLOATS * sizeof(float), (void*)offset);
+    glEnableVertexAttribArray(1);
+    offset += 3 * sizeof(float);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, MODEL_VERTEX_STRIDE_FLOATS * sizeof(float), (void*)offset);
+    glEnableVertexAttribArray(2);
+    offset += 2 * sizeof(float);
+    glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, MODEL_VERTEX_STRIDE_FLOATS * sizeof(float), (void*)offset);
+    glEnableVertexAttribArray(3);
+    offset += 4 * sizeof(float);
+    glVertexAttribPointer(4, 4, GL_FLOAT, GL_FALSE, MODEL_VERTEX_STRIDE_FLOATS * sizeof(float), (void*)offset);
+    glEnableVertexAttribArray(4);
+    offset += 4 * sizeof(float);
+    glVertexAttribPointer(9, 4, GL_FLOAT, GL_FALSE, MODEL_VERTEX_STRIDE_FLOATS * sizeof(float), (void*)offset);
+    glEnableVertexAttribArray(9);
+    if (skinning_data) {
+        glBindBuffer(GL_ARRAY_BUFFER, newMesh->skinningVBO);
+        glEnableVertexAttribArray(10);
+        glVertexAttribIPointer(10, 4, GL_INT, sizeof(SkinningVertexData), (void*)offsetof(SkinningVertexData, bone_indices));
+        glEnableVertexAttribArray(11);
+        glVertexAttribPointer(11, 4, GL_FLOAT, GL_FALSE, sizeof(SkinningVertexData), (void*)offsetof(SkinningVertexData, bone_weights));
+    }
+    glBindVertexArray(0);
+}
+
 LoadedModel* Model_Load(const char* path) {
     if (!g_ErrorModel) {
         create_error_model();
@@ -465,61 +518,16 @@ LoadedModel* Model_Load(const char* path) {
                 continue;
             }
 
-            glGenVertexArrays(1, &newMesh->VAO);
-            glGenBuffers(1, &newMesh->VBO);
-            if (skinning_data) {
-                glGenBuffers(1, &newMesh->skinningVBO);
-            }
-            if (newMesh->useEBO) {
-                glGenBuffers(1, &newMesh->EBO);
-            }
-
-            glBindVertexArray(newMesh->VAO);
-            glBindBuffer(GL_ARRAY_BUFFER, newMesh->VBO);
-            glBufferData(GL_ARRAY_BUFFER, newMesh->final_vbo_data_size, newMesh->final_vbo_data, GL_DYNAMIC_DRAW);
-            if (skinning_data) {
-                glBindBuffer(GL_ARRAY_BUFFER, newMesh->skinningVBO);
-                glBufferData(GL_ARRAY_BUFFER, vertexCount * sizeof(SkinningVertexData), skinning_data, GL_STATIC_DRAW);
-            }
-
-            if (newMesh->useEBO) {
-                glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, newMesh->EBO);
-                glBufferData(GL_ELEMENT_ARRAY_BUFFER, newMesh->indexCount * sizeof(unsigned int), newMesh->indexData, GL_STATIC_DRAW);
-            }
-
-            size_t offset = 0;
-            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, MODEL_VERTEX_STRIDE_FLOATS * sizeof(float), (void*)offset);
-            glEnableVertexAttribArray(0);
-            offset += 3 * sizeof(float);
-            glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, MODEL_VERTEX_STRIDE_FLOATS * sizeof(float), (void*)offset);
-            glEnableVertexAttribArray(1);
-            offset += 3 * sizeof(float);
-            glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, MODEL_VERTEX_STRIDE_FLOATS * sizeof(float), (void*)offset);
-            glEnableVertexAttribArray(2);
-            offset += 2 * sizeof(float);
-            glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, MODEL_VERTEX_STRIDE_FLOATS * sizeof(float), (void*)offset);
-            glEnableVertexAttribArray(3);
-            offset += 4 * sizeof(float);
-            glVertexAttribPointer(4, 4, GL_FLOAT, GL_FALSE, MODEL_VERTEX_STRIDE_FLOATS * sizeof(float), (void*)offset);
-            glEnableVertexAttribArray(4);
-            offset += 4 * sizeof(float);
-            glVertexAttribPointer(9, 4, GL_FLOAT, GL_FALSE, MODEL_VERTEX_STRIDE_FLOATS * sizeof(float), (void*)offset);
-            glEnableVertexAttribArray(9);
-            if (skinning_data) {
-                glBindBuffer(GL_ARRAY_BUFFER, newMesh->skinningVBO);
-                glEnableVertexAttribArray(10);
-                glVertexAttribIPointer(10, 4, GL_INT, sizeof(SkinningVertexData), (void*)offsetof(SkinningVertexData, bone_indices));
-                glEnableVertexAttribArray(11);
-                glVertexAttribPointer(11, 4, GL_FLOAT, GL_FALSE, sizeof(SkinningVertexData), (void*)offsetof(SkinningVertexData, bone_weights));
-                free(skinning_data);
+            if (!g_is_headless_mode) {
+                Model_UploadMesh(newMesh, skinning_data, vertexCount);
             }
+            free(skinning_data);
 
             currentMeshIndex++;
         }
     }
     loadedModel->meshCount = currentMeshIndex;
     Model_CombineMeshData(loadedModel);
-    glBindVertexArray(0);
     cgltf_free(data);
     return loadedModel;
 }
@@ -547,8 +555,12 @@ void Model_Free(LoadedModel* model) {
         free(model->skins);
     }
     for (int i = 0; i < model->meshCount; ++i) {
-        glDeleteVertexArrays(1, &model->meshes[i].VAO);
-        glDeleteBuffers(1, &model->meshes[i].VBO);
+        if (model->meshes[i].VAO) {
+            glDeleteVertexArrays(1, &model->meshes[i].VAO);
+        }
+        if (model->meshes[i].VBO) {
+            glDeleteBuffers(1, &model->meshes[i].VBO);
+        }
         if (model->meshes[i].skinningVBO) {
             glDeleteBuffers(1, &model->meshes[i].skinningVBO);
         }
@@ -564,7 +576,7 @@ void Model_Free(LoadedModel* model) {
                 free(model->meshes[i].material);
             }
         }
-        if (model->meshes[i].useEBO) {
+        if (model->meshes[i].EBO) {
             glDeleteBuffers(1, &model->meshes[i].EBO);
         }
         free(model->meshes[i].indexData);
@@ -580,12 +592,16 @@ void Model_Free(LoadedModel* model) {
 void ModelLoader_Shutdown() {
     if (g_ErrorModel) {
         for (int i = 0; i < g_ErrorModel->meshCount; ++i) {
-            glDeleteVertexArrays(1, &g_ErrorModel->meshes[i].VAO);
-            glDeleteBuffers(1, &g_ErrorModel->meshes[i].VBO);
+            if (g_ErrorModel->meshes[i].VAO) {
+                glDeleteVertexArrays(1, &g_ErrorModel->meshes[i].VAO);
+            }
+            if (g_ErrorModel->meshes[i].VBO) {
+                glDeleteBuffers(1, &g_ErrorModel->meshes[i].VBO);
+            }
             if (g_ErrorModel->meshes[i].skinningVBO) {
                 glDeleteBuffers(1, &g_ErrorModel->meshes[i].skinningVBO);
             }
-            if (g_ErrorModel->meshes[i].useEBO) {
+            if (g_ErrorModel->meshes[i].EBO) {
                 glDeleteBuffers(1, &g_ErrorModel->meshes[i].EBO);
             }
             free(g_ErrorModel->meshes[i].indexData);
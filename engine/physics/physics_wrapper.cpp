@@ -91,7 +91,8 @@ extern "C" {
     void Physics_StepSimulation(PhysicsWorldHandle handle, float deltaTime) {
         if (!handle) return;
         PhysicsWorld* world = (PhysicsWorld*)handle;
-        world->dynamicsWorld->stepSimulation(deltaTime, 10, 1.0f / 60.0f);
+        // The engine already calls this at a fixed tick rate, so step exactly once.
+        world->dynamicsWorld->stepSimulation(deltaTime, 0);
     }
 
     RigidBodyHandle Physics_CreatePlayerCapsule(PhysicsWorldHandle handle, float radius, float totalHeight, float mass, Vec3 startPos) {
@@ -375,6 +376,19 @@ extern "C" {
         return Vec3{ vel.x(), vel.y(), vel.z() };
     }
 
+    Vec3 Physics_GetAngularVelocity(RigidBodyHandle bodyHandle) {
+        if (!bodyHandle) return Vec3{ 0,0,0 };
+        RigidBody* rb = (RigidBody*)bodyHandle;
+        btVector3 vel = rb->body->getAngularVelocity();
+        return Vec3{ vel.x(), vel.y(), vel.z() };
+    }
+
+    void Physics_SetAngularVelocity(RigidBodyHandle bodyHandle, Vec3 velocity) {
+        if (!bodyHandle) return;
+        RigidBody* rb = (RigidBody*)bodyHandle;
+        rb->body->setAngularVelocity(btVector3(velocity.x, velocity.y, velocity.z));
+    }
+
     void Physics_SetGravityEnabled(RigidBodyHandle bodyHandle, bool enabled) {
         if (!bodyHandle) return;
         RigidBody* rb = (RigidBody*)bodyHandle;
@@ -475,34 +489,21 @@ extern "C" {
         }
     }
 
-    void Physics_ApplyBuoyancyInVolume(PhysicsWorldHandle handle, const float* vertices, int numVertices, const Mat4* transform) {
-        if (!handle || !vertices || numVertices == 0) return;
-        PhysicsWorld* world = (PhysicsWorld*)handle;
-        btDynamicsWorld* dynamicsWorld = world->dynamicsWorld;
-        btVector3 gravity = dynamicsWorld->getGravity();
-
-        btTransform brushTransform;
-        brushTransform.setFromOpenGLMatrix(transform->m);
-
-        btVector3 brush_min(FLT_MAX, FLT_MAX, FLT_MAX);
-        btVector3 brush_max(-FLT_MAX, -FLT_MAX, -FLT_MAX);
-        for (int v_idx = 0; v_idx < numVertices; ++v_idx) {
-            btVector3 local_v(vertices[v_idx * 7 + 0], vertices[v_idx * 7 + 1], vertices[v_idx * 7 + 2]);
-            btVector3 world_v = brushTransform * local_v;
-            brush_min.setMin(world_v);
-            brush_max.setMax(world_v);
-        }
+    struct BuoyancyCallback : public btBroadphaseAabbCallback {
+        btVector3 volumeMin;
+        btVector3 volumeMax;
+        btVector3 gravity;
 
-        for (int i = 0; i < dynamicsWorld->getNumCollisionObjects(); ++i) {
-            btCollisionObject* obj = dynamicsWorld->getCollisionObjectArray()[i];
+        virtual bool process(const btBroadphaseProxy* proxy) {
+            btCollisionObject* obj = (btCollisionObject*)proxy->m_clientObject;
             btRigidBody* body = btRigidBody::upcast(obj);
 
             if (body && body->getMass() > 0.0f) {
                 btVector3 bodyPos = body->getWorldTransform().getOrigin();
 
-                if (bodyPos.x() > brush_min.x() && bodyPos.x() < brush_max.x() &&
-                    bodyPos.y() > brush_min.y() && bodyPos.y() < brush_max.y() &&
-                    bodyPos.z() > brush_min.z() && bodyPos.z() < brush_max.z())
+                if (bodyPos.x() > volumeMin.x() && bodyPos.x() < volumeMax.x() &&
+                    bodyPos.y() > volumeMin.y() && bodyPos.y() < volumeMax.y() &&
+                    bodyPos.z() > volumeMin.z() && bodyPos.z() < volumeMax.z())
                 {
                     float buoyancyMultiplier = 1.5f;
                     btVector3 buoyancyForce = -gravity * body->getMass() * buoyancyMultiplier;
@@ -517,7 +518,39 @@ extern "C" {
                     body->applyTorque(angularDrag);
                 }
             }
+            return true;
         }
+    };
+
+    void Physics_ApplyBuoyancyInAABB(PhysicsWorldHandle handle, Vec3 volumeMin, Vec3 volumeMax) {
+        if (!handle) return;
+        PhysicsWorld* world = (PhysicsWorld*)handle;
+
+        // Only bodies whose broadphase proxy overlaps the volume are visited,
+        // instead of every collision object in the world.
+        BuoyancyCallback callback;
+        callback.volumeMin = btVector3(volumeMin.x, volumeMin.y, volumeMin.z);
+        callback.volumeMax = btVector3(volumeMax.x, volumeMax.y, volumeMax.z);
+        callback.gravity = world->dynamicsWorld->getGravity();
+        world->overlappingPairCache->aabbTest(callback.volumeMin, callback.volumeMax, callback);
+    }
+
+    void Physics_ApplyBuoyancyInVolume(PhysicsWorldHandle handle, const float* vertices, int numVertices, const Mat4* transform) {
+        if (!handle || !vertices || numVertices == 0) return;
+
+        btTransform brushTransform;
+        brushTransform.setFromOpenGLMatrix(transform->m);
+
+        btVector3 brush_min(FLT_MAX, FLT_MAX, FLT_MAX);
+        btVector3 brush_max(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+        for (int v_idx = 0; v_idx < numVertices; ++v_idx) {
+            btVector3 local_v(vertices[v_idx * 7 + 0], vertices[v_idx * 7 + 1], vertices[v_idx * 7 + 2]);
+            btVector3 world_v = brushTransform * local_v;
+            brush_min.setMin(world_v);
+            brush_max.setMax(world_v);
+        }
+
+        Physics_ApplyBuoyancyInAABB(handle, Vec3{ brush_min.x(), brush_min.y(), brush_min.z() }, Vec3{ brush_max.x(), brush_max.y(), brush_max.z() });
     }
 
     void Physics_SetDeactivationEnabled(PhysicsWorldHandle handle, bool enabled) {
@@ -74,6 +74,8 @@ extern "C" {
 	PHYSICS_API void Physics_ApplyCentralImpulse(RigidBodyHandle body, Vec3 impulse);
 	PHYSICS_API void Physics_Activate(RigidBodyHandle body);
 	PHYSICS_API Vec3 Physics_GetLinearVelocity(RigidBodyHandle body);
+	PHYSICS_API Vec3 Physics_GetAngularVelocity(RigidBodyHandle body);
+	PHYSICS_API void Physics_SetAngularVelocity(RigidBodyHandle body, Vec3 velocity);
 	PHYSICS_API void Physics_SetGravityEnabled(RigidBodyHandle body, bool enabled);
 	PHYSICS_API void Physics_ToggleCollision(PhysicsWorldHandle world, RigidBodyHandle body, bool enabled);
 	PHYSICS_API void Physics_Teleport(RigidBodyHandle body, Vec3 position);
@@ -82,6 +84,7 @@ extern "C" {
 	PHYSICS_API bool Physics_Raycast(PhysicsWorldHandle world, Vec3 start, Vec3 end, RaycastHitInfo* hitInfo);
 	PHYSICS_API void Physics_ApplyImpulse(RigidBodyHandle bodyHandle, Vec3 impulse, Vec3 rel_pos);
 	PHYSICS_API void Physics_ApplyBuoyancyInVolume(PhysicsWorldHandle handle, const float* vertices, int numVertices, const Mat4* transform);
+	PHYSICS_API void Physics_ApplyBuoyancyInAABB(PhysicsWorldHandle handle, Vec3 volumeMin, Vec3 volumeMax);
 	PHYSICS_API void Physics_SetDeactivationEnabled(PhysicsWorldHandle handle, bool enabled);
 	PHYSICS_API bool Physics_CheckGroundContact(PhysicsWorldHandle handle, RigidBodyHandle bodyHandle, float groundCheckDistance);
 	PHYSICS_API float Physics_GetTotalMassOnObject(PhysicsWorldHandle handle, RigidBodyHandle bodyHandle);
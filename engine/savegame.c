@@ -0,0 +1,960 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 Soft Sprint Studios
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "savegame.h"
+#include "gl_console.h"
+#include "io_system.h"
+#include "physics_wrapper.h"
+#include <SDL.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SAVEGAME_MAGIC "TSAV"
+#define SAVEGAME_VERSION 1
+
+// A save is the map path plus the runtime state of every entity that differs
+// from the state it had right after the map was loaded. Records are plain
+// structs written as-is, so saves are only portable between identical builds.
+
+typedef struct {
+    char magic[4];
+    int version;
+    char mapPath[256];
+    int numObjects;
+    int numBrushes;
+    int numLights;
+    int numLogicEntities;
+    int numSprites;
+    int numParticleEmitters;
+    int numIOConnections;
+} SaveHeader;
+
+typedef struct {
+    Vec3 cameraPosition;
+    Vec3 bodyPosition;
+    Vec3 velocity;
+    float yaw;
+    float pitch;
+    bool isCrouching;
+    float currentHeight;
+    float health;
+    bool flashlightOn;
+} SavePlayerState;
+
+typedef struct {
+    int index;
+    Vec3 pos, rot, scale;
+    Mat4 modelMatrix;
+    Vec3 linearVelocity;
+    Vec3 angularVelocity;
+    int current_animation;
+    float animation_time;
+    bool animation_playing;
+    bool animation_looping;
+} SaveObjectState;
+
+typedef struct {
+    int index;
+    Vec3 pos, rot, scale;
+    Mat4 modelMatrix;
+    Vec3 linearVelocity;
+    Vec3 angularVelocity;
+    DoorState door_state;
+    Vec3 door_start_pos;
+    Vec3 door_end_pos;
+    Vec3 door_move_dir;
+    Vec3 pendulum_start_pos;
+    Vec3 pendulum_swing_dir;
+    bool runtime_is_visible;
+    bool runtime_was_pressed;
+    bool runtime_playerIsTouching;
+    bool runtime_hasFired;
+    bool runtime_active;
+    float current_angular_velocity;
+    float target_angular_velocity;
+    Vec3 start_pos;
+    Vec3 end_pos;
+    Vec3 move_dir;
+    PlatState plat_state;
+    float wait_timer;
+} SaveBrushState;
+
+typedef struct {
+    int index;
+    bool is_on;
+    float intensity;
+    int preset;
+    float preset_time;
+    int preset_index;
+} SaveLightState;
+
+typedef struct {
+    int index;
+    bool runtime_active;
+    float runtime_float_a;
+    int runtime_int_a;
+    float runtime_float_b;
+} SaveLogicState;
+
+typedef struct {
+    int index;
+    bool visible;
+} SaveSpriteState;
+
+typedef struct {
+    int index;
+    bool is_on;
+} SaveEmitterState;
+
+typedef struct {
+    int index;
+    int numProperties;
+    KeyValue properties[MAX_ENTITY_PROPERTIES];
+} SavePropertyState;
+
+typedef struct {
+    char targetName[64];
+    char inputName[64];
+    char parameter[64];
+    float delay;
+} SaveEventState;
+
+typedef struct SaveSnapshot {
+    char path[256];
+    SaveHeader header;
+    SavePlayerState player;
+    SaveEventState* events; int numEvents;
+    int* firedConnections; int numFiredConnections;
+    SaveObjectState* objects; int numObjects;
+    SaveBrushState* brushes; int numBrushes;
+    SaveLightState* lights; int numLights;
+    SaveLogicState* logic; int numLogic;
+    SaveSpriteState* sprites; int numSprites;
+    SaveEmitterState* emitters; int numEmitters;
+    SavePropertyState* brushProperties; int numBrushProperties;
+    SavePropertyState* logicProperties; int numLogicProperties;
+    bool success;
+    char error[256];
+    struct SaveSnapshot* next;
+} SaveSnapshot;
+
+// Entity properties are kept packed, most entities only have a handful.
+typedef struct {
+    int* offsets;
+    int* counts;
+    KeyValue* pool;
+} SavePropertyBaseline;
+
+typedef struct {
+    bool valid;
+    SaveHeader header;
+    SaveObjectState* objects;
+    SaveBrushState* brushes;
+    SaveLightState* lights;
+    SaveLogicState* logic;
+    SaveSpriteState* sprites;
+    SaveEmitterState* emitters;
+    SavePropertyBaseline brushProperties;
+    SavePropertyBaseline logicProperties;
+} SaveBaseline;
+
+static SaveBaseline g_save_baseline;
+
+static SDL_Thread* g_save_thread = NULL;
+static SDL_mutex* g_save_mutex = NULL;
+static SDL_cond* g_save_cond = NULL;
+static SDL_cond* g_save_idle_cond = NULL;
+static SaveSnapshot* g_save_queue_head = NULL;
+static SaveSnapshot* g_save_queue_tail = NULL;
+static SaveSnapshot* g_save_done = NULL;
+static int g_save_jobs_in_flight = 0;
+static bool g_save_thread_running = false;
+
+static void savegame_capture_object(SaveObjectState* s, int index, const SceneObject* obj) {
+    memset(s, 0, sizeof(*s));
+    s->index = index;
+    s->pos = obj->pos;
+    s->rot = obj->rot;
+    s->scale = obj->scale;
+    s->modelMatrix = obj->modelMatrix;
+    if (obj->physicsBody && obj->mass > 0.0f) {
+        s->linearVelocity = Physics_GetLinearVelocity(obj->physicsBody);
+        s->angularVelocity = Physics_GetAngularVelocity(obj->physicsBody);
+    }
+    s->current_animation = obj->current_animation;
+    s->animation_time = obj->animation_time;
+    s->animation_playing = obj->animation_playing;
+    s->animation_looping = obj->animation_looping;
+}
+
+static void savegame_capture_brush(SaveBrushState* s, int index, const Brush* b) {
+    memset(s, 0, sizeof(*s));
+    s->index = index;
+    s->pos = b->pos;
+    s->rot = b->rot;
+    s->scale = b->scale;
+    s->modelMatrix = b->modelMatrix;
+    if (b->physicsBody && b->mass > 0.0f) {
+        s->linearVelocity = Physics_GetLinearVelocity(b->physicsBody);
+        s->angularVelocity = Physics_GetAngularVelocity(b->physicsBody);
+    }
+    s->door_state = b->door_state;
+    s->door_start_pos = b->door_start_pos;
+    s->door_end_pos = b->door_end_pos;
+    s->door_move_dir = b->door_move_dir;
+    s->pendulum_start_pos = b->pendulum_start_pos;
+    s->pendulum_swing_dir = b->pendulum_swing_dir;
+    s->runtime_is_visible = b->runtime_is_visible;
+    s->runtime_was_pressed = b->runtime_was_pressed;
+    s->runtime_playerIsTouching = b->runtime_playerIsTouching;
+    s->runtime_hasFired = b->runtime_hasFired;
+    s->runtime_active = b->runtime_active;
+    s->current_angular_velocity = b->current_angular_velocity;
+    s->target_angular_velocity = b->target_angular_velocity;
+    s->start_pos = b->start_pos;
+    s->end_pos = b->end_pos;
+    s->move_dir = b->move_dir;
+    s->plat_state = b->plat_state;
+    s->wait_timer = b->wait_timer;
+}
+
+static void savegame_capture_light(SaveLightState* s, int index, const Light* l) {
+    memset(s, 0, sizeof(*s));
+    s->index = index;
+    s->is_on = l->is_on;
+    s->intensity = l->intensity;
+    s->preset = l->preset;
+    s->preset_time = l->preset_time;
+    s->preset_index = l->preset_index;
+}
+
+static void savegame_capture_logic(SaveLogicState* s, int index, const LogicEntity* ent) {
+    memset(s, 0, sizeof(*s));
+    s->index = index;
+    s->runtime_active = ent->runtime_active;
+    s->runtime_float_a = ent->runtime_float_a;
+    s->runtime_int_a = ent->runtime_int_a;
+    s->runtime_float_b = ent->runtime_float_b;
+}
+
+static void savegame_capture_sprite(SaveSpriteState* s, int index, const Sprite* sprite) {
+    memset(s, 0, sizeof(*s));
+    s->index = index;
+    s->visible = sprite->visible;
+}
+
+static void savegame_capture_emitter(SaveEmitterState* s, int index, const ParticleEmitter* emitter) {
+    memset(s, 0, sizeof(*s));
+    s->index = index;
+    s->is_on = emitter->is_on;
+}
+
+static void savegame_fill_header(SaveHeader* header, const Scene* scene) {
+    memset(header, 0, sizeof(*header));
+    memcpy(header->magic, SAVEGAME_MAGIC, 4);
+    header->version = SAVEGAME_VERSION;
+    strncpy(header->mapPath, scene->mapPath, sizeof(header->mapPath) - 1);
+    header->numObjects = scene->numObjects;
+    header->numBrushes = scene->numBrushes;
+    header->numLights = scene->numActiveLights;
+    header->numLogicEntities = scene->numLogicEntities;
+    header->numSprites = scene->numSprites;
+    header->numParticleEmitters = scene->numParticleEmitters;
+    header->numIOConnections = g_num_io_connections;
+}
+
+static bool savegame_header_matches(const SaveHeader* a, const SaveHeader* b) {
+    return strcmp(a->mapPath, b->mapPath) == 0 &&
+        a->numObjects == b->numObjects && a->numBrushes == b->numBrushes &&
+        a->numLights == b->numLights && a->numLogicEntities == b->numLogicEntities &&
+        a->numSprites == b->numSprites && a->numParticleEmitters == b->numParticleEmitters &&
+        a->numIOConnections == b->numIOConnections;
+}
+
+static void savegame_free_property_baseline(SavePropertyBaseline* props) {
+    free(props->offsets);
+    free(props->counts);
+    free(props->pool);
+    memset(props, 0, sizeof(*props));
+}
+
+static void savegame_free_baseline(void) {
+    free(g_save_baseline.objects);
+    free(g_save_baseline.brushes);
+    free(g_save_baseline.lights);
+    free(g_save_baseline.logic);
+    free(g_save_baseline.sprites);
+    free(g_save_baseline.emitters);
+    savegame_free_property_baseline(&g_save_baseline.brushProperties);
+    savegame_free_property_baseline(&g_save_baseline.logicProperties);
+    memset(&g_save_baseline, 0, sizeof(g_save_baseline));
+}
+
+static bool savegame_capture_property_baseline(SavePropertyBaseline* props, int count, const KeyValue* (*get)(const Scene*, int, int*), const Scene* scene) {
+    int total = 0;
+    props->offsets = malloc(sizeof(int) * (count > 0 ? count : 1));
+    props->counts = malloc(sizeof(int) * (count > 0 ? count : 1));
+    if (!props->offsets || !props->counts) return false;
+    for (int i = 0; i < count; ++i) {
+        int n;
+        get(scene, i, &n);
+        props->offsets[i] = total;
+        props->counts[i] = n;
+        total += n;
+    }
+    props->pool = malloc(sizeof(KeyValue) * (total > 0 ? total : 1));
+    if (!props->pool) return false;
+    for (int i = 0; i < count; ++i) {
+        int n;
+        const KeyValue* kv = get(scene, i, &n);
+        memcpy(&props->pool[props->offsets[i]], kv, sizeof(KeyValue) * n);
+    }
+    return true;
+}
+
+static const KeyValue* savegame_brush_properties(const Scene* scene, int index, int* count) {
+    *count = scene->brushes[index].numProperties;
+    return scene->brushes[index].properties;
+}
+
+static const KeyValue* savegame_logic_properties(const Scene* scene, int index, int* count) {
+    *count = scene->logicEntities[index].numProperties;
+    return scene->logicEntities[index].properties;
+}
+
+static bool savegame_properties_changed(const SavePropertyBaseline* props, int index, const KeyValue* kv, int count) {
+    return props->counts[index] != count || memcmp(&props->pool[props->offsets[index]], kv, sizeof(KeyValue) * count) != 0;
+}
+
+void SaveGame_CaptureBaseline(Scene* scene) {
+    savegame_free_baseline();
+    SaveBaseline* base = &g_save_baseline;
+    savegame_fill_header(&base->header, scene);
+
+    base->objects = malloc(sizeof(SaveObjectState) * (scene->numObjects > 0 ? scene->numObjects : 1));
+    base->brushes = malloc(sizeof(SaveBrushState) * (scene->numBrushes > 0 ? scene->numBrushes : 1));
+    base->lights = malloc(sizeof(SaveLightState) * (scene->numActiveLights > 0 ? scene->numActiveLights : 1));
+    base->logic = malloc(sizeof(SaveLogicState) * (scene->numLogicEntities > 0 ? scene->numLogicEntities : 1));
+    base->sprites = malloc(sizeof(SaveSpriteState) * (scene->numSprites > 0 ? scene->numSprites : 1));
+    base->emitters = malloc(sizeof(SaveEmitterState) * (scene->numParticleEmitters > 0 ? scene->numParticleEmitters : 1));
+    if (!base->objects || !base->brushes || !base->lights || !base->logic || !base->sprites || !base->emitters ||
+        !savegame_capture_property_baseline(&base->brushProperties, scene->numBrushes, savegame_brush_properties, scene) ||
+        !savegame_capture_property_baseline(&base->logicProperties, scene->numLogicEntities, savegame_logic_properties, scene)) {
+        Console_Printf_Error("[ERROR] Failed to allocate savegame baseline for %s.", scene->mapPath);
+        savegame_free_baseline();
+        return;
+    }
+
+    for (int i = 0; i < scene->numObjects; ++i) savegame_capture_object(&base->objects[i], i, &scene->objects[i]);
+    for (int i = 0; i < scene->numBrushes; ++i) savegame_capture_brush(&base->brushes[i], i, &scene->brushes[i]);
+    for (int i = 0; i < scene->numActiveLights; ++i) savegame_capture_light(&base->lights[i], i, &scene->lights[i]);
+    for (int i = 0; i < scene->numLogicEntities; ++i) savegame_capture_logic(&base->logic[i], i, &scene->logicEntities[i]);
+    for (int i = 0; i < scene->numSprites; ++i) savegame_capture_sprite(&base->sprites[i], i, &scene->sprites[i]);
+    for (int i = 0; i < scene->numParticleEmitters; ++i) savegame_capture_emitter(&base->emitters[i], i, &scene->particleEmitters[i]);
+    base->valid = true;
+}
+
+static void savegame_free_snapshot(SaveSnapshot* snap) {
+    if (!snap) return;
+    free(snap->events);
+    free(snap->firedConnections);
+    free(snap->objects);
+    free(snap->brushes);
+    free(snap->lights);
+    free(snap->logic);
+    free(snap->sprites);
+    free(snap->emitters);
+    free(snap->brushProperties);
+    free(snap->logicProperties);
+    free(snap);
+}
+
+// Appends a record to a snapshot array that grows on demand. Deltas are
+// usually a small fraction of the scene so arrays start empty.
+static bool savegame_push(void** array, int* count, int* capacity, const void* record, size_t record_size) {
+    if (*count >= *capacity) {
+        int new_capacity = *capacity ? *capacity * 2 : 16;
+        void* grown = realloc(*array, record_size * new_capacity);
+        if (!grown) return false;
+        *array = grown;
+        *capacity = new_capacity;
+    }
+    memcpy((char*)*array + record_size * (*count), record, record_size);
+    (*count)++;
+    return true;
+}
+
+static int savegame_compare_events(const void* a, const void* b) {
+    const PendingEvent* ea = (const PendingEvent*)a;
+    const PendingEvent* eb = (const PendingEvent*)b;
+    if (ea->executionTime != eb->executionTime) return ea->executionTime < eb->executionTime ? -1 : 1;
+    if (ea->sequence != eb->sequence) return ea->sequence < eb->sequence ? -1 : 1;
+    return 0;
+}
+
+static SaveSnapshot* savegame_take_snapshot(Scene* scene, Engine* engine) {
+    const SaveBaseline* base = &g_save_baseline;
+    SaveSnapshot* snap = calloc(1, sizeof(SaveSnapshot));
+    if (!snap) return NULL;
+    savegame_fill_header(&snap->header, scene);
+
+    SavePlayerState* player = &snap->player;
+    player->cameraPosition = engine->camera.position;
+    player->bodyPosition = engine->camera.position;
+    if (engine->camera.physicsBody) {
+        Physics_GetPosition(engine->camera.physicsBody, &player->bodyPosition);
+        player->velocity = Physics_GetLinearVelocity(engine->camera.physicsBody);
+    }
+    player->yaw = engine->camera.yaw;
+    player->pitch = engine->camera.pitch;
+    player->isCrouching = engine->camera.isCrouching;
+    player->currentHeight = engine->camera.currentHeight;
+    player->health = engine->camera.health;
+    player->flashlightOn = engine->flashlight_on;
+
+    bool ok = true;
+    int capacity = 0;
+    // The IO queue is a heap, so put the events back in firing order first.
+    // Loading re-queues them in this order, which keeps same-frame events in sequence.
+    const PendingEvent* queued;
+    int num_events = IO_GetPendingEvents(&queued);
+    PendingEvent* events = num_events > 0 ? malloc(sizeof(PendingEvent) * num_events) : NULL;
+    if (num_events > 0 && !events) ok = false;
+    if (events) {
+        memcpy(events, queued, sizeof(PendingEvent) * num_events);
+        qsort(events, num_events, sizeof(PendingEvent), savegame_compare_events);
+    }
+    for (int i = 0; i < num_events && ok; ++i) {
+        if (!events[i].active) continue;
+        SaveEventState e;
+        memset(&e, 0, sizeof(e));
+        memcpy(e.targetName, events[i].targetName, sizeof(e.targetName));
+        memcpy(e.inputName, events[i].inputName, sizeof(e.inputName));
+        memcpy(e.parameter, events[i].parameter, sizeof(e.parameter));
+        e.delay = events[i].executionTime - engine->lastFrame;
+        ok = savegame_push((void**)&snap->events, &snap->numEvents, &capacity, &e, sizeof(e));
+    }
+    free(events);
+
+    capacity = 0;
+    for (int i = 0; i < g_num_io_connections && ok; ++i) {
+        if (g_io_connections[i].hasFired) ok = savegame_push((void**)&snap->firedConnections, &snap->numFiredConnections, &capacity, &i, sizeof(int));
+    }
+
+    capacity = 0;
+    for (int i = 0; i < scene->numObjects && ok; ++i) {
+        SaveObjectState s;
+        savegame_capture_object(&s, i, &scene->objects[i]);
+        if (memcmp(&s, &base->objects[i], sizeof(s)) != 0) ok = savegame_push((void**)&snap->objects, &snap->numObjects, &capacity, &s, sizeof(s));
+    }
+    capacity = 0;
+    for (int i = 0; i < scene->numBrushes && ok; ++i) {
+        SaveBrushState s;
+        savegame_capture_brush(&s, i, &scene->brushes[i]);
+        if (memcmp(&s, &base->brushes[i], sizeof(s)) != 0) ok = savegame_push((void**)&snap->brushes, &snap->numBrushes, &capacity, &s, sizeof(s));
+    }
+    capacity = 0;
+    for (int i = 0; i < scene->numActiveLights && ok; ++i) {
+        SaveLightState s;
+        savegame_capture_light(&s, i, &scene->lights[i]);
+        if (memcmp(&s, &base->lights[i], sizeof(s)) != 0) ok = savegame_push((void**)&snap->lights, &snap->numLights, &capacity, &s, sizeof(s));
+    }
+    capacity = 0;
+    for (int i = 0; i < scene->numLogicEntities && ok; ++i) {
+        SaveLogicState s;
+        savegame_capture_logic(&s, i, &scene->logicEntities[i]);
+        if (memcmp(&s, &base->logic[i], sizeof(s)) != 0) ok = savegame_push((void**)&snap->logic, &snap->numLogic, &capacity, &s, sizeof(s));
+    }
+    capacity = 0;
+    for (int i = 0; i < scene->numSprites && ok; ++i) {
+        SaveSpriteState s;
+        savegame_capture_sprite(&s, i, &scene->sprites[i]);
+        if (memcmp(&s, &base->sprites[i], sizeof(s)) != 0) ok = savegame_push((void**)&snap->sprites, &snap->numSprites, &capacity, &s, sizeof(s));
+    }
+    capacity = 0;
+    for (int i = 0; i < scene->numParticleEmitters && ok; ++i) {
+        SaveEmitterState s;
+        savegame_capture_emitter(&s, i, &scene->particleEmitters[i]);
+        if (memcmp(&s, &base->emitters[i], sizeof(s)) != 0) ok = savegame_push((void**)&snap->emitters, &snap->numEmitters, &capacity, &s, sizeof(s));
+    }
+
+    capacity = 0;
+    for (int i = 0; i < scene->numBrushes && ok; ++i) {
+        const Brush* b = &scene->brushes[i];
+        if (!savegame_properties_changed(&base->brushProperties, i, b->properties, b->numProperties)) continue;
+        SavePropertyState s;
+        s.index = i;
+        s.numProperties = b->numProperties;
+        memcpy(s.properties, b->properties, sizeof(s.properties));
+        ok = savegame_push((void**)&snap->brushProperties, &snap->numBrushProperties, &capacity, &s, sizeof(s));
+    }
+    capacity = 0;
+    for (int i = 0; i < scene->numLogicEntities && ok; ++i) {
+        const LogicEntity* ent = &scene->logicEntities[i];
+        if (!savegame_properties_changed(&base->logicProperties, i, ent->properties, ent->numProperties)) continue;
+        SavePropertyState s;
+        s.index = i;
+        s.numProperties = ent->numProperties;
+        memcpy(s.properties, ent->properties, sizeof(s.properties));
+        ok = savegame_push((void**)&snap->logicProperties, &snap->numLogicProperties, &capacity, &s, sizeof(s));
+    }
+
+    if (!ok) {
+        savegame_free_snapshot(snap);
+        return NULL;
+    }
+    return snap;
+}
+
+static bool savegame_write_section(FILE* file, const void* records, int count, size_t record_size) {
+    if (fwrite(&count, sizeof(int), 1, file) != 1) return false;
+    return count == 0 || fwrite(records, record_size, count, file) == (size_t)count;
+}
+
+static bool savegame_write_properties(FILE* file, const SavePropertyState* records, int count) {
+    if (fwrite(&count, sizeof(int), 1, file) != 1) return false;
+    for (int i = 0; i < count; ++i) {
+        if (fwrite(&records[i].index, sizeof(int), 1, file) != 1 ||
+            fwrite(&records[i].numProperties, sizeof(int), 1, file) != 1) return false;
+        if (records[i].numProperties > 0 &&
+            fwrite(records[i].properties, sizeof(KeyValue), records[i].numProperties, file) != (size_t)records[i].numProperties) return false;
+    }
+    return true;
+}
+
+// Runs on the saver thread. The file is written next to the target and moved
+// over it when complete, so a crash mid-save never leaves a truncated save.
+static void savegame_write_snapshot(SaveSnapshot* snap) {
+    char temp_path[300];
+    snprintf(temp_path, sizeof(temp_path), "%s.tmp", snap->path);
+
+    FILE* file = fopen(temp_path, "wb");
+    if (!file) {
+        snprintf(snap->error, sizeof(snap->error), "Failed to open %s for writing.", temp_path);
+        return;
+    }
+
+    bool ok = fwrite(&snap->header, sizeof(snap->header), 1, file) == 1 &&
+        fwrite(&snap->player, sizeof(snap->player), 1, file) == 1 &&
+        savegame_write_section(file, snap->events, snap->numEvents, sizeof(SaveEventState)) &&
+        savegame_write_section(file, snap->firedConnections, snap->numFiredConnections, sizeof(int)) &&
+        savegame_write_section(file, snap->objects, snap->numObjects, sizeof(SaveObjectState)) &&
+        savegame_write_section(file, snap->brushes, snap->numBrushes, sizeof(SaveBrushState)) &&
+        savegame_write_section(file, snap->lights, snap->numLights, sizeof(SaveLightState)) &&
+        savegame_write_section(file, snap->logic, snap->numLogic, sizeof(SaveLogicState)) &&
+        savegame_write_section(file, snap->sprites, snap->numSprites, sizeof(SaveSpriteState)) &&
+        savegame_write_section(file, snap->emitters, snap->numEmitters, sizeof(SaveEmitterState)) &&
+        savegame_write_properties(file, snap->brushProperties, snap->numBrushProperties) &&
+        savegame_write_properties(file, snap->logicProperties, snap->numLogicProperties);
+    ok = (fclose(file) == 0) && ok;
+
+    if (!ok) {
+        remove(temp_path);
+        snprintf(snap->error, sizeof(snap->error), "Failed to write %s.", snap->path);
+        return;
+    }
+    remove(snap->path);
+    if (rename(temp_path, snap->path) != 0) {
+        snprintf(snap->error, sizeof(snap->error), "Failed to move %s into place.", temp_path);
+        return;
+    }
+    snap->success = true;
+}
+
+static int SaveGame_Thread_Worker(void* data) {
+    (void)data;
+    SDL_LockMutex(g_save_mutex);
+    while (true) {
+        while (g_save_thread_running && !g_save_queue_head) {
+            SDL_CondWait(g_save_cond, g_save_mutex);
+        }
+        if (!g_save_queue_head) break;
+
+        SaveSnapshot* snap = g_save_queue_head;
+        g_save_queue_head = snap->next;
+        if (!g_save_queue_head) g_save_queue_tail = NULL;
+        SDL_UnlockMutex(g_save_mutex);
+
+        savegame_write_snapshot(snap);
+
+        SDL_LockMutex(g_save_mutex);
+        snap->next = g_save_done;
+        g_save_done = snap;
+        g_save_jobs_in_flight--;
+        SDL_CondBroadcast(g_save_idle_cond);
+    }
+    SDL_UnlockMutex(g_save_mutex);
+    return 0;
+}
+
+void SaveGame_Init(void) {
+    memset(&g_save_baseline, 0, sizeof(g_save_baseline));
+    g_save_mutex = SDL_CreateMutex();
+    g_save_cond = SDL_CreateCond();
+    g_save_idle_cond = SDL_CreateCond();
+    g_save_thread_running = true;
+    g_save_thread = SDL_CreateThread(SaveGame_Thread_Worker, "SaveGameThread", NULL);
+    if (!g_save_thread) {
+        g_save_thread_running = false;
+        Console_Printf_Error("[ERROR] Failed to create savegame thread: %s. Saves will be written synchronously.", SDL_GetError());
+    }
+}
+
+void SaveGame_Shutdown(void) {
+    SaveGame_Flush();
+    if (g_save_thread) {
+        SDL_LockMutex(g_save_mutex);
+        g_save_thread_running = false;
+        SDL_CondSignal(g_save_cond);
+        SDL_UnlockMutex(g_save_mutex);
+        SDL_WaitThread(g_save_thread, NULL);
+        g_save_thread = NULL;
+    }
+    SaveGame_Update();
+    if (g_save_cond) SDL_DestroyCond(g_save_cond);
+    if (g_save_idle_cond) SDL_DestroyCond(g_save_idle_cond);
+    if (g_save_mutex) SDL_DestroyMutex(g_save_mutex);
+    g_save_cond = NULL;
+    g_save_idle_cond = NULL;
+    g_save_mutex = NULL;
+    savegame_free_baseline();
+}
+
+bool SaveGame_Write(const char* filepath, Scene* scene, Engine* engine) {
+    if (!g_save_baseline.valid || strcmp(g_save_baseline.header.mapPath, scene->mapPath) != 0) {
+        Console_Printf_Error("[ERROR] No baseline for %s, the map has to be loaded before it can be saved.", scene->mapPath);
+        return false;
+    }
+    SaveHeader current;
+    savegame_fill_header(&current, scene);
+    if (!savegame_header_matches(&current, &g_save_baseline.header)) {
+        Console_Printf_Error("[ERROR] Entities were added or removed since %s was loaded, cannot write a delta save.", scene->mapPath);
+        return false;
+    }
+
+    SaveSnapshot* snap = savegame_take_snapshot(scene, engine);
+    if (!snap) {
+        Console_Printf_Error("[ERROR] Failed to allocate savegame snapshot.");
+        return false;
+    }
+    strncpy(snap->path, filepath, sizeof(snap->path) - 1);
+
+    if (!g_save_thread) {
+        savegame_write_snapshot(snap);
+        bool success = snap->success;
+        if (success) Console_Printf("Game saved to %s", snap->path);
+        else Console_Printf_Error("[ERROR] %s", snap->error);
+        savegame_free_snapshot(snap);
+        return success;
+    }
+
+    SDL_LockMutex(g_save_mutex);
+    if (g_save_queue_tail) g_save_queue_tail->next = snap;
+    else g_save_queue_head = snap;
+    g_save_queue_tail = snap;
+    g_save_jobs_in_flight++;
+    SDL_CondSignal(g_save_cond);
+    SDL_UnlockMutex(g_save_mutex);
+    return true;
+}
+
+void SaveGame_Update(void) {
+    if (!g_save_mutex) return;
+    SDL_LockMutex(g_save_mutex);
+    SaveSnapshot* done = g_save_done;
+    g_save_done = NULL;
+    SDL_UnlockMutex(g_save_mutex);
+
+    while (done) {
+        SaveSnapshot* next = done->next;
+        if (done->success) Console_Printf("Game saved to %s", done->path);
+        else Console_Printf_Error("[ERROR] %s", done->error);
+        savegame_free_snapshot(done);
+        done = next;
+    }
+}
+
+void SaveGame_Flush(void) {
+    if (!g_save_mutex) return;
+    SDL_LockMutex(g_save_mutex);
+    while (g_save_jobs_in_flight > 0) {
+        SDL_CondWait(g_save_idle_cond, g_save_mutex);
+    }
+    SDL_UnlockMutex(g_save_mutex);
+    SaveGame_Update();
+}
+
+bool SaveGame_IsBinary(const char* filepath) {
+    FILE* file = fopen(filepath, "rb");
+    if (!file) return false;
+    char magic[4];
+    bool binary = fread(magic, 1, 4, file) == 4 && memcmp(magic, SAVEGAME_MAGIC, 4) == 0;
+    fclose(file);
+    return binary;
+}
+
+typedef struct {
+    const unsigned char* data;
+    size_t size;
+    size_t offset;
+} SaveReader;
+
+static bool savegame_read(SaveReader* reader, void* out, size_t size) {
+    if (reader->size - reader->offset < size) return false;
+    memcpy(out, reader->data + reader->offset, size);
+    reader->offset += size;
+    return true;
+}
+
+// Reads a section into a freshly allocated array. Every record index is checked
+// against limit so a save can never touch entities past the end of the scene.
+static bool savegame_read_section(SaveReader* reader, void** records, int* count, size_t record_size, int limit) {
+    if (!savegame_read(reader, count, sizeof(int)) || *count < 0 || (size_t)*count > (reader->size - reader->offset) / record_size) return false;
+    if (*count == 0) return true;
+    *records = malloc(record_size * (*count));
+    if (!*records || !savegame_read(reader, *records, record_size * (*count))) return false;
+    for (int i = 0; i < *count && limit >= 0; ++i) {
+        int index = *(const int*)((const char*)*records + record_size * i);
+        if (index < 0 || index >= limit) return false;
+    }
+    return true;
+}
+
+static bool savegame_read_properties(SaveReader* reader, SavePropertyState** records, int* count, int limit) {
+    if (!savegame_read(reader, count, sizeof(int)) || *count < 0 || *count > limit) return false;
+    if (*count == 0) return true;
+    *records = calloc(*count, sizeof(SavePropertyState));
+    if (!*records) return false;
+    for (int i = 0; i < *count; ++i) {
+        SavePropertyState* s = &(*records)[i];
+        if (!savegame_read(reader, &s->index, sizeof(int)) || !savegame_read(reader, &s->numProperties, sizeof(int))) return false;
+        if (s->index < 0 || s->index >= limit || s->numProperties < 0 || s->numProperties > MAX_ENTITY_PROPERTIES) return false;
+        if (!savegame_read(reader, s->properties, sizeof(KeyValue) * s->numProperties)) return false;
+    }
+    return true;
+}
+
+static void savegame_apply_object(SceneObject* obj, const SaveObjectState* s) {
+    obj->pos = s->pos;
+    obj->rot = s->rot;
+    obj->scale = s->scale;
+    obj->modelMatrix = s->modelMatrix;
+    obj->current_animation = s->current_animation;
+    obj->animation_time = s->animation_time;
+    obj->animation_playing = s->animation_playing;
+    obj->animation_looping = s->animation_looping;
+    if (obj->physicsBody && obj->mass > 0.0f) {
+        Physics_SetWorldTransform(obj->physicsBody, create_trs_matrix(obj->pos, obj->rot, (Vec3) { 1.0f, 1.0f, 1.0f }));
+        Physics_SetLinearVelocity(obj->physicsBody, s->linearVelocity);
+        Physics_SetAngularVelocity(obj->physicsBody, s->angularVelocity);
+    }
+}
+
+static void savegame_apply_brush(Brush* b, const SaveBrushState* s) {
+    b->pos = s->pos;
+    b->rot = s->rot;
+    b->scale = s->scale;
+    b->modelMatrix = s->modelMatrix;
+    b->door_state = s->door_state;
+    b->door_start_pos = s->door_start_pos;
+    b->door_end_pos = s->door_end_pos;
+    b->door_move_dir = s->door_move_dir;
+    b->pendulum_start_pos = s->pendulum_start_pos;
+    b->pendulum_swing_dir = s->pendulum_swing_dir;
+    b->runtime_is_visible = s->runtime_is_visible;
+    b->runtime_was_pressed = s->runtime_was_pressed;
+    b->runtime_playerIsTouching = s->runtime_playerIsTouching;
+    b->runtime_hasFired = s->runtime_hasFired;
+    b->runtime_active = s->runtime_active;
+    b->current_angular_velocity = s->current_angular_velocity;
+    b->target_angular_velocity = s->target_angular_velocity;
+    b->start_pos = s->start_pos;
+    b->end_pos = s->end_pos;
+    b->move_dir = s->move_dir;
+    b->plat_state = s->plat_state;
+    b->wait_timer = s->wait_timer;
+    if (b->physicsBody) {
+        Physics_SetWorldTransform(b->physicsBody, b->modelMatrix);
+        if (b->mass > 0.0f) {
+            Physics_SetLinearVelocity(b->physicsBody, s->linearVelocity);
+            Physics_SetAngularVelocity(b->physicsBody, s->angularVelocity);
+        }
+    }
+}
+
+static void savegame_apply_light(Light* l, const SaveLightState* s) {
+    l->is_on = s->is_on;
+    l->intensity = s->intensity;
+    l->preset = s->preset;
+    l->preset_time = s->preset_time;
+    l->preset_index = s->preset_index;
+}
+
+static void savegame_apply_logic(LogicEntity* ent, const SaveLogicState* s) {
+    ent->runtime_active = s->runtime_active;
+    ent->runtime_float_a = s->runtime_float_a;
+    ent->runtime_int_a = s->runtime_int_a;
+    ent->runtime_float_b = s->runtime_float_b;
+}
+
+static void savegame_apply_properties(KeyValue* properties, int* numProperties, const KeyValue* source, int count) {
+    memset(properties, 0, sizeof(KeyValue) * MAX_ENTITY_PROPERTIES);
+    memcpy(properties, source, sizeof(KeyValue) * count);
+    *numProperties = count;
+}
+
+// Resets every entity to the state it was loaded with, then applies the
+// deltas on top. Entities a save does not mention end up as the map has them.
+static void savegame_apply_snapshot(const SaveSnapshot* snap, Scene* scene, Engine* engine) {
+    const SaveBaseline* base = &g_save_baseline;
+
+    for (int i = 0; i < scene->numObjects; ++i) savegame_apply_object(&scene->objects[i], &base->objects[i]);
+    for (int i = 0; i < scene->numBrushes; ++i) savegame_apply_brush(&scene->brushes[i], &base->brushes[i]);
+    for (int i = 0; i < scene->numActiveLights; ++i) savegame_apply_light(&scene->lights[i], &base->lights[i]);
+    for (int i = 0; i < scene->numLogicEntities; ++i) savegame_apply_logic(&scene->logicEntities[i], &base->logic[i]);
+    for (int i = 0; i < scene->numSprites; ++i) scene->sprites[i].visible = base->sprites[i].visible;
+    for (int i = 0; i < scene->numParticleEmitters; ++i) scene->particleEmitters[i].is_on = base->emitters[i].is_on;
+    for (int i = 0; i < scene->numBrushes; ++i) {
+        Brush* b = &scene->brushes[i];
+        savegame_apply_properties(b->properties, &b->numProperties, &base->brushProperties.pool[base->brushProperties.offsets[i]], base->brushProperties.counts[i]);
+    }
+    for (int i = 0; i < scene->numLogicEntities; ++i) {
+        LogicEntity* ent = &scene->logicEntities[i];
+        savegame_apply_properties(ent->properties, &ent->numProperties, &base->logicProperties.pool[base->logicProperties.offsets[i]], base->logicProperties.counts[i]);
+    }
+
+    for (int i = 0; i < snap->numObjects; ++i) savegame_apply_object(&scene->objects[snap->objects[i].index], &snap->objects[i]);
+    for (int i = 0; i < snap->numBrushes; ++i) savegame_apply_brush(&scene->brushes[snap->brushes[i].index], &snap->brushes[i]);
+    for (int i = 0; i < snap->numLights; ++i) savegame_apply_light(&scene->lights[snap->lights[i].index], &snap->lights[i]);
+    for (int i = 0; i < snap->numLogic; ++i) savegame_apply_logic(&scene->logicEntities[snap->logic[i].index], &snap->logic[i]);
+    for (int i = 0; i < snap->numSprites; ++i) scene->sprites[snap->sprites[i].index].visible = snap->sprites[i].visible;
+    for (int i = 0; i < snap->numEmitters; ++i) scene->particleEmitters[snap->emitters[i].index].is_on = snap->emitters[i].is_on;
+    for (int i = 0; i < snap->numBrushProperties; ++i) {
+        const SavePropertyState* s = &snap->brushProperties[i];
+        Brush* b = &scene->brushes[s->index];
+        savegame_apply_properties(b->properties, &b->numProperties, s->properties, s->numProperties);
+    }
+    for (int i = 0; i < snap->numLogicProperties; ++i) {
+        const SavePropertyState* s = &snap->logicProperties[i];
+        LogicEntity* ent = &scene->logicEntities[s->index];
+        savegame_apply_properties(ent->properties, &ent->numProperties, s->properties, s->numProperties);
+    }
+    Scene_RefreshEntityClasses(scene);
+
+    for (int i = 0; i < g_num_io_connections; ++i) g_io_connections[i].hasFired = false;
+    for (int i = 0; i < snap->numFiredConnections; ++i) g_io_connections[snap->firedConnections[i]].hasFired = true;
+    IO_ClearPendingEvents();
+    for (int i = 0; i < snap->numEvents; ++i) {
+        const SaveEventState* e = &snap->events[i];
+        IO_QueueEvent(e->targetName, e->inputName, e->parameter, engine->lastFrame + e->delay);
+    }
+
+    const SavePlayerState* player = &snap->player;
+    if (engine->camera.physicsBody) {
+        Physics_Teleport(engine->camera.physicsBody, player->bodyPosition);
+        Physics_SetLinearVelocity(engine->camera.physicsBody, player->velocity);
+    }
+    engine->camera.position = player->cameraPosition;
+    engine->camera.yaw = player->yaw;
+    engine->camera.pitch = player->pitch;
+    engine->camera.isCrouching = player->isCrouching;
+    engine->camera.currentHeight = player->currentHeight;
+    engine->camera.health = player->health;
+    engine->prev_health = player->health;
+    engine->flashlight_on = player->flashlightOn;
+}
+
+bool SaveGame_Load(const char* filepath, Scene* scene, Renderer* renderer, Engine* engine, bool allow_in_place) {
+    FILE* file = fopen(filepath, "rb");
+    if (!file) {
+        Console_Printf_Error("[ERROR] Could not open save file %s.", filepath);
+        return false;
+    }
+    fseek(file, 0, SEEK_END);
+    long file_size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    unsigned char* data = file_size > 0 ? malloc(file_size) : NULL;
+    bool read_ok = data && fread(data, 1, file_size, file) == (size_t)file_size;
+    fclose(file);
+    if (!read_ok) {
+        Console_Printf_Error("[ERROR] Failed to read save file %s.", filepath);
+        free(data);
+        return false;
+    }
+
+    SaveReader reader = { data, (size_t)file_size, 0 };
+    SaveSnapshot* snap = calloc(1, sizeof(SaveSnapshot));
+    bool ok = snap && savegame_read(&reader, &snap->header, sizeof(snap->header)) &&
+        memcmp(snap->header.magic, SAVEGAME_MAGIC, 4) == 0 && snap->header.version == SAVEGAME_VERSION;
+    if (!ok) {
+        Console_Printf_Error("[ERROR] %s is not a supported save file.", filepath);
+        savegame_free_snapshot(snap);
+        free(data);
+        return false;
+    }
+    snap->header.mapPath[sizeof(snap->header.mapPath) - 1] = '\0';
+
+    const SaveHeader* h = &snap->header;
+    ok = savegame_read(&reader, &snap->player, sizeof(snap->player)) &&
+        savegame_read_section(&reader, (void**)&snap->events, &snap->numEvents, sizeof(SaveEventState), -1) &&
+        savegame_read_section(&reader, (void**)&snap->firedConnections, &snap->numFiredConnections, sizeof(int), h->numIOConnections) &&
+        savegame_read_section(&reader, (void**)&snap->objects, &snap->numObjects, sizeof(SaveObjectState), h->numObjects) &&
+        savegame_read_section(&reader, (void**)&snap->brushes, &snap->numBrushes, sizeof(SaveBrushState), h->numBrushes) &&
+        savegame_read_section(&reader, (void**)&snap->lights, &snap->numLights, sizeof(SaveLightState), h->numLights) &&
+        savegame_read_section(&reader, (void**)&snap->logic, &snap->numLogic, sizeof(SaveLogicState), h->numLogicEntities) &&
+        savegame_read_section(&reader, (void**)&snap->sprites, &snap->numSprites, sizeof(SaveSpriteState), h->numSprites) &&
+        savegame_read_section(&reader, (void**)&snap->emitters, &snap->numEmitters, sizeof(SaveEmitterState), h->numParticleEmitters) &&
+        savegame_read_properties(&reader, &snap->brushProperties, &snap->numBrushProperties, h->numBrushes) &&
+        savegame_read_properties(&reader, &snap->logicProperties, &snap->numLogicProperties, h->numLogicEntities);
+    free(data);
+    if (!ok) {
+        Console_Printf_Error("[ERROR] Save file %s is truncated or corrupt.", filepath);
+        savegame_free_snapshot(snap);
+        return false;
+    }
+
+    SaveHeader current;
+    savegame_fill_header(&current, scene);
+    bool in_place = allow_in_place && g_save_baseline.valid &&
+        savegame_header_matches(&current, h) && savegame_header_matches(&g_save_baseline.header, h);
+    if (!in_place) {
+        if (!Scene_LoadMap(scene, renderer, h->mapPath, engine)) {
+            savegame_free_snapshot(snap);
+            return false;
+        }
+        savegame_fill_header(&current, scene);
+        if (!g_save_baseline.valid || !savegame_header_matches(&current, h)) {
+            Console_Printf_Error("[ERROR] %s no longer matches the map it was saved on.", filepath);
+            savegame_free_snapshot(snap);
+            return false;
+        }
+    }
+
+    savegame_apply_snapshot(snap, scene, engine);
+    Console_Printf("Restored %d changed entities from %s%s.",
+        snap->numObjects + snap->numBrushes + snap->numLights + snap->numLogic + snap->numSprites + snap->numEmitters,
+        filepath, in_place ? " in place" : "");
+    savegame_free_snapshot(snap);
+    return true;
+}
@@ -0,0 +1,64 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 Soft Sprint Studios
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+#ifndef SAVEGAME_H
+#define SAVEGAME_H
+
+//----------------------------------------//
+// Brief: Binary delta savegames, written on a background thread
+//----------------------------------------//
+
+#include <stdbool.h>
+#include "map.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    void SaveGame_Init(void);
+    void SaveGame_Shutdown(void);
+    // Records the state of a freshly loaded map. Saves only store what has
+    // changed since this point.
+    void SaveGame_CaptureBaseline(Scene* scene);
+    // Snapshots the runtime state now and writes it to filepath on the saver
+    // thread, or inline if that thread could not be started. Returns false if
+    // the snapshot could not be taken or the inline write failed.
+    bool SaveGame_Write(const char* filepath, Scene* scene, Engine* engine);
+    // True if filepath starts with the binary savegame header. Older saves are
+    // full text maps and go through Scene_LoadMap instead.
+    bool SaveGame_IsBinary(const char* filepath);
+    // Restores a binary save. When the save belongs to the map that is already
+    // loaded and allow_in_place is set, entities are reset in place and no
+    // assets are reloaded.
+    bool SaveGame_Load(const char* filepath, Scene* scene, Renderer* renderer, Engine* engine, bool allow_in_place);
+    // Reports finished writes, call once per frame.
+    void SaveGame_Update(void);
+    // Blocks until every queued save is on disk.
+    void SaveGame_Flush(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SAVEGAME_H
@@ -30,17 +30,12 @@
 //----------------------------------------//
 
 #include <stdbool.h>
-#include <SDL_thread.h>
-#include <SDL_mutex.h>
 #include "sound_api.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-    SOUND_API void DSP_Reverb_Thread_Init(void);
-    SOUND_API void DSP_Reverb_Thread_Shutdown(void);
-
     typedef enum {
         REVERB_PRESET_NONE,
         REVERB_PRESET_SMALL_ROOM,
@@ -27,16 +27,27 @@
 #include <string.h>
 #include <AL/al.h>
 #include <AL/alc.h>
+#include <AL/efx.h>
+#include <math.h>
+#include <SDL_thread.h>
+#include <SDL_mutex.h>
+#include <SDL_timer.h>
 #include "minimp3.h"
 #include "minivorbis.h"
 
-#define MAX_WET_CACHE_ENTRIES 256
 #define MAX_PLAYING_SOUNDS 512
 #define MAX_BUFFERS 1024
+#define MAX_STREAM_ASSETS 64
+#define MAX_STREAMING_SOURCES 32
+#define STREAM_BUFFER_COUNT 4
+#define STREAM_BUFFER_SAMPLES 16384
+#define STREAM_HANDLE_FLAG 0x80000000u
+#define REVERB_SLOT_COUNT 2
+#define REVERB_CROSSFADE_TIME 0.75f
+#define REVERB_PRUNE_INTERVAL 1.0f
 
 typedef struct {
     ALuint bufferID;
-    void* pcmData;
     unsigned int dataSize;
     ALenum format;
     ALsizei freq;
@@ -49,28 +60,211 @@ static ALCdevice* g_sound_device = NULL;
 static ALCcontext* g_sound_context = NULL;
 static ReverbPreset g_current_reverb_preset = REVERB_PRESET_NONE;
 
+// Reverb runs in real time on OpenAL Soft's EFX auxiliary slots. Two slots
+// hold the outgoing and incoming preset so zone changes crossfade instead of
+// cutting, and every source sends into both at full level.
 typedef struct {
-    ALuint dryBufferID;
-    ReverbPreset preset;
-    ALuint wetBufferID;
-} WetBufferCacheEntry;
+    bool available;
+    LPALGENEFFECTS alGenEffects;
+    LPALDELETEEFFECTS alDeleteEffects;
+    LPALEFFECTI alEffecti;
+    LPALEFFECTF alEffectf;
+    LPALGENFILTERS alGenFilters;
+    LPALDELETEFILTERS alDeleteFilters;
+    LPALFILTERI alFilteri;
+    LPALFILTERF alFilterf;
+    LPALGENAUXILIARYEFFECTSLOTS alGenAuxiliaryEffectSlots;
+    LPALDELETEAUXILIARYEFFECTSLOTS alDeleteAuxiliaryEffectSlots;
+    LPALAUXILIARYEFFECTSLOTI alAuxiliaryEffectSloti;
+    LPALAUXILIARYEFFECTSLOTF alAuxiliaryEffectSlotf;
+    ALuint slots[REVERB_SLOT_COUNT];
+    ALuint effects[REVERB_SLOT_COUNT];
+    ALuint filter;
+    float slotGain[REVERB_SLOT_COUNT];
+    float slotTarget[REVERB_SLOT_COUNT];
+    int activeSlot;
+    float dryLevel;
+    float dryTarget;
+    float pruneTimer;
+} ReverbBus;
+
+static ReverbBus g_reverb;
 
-static WetBufferCacheEntry g_wet_buffer_cache[MAX_WET_CACHE_ENTRIES];
-static int g_wet_cache_count = 0;
+typedef struct {
+    ALuint sourceID;
+} PlayingSource;
+
+static PlayingSource g_playing_sources[MAX_PLAYING_SOUNDS];
+static int g_playing_source_count = 0;
+
+typedef enum {
+    STREAM_CODEC_WAV,
+    STREAM_CODEC_MP3,
+    STREAM_CODEC_OGG
+} StreamCodec;
 
 typedef struct {
-    ALuint drySourceID;
-    ALuint wetSourceID;
-} PlayingSourceLink;
+    bool used;
+    char path[256];
+    StreamCodec codec;
+} StreamAsset;
+
+typedef struct {
+    StreamCodec codec;
+    int channels;
+    int rate;
+    FILE* file;
+    int bitsPerSample;
+    long wavDataStart;
+    unsigned int wavDataSize;
+    unsigned int wavDataPos;
+    mp3dec_t mp3d;
+    unsigned char* mp3Data;
+    size_t mp3Size;
+    size_t mp3Pos;
+    short mp3Frame[MINIMP3_MAX_SAMPLES_PER_FRAME];
+    int mp3FrameSamples;
+    int mp3FrameChannels;
+    int mp3FramePos;
+    OggVorbis_File vorbis;
+} StreamDecoder;
+
+typedef struct {
+    bool active;
+    bool reserved;
+    bool looping;
+    bool finished;
+    bool playing;
+    float pendingSeek;
+    ALuint sourceID;
+    ALuint buffers[STREAM_BUFFER_COUNT];
+    StreamDecoder decoder;
+} StreamingSource;
+
+static StreamAsset g_stream_assets[MAX_STREAM_ASSETS];
+static StreamingSource g_streams[MAX_STREAMING_SOURCES];
+static unsigned int g_stream_threshold_bytes = 1024 * 1024;
+static SDL_Thread* g_stream_thread = NULL;
+static SDL_mutex* g_stream_mutex = NULL;
+static volatile bool g_stream_thread_running = false;
+
+static int Stream_Thread_Worker(void* data);
+static void stream_destroy(StreamingSource* s);
+
+static float clampf(float v, float lo, float hi) {
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+static void reverb_load_preset(int slot, ReverbPreset preset) {
+    ReverbSettings settings = DSP_Reverb_GetSettingsForPreset(preset);
+    // Comb feedback g gives a 60 dB decay after 3 / -log10(g) loop passes,
+    // the Freeverb combs average roughly 31 ms per pass.
+    float decay = settings.roomSize > 0.0f && settings.roomSize < 1.0f ? -3.0f * 0.031f / log10f(settings.roomSize) : AL_REVERB_MAX_DECAY_TIME;
+    ALuint effect = g_reverb.effects[slot];
+    g_reverb.alEffectf(effect, AL_REVERB_DECAY_TIME, clampf(decay, AL_REVERB_MIN_DECAY_TIME, AL_REVERB_MAX_DECAY_TIME));
+    g_reverb.alEffectf(effect, AL_REVERB_DECAY_HFRATIO, clampf(1.0f - settings.damping, AL_REVERB_MIN_DECAY_HFRATIO, AL_REVERB_MAX_DECAY_HFRATIO));
+    g_reverb.alEffectf(effect, AL_REVERB_GAIN, clampf(settings.wetLevel, AL_REVERB_MIN_GAIN, AL_REVERB_MAX_GAIN));
+    g_reverb.alEffectf(effect, AL_REVERB_DIFFUSION, clampf(settings.width, AL_REVERB_MIN_DIFFUSION, AL_REVERB_MAX_DIFFUSION));
+    g_reverb.alEffectf(effect, AL_REVERB_DENSITY, clampf(settings.roomSize, AL_REVERB_MIN_DENSITY, AL_REVERB_MAX_DENSITY));
+    g_reverb.alAuxiliaryEffectSloti(g_reverb.slots[slot], AL_EFFECTSLOT_EFFECT, (ALint)effect);
+}
 
-static PlayingSourceLink g_playing_source_links[MAX_PLAYING_SOUNDS];
-static int g_playing_link_count = 0;
+static void reverb_bus_init(bool has_efx) {
+    memset(&g_reverb, 0, sizeof(g_reverb));
+    g_reverb.dryLevel = 1.0f;
+    g_reverb.dryTarget = 1.0f;
+    if (!has_efx) {
+        Console_Printf_Warning("OpenAL EFX is not available, reverb is disabled.");
+        return;
+    }
+
+    g_reverb.alGenEffects = (LPALGENEFFECTS)alGetProcAddress("alGenEffects");
+    g_reverb.alDeleteEffects = (LPALDELETEEFFECTS)alGetProcAddress("alDeleteEffects");
+    g_reverb.alEffecti = (LPALEFFECTI)alGetProcAddress("alEffecti");
+    g_reverb.alEffectf = (LPALEFFECTF)alGetProcAddress("alEffectf");
+    g_reverb.alGenFilters = (LPALGENFILTERS)alGetProcAddress("alGenFilters");
+    g_reverb.alDeleteFilters = (LPALDELETEFILTERS)alGetProcAddress("alDeleteFilters");
+    g_reverb.alFilteri = (LPALFILTERI)alGetProcAddress("alFilteri");
+    g_reverb.alFilterf = (LPALFILTERF)alGetProcAddress("alFilterf");
+    g_reverb.alGenAuxiliaryEffectSlots = (LPALGENAUXILIARYEFFECTSLOTS)alGetProcAddress("alGenAuxiliaryEffectSlots");
+    g_reverb.alDeleteAuxiliaryEffectSlots = (LPALDELETEAUXILIARYEFFECTSLOTS)alGetProcAddress("alDeleteAuxiliaryEffectSlots");
+    g_reverb.alAuxiliaryEffectSloti = (LPALAUXILIARYEFFECTSLOTI)alGetProcAddress("alAuxiliaryEffectSloti");
+    g_reverb.alAuxiliaryEffectSlotf = (LPALAUXILIARYEFFECTSLOTF)alGetProcAddress("alAuxiliaryEffectSlotf");
+    if (!g_reverb.alGenEffects || !g_reverb.alEffecti || !g_reverb.alGenFilters || !g_reverb.alGenAuxiliaryEffectSlots || !g_reverb.alAuxiliaryEffectSloti) {
+        Console_Printf_Warning("OpenAL EFX entry points are missing, reverb is disabled.");
+        return;
+    }
+
+    alGetError();
+    g_reverb.alGenAuxiliaryEffectSlots(REVERB_SLOT_COUNT, g_reverb.slots);
+    g_reverb.alGenEffects(REVERB_SLOT_COUNT, g_reverb.effects);
+    g_reverb.alGenFilters(1, &g_reverb.filter);
+    g_reverb.alFilteri(g_reverb.filter, AL_FILTER_TYPE, AL_FILTER_LOWPASS);
+    g_reverb.alFilterf(g_reverb.filter, AL_LOWPASS_GAINHF, 1.0f);
+    for (int i = 0; i < REVERB_SLOT_COUNT; ++i) {
+        g_reverb.alEffecti(g_reverb.effects[i], AL_EFFECT_TYPE, AL_EFFECT_REVERB);
+        g_reverb.alAuxiliaryEffectSlotf(g_reverb.slots[i], AL_EFFECTSLOT_GAIN, 0.0f);
+        g_reverb.alAuxiliaryEffectSloti(g_reverb.slots[i], AL_EFFECTSLOT_AUXILIARY_SEND_AUTO, AL_TRUE);
+    }
+    if (alGetError() != AL_NO_ERROR) {
+        Console_Printf_Warning("Failed to create OpenAL reverb slots, reverb is disabled.");
+        return;
+    }
+    g_reverb.available = true;
+}
+
+static void reverb_bus_shutdown(void) {
+    if (!g_reverb.available) return;
+    g_reverb.alDeleteAuxiliaryEffectSlots(REVERB_SLOT_COUNT, g_reverb.slots);
+    g_reverb.alDeleteEffects(REVERB_SLOT_COUNT, g_reverb.effects);
+    g_reverb.alDeleteFilters(1, &g_reverb.filter);
+    g_reverb.available = false;
+}
+
+static void reverb_apply_dry(ALuint sourceID) {
+    g_reverb.alFilterf(g_reverb.filter, AL_LOWPASS_GAIN, g_reverb.dryLevel);
+    alSourcei(sourceID, AL_DIRECT_FILTER, (ALint)g_reverb.filter);
+}
+
+static void reverb_apply_sends(ALuint sourceID) {
+    g_reverb.alFilterf(g_reverb.filter, AL_LOWPASS_GAIN, 1.0f);
+    for (int i = 0; i < REVERB_SLOT_COUNT; ++i) {
+        alSource3i(sourceID, AL_AUXILIARY_SEND_FILTER, (ALint)g_reverb.slots[i], i, (ALint)g_reverb.filter);
+    }
+}
+
+static void track_source(ALuint sourceID) {
+    if (!g_reverb.available) return;
+    reverb_apply_dry(sourceID);
+    reverb_apply_sends(sourceID);
+    if (g_playing_source_count < MAX_PLAYING_SOUNDS) {
+        g_playing_sources[g_playing_source_count].sourceID = sourceID;
+        g_playing_source_count++;
+    }
+}
+
+static PlayingSource* find_playing_source(ALuint sourceID) {
+    for (int i = 0; i < g_playing_source_count; ++i) {
+        if (g_playing_sources[i].sourceID == sourceID) return &g_playing_sources[i];
+    }
+    return NULL;
+}
+
+static void untrack_source(ALuint sourceID) {
+    PlayingSource* p = find_playing_source(sourceID);
+    if (p) {
+        *p = g_playing_sources[g_playing_source_count - 1];
+        g_playing_source_count--;
+    }
+}
 
 bool SoundSystem_Init() {
     g_sound_device = alcOpenDevice(NULL);
     if (!g_sound_device) return false;
 
-    g_sound_context = alcCreateContext(g_sound_device, NULL);
+    bool has_efx = alcIsExtensionPresent(g_sound_device, "ALC_EXT_EFX") == ALC_TRUE;
+    ALCint attribs[] = { ALC_MAX_AUXILIARY_SENDS, REVERB_SLOT_COUNT, 0 };
+    g_sound_context = alcCreateContext(g_sound_device, has_efx ? attribs : NULL);
     if (!g_sound_context) {
         alcCloseDevice(g_sound_device);
         return false;
@@ -84,17 +278,36 @@ bool SoundSystem_Init() {
 
     alDistanceModel(AL_INVERSE_DISTANCE_CLAMPED);
 
+    reverb_bus_init(has_efx);
+
+    g_stream_mutex = SDL_CreateMutex();
+    g_stream_thread_running = true;
+    g_stream_thread = SDL_CreateThread(Stream_Thread_Worker, "SoundStreamThread", NULL);
+
     return true;
 }
 
 void SoundSystem_Shutdown() {
+    if (g_stream_thread) {
+        g_stream_thread_running = false;
+        SDL_WaitThread(g_stream_thread, NULL);
+        g_stream_thread = NULL;
+    }
+    for (int i = 0; i < MAX_STREAMING_SOURCES; ++i) {
+        if (g_streams[i].active) stream_destroy(&g_streams[i]);
+    }
+    memset(g_stream_assets, 0, sizeof(g_stream_assets));
+    if (g_stream_mutex) {
+        SDL_DestroyMutex(g_stream_mutex);
+        g_stream_mutex = NULL;
+    }
+
     for (int i = 0; i < g_buffer_count; i++) {
-        free(g_buffers[i].pcmData);
         alDeleteBuffers(1, &g_buffers[i].bufferID);
     }
     g_buffer_count = 0;
-    g_wet_cache_count = 0;
-    g_playing_link_count = 0;
+    g_playing_source_count = 0;
+    reverb_bus_shutdown();
 
     if (g_sound_context) {
         alcMakeContextCurrent(NULL);
@@ -114,8 +327,61 @@ void SoundSystem_UpdateListener(Vec3 position, Vec3 forward, Vec3 up) {
 }
 
 void SoundSystem_SetCurrentReverb(ReverbPreset preset) {
-    if (g_current_reverb_preset != preset) {
-        g_current_reverb_preset = preset;
+    if (g_current_reverb_preset == preset) return;
+    g_current_reverb_preset = preset;
+    if (!g_reverb.available) return;
+
+    // The new preset fades in on the other slot while the current one fades
+    // out, so tails already in the old slot ring out naturally.
+    for (int i = 0; i < REVERB_SLOT_COUNT; ++i) g_reverb.slotTarget[i] = 0.0f;
+    if (preset != REVERB_PRESET_NONE) {
+        int next = 1 - g_reverb.activeSlot;
+        reverb_load_preset(next, preset);
+        g_reverb.activeSlot = next;
+        g_reverb.slotTarget[next] = 1.0f;
+    }
+    g_reverb.dryTarget = DSP_Reverb_GetSettingsForPreset(preset).dryLevel;
+}
+
+void SoundSystem_Update(float deltaTime) {
+    if (!g_reverb.available) return;
+
+    float step = deltaTime / REVERB_CROSSFADE_TIME;
+    for (int i = 0; i < REVERB_SLOT_COUNT; ++i) {
+        float gain = g_reverb.slotGain[i];
+        if (gain == g_reverb.slotTarget[i]) continue;
+        gain = gain < g_reverb.slotTarget[i] ? fminf(gain + step, g_reverb.slotTarget[i]) : fmaxf(gain - step, g_reverb.slotTarget[i]);
+        g_reverb.slotGain[i] = gain;
+        g_reverb.alAuxiliaryEffectSlotf(g_reverb.slots[i], AL_EFFECTSLOT_GAIN, gain);
+    }
+
+    g_reverb.pruneTimer += deltaTime;
+    if (g_reverb.pruneTimer >= REVERB_PRUNE_INTERVAL) {
+        g_reverb.pruneTimer = 0.0f;
+        SDL_LockMutex(g_stream_mutex);
+        for (int i = g_playing_source_count - 1; i >= 0; --i) {
+            ALuint id = g_playing_sources[i].sourceID;
+            ALint state = AL_STOPPED;
+            if (alIsSource(id)) alGetSourcei(id, AL_SOURCE_STATE, &state);
+            else state = AL_NONE;
+            bool stream = false;
+            for (int j = 0; j < MAX_STREAMING_SOURCES; ++j) {
+                if (g_streams[j].active && g_streams[j].sourceID == id) stream = true;
+            }
+            if (state == AL_NONE || (state == AL_STOPPED && !stream)) {
+                g_playing_sources[i] = g_playing_sources[g_playing_source_count - 1];
+                g_playing_source_count--;
+            }
+        }
+        SDL_UnlockMutex(g_stream_mutex);
+    }
+
+    if (g_reverb.dryLevel == g_reverb.dryTarget) return;
+    float dry = g_reverb.dryLevel;
+    dry = dry < g_reverb.dryTarget ? fminf(dry + step, g_reverb.dryTarget) : fmaxf(dry - step, g_reverb.dryTarget);
+    g_reverb.dryLevel = dry;
+    for (int i = 0; i < g_playing_source_count; ++i) {
+        reverb_apply_dry(g_playing_sources[i].sourceID);
     }
 }
 
@@ -126,52 +392,398 @@ static BufferData* find_buffer_data(ALuint bufferID) {
     return NULL;
 }
 
-static unsigned int get_or_create_wet_buffer(unsigned int dryBufferID, ReverbPreset preset) {
-    if (preset == REVERB_PRESET_NONE) {
-        return 0;
+static bool stream_decoder_open(StreamDecoder* dec, const char* path, StreamCodec codec) {
+    memset(dec, 0, sizeof(*dec));
+    dec->codec = codec;
+
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        Console_Printf_Error("ERROR: Could not open sound stream %s", path);
+        return false;
     }
 
-    for (int i = 0; i < g_wet_cache_count; ++i) {
-        if (g_wet_buffer_cache[i].dryBufferID == dryBufferID && g_wet_buffer_cache[i].preset == preset) {
-            return g_wet_buffer_cache[i].wetBufferID;
+    if (codec == STREAM_CODEC_WAV) {
+        char chunkId[4];
+        unsigned int chunkSize;
+        unsigned short audioFormat = 0, numChannels = 0;
+        bool foundFmt = false;
+
+        fread(chunkId, 1, 4, file);
+        fread(&chunkSize, 4, 1, file);
+        fread(chunkId, 1, 4, file);
+        if (strncmp(chunkId, "WAVE", 4) != 0) {
+            fclose(file);
+            return false;
         }
+        while (fread(chunkId, 1, 4, file) == 4 && fread(&chunkSize, 4, 1, file) == 1) {
+            if (strncmp(chunkId, "fmt ", 4) == 0) {
+                unsigned int sampleRate = 0;
+                unsigned short bitsPerSample = 0;
+                fread(&audioFormat, 2, 1, file);
+                fread(&numChannels, 2, 1, file);
+                fread(&sampleRate, 4, 1, file);
+                fseek(file, 6, SEEK_CUR);
+                fread(&bitsPerSample, 2, 1, file);
+                if (chunkSize > 16) fseek(file, chunkSize - 16, SEEK_CUR);
+                dec->channels = numChannels;
+                dec->rate = sampleRate;
+                dec->bitsPerSample = bitsPerSample;
+                foundFmt = true;
+            }
+            else if (strncmp(chunkId, "data", 4) == 0) {
+                dec->wavDataStart = ftell(file);
+                dec->wavDataSize = chunkSize;
+                break;
+            }
+            else {
+                fseek(file, chunkSize, SEEK_CUR);
+            }
+        }
+        if (!foundFmt || dec->wavDataSize == 0 || (dec->bitsPerSample != 8 && dec->bitsPerSample != 16) || dec->channels < 1 || dec->channels > 2) {
+            fclose(file);
+            return false;
+        }
+        dec->file = file;
+        return true;
     }
 
-    BufferData* dryBuffer = find_buffer_data(dryBufferID);
-    if (!dryBuffer || !dryBuffer->pcmData) {
-        return 0;
+    if (codec == STREAM_CODEC_MP3) {
+        fseek(file, 0, SEEK_END);
+        long file_size = ftell(file);
+        fseek(file, 0, SEEK_SET);
+        dec->mp3Data = (unsigned char*)malloc(file_size);
+        if (!dec->mp3Data) {
+            fclose(file);
+            return false;
+        }
+        dec->mp3Size = fread(dec->mp3Data, 1, file_size, file);
+        fclose(file);
+
+        mp3dec_init(&dec->mp3d);
+        mp3dec_frame_info_t info;
+        size_t pos = 0;
+        while (pos < dec->mp3Size) {
+            int samples = mp3dec_decode_frame(&dec->mp3d, dec->mp3Data + pos, (int)(dec->mp3Size - pos), NULL, &info);
+            if (info.frame_bytes == 0) break;
+            if (samples > 0) {
+                dec->channels = info.channels;
+                dec->rate = info.hz;
+                break;
+            }
+            pos += info.frame_bytes;
+        }
+        if (dec->channels == 0) {
+            free(dec->mp3Data);
+            dec->mp3Data = NULL;
+            return false;
+        }
+        mp3dec_init(&dec->mp3d);
+        return true;
     }
 
-    if (dryBuffer->format != AL_FORMAT_MONO16) {
-        return 0;
+    if (ov_open_callbacks(file, &dec->vorbis, NULL, 0, OV_CALLBACKS_DEFAULT) != 0) {
+        Console_Printf_Error("ERROR: Invalid Ogg Vorbis file: %s", path);
+        fclose(file);
+        return false;
     }
+    vorbis_info* info = ov_info(&dec->vorbis, -1);
+    dec->channels = info->channels;
+    dec->rate = info->rate;
+    return true;
+}
 
-    int num_samples = dryBuffer->dataSize / sizeof(short);
-    ReverbSettings settings = DSP_Reverb_GetSettingsForPreset(preset);
+static void stream_decoder_close(StreamDecoder* dec) {
+    if (dec->codec == STREAM_CODEC_WAV) {
+        if (dec->file) fclose(dec->file);
+    }
+    else if (dec->codec == STREAM_CODEC_MP3) {
+        free(dec->mp3Data);
+    }
+    else {
+        ov_clear(&dec->vorbis);
+    }
+    memset(dec, 0, sizeof(*dec));
+}
+
+// Reads up to max_samples mono 16-bit samples, downmixing stereo sources the
+// same way the non-streaming loaders do. Returns 0 at the end of the stream.
+static int stream_decoder_read(StreamDecoder* dec, short* out, int max_samples) {
+    int written = 0;
+
+    if (dec->codec == STREAM_CODEC_WAV) {
+        unsigned char raw[4096];
+        int frame_bytes = dec->channels * (dec->bitsPerSample / 8);
+        while (written < max_samples && dec->wavDataPos < dec->wavDataSize) {
+            unsigned int want = (unsigned int)(max_samples - written) * frame_bytes;
+            if (want > sizeof(raw) / frame_bytes * frame_bytes) want = sizeof(raw) / frame_bytes * frame_bytes;
+            if (want > dec->wavDataSize - dec->wavDataPos) want = dec->wavDataSize - dec->wavDataPos;
+            size_t got = fread(raw, 1, want, dec->file);
+            if (got < (size_t)frame_bytes) break;
+            dec->wavDataPos += (unsigned int)got;
+            int frames = (int)(got / frame_bytes);
+            for (int i = 0; i < frames; ++i) {
+                int sum = 0;
+                for (int c = 0; c < dec->channels; ++c) {
+                    if (dec->bitsPerSample == 8) sum += ((int)raw[i * frame_bytes + c] - 128) << 8;
+                    else sum += ((short*)raw)[i * dec->channels + c];
+                }
+                out[written++] = (short)(sum / dec->channels);
+            }
+        }
+        return written;
+    }
+
+    if (dec->codec == STREAM_CODEC_MP3) {
+        while (written < max_samples) {
+            if (dec->mp3FramePos >= dec->mp3FrameSamples) {
+                if (dec->mp3Pos >= dec->mp3Size) break;
+                mp3dec_frame_info_t info;
+                int samples = mp3dec_decode_frame(&dec->mp3d, dec->mp3Data + dec->mp3Pos, (int)(dec->mp3Size - dec->mp3Pos), dec->mp3Frame, &info);
+                if (info.frame_bytes == 0) {
+                    dec->mp3Pos = dec->mp3Size;
+                    break;
+                }
+                dec->mp3Pos += info.frame_bytes;
+                dec->mp3FrameSamples = samples;
+                dec->mp3FrameChannels = info.channels;
+                dec->mp3FramePos = 0;
+                continue;
+            }
+            if (dec->mp3FrameChannels == 2) {
+                const short* s = &dec->mp3Frame[dec->mp3FramePos * 2];
+                out[written++] = (short)(((int)s[0] + (int)s[1]) / 2);
+            }
+            else {
+                out[written++] = dec->mp3Frame[dec->mp3FramePos];
+            }
+            dec->mp3FramePos++;
+        }
+        return written;
+    }
 
-    ProcessedAudio wet_audio = DSP_Reverb_Process((short*)dryBuffer->pcmData, num_samples, dryBuffer->freq, &settings, true);
-    if (!wet_audio.data) {
+    char raw[4096];
+    int bitstream;
+    int frame_bytes = dec->channels * 2;
+    while (written < max_samples) {
+        int want = (max_samples - written) * frame_bytes;
+        if (want > (int)sizeof(raw)) want = (int)sizeof(raw) / frame_bytes * frame_bytes;
+        long got = ov_read(&dec->vorbis, raw, want, 0, 2, 1, &bitstream);
+        if (got <= 0) break;
+        const short* pcm = (const short*)raw;
+        int frames = (int)(got / frame_bytes);
+        for (int i = 0; i < frames; ++i) {
+            if (dec->channels == 2) out[written++] = (short)(((int)pcm[i * 2] + (int)pcm[i * 2 + 1]) / 2);
+            else out[written++] = pcm[i * dec->channels];
+        }
+    }
+    return written;
+}
+
+static void stream_decoder_seek(StreamDecoder* dec, float seconds) {
+    if (seconds < 0.0f) seconds = 0.0f;
+    size_t target = (size_t)(seconds * dec->rate);
+
+    if (dec->codec == STREAM_CODEC_WAV) {
+        int frame_bytes = dec->channels * (dec->bitsPerSample / 8);
+        size_t offset = target * frame_bytes;
+        if (offset > dec->wavDataSize) offset = dec->wavDataSize;
+        dec->wavDataPos = (unsigned int)offset;
+        fseek(dec->file, dec->wavDataStart + (long)offset, SEEK_SET);
+    }
+    else if (dec->codec == STREAM_CODEC_MP3) {
+        // Walk frame headers without decoding until the frame containing the target.
+        mp3dec_init(&dec->mp3d);
+        size_t pos = 0;
+        size_t samples_before = 0;
+        while (pos < dec->mp3Size) {
+            mp3dec_frame_info_t info;
+            int samples = mp3dec_decode_frame(&dec->mp3d, dec->mp3Data + pos, (int)(dec->mp3Size - pos), NULL, &info);
+            if (info.frame_bytes == 0) {
+                pos = dec->mp3Size;
+                break;
+            }
+            if (samples_before + (size_t)samples > target) break;
+            samples_before += samples;
+            pos += info.frame_bytes;
+        }
+        mp3dec_init(&dec->mp3d);
+        dec->mp3Pos = pos;
+        dec->mp3FrameSamples = 0;
+        dec->mp3FramePos = 0;
+        if (pos < dec->mp3Size && target > samples_before) {
+            short discard[MINIMP3_MAX_SAMPLES_PER_FRAME];
+            stream_decoder_read(dec, discard, (int)(target - samples_before));
+        }
+    }
+    else {
+        ov_pcm_seek(&dec->vorbis, (ogg_int64_t)target);
+    }
+}
+
+// Fills one OpenAL buffer from the decoder. Looping streams wrap back to the
+// start inside the same buffer so the loop point has no gap.
+static bool stream_fill_buffer(StreamingSource* s, ALuint buffer) {
+    short pcm[STREAM_BUFFER_SAMPLES];
+    int total = 0;
+    bool wrapped = false;
+    while (total < STREAM_BUFFER_SAMPLES) {
+        int got = stream_decoder_read(&s->decoder, pcm + total, STREAM_BUFFER_SAMPLES - total);
+        if (got > 0) {
+            total += got;
+            wrapped = false;
+            continue;
+        }
+        if (!s->looping || wrapped) break;
+        stream_decoder_seek(&s->decoder, 0.0f);
+        wrapped = true;
+    }
+    if (total == 0) {
+        s->finished = true;
+        return false;
+    }
+    alBufferData(buffer, AL_FORMAT_MONO16, pcm, total * sizeof(short), s->decoder.rate);
+    return true;
+}
+
+static void stream_service(StreamingSource* s) {
+    if (s->pendingSeek >= 0.0f) {
+        alSourceStop(s->sourceID);
+        alSourcei(s->sourceID, AL_BUFFER, 0);
+        stream_decoder_seek(&s->decoder, s->pendingSeek);
+        s->pendingSeek = -1.0f;
+        s->finished = false;
+        for (int i = 0; i < STREAM_BUFFER_COUNT; ++i) {
+            if (!stream_fill_buffer(s, s->buffers[i])) break;
+            alSourceQueueBuffers(s->sourceID, 1, &s->buffers[i]);
+        }
+        if (s->playing) alSourcePlay(s->sourceID);
+        return;
+    }
+
+    ALint processed = 0;
+    alGetSourcei(s->sourceID, AL_BUFFERS_PROCESSED, &processed);
+    while (processed-- > 0) {
+        ALuint buffer;
+        alSourceUnqueueBuffers(s->sourceID, 1, &buffer);
+        if (!s->finished && stream_fill_buffer(s, buffer)) {
+            alSourceQueueBuffers(s->sourceID, 1, &buffer);
+        }
+    }
+
+    ALint state = 0, queued = 0;
+    alGetSourcei(s->sourceID, AL_SOURCE_STATE, &state);
+    alGetSourcei(s->sourceID, AL_BUFFERS_QUEUED, &queued);
+    // OpenAL stops a source that runs dry before the refill lands. Only that
+    // underrun is resumed; a source that was stopped on purpose stays stopped.
+    if (state == AL_STOPPED && s->playing) {
+        if (queued > 0) alSourcePlay(s->sourceID);
+        else if (s->finished) s->playing = false;
+    }
+}
+
+static int Stream_Thread_Worker(void* data) {
+    while (g_stream_thread_running) {
+        SDL_LockMutex(g_stream_mutex);
+        for (int i = 0; i < MAX_STREAMING_SOURCES; ++i) {
+            if (g_streams[i].active) stream_service(&g_streams[i]);
+        }
+        SDL_UnlockMutex(g_stream_mutex);
+        SDL_Delay(10);
+    }
+    return 0;
+}
+
+static StreamingSource* find_stream(ALuint sourceID) {
+    for (int i = 0; i < MAX_STREAMING_SOURCES; ++i) {
+        if (g_streams[i].active && g_streams[i].sourceID == sourceID) return &g_streams[i];
+    }
+    return NULL;
+}
+
+static void stream_destroy(StreamingSource* s) {
+    alSourceStop(s->sourceID);
+    alSourcei(s->sourceID, AL_BUFFER, 0);
+    alDeleteSources(1, &s->sourceID);
+    alDeleteBuffers(STREAM_BUFFER_COUNT, s->buffers);
+    stream_decoder_close(&s->decoder);
+    memset(s, 0, sizeof(*s));
+}
+
+static unsigned int register_stream_asset(const char* path, StreamCodec codec) {
+    for (int i = 0; i < MAX_STREAM_ASSETS; ++i) {
+        if (!g_stream_assets[i].used) {
+            g_stream_assets[i].used = true;
+            g_stream_assets[i].codec = codec;
+            strncpy(g_stream_assets[i].path, path, sizeof(g_stream_assets[i].path) - 1);
+            g_stream_assets[i].path[sizeof(g_stream_assets[i].path) - 1] = '\0';
+            return STREAM_HANDLE_FLAG | (unsigned int)(i + 1);
+        }
+    }
+    return 0;
+}
+
+static StreamAsset* find_stream_asset(unsigned int handle) {
+    if (!(handle & STREAM_HANDLE_FLAG)) return NULL;
+    unsigned int index = (handle & ~STREAM_HANDLE_FLAG) - 1;
+    if (index >= MAX_STREAM_ASSETS || !g_stream_assets[index].used) return NULL;
+    return &g_stream_assets[index];
+}
+
+// The slot is claimed before the decoder is opened and the decoder is filled
+// in place. OggVorbis_File points into itself, so a live stream must never be
+// copied by value.
+static unsigned int play_stream(StreamAsset* asset, Vec3 position, float volume, float pitch, float maxDistance, bool looping) {
+    SDL_LockMutex(g_stream_mutex);
+    StreamingSource* s = NULL;
+    for (int i = 0; i < MAX_STREAMING_SOURCES; ++i) {
+        if (!g_streams[i].active && !g_streams[i].reserved) {
+            s = &g_streams[i];
+            s->reserved = true;
+            break;
+        }
+    }
+    SDL_UnlockMutex(g_stream_mutex);
+
+    if (!s) {
+        Console_Printf_Warning("Too many streaming sounds playing, skipping %s", asset->path);
         return 0;
     }
 
-    ALuint wetBufferID;
-    alGenBuffers(1, &wetBufferID);
-    alBufferData(wetBufferID, AL_FORMAT_MONO16, wet_audio.data, wet_audio.num_samples * sizeof(short), dryBuffer->freq);
-    free(wet_audio.data);
+    s->looping = looping;
+    s->finished = false;
+    s->playing = true;
+    s->pendingSeek = -1.0f;
+    if (!stream_decoder_open(&s->decoder, asset->path, asset->codec)) {
+        memset(s, 0, sizeof(*s));
+        return 0;
+    }
+
+    alGenSources(1, &s->sourceID);
+    alGenBuffers(STREAM_BUFFER_COUNT, s->buffers);
+    alSource3f(s->sourceID, AL_POSITION, position.x, position.y, position.z);
+    alSourcef(s->sourceID, AL_GAIN, volume);
+    alSourcef(s->sourceID, AL_PITCH, pitch);
+    alSourcef(s->sourceID, AL_MAX_DISTANCE, maxDistance);
+    alSourcei(s->sourceID, AL_LOOPING, AL_FALSE);
+    for (int i = 0; i < STREAM_BUFFER_COUNT; ++i) {
+        if (!stream_fill_buffer(s, s->buffers[i])) break;
+        alSourceQueueBuffers(s->sourceID, 1, &s->buffers[i]);
+    }
+    alSourcePlay(s->sourceID);
 
     if (alGetError() != AL_NO_ERROR) {
-        alDeleteBuffers(1, &wetBufferID);
+        stream_destroy(s);
         return 0;
     }
 
-    if (g_wet_cache_count < MAX_WET_CACHE_ENTRIES) {
-        g_wet_buffer_cache[g_wet_cache_count].dryBufferID = dryBufferID;
-        g_wet_buffer_cache[g_wet_cache_count].preset = preset;
-        g_wet_buffer_cache[g_wet_cache_count].wetBufferID = wetBufferID;
-        g_wet_cache_count++;
-    }
+    ALuint sourceID = s->sourceID;
+    SDL_LockMutex(g_stream_mutex);
+    s->active = true;
+    s->reserved = false;
+    SDL_UnlockMutex(g_stream_mutex);
 
-    return wetBufferID;
+    track_source(sourceID);
+    return sourceID;
 }
 
 static unsigned int internal_LoadMP3(const char* path) {
@@ -211,9 +823,9 @@ static unsigned int internal_LoadMP3(const char* path) {
     unsigned char* buf_ptr = file_buffer;
     int bytes_left = file_size;
 
-    while (bytes_left > 0 && (samples = mp3dec_decode_frame(&mp3d, buf_ptr, bytes_left, NULL, &info)) > 0) {
-        if (pcm_size + (size_t)samples * info.channels > pcm_capacity) {
-            pcm_capacity = pcm_capacity * 2 + (size_t)samples * info.channels;
+    while (bytes_left > 0) {
+        if (pcm_size + MINIMP3_MAX_SAMPLES_PER_FRAME > pcm_capacity) {
+            pcm_capacity = pcm_capacity * 2 + MINIMP3_MAX_SAMPLES_PER_FRAME;
             short* new_pcm_buffer = (short*)realloc(pcm_buffer, pcm_capacity * sizeof(short));
             if (!new_pcm_buffer) {
                 free(pcm_buffer);
@@ -223,7 +835,8 @@ static unsigned int internal_LoadMP3(const char* path) {
             pcm_buffer = new_pcm_buffer;
         }
 
-        mp3dec_decode_frame(&mp3d, buf_ptr, bytes_left, pcm_buffer + pcm_size, &info);
+        samples = mp3dec_decode_frame(&mp3d, buf_ptr, bytes_left, pcm_buffer + pcm_size, &info);
+        if (samples <= 0) break;
 
         pcm_size += samples * info.channels;
         buf_ptr += info.frame_bytes;
@@ -261,22 +874,20 @@ static unsigned int internal_LoadMP3(const char* path) {
     alGenBuffers(1, &bufferID);
     alBufferData(bufferID, format, final_pcm_buffer, final_pcm_size_bytes, info.hz);
 
+    free(final_pcm_buffer);
     if (alGetError() != AL_NO_ERROR) {
-        free(final_pcm_buffer);
         alDeleteBuffers(1, &bufferID);
         return 0;
     }
 
     if (g_buffer_count < MAX_BUFFERS) {
         g_buffers[g_buffer_count].bufferID = bufferID;
-        g_buffers[g_buffer_count].pcmData = final_pcm_buffer;
         g_buffers[g_buffer_count].dataSize = final_pcm_size_bytes;
         g_buffers[g_buffer_count].format = format;
         g_buffers[g_buffer_count].freq = info.hz;
         g_buffer_count++;
     }
     else {
-        free(final_pcm_buffer);
         alDeleteBuffers(1, &bufferID);
         return 0;
     }
@@ -347,22 +958,20 @@ static unsigned int internal_LoadOGG(const char* path) {
     alBufferData(bufferID, format, pcm_data, total_bytes, info->rate);
     ov_clear(&vorbis);
 
+    free(pcm_data);
     if (alGetError() != AL_NO_ERROR) {
-        free(pcm_data);
         alDeleteBuffers(1, &bufferID);
         return 0;
     }
 
     if (g_buffer_count < MAX_BUFFERS) {
         g_buffers[g_buffer_count].bufferID = bufferID;
-        g_buffers[g_buffer_count].pcmData = pcm_data;
         g_buffers[g_buffer_count].dataSize = total_bytes;
         g_buffers[g_buffer_count].format = format;
         g_buffers[g_buffer_count].freq = info->rate;
         g_buffer_count++;
     }
     else {
-        free(pcm_data);
         alDeleteBuffers(1, &bufferID);
         return 0;
     }
@@ -436,22 +1045,20 @@ static unsigned int internal_LoadWAV(const char* path) {
     alGenBuffers(1, &bufferID);
     alBufferData(bufferID, format, data, dataSize, sampleRate);
 
+    free(data);
     if (alGetError() != AL_NO_ERROR) {
-        free(data);
         alDeleteBuffers(1, &bufferID);
         return 0;
     }
 
     if (g_buffer_count < MAX_BUFFERS) {
         g_buffers[g_buffer_count].bufferID = bufferID;
-        g_buffers[g_buffer_count].pcmData = data;
         g_buffers[g_buffer_count].dataSize = dataSize;
         g_buffers[g_buffer_count].format = format;
         g_buffers[g_buffer_count].freq = sampleRate;
         g_buffer_count++;
     }
     else {
-        free(data);
         alDeleteBuffers(1, &bufferID);
         return 0;
     }
@@ -459,6 +1066,20 @@ static unsigned int internal_LoadWAV(const char* path) {
     return bufferID;
 }
 
+void SoundSystem_SetStreamingThreshold(unsigned int bytes) {
+    g_stream_threshold_bytes = bytes;
+}
+
+static bool should_stream(const char* path) {
+    if (g_stream_threshold_bytes == 0) return false;
+    FILE* file = fopen(path, "rb");
+    if (!file) return false;
+    fseek(file, 0, SEEK_END);
+    long file_size = ftell(file);
+    fclose(file);
+    return file_size >= (long)g_stream_threshold_bytes;
+}
+
 unsigned int SoundSystem_LoadSound(const char* path) {
     const char* ext = strrchr(path, '.');
     if (!ext) {
@@ -466,6 +1087,19 @@ unsigned int SoundSystem_LoadSound(const char* path) {
         return 0;
     }
 
+    if (should_stream(path)) {
+        StreamCodec codec;
+        bool supported = true;
+        if (_stricmp(ext, ".wav") == 0) codec = STREAM_CODEC_WAV;
+        else if (_stricmp(ext, ".mp3") == 0) codec = STREAM_CODEC_MP3;
+        else if (_stricmp(ext, ".ogg") == 0) codec = STREAM_CODEC_OGG;
+        else supported = false;
+        if (supported) {
+            unsigned int handle = register_stream_asset(path, codec);
+            if (handle != 0) return handle;
+        }
+    }
+
     if (_stricmp(ext, ".wav") == 0) {
         return internal_LoadWAV(path);
     }
@@ -480,81 +1114,43 @@ unsigned int SoundSystem_LoadSound(const char* path) {
     return 0;
 }
 
-static ALuint find_wet_source(ALuint drySourceID) {
-    for (int i = 0; i < g_playing_link_count; ++i) {
-        if (g_playing_source_links[i].drySourceID == drySourceID) {
-            return g_playing_source_links[i].wetSourceID;
-        }
-    }
-    return 0;
-}
-
-static void remove_link(ALuint drySourceID) {
-    int found_index = -1;
-    for (int i = 0; i < g_playing_link_count; ++i) {
-        if (g_playing_source_links[i].drySourceID == drySourceID) {
-            found_index = i;
-            break;
-        }
-    }
-    if (found_index != -1) {
-        if (g_playing_link_count > 1) {
-            g_playing_source_links[found_index] = g_playing_source_links[g_playing_link_count - 1];
-        }
-        g_playing_link_count--;
-    }
-}
-
 unsigned int SoundSystem_PlaySound(unsigned int bufferID, Vec3 position, float volume, float pitch, float maxDistance, bool looping) {
     if (bufferID == 0) return 0;
 
-    ReverbSettings settings = DSP_Reverb_GetSettingsForPreset(g_current_reverb_preset);
-    unsigned int wetBufferID = get_or_create_wet_buffer(bufferID, g_current_reverb_preset);
-
-    PlayingSound p_sound = { 0, 0 };
-    alGenSources(1, &p_sound.drySourceID);
-
-    alSourcei(p_sound.drySourceID, AL_BUFFER, bufferID);
-    alSource3f(p_sound.drySourceID, AL_POSITION, position.x, position.y, position.z);
-    alSourcef(p_sound.drySourceID, AL_GAIN, volume * settings.dryLevel);
-    alSourcef(p_sound.drySourceID, AL_PITCH, pitch);
-    alSourcef(p_sound.drySourceID, AL_MAX_DISTANCE, maxDistance);
-    alSourcei(p_sound.drySourceID, AL_LOOPING, looping ? AL_TRUE : AL_FALSE);
-    alSourcePlay(p_sound.drySourceID);
-
-    if (wetBufferID != 0) {
-        alGenSources(1, &p_sound.wetSourceID);
-        alSourcei(p_sound.wetSourceID, AL_BUFFER, wetBufferID);
-        alSource3f(p_sound.wetSourceID, AL_POSITION, position.x, position.y, position.z);
-        alSourcef(p_sound.wetSourceID, AL_GAIN, volume * settings.wetLevel);
-        alSourcef(p_sound.wetSourceID, AL_PITCH, pitch);
-        alSourcef(p_sound.wetSourceID, AL_MAX_DISTANCE, maxDistance);
-        alSourcei(p_sound.wetSourceID, AL_LOOPING, looping ? AL_TRUE : AL_FALSE);
-        alSourcePlay(p_sound.wetSourceID);
-
-        if (g_playing_link_count < MAX_PLAYING_SOUNDS) {
-            g_playing_source_links[g_playing_link_count].drySourceID = p_sound.drySourceID;
-            g_playing_source_links[g_playing_link_count].wetSourceID = p_sound.wetSourceID;
-            g_playing_link_count++;
-        }
+    if (bufferID & STREAM_HANDLE_FLAG) {
+        StreamAsset* asset = find_stream_asset(bufferID);
+        return asset ? play_stream(asset, position, volume, pitch, maxDistance, looping) : 0;
     }
 
+    ALuint sourceID = 0;
+    alGenSources(1, &sourceID);
+
+    alSourcei(sourceID, AL_BUFFER, bufferID);
+    alSource3f(sourceID, AL_POSITION, position.x, position.y, position.z);
+    alSourcef(sourceID, AL_GAIN, volume);
+    alSourcef(sourceID, AL_PITCH, pitch);
+    alSourcef(sourceID, AL_MAX_DISTANCE, maxDistance);
+    alSourcei(sourceID, AL_LOOPING, looping ? AL_TRUE : AL_FALSE);
+    track_source(sourceID);
+    alSourcePlay(sourceID);
+
     if (alGetError() != AL_NO_ERROR) {
-        alDeleteSources(1, &p_sound.drySourceID);
-        if (p_sound.wetSourceID != 0) alDeleteSources(1, &p_sound.wetSourceID);
+        untrack_source(sourceID);
+        alDeleteSources(1, &sourceID);
         return 0;
     }
 
-    return p_sound.drySourceID;
+    return sourceID;
 }
 
 void SoundSystem_SetSourceLooping(unsigned int sourceID, bool loop) {
     if (sourceID == 0) return;
+    SDL_LockMutex(g_stream_mutex);
+    StreamingSource* stream = find_stream(sourceID);
+    if (stream) stream->looping = loop;
+    SDL_UnlockMutex(g_stream_mutex);
+    if (stream) return;
     alSourcei(sourceID, AL_LOOPING, loop ? AL_TRUE : AL_FALSE);
-    ALuint wetSourceID = find_wet_source(sourceID);
-    if (wetSourceID != 0) {
-        alSourcei(wetSourceID, AL_LOOPING, loop ? AL_TRUE : AL_FALSE);
-    }
 }
 
 void SoundSystem_SetMasterVolume(float volume) {
@@ -565,51 +1161,58 @@ void SoundSystem_SetMasterVolume(float volume) {
 
 void SoundSystem_SetSourceProperties(unsigned int sourceID, float volume, float pitch, float maxDistance) {
     if (sourceID == 0) return;
-    ReverbSettings settings = DSP_Reverb_GetSettingsForPreset(g_current_reverb_preset);
-    alSourcef(sourceID, AL_GAIN, volume * settings.dryLevel);
+    alSourcef(sourceID, AL_GAIN, volume);
     alSourcef(sourceID, AL_PITCH, pitch);
     alSourcef(sourceID, AL_MAX_DISTANCE, maxDistance);
-    ALuint wetSourceID = find_wet_source(sourceID);
-    if (wetSourceID != 0) {
-        alSourcef(wetSourceID, AL_GAIN, volume * settings.wetLevel);
-        alSourcef(wetSourceID, AL_PITCH, pitch);
-        alSourcef(wetSourceID, AL_MAX_DISTANCE, maxDistance);
-    }
 }
 
 void SoundSystem_SetSourcePosition(unsigned int sourceID, Vec3 position) {
     if (sourceID == 0) return;
     alSource3f(sourceID, AL_POSITION, position.x, position.y, position.z);
-    ALuint wetSourceID = find_wet_source(sourceID);
-    if (wetSourceID != 0) {
-        alSource3f(wetSourceID, AL_POSITION, position.x, position.y, position.z);
-    }
+}
+
+void SoundSystem_StopSound(unsigned int sourceID) {
+    if (sourceID == 0) return;
+    SDL_LockMutex(g_stream_mutex);
+    StreamingSource* stream = find_stream(sourceID);
+    if (stream) stream->playing = false;
+    alSourceStop(sourceID);
+    SDL_UnlockMutex(g_stream_mutex);
+}
+
+void SoundSystem_SeekSource(unsigned int sourceID, float seconds) {
+    if (sourceID == 0) return;
+    SDL_LockMutex(g_stream_mutex);
+    StreamingSource* stream = find_stream(sourceID);
+    if (stream) stream->pendingSeek = seconds < 0.0f ? 0.0f : seconds;
+    SDL_UnlockMutex(g_stream_mutex);
+    if (stream) return;
+
+    alSourcef(sourceID, AL_SEC_OFFSET, seconds);
 }
 
 void SoundSystem_DeleteSource(unsigned int sourceID) {
     if (sourceID == 0) return;
-    ALuint wetSourceID = find_wet_source(sourceID);
-    if (wetSourceID != 0) {
-        alDeleteSources(1, &wetSourceID);
-        remove_link(sourceID);
-    }
+    SDL_LockMutex(g_stream_mutex);
+    untrack_source(sourceID);
+    StreamingSource* stream = find_stream(sourceID);
+    if (stream) stream_destroy(stream);
+    SDL_UnlockMutex(g_stream_mutex);
+    if (stream) return;
     alDeleteSources(1, &sourceID);
 }
 
 void SoundSystem_DeleteBuffer(unsigned int bufferID) {
     if (bufferID == 0) return;
 
-    for (int i = g_wet_cache_count - 1; i >= 0; i--) {
-        if (g_wet_buffer_cache[i].dryBufferID == bufferID) {
-            alDeleteBuffers(1, &g_wet_buffer_cache[i].wetBufferID);
-            g_wet_buffer_cache[i] = g_wet_buffer_cache[g_wet_cache_count - 1];
-            g_wet_cache_count--;
-        }
+    if (bufferID & STREAM_HANDLE_FLAG) {
+        StreamAsset* asset = find_stream_asset(bufferID);
+        if (asset) memset(asset, 0, sizeof(*asset));
+        return;
     }
 
     BufferData* buf = find_buffer_data(bufferID);
     if (buf) {
-        free(buf->pcmData);
         alDeleteBuffers(1, &bufferID);
 
         int index = buf - g_buffers;
@@ -43,20 +43,19 @@ extern "C" {
         unsigned int bufferID;
     } Sound;
 
-    typedef struct {
-        unsigned int drySourceID;
-        unsigned int wetSourceID;
-    } PlayingSound;
-
     SOUND_API bool SoundSystem_Init();
     SOUND_API void SoundSystem_Shutdown();
     SOUND_API void SoundSystem_UpdateListener(Vec3 position, Vec3 forward, Vec3 up);
     SOUND_API void SoundSystem_SetCurrentReverb(ReverbPreset preset);
+    SOUND_API void SoundSystem_Update(float deltaTime);
     SOUND_API unsigned int SoundSystem_LoadSound(const char* path);
     SOUND_API unsigned int SoundSystem_PlaySound(unsigned int bufferID, Vec3 position, float volume, float pitch, float maxDistance, bool looping);
     SOUND_API void SoundSystem_SetSourcePosition(unsigned int sourceID, Vec3 position);
     SOUND_API void SoundSystem_SetSourceProperties(unsigned int sourceID, float volume, float pitch, float maxDistance);
     SOUND_API void SoundSystem_SetSourceLooping(unsigned int sourceID, bool loop);
+    SOUND_API void SoundSystem_StopSound(unsigned int sourceID);
+    SOUND_API void SoundSystem_SeekSource(unsigned int sourceID, float seconds);
+    SOUND_API void SoundSystem_SetStreamingThreshold(unsigned int bytes);
     SOUND_API void SoundSystem_SetMasterVolume(float volume);
     SOUND_API void SoundSystem_DeleteSource(unsigned int sourceID);
     SOUND_API void SoundSystem_DeleteBuffer(unsigned int bufferID);
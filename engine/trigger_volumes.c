@@ -0,0 +1,354 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 Soft Sprint Studios
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "trigger_volumes.h"
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Entity brushes are bucketed once into a hashed uniform grid keyed by their
+// world bounds. A point query only looks at the brushes sharing its cell, so
+// trigger, DSP zone and water checks no longer transform every vertex of
+// every volume each tick. Volumes too large for the grid sit in a short list
+// that is always tested, and brushes that start moving (doors, plats,
+// rotators) leave the grid for a list whose bounds are refreshed whenever
+// their matrix changes.
+
+#define TRIGGER_CELL_SIZE 4.0f
+#define TRIGGER_MAX_CELLS_PER_VOLUME 64
+#define TRIGGER_MAX_QUERY 1024
+
+typedef enum {
+    VOLUME_GRID,
+    VOLUME_LARGE,
+    VOLUME_MOVING
+} VolumePlacement;
+
+typedef struct {
+    int brush;
+    EntityClassId classId;
+    Vec3 min;
+    Vec3 max;
+    Mat4 matrix;
+    VolumePlacement placement;
+} TriggerVolume;
+
+typedef struct {
+    int x, y, z;
+    int head;
+    bool used;
+} GridCell;
+
+typedef struct {
+    int volume;
+    int next;
+} GridEntry;
+
+static TriggerVolume* g_volumes = NULL;
+static int g_num_volumes = 0;
+static int g_volume_capacity = 0;
+static int g_volume_of_brush[MAX_BRUSHES];
+
+static GridCell* g_cells = NULL;
+static int g_cell_capacity = 0;
+static GridEntry* g_entries = NULL;
+static int g_num_entries = 0;
+static int g_entry_capacity = 0;
+
+static int g_large[MAX_BRUSHES];
+static int g_num_large = 0;
+static int g_moving[MAX_BRUSHES];
+static int g_num_moving = 0;
+
+static int g_touching[MAX_BRUSHES];
+static int g_num_touching = 0;
+static int g_entered[MAX_BRUSHES];
+static int g_exited[MAX_BRUSHES];
+static int g_inside[TRIGGER_MAX_QUERY];
+
+static bool g_dirty = true;
+
+static void compute_bounds(const Brush* b, Vec3* min_out, Vec3* max_out) {
+    Vec3 min_aabb = { FLT_MAX, FLT_MAX, FLT_MAX };
+    Vec3 max_aabb = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+    for (int v = 0; v < b->numVertices; ++v) {
+        Vec3 world_v = mat4_mul_vec3(&b->modelMatrix, b->vertices[v].pos);
+        min_aabb.x = fminf(min_aabb.x, world_v.x);
+        min_aabb.y = fminf(min_aabb.y, world_v.y);
+        min_aabb.z = fminf(min_aabb.z, world_v.z);
+        max_aabb.x = fmaxf(max_aabb.x, world_v.x);
+        max_aabb.y = fmaxf(max_aabb.y, world_v.y);
+        max_aabb.z = fmaxf(max_aabb.z, world_v.z);
+    }
+    *min_out = min_aabb;
+    *max_out = max_aabb;
+}
+
+static bool contains_point(const TriggerVolume* vol, Vec3 p) {
+    return p.x >= vol->min.x && p.x <= vol->max.x &&
+        p.y >= vol->min.y && p.y <= vol->max.y &&
+        p.z >= vol->min.z && p.z <= vol->max.z;
+}
+
+static int cell_coord(float v) {
+    return (int)floorf(v / TRIGGER_CELL_SIZE);
+}
+
+static unsigned int cell_hash(int x, int y, int z) {
+    return ((unsigned int)x * 73856093u) ^ ((unsigned int)y * 19349663u) ^ ((unsigned int)z * 83492791u);
+}
+
+static GridCell* find_cell(int x, int y, int z, bool create) {
+    if (g_cell_capacity == 0) return NULL;
+    unsigned int mask = (unsigned int)g_cell_capacity - 1;
+    unsigned int slot = cell_hash(x, y, z) & mask;
+    while (g_cells[slot].used) {
+        GridCell* cell = &g_cells[slot];
+        if (cell->x == x && cell->y == y && cell->z == z) return cell;
+        slot = (slot + 1) & mask;
+    }
+    if (!create) return NULL;
+    GridCell* cell = &g_cells[slot];
+    cell->used = true;
+    cell->x = x;
+    cell->y = y;
+    cell->z = z;
+    cell->head = -1;
+    return cell;
+}
+
+static long long volume_cell_count(const TriggerVolume* vol) {
+    long long nx = (long long)cell_coord(vol->max.x) - cell_coord(vol->min.x) + 1;
+    long long ny = (long long)cell_coord(vol->max.y) - cell_coord(vol->min.y) + 1;
+    long long nz = (long long)cell_coord(vol->max.z) - cell_coord(vol->min.z) + 1;
+    return nx * ny * nz;
+}
+
+static void rebuild(Scene* scene) {
+    const int* entity_brushes;
+    int num_entity_brushes = Scene_GetEntityBrushes(scene, &entity_brushes);
+
+    if (num_entity_brushes > g_volume_capacity) {
+        TriggerVolume* volumes = realloc(g_volumes, sizeof(TriggerVolume) * num_entity_brushes);
+        if (!volumes) return;
+        g_volumes = volumes;
+        g_volume_capacity = num_entity_brushes;
+    }
+
+    for (int i = 0; i < scene->numBrushes; ++i) g_volume_of_brush[i] = -1;
+    g_num_volumes = 0;
+    g_num_large = 0;
+    g_num_moving = 0;
+    g_num_entries = 0;
+
+    int total_entries = 0;
+    for (int k = 0; k < num_entity_brushes; ++k) {
+        int i = entity_brushes[k];
+        Brush* b = &scene->brushes[i];
+        if (b->numVertices == 0) continue;
+
+        TriggerVolume* vol = &g_volumes[g_num_volumes];
+        vol->brush = i;
+        vol->classId = b->classId;
+        vol->matrix = b->modelMatrix;
+        compute_bounds(b, &vol->min, &vol->max);
+        long long cells = volume_cell_count(vol);
+        if (cells > TRIGGER_MAX_CELLS_PER_VOLUME) {
+            vol->placement = VOLUME_LARGE;
+            g_large[g_num_large++] = g_num_volumes;
+        }
+        else {
+            vol->placement = VOLUME_GRID;
+            total_entries += (int)cells;
+        }
+        g_volume_of_brush[i] = g_num_volumes++;
+    }
+
+    if (total_entries > g_entry_capacity) {
+        GridEntry* entries = realloc(g_entries, sizeof(GridEntry) * total_entries);
+        if (!entries) return;
+        g_entries = entries;
+        g_entry_capacity = total_entries;
+    }
+    int wanted_cells = 16;
+    while (wanted_cells < total_entries * 2) wanted_cells <<= 1;
+    if (wanted_cells > g_cell_capacity) {
+        GridCell* cells = realloc(g_cells, sizeof(GridCell) * wanted_cells);
+        if (!cells) return;
+        g_cells = cells;
+        g_cell_capacity = wanted_cells;
+    }
+    memset(g_cells, 0, sizeof(GridCell) * g_cell_capacity);
+
+    for (int v = 0; v < g_num_volumes; ++v) {
+        TriggerVolume* vol = &g_volumes[v];
+        if (vol->placement != VOLUME_GRID) continue;
+        int x0 = cell_coord(vol->min.x), x1 = cell_coord(vol->max.x);
+        int y0 = cell_coord(vol->min.y), y1 = cell_coord(vol->max.y);
+        int z0 = cell_coord(vol->min.z), z1 = cell_coord(vol->max.z);
+        for (int x = x0; x <= x1; ++x) {
+            for (int y = y0; y <= y1; ++y) {
+                for (int z = z0; z <= z1; ++z) {
+                    GridCell* cell = find_cell(x, y, z, true);
+                    GridEntry* entry = &g_entries[g_num_entries];
+                    entry->volume = v;
+                    entry->next = cell->head;
+                    cell->head = g_num_entries++;
+                }
+            }
+        }
+    }
+
+    g_num_touching = 0;
+    for (int v = 0; v < g_num_volumes; ++v) {
+        if (scene->brushes[g_volumes[v].brush].runtime_playerIsTouching) {
+            g_touching[g_num_touching++] = g_volumes[v].brush;
+        }
+    }
+
+    g_dirty = false;
+}
+
+void TriggerVolumes_MarkDirty(void) {
+    g_dirty = true;
+}
+
+void TriggerVolumes_Update(Scene* scene) {
+    if (g_dirty) {
+        rebuild(scene);
+        return;
+    }
+    for (int v = 0; v < g_num_volumes; ++v) {
+        TriggerVolume* vol = &g_volumes[v];
+        Brush* b = &scene->brushes[vol->brush];
+        if (memcmp(&vol->matrix, &b->modelMatrix, sizeof(Mat4)) == 0) continue;
+        vol->matrix = b->modelMatrix;
+        compute_bounds(b, &vol->min, &vol->max);
+        if (vol->placement != VOLUME_MOVING) {
+            vol->placement = VOLUME_MOVING;
+            g_moving[g_num_moving++] = v;
+        }
+    }
+}
+
+static int gather_candidates(Vec3 point, int* out, int max_out) {
+    int count = 0;
+    GridCell* cell = find_cell(cell_coord(point.x), cell_coord(point.y), cell_coord(point.z), false);
+    if (cell) {
+        for (int e = cell->head; e != -1 && count < max_out; e = g_entries[e].next) {
+            int v = g_entries[e].volume;
+            if (g_volumes[v].placement == VOLUME_GRID) out[count++] = v;
+        }
+    }
+    for (int k = 0; k < g_num_large && count < max_out; ++k) {
+        if (g_volumes[g_large[k]].placement == VOLUME_LARGE) out[count++] = g_large[k];
+    }
+    for (int k = 0; k < g_num_moving && count < max_out; ++k) {
+        out[count++] = g_moving[k];
+    }
+    return count;
+}
+
+static void sort_indices(int* indices, int count) {
+    for (int i = 1; i < count; ++i) {
+        int value = indices[i];
+        int j = i - 1;
+        while (j >= 0 && indices[j] > value) {
+            indices[j + 1] = indices[j];
+            --j;
+        }
+        indices[j + 1] = value;
+    }
+}
+
+int TriggerVolumes_QueryPoint(Vec3 point, EntityClassId classId, int* indices_out, int max_indices) {
+    if (g_dirty) return 0;
+    int candidates[TRIGGER_MAX_QUERY];
+    int num_candidates = gather_candidates(point, candidates, TRIGGER_MAX_QUERY);
+    int matches[TRIGGER_MAX_QUERY];
+    int count = 0;
+    for (int k = 0; k < num_candidates; ++k) {
+        TriggerVolume* vol = &g_volumes[candidates[k]];
+        if (classId != ENTITY_CLASS_NONE && vol->classId != classId) continue;
+        if (!contains_point(vol, point)) continue;
+        matches[count++] = vol->brush;
+    }
+    sort_indices(matches, count);
+    if (count > max_indices) count = max_indices;
+    memcpy(indices_out, matches, sizeof(int) * count);
+    return count;
+}
+
+bool TriggerVolumes_GetBounds(int brush_index, Vec3* min_out, Vec3* max_out) {
+    if (g_dirty || brush_index < 0 || brush_index >= MAX_BRUSHES) return false;
+    int v = g_volume_of_brush[brush_index];
+    if (v < 0) return false;
+    *min_out = g_volumes[v].min;
+    *max_out = g_volumes[v].max;
+    return true;
+}
+
+void TriggerVolumes_UpdateOverlaps(Scene* scene, Vec3 point, TriggerOverlaps* out) {
+    int num_entered = 0;
+    int num_exited = 0;
+    int num_inside = 0;
+
+    if (!g_dirty) {
+        int kept = 0;
+        for (int k = 0; k < g_num_touching; ++k) {
+            int i = g_touching[k];
+            Brush* b = &scene->brushes[i];
+            if (!b->runtime_playerIsTouching) continue;
+            int v = g_volume_of_brush[i];
+            if (b->runtime_active && (v < 0 || !contains_point(&g_volumes[v], point))) {
+                b->runtime_playerIsTouching = false;
+                g_exited[num_exited++] = i;
+                continue;
+            }
+            g_touching[kept++] = i;
+        }
+        g_num_touching = kept;
+
+        int found[TRIGGER_MAX_QUERY];
+        int num_found = TriggerVolumes_QueryPoint(point, ENTITY_CLASS_NONE, found, TRIGGER_MAX_QUERY);
+        for (int k = 0; k < num_found; ++k) {
+            int i = found[k];
+            Brush* b = &scene->brushes[i];
+            if (!b->runtime_active) continue;
+            g_inside[num_inside++] = i;
+            if (!b->runtime_playerIsTouching) {
+                b->runtime_playerIsTouching = true;
+                g_entered[num_entered++] = i;
+                g_touching[g_num_touching++] = i;
+            }
+        }
+    }
+
+    out->entered = g_entered;
+    out->numEntered = num_entered;
+    out->exited = g_exited;
+    out->numExited = num_exited;
+    out->inside = g_inside;
+    out->numInside = num_inside;
+}
@@ -0,0 +1,68 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 Soft Sprint Studios
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+#ifndef TRIGGER_VOLUMES_H
+#define TRIGGER_VOLUMES_H
+
+//----------------------------------------//
+// Brief: Uniform grid broadphase over entity brush volumes
+//----------------------------------------//
+
+#include <stdbool.h>
+#include "map.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    // Result of one player overlap update. The index lists point into storage
+    // owned by the module and stay valid until the next update.
+    typedef struct {
+        const int* entered;
+        int numEntered;
+        const int* exited;
+        int numExited;
+        const int* inside;
+        int numInside;
+    } TriggerOverlaps;
+
+    // Forces a full rebuild on the next update. Called whenever the entity
+    // class lists are refreshed.
+    void TriggerVolumes_MarkDirty(void);
+    // Rebuilds the grid if needed and refreshes the bounds of volumes whose
+    // transform changed since the last update.
+    void TriggerVolumes_Update(Scene* scene);
+    // Walks the volumes around the point, flags runtime_playerIsTouching on
+    // active brushes and reports which ones were entered, left or occupied.
+    void TriggerVolumes_UpdateOverlaps(Scene* scene, Vec3 point, TriggerOverlaps* out);
+    // Writes the brushes of the given class whose bounds contain the point, in
+    // ascending brush order. ENTITY_CLASS_NONE matches every class.
+    int TriggerVolumes_QueryPoint(Vec3 point, EntityClassId classId, int* indices_out, int max_indices);
+    bool TriggerVolumes_GetBounds(int brush_index, Vec3* min_out, Vec3* max_out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TRIGGER_VOLUMES_H
\ No newline at end of file
@@ -0,0 +1,72 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 Soft Sprint Studios
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifdef PLATFORM_WINDOWS
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+#include <iostream>
+
+using EngineBakeMainFunc = int(*)(int argc, char* argv[]);
+
+int main(int argc, char* argv[]) {
+#ifdef PLATFORM_WINDOWS
+    HMODULE engineLib = LoadLibraryA("engine.dll");
+    if (!engineLib) {
+        std::cerr << "Failed to load engine.dll" << std::endl;
+        return -1;
+    }
+
+    auto Engine_BakeMain = reinterpret_cast<EngineBakeMainFunc>(GetProcAddress(engineLib, "Engine_BakeMain"));
+    if (!Engine_BakeMain) {
+        std::cerr << "Failed to find Engine_BakeMain in engine.dll" << std::endl;
+        FreeLibrary(engineLib);
+        return -1;
+    }
+
+    int result = Engine_BakeMain(argc, argv);
+    FreeLibrary(engineLib);
+    return result;
+#else
+    void* engineLib = dlopen("./libengine.so", RTLD_NOW);
+    if (!engineLib) {
+        std::cerr << "Failed to load libengine.so: " << dlerror() << std::endl;
+        return -1;
+    }
+
+    dlerror();
+    auto Engine_BakeMain = reinterpret_cast<EngineBakeMainFunc>(dlsym(engineLib, "Engine_BakeMain"));
+    if (const char* error = dlerror()) {
+        std::cerr << "Failed to find Engine_BakeMain: " << error << std::endl;
+        dlclose(engineLib);
+        return -1;
+    }
+
+    int result = Engine_BakeMain(argc, argv);
+    dlclose(engineLib);
+    return result;
+#endif
+}
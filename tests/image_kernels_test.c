@@ -0,0 +1,283 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 Soft Sprint Studios
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <math.h>
+#include <time.h>
+#include "math_lib/image_kernels.h"
+
+// Checks the vectorized image kernels against the scalar filters the
+// lightmapper used before them, then reports their throughput. Run with
+// "--bench" for larger images and more repetitions.
+
+#define TOLERANCE 1e-4f
+
+static int g_failures = 0;
+
+static int clampi(int v, int lo, int hi) {
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+static float* make_image(int width, int height, int channels, unsigned int seed) {
+    float* data = (float*)malloc(sizeof(float) * width * height * channels);
+    for (int i = 0; i < width * height * channels; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        data[i] = (float)(seed >> 8) / (float)(1u << 24) * 4.0f;
+    }
+    return data;
+}
+
+static void check(const char* name, const float* expected, const float* actual, int count) {
+    float max_error = 0.0f;
+    for (int i = 0; i < count; ++i) {
+        float error = fabsf(expected[i] - actual[i]);
+        if (error > max_error) max_error = error;
+    }
+    bool ok = max_error <= TOLERANCE;
+    printf("[%s] %s (max error %g)\n", ok ? "PASS" : "FAIL", name, max_error);
+    if (!ok) g_failures++;
+}
+
+static double seconds_now(void) {
+    return (double)clock() / (double)CLOCKS_PER_SEC;
+}
+
+static void report(const char* name, int width, int height, int runs, double seconds) {
+    double mpix = (double)width * height * runs / 1.0e6;
+    printf("  %-16s %8.1f MPix/s\n", name, seconds > 0.0 ? mpix / seconds : 0.0);
+}
+
+// Scalar reference: the lightmapper's old interleaved two-pass gaussian.
+static void reference_gaussian(float* data, int width, int height, int channels, int radius) {
+    int size = radius * 2 + 1;
+    float* kernel = (float*)malloc(sizeof(float) * size);
+    float sigma = (float)radius / 2.0f, sum = 0.0f;
+    for (int i = 0; i < size; ++i) {
+        int x = i - radius;
+        kernel[i] = expf(-(float)(x * x) / (2.0f * sigma * sigma));
+        sum += kernel[i];
+    }
+    for (int i = 0; i < size; ++i) kernel[i] /= sum;
+
+    float* temp = (float*)malloc(sizeof(float) * width * height * channels);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            for (int c = 0; c < channels; ++c) {
+                float total = 0.0f;
+                for (int k = -radius; k <= radius; ++k) total += data[(y * width + clampi(x + k, 0, width - 1)) * channels + c] * kernel[k + radius];
+                temp[(y * width + x) * channels + c] = total;
+            }
+        }
+    }
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            for (int c = 0; c < channels; ++c) {
+                float total = 0.0f;
+                for (int k = -radius; k <= radius; ++k) total += temp[(clampi(y + k, 0, height - 1) * width + x) * channels + c] * kernel[k + radius];
+                data[(y * width + x) * channels + c] = total;
+            }
+        }
+    }
+    free(temp);
+    free(kernel);
+}
+
+// Scalar reference: the old sliding-window box blur, column-major vertical pass.
+static void reference_box(float* out, const float* in, int width, int height, int radius) {
+    float* temp = (float*)malloc(sizeof(float) * width * height);
+    float scale = 1.0f / (float)(2 * radius + 1);
+    for (int y = 0; y < height; ++y) {
+        float sum = 0.0f;
+        for (int x = -radius; x <= radius; ++x) sum += in[y * width + clampi(x, 0, width - 1)];
+        for (int x = 0; x < width; ++x) {
+            temp[y * width + x] = sum * scale;
+            sum += in[y * width + clampi(x + radius + 1, 0, width - 1)] - in[y * width + clampi(x - radius, 0, width - 1)];
+        }
+    }
+    for (int x = 0; x < width; ++x) {
+        float sum = 0.0f;
+        for (int y = -radius; y <= radius; ++y) sum += temp[clampi(y, 0, height - 1) * width + x];
+        for (int y = 0; y < height; ++y) {
+            out[y * width + x] = sum * scale;
+            sum += temp[clampi(y + radius + 1, 0, height - 1) * width + x] - temp[clampi(y - radius, 0, height - 1) * width + x];
+        }
+    }
+    free(temp);
+}
+
+static void reference_pad(float* dst, const float* src, int width, int height, int channels, int pad) {
+    int padded_width = width + 2 * pad, padded_height = height + 2 * pad;
+    for (int y = 0; y < padded_height; ++y) {
+        for (int x = 0; x < padded_width; ++x) {
+            int sx = clampi(x - pad, 0, width - 1), sy = clampi(y - pad, 0, height - 1);
+            for (int c = 0; c < channels; ++c) dst[(y * padded_width + x) * channels + c] = src[(sy * width + sx) * channels + c];
+        }
+    }
+}
+
+static void gaussian_with_kernels(float* data, int width, int height, int channels, int radius) {
+    int count = width * height;
+    float* storage = (float*)malloc(sizeof(float) * count * channels);
+    float* planes[4];
+    for (int c = 0; c < channels; ++c) planes[c] = storage + (size_t)count * c;
+    float kernel[2 * 16 + 1];
+    Image_BuildGaussianKernel(kernel, radius);
+    Image_Deinterleave(data, planes, channels, count);
+    for (int c = 0; c < channels; ++c) Image_SeparableBlur(planes[c], width, height, kernel, radius);
+    Image_Interleave((const float* const*)planes, data, channels, count);
+    free(storage);
+}
+
+static void test_gaussian(int width, int height, int channels, int radius, int runs) {
+    int count = width * height * channels;
+    float* source = make_image(width, height, channels, 1u);
+    float* expected = (float*)malloc(sizeof(float) * count);
+    float* actual = (float*)malloc(sizeof(float) * count);
+
+    double ref_time = 0.0, new_time = 0.0;
+    for (int r = 0; r < runs; ++r) {
+        memcpy(expected, source, sizeof(float) * count);
+        double t = seconds_now();
+        reference_gaussian(expected, width, height, channels, radius);
+        ref_time += seconds_now() - t;
+
+        memcpy(actual, source, sizeof(float) * count);
+        t = seconds_now();
+        gaussian_with_kernels(actual, width, height, channels, radius);
+        new_time += seconds_now() - t;
+    }
+
+    char name[96];
+    snprintf(name, sizeof(name), "gaussian %dx%d c%d r%d", width, height, channels, radius);
+    check(name, expected, actual, count);
+    report("scalar", width, height, runs, ref_time);
+    report("kernels", width, height, runs, new_time);
+    free(source); free(expected); free(actual);
+}
+
+static void test_box(int width, int height, int radius, int runs) {
+    int count = width * height;
+    float* source = make_image(width, height, 1, 7u);
+    float* expected = (float*)malloc(sizeof(float) * count);
+    float* actual = (float*)malloc(sizeof(float) * count);
+
+    double ref_time = 0.0, new_time = 0.0;
+    for (int r = 0; r < runs; ++r) {
+        double t = seconds_now();
+        reference_box(expected, source, width, height, radius);
+        ref_time += seconds_now() - t;
+        t = seconds_now();
+        Image_BoxBlur(actual, source, width, height, radius);
+        new_time += seconds_now() - t;
+    }
+
+    char name[96];
+    snprintf(name, sizeof(name), "box %dx%d r%d", width, height, radius);
+    check(name, expected, actual, count);
+    report("scalar", width, height, runs, ref_time);
+    report("kernels", width, height, runs, new_time);
+    free(source); free(expected); free(actual);
+}
+
+static void test_pad(int width, int height, int channels, int pad) {
+    int padded = (width + 2 * pad) * (height + 2 * pad) * channels;
+    float* source = make_image(width, height, channels, 13u);
+    float* expected = (float*)malloc(sizeof(float) * padded);
+    float* actual = (float*)malloc(sizeof(float) * padded);
+    reference_pad(expected, source, width, height, channels, pad);
+    Image_PadEdges(actual, source, width, height, pad, sizeof(float) * channels);
+
+    char name[96];
+    snprintf(name, sizeof(name), "pad %dx%d c%d p%d", width, height, channels, pad);
+    check(name, expected, actual, padded);
+    free(source); free(expected); free(actual);
+}
+
+// Dilation is new behaviour, so it is checked against its definition: covered
+// texels never change, and each newly covered texel is the mean of its covered
+// 8-neighbours from the previous iteration.
+static void test_dilate(int width, int height) {
+    int count = width * height;
+    float* plane = make_image(width, height, 1, 21u);
+    unsigned char* mask = (unsigned char*)malloc(count);
+    for (int i = 0; i < count; ++i) {
+        int x = i % width, y = i / width;
+        mask[i] = (x > width / 3 && x < 2 * width / 3 && y > height / 3 && y < 2 * height / 3) ? 1 : 0;
+    }
+
+    float* expected = (float*)malloc(sizeof(float) * count);
+    unsigned char* expected_mask = (unsigned char*)malloc(count);
+    for (int i = 0; i < count; ++i) {
+        int x = i % width, y = i / width;
+        expected[i] = plane[i];
+        expected_mask[i] = mask[i];
+        if (mask[i]) continue;
+        float sum = 0.0f;
+        int n = 0;
+        for (int dy = -1; dy <= 1; ++dy) {
+            for (int dx = -1; dx <= 1; ++dx) {
+                int nx = x + dx, ny = y + dy;
+                if ((dx == 0 && dy == 0) || nx < 0 || ny < 0 || nx >= width || ny >= height || !mask[ny * width + nx]) continue;
+                sum += plane[ny * width + nx];
+                n++;
+            }
+        }
+        if (n > 0) {
+            expected[i] = sum / (float)n;
+            expected_mask[i] = 1;
+        }
+    }
+
+    float* planes[1] = { plane };
+    Image_Dilate(planes, 1, mask, width, height, 1);
+
+    char name[96];
+    snprintf(name, sizeof(name), "dilate %dx%d", width, height);
+    check(name, expected, plane, count);
+    if (memcmp(expected_mask, mask, count) != 0) {
+        printf("[FAIL] %s mask\n", name);
+        g_failures++;
+    }
+    free(plane); free(mask); free(expected); free(expected_mask);
+}
+
+int main(int argc, char* argv[]) {
+    bool bench = argc > 1 && strcmp(argv[1], "--bench") == 0;
+    int size = bench ? 1024 : 128;
+    int runs = bench ? 10 : 1;
+
+    // Odd sizes exercise the scalar tails after the vector lanes.
+    test_gaussian(size, size, 3, 2, runs);
+    test_gaussian(37, 29, 4, 4, 1);
+    test_box(size, size, 4, runs);
+    test_box(53, 17, 8, 1);
+    test_pad(31, 19, 3, 2);
+    test_pad(16, 16, 4, 4);
+    test_dilate(67, 41);
+
+    if (g_failures) printf("%d check(s) failed.\n", g_failures);
+    return g_failures ? 1 : 0;
+}
\ No newline at end of file
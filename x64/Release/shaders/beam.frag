@@ -2,8 +2,8 @@
 out vec4 FragColor;
 
 in vec2 TexCoords;
+in vec3 Color;
 
-uniform vec3 u_color;
 uniform float u_time;
 
 float rand(vec2 co){
@@ -26,7 +26,7 @@ void main()
 
     float intensity = core * 1.5 + glow * 0.3 + dynamic_effect * 0.5;
 
-    vec3 final_color = u_color * intensity;
+    vec3 final_color = Color * intensity;
     float alpha = clamp(intensity * 0.3, 0.0, 1.0);
     
     FragColor = vec4(final_color, alpha);
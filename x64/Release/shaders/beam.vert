@@ -1,8 +1,10 @@
 #version 450 core
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec2 aTexCoords;
+layout (location = 2) in vec3 aColor;
 
 out vec2 TexCoords;
+out vec3 Color;
 
 uniform mat4 view;
 uniform mat4 projection;
@@ -11,4 +13,5 @@ void main()
 {
     gl_Position = projection * view * vec4(aPos, 1.0);
     TexCoords = aTexCoords;
+    Color = aColor;
 }
\ No newline at end of file
@@ -0,0 +1,22 @@
+#version 450 core
+#extension GL_ARB_bindless_texture : require
+out vec4 FragColor;
+
+// Output is premultiplied so alpha-blended and additive particles can share
+// one sorted draw with GL_ONE, GL_ONE_MINUS_SRC_ALPHA: additive particles
+// simply write zero alpha.
+
+in vec2 TexCoords;
+in vec4 ParticleColor;
+flat in uvec2 TextureHandle;
+flat in uint Additive;
+
+void main()
+{
+    vec4 texColor = texture(sampler2D(TextureHandle), TexCoords);
+    if (texColor.a < 0.1)
+        discard;
+
+    vec4 color = texColor * ParticleColor;
+    FragColor = vec4(color.rgb * color.a, Additive != 0u ? 0.0 : color.a);
+}
\ No newline at end of file
@@ -0,0 +1,83 @@
+#version 450 core
+
+// Expands each sorted GPU particle into a camera-facing quad without a
+// geometry shader: six vertices per particle, pulled from the sort list by
+// gl_VertexID.
+
+struct Particle {
+    vec3 position;
+    float life;
+    vec3 velocity;
+    float maxLife;
+    float angle;
+    float angularVelocity;
+    int emitter;
+    uint padding;
+};
+
+struct Emitter {
+    vec4 position;
+    vec4 gravity;
+    vec4 startVelocity;
+    vec4 velocityVariation;
+    vec4 startColor;
+    vec4 endColor;
+    vec4 angles;
+    float startSize;
+    float endSize;
+    uint spawnOffset;
+    uint spawnCount;
+    uvec2 texture;
+    uint flags;
+    int alive;
+    float lifetime;
+    float lifetimeVariation;
+    int maxParticles;
+    uint padding;
+};
+
+struct SortEntry {
+    float key;
+    uint index;
+};
+
+layout(std430, binding = 6) readonly buffer ParticleBlock { Particle particles[]; };
+layout(std430, binding = 10) readonly buffer EmitterBlock { Emitter emitters[]; };
+layout(std430, binding = 12) readonly buffer SortBlock { SortEntry entries[]; };
+
+out vec2 TexCoords;
+out vec4 ParticleColor;
+flat out uvec2 TextureHandle;
+flat out uint Additive;
+
+uniform mat4 projection;
+uniform mat4 view;
+
+const vec2 CORNERS[6] = vec2[](
+    vec2(-0.5, -0.5), vec2(0.5, -0.5), vec2(-0.5, 0.5),
+    vec2(-0.5, 0.5), vec2(0.5, -0.5), vec2(0.5, 0.5)
+);
+
+void main()
+{
+    Particle p = particles[entries[gl_VertexID / 6].index];
+    Emitter e = emitters[p.emitter];
+    vec2 corner = CORNERS[gl_VertexID % 6];
+
+    float lifeRatio = clamp(1.0 - p.life / p.maxLife, 0.0, 1.0);
+    float size = mix(e.startSize, e.endSize, lifeRatio);
+    ParticleColor = mix(e.startColor, e.endColor, lifeRatio);
+    TextureHandle = e.texture;
+    Additive = e.flags & 1u;
+    TexCoords = vec2(corner.x + 0.5, 0.5 - corner.y);
+
+    vec3 camRight = vec3(view[0][0], view[1][0], view[2][0]);
+    vec3 camUp = vec3(view[0][1], view[1][1], view[2][1]);
+    float c = cos(p.angle);
+    float s = sin(p.angle);
+    vec3 right = c * camRight + s * camUp;
+    vec3 up = -s * camRight + c * camUp;
+    vec3 worldPos = p.position + (right * corner.x + up * corner.y) * size;
+
+    gl_Position = projection * view * vec4(worldPos, 1.0);
+}
\ No newline at end of file
@@ -25,6 +25,7 @@ in vec4 v_Color2;
 in float fadeAlpha;
 
 flat in int isBrush;
+flat in int decalIndex;
 
 in vec2 Velocity;
 
@@ -88,6 +89,20 @@ layout(std430, binding = 3) readonly buffer LightBlock {
     ShaderLight lights[];
 };
 
+struct DecalInstance {
+    mat4 model;
+    uvec2 diffuseMap;
+    uvec2 normalMap;
+    uvec2 rmaMap;
+    uvec2 lightmap;
+    uvec2 directionalLightmap;
+    uvec2 flags;
+};
+
+layout(std430, binding = 4) readonly buffer DecalBlock {
+    DecalInstance decals[];
+};
+
 uniform int numActiveLights;
 uniform Sun sun;
 uniform Flashlight flashlight;
@@ -415,9 +430,28 @@ void main()
         finalTexCoords4 = ReliefMapping(heightMap4, TexCoords4, heightScale4, viewDir_tangent, parallaxFadeFactor);
     }
 
-    vec4 texColor1 = texture(diffuseMap, finalTexCoords1);
-    vec3 normalTex1 = texture(normalMap, finalTexCoords1).rgb;
-    vec3 rma1 = texture(rmaMap, finalTexCoords1).rgb;
+    sampler2D layerDiffuse = diffuseMap;
+    sampler2D layerNormal = normalMap;
+    sampler2D layerRma = rmaMap;
+    sampler2D bakedLightmap = lightmap;
+    sampler2D bakedDirectionalLightmap = directionalLightmap;
+    bool hasLightmap = useLightmap;
+    bool hasDirectionalLightmap = useDirectionalLightmap;
+    if (decalIndex >= 0) {
+        // Instanced decals carry their own textures, so one draw covers every decal.
+        DecalInstance decal = decals[decalIndex];
+        layerDiffuse = sampler2D(decal.diffuseMap);
+        layerNormal = sampler2D(decal.normalMap);
+        layerRma = sampler2D(decal.rmaMap);
+        hasLightmap = (decal.flags.x & 1u) != 0u;
+        hasDirectionalLightmap = (decal.flags.x & 2u) != 0u;
+        if (hasLightmap) bakedLightmap = sampler2D(decal.lightmap);
+        if (hasDirectionalLightmap) bakedDirectionalLightmap = sampler2D(decal.directionalLightmap);
+    }
+
+    vec4 texColor1 = texture(layerDiffuse, finalTexCoords1);
+    vec3 normalTex1 = texture(layerNormal, finalTexCoords1).rgb;
+    vec3 rma1 = texture(layerRma, finalTexCoords1).rgb;
 
     vec4 texColor2 = texture(diffuseMap2, finalTexCoords2);
     vec3 normalTex2 = texture(normalMap2, finalTexCoords2).rgb;
@@ -610,10 +644,10 @@ void main()
 	vec3 bakedSpecular = vec3(0.0);
 	vec3 bakedRadiance = vec3(0.0);
     if (isBrush == 1) {
-        if (useLightmap) {
-            bakedRadiance = r_lightmaps_bicubic ? texture_bicubic(lightmap, TexCoordsLightmap, textureSize(lightmap, 0)).rgb : texture(lightmap, TexCoordsLightmap).rgb;
-            if (useDirectionalLightmap) {
-                vec4 directionalData = texture(directionalLightmap, TexCoordsLightmap);
+        if (hasLightmap) {
+            bakedRadiance = r_lightmaps_bicubic ? texture_bicubic(bakedLightmap, TexCoordsLightmap, textureSize(bakedLightmap, 0)).rgb : texture(bakedLightmap, TexCoordsLightmap).rgb;
+            if (hasDirectionalLightmap) {
+                vec4 directionalData = texture(bakedDirectionalLightmap, TexCoordsLightmap);
                 vec3 bakedLightDir = normalize(directionalData.rgb * 2.0 - 1.0);
                 float NdotL_baked = max(dot(N, bakedLightDir), 0.0);
                 bakedDiffuse = bakedRadiance * albedo * NdotL_baked;
@@ -713,22 +747,22 @@ void main()
     vec3 finalColor = Lo + ambient + bakedDiffuse + bakedSpecular;
 	
     if (r_debug_lightmaps) {
-        if (isBrush == 1 && useLightmap) {
+        if (isBrush == 1 && hasLightmap) {
             if (r_lightmaps_bicubic) {
-                finalColor = texture_bicubic(lightmap, TexCoordsLightmap, textureSize(lightmap, 0)).rgb;
+                finalColor = texture_bicubic(bakedLightmap, TexCoordsLightmap, textureSize(bakedLightmap, 0)).rgb;
             } else {
-                finalColor = texture(lightmap, TexCoordsLightmap).rgb;
+                finalColor = texture(bakedLightmap, TexCoordsLightmap).rgb;
             }
         } else {
             finalColor = vec3(0.0);
         }
 	}
     else if (r_debug_lightmaps_directional) {
-        if (isBrush == 1 && useDirectionalLightmap) {
+        if (isBrush == 1 && hasDirectionalLightmap) {
             if (r_lightmaps_bicubic) {
-                finalColor = texture_bicubic(directionalLightmap, TexCoordsLightmap, textureSize(directionalLightmap, 0)).rgb;
+                finalColor = texture_bicubic(bakedDirectionalLightmap, TexCoordsLightmap, textureSize(bakedDirectionalLightmap, 0)).rgb;
             } else {
-                finalColor = texture(directionalLightmap, TexCoordsLightmap).rgb;
+                finalColor = texture(bakedDirectionalLightmap, TexCoordsLightmap).rgb;
             }
         } else {
             finalColor = vec3(0.0);
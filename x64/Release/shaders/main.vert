@@ -26,6 +26,7 @@ out VS_OUT {
     ivec4 boneIndices;
     vec4 boneWeights;
     flat int isBrush;
+    flat int decalIndex;
     float clipDist;
 } vs_out;
 
@@ -43,6 +44,22 @@ uniform float u_windStrength;
 uniform float u_fadeStartDist;
 uniform float u_fadeEndDist;
 
+struct DecalInstance {
+    mat4 model;
+    uvec2 diffuseMap;
+    uvec2 normalMap;
+    uvec2 rmaMap;
+    uvec2 lightmap;
+    uvec2 directionalLightmap;
+    uvec2 flags;
+};
+
+layout(std430, binding = 4) readonly buffer DecalBlock {
+    DecalInstance decals[];
+};
+
+uniform bool u_decalInstanced;
+
 void main()
 {
     mat4 boneTransform = mat4(1.0);
@@ -68,7 +85,8 @@ void main()
         finalPos.z += (sway + flutter) * u_windDirection.z;
     }
 
-    mat4 finalModelMatrix = model * boneTransform;
+    mat4 instanceModel = u_decalInstanced ? decals[gl_InstanceID].model : model;
+    mat4 finalModelMatrix = instanceModel * boneTransform;
     vs_out.worldPos = vec3(finalModelMatrix * vec4(finalPos, 1.0));
     vs_out.texCoords = aTexCoords;
     vs_out.texCoords2 = aTexCoords2;
@@ -80,6 +98,7 @@ void main()
     vs_out.boneIndices = aBoneIndices;
     vs_out.boneWeights = aBoneWeights;
     vs_out.isBrush = (isBrush ? 1 : 0);
+    vs_out.decalIndex = u_decalInstanced ? gl_InstanceID : -1;
 
     mat3 normalMatrix = mat3(transpose(inverse(finalModelMatrix)));
     vs_out.worldNormal = normalize(normalMatrix * aNormal);
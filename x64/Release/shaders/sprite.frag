@@ -1,13 +1,13 @@
 #version 450 core
+#extension GL_ARB_bindless_texture : require
 out vec4 FragColor;
 
 in vec2 TexCoords;
-
-uniform sampler2D spriteTexture;
+flat in uvec2 TextureHandle;
 
 void main()
 {
-    vec4 texColor = texture(spriteTexture, TexCoords);
+    vec4 texColor = texture(sampler2D(TextureHandle), TexCoords);
     if (texColor.a < 0.1)
         discard;
 
@@ -1,71 +1,18 @@
 #version 450 core
 layout (location = 0) out vec4 fragColor;
 
+// Resolves the filtered half-resolution reflections onto the lit scene. The
+// reflection texture holds premultiplied color with the weight in alpha, so
+// bilinear upsampling does not darken edges next to pixels without a hit.
+
 uniform sampler2D colorBuffer;
 uniform sampler2D gNormal;
 uniform sampler2D gPBRParams;
 uniform sampler2D gPosition;
-uniform mat4 projection, view;
-
-uniform int binarySearchCount = 8;
-uniform int rayMarchCount = 64;
-uniform float rayStep = 0.015;
-uniform float thickness = 0.1;
+uniform sampler2D reflectionBuffer;
 
 in vec2 TexCoords;
 
-vec2 binarySearch(inout vec3 dir, inout vec3 hitCoord, inout float dDepth) {
-    float depth;
-    vec4 projectedCoord;
- 
-    for(int i = 0; i < binarySearchCount; i++) {
-        projectedCoord = projection * vec4(hitCoord, 1.0);
-        projectedCoord.xy /= projectedCoord.w;
-        projectedCoord.xy = projectedCoord.xy * 0.5 + 0.5;
- 
-        depth = texture(gPosition, projectedCoord.xy).z;
- 
-        dDepth = hitCoord.z - depth;
-
-        dir *= 0.5;
-        if(dDepth > 0.0)
-            hitCoord += dir;
-        else
-            hitCoord -= dir;    
-    }
-
-    projectedCoord = projection * vec4(hitCoord, 1.0);
-    projectedCoord.xy /= projectedCoord.w;
-    projectedCoord.xy = projectedCoord.xy * 0.5 + 0.5;
- 
-    return projectedCoord.xy;
-}
-
-vec2 rayCast(vec3 dir, inout vec3 hitCoord, out float dDepth) {
-    dir *= rayStep;
-    
-    for (int i = 0; i < rayMarchCount; i++) {
-        hitCoord += dir;
-
-        vec4 projectedCoord = projection * vec4(hitCoord, 1.0);
-        projectedCoord.xy /= projectedCoord.w;
-        projectedCoord.xy = projectedCoord.xy * 0.5 + 0.5; 
-
-        if (projectedCoord.x < 0.0 || projectedCoord.x > 1.0 || projectedCoord.y < 0.0 || projectedCoord.y > 1.0) {
-            return vec2(-1.0);
-        }
-
-        float depth = texture(gPosition, projectedCoord.xy).z;
-        dDepth = hitCoord.z - depth;
-        
-        if (dDepth <= 0.0 && dDepth > -thickness) {
-            return binarySearch(dir, hitCoord, dDepth);
-        }
-    }
-
-    return vec2(-1.0);
-}
-
 float fresnel(vec3 viewDir, vec3 normal) {
     return pow(1.0 - max(dot(viewDir, normal), 0.0), 5.0);
 }
@@ -89,28 +36,16 @@ void main() {
         return;
     }
 
-    vec3 normal = normalize(texture(gNormal, TexCoords).xyz);
-    vec3 reflected = normalize(reflect(normalize(viewPos), normal));
+    vec4 reflection = texture(reflectionBuffer, TexCoords);
+    if (reflection.a <= 0.001) {
+        fragColor = vec4(baseColor, 1.0);
+        return;
+    }
 
-    vec3 hitPos = viewPos;
-    float dDepth; 
-    vec2 coords = rayCast(reflected * max(-viewPos.z, 0.2), hitPos, dDepth);
-    
-    vec3 finalColor;
+    vec3 normal = normalize(texture(gNormal, TexCoords).xyz);
+    vec3 reflectedColor = reflection.rgb / reflection.a;
+    float fresnelFactor = fresnel(-normalize(viewPos), normal);
 
-    if (coords.x >= 0.0) {
-        float lod = roughness * 4.0;
-        vec3 reflectedColor = textureLod(colorBuffer, coords, lod).rgb;
-        
-        float dist = length(texture(gPosition, coords).xyz - viewPos);
-        float fade = clamp(1.0 - dist / 50.0, 0.0, 1.0);
-        
-        float fresnelFactor = fresnel(-normalize(viewPos), normal);
-        
-        finalColor = mix(baseColor, reflectedColor, reflectionStrength * fade * fresnelFactor);
-    } else {
-        finalColor = baseColor;
-    }
-    
+    vec3 finalColor = mix(baseColor, reflectedColor, reflectionStrength * fresnelFactor * clamp(reflection.a, 0.0, 1.0));
     fragColor = vec4(finalColor, 1.0);
 }
\ No newline at end of file